@@ -39,7 +39,8 @@ public:
     enum close_type
     {
         CLOSE_NORMAL,
-        CLOSE_FATAL
+        CLOSE_FATAL,
+        CLOSE_IDLE      /**< The connection is idle and can be returned to the connection pool */
     };
 
     /**
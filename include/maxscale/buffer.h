@@ -77,7 +77,8 @@ typedef enum
     GWBUF_INFO_PARSED = 0x1
 } gwbuf_info_t;
 
-#define GWBUF_IS_PARSED(b) (b->sbuf->info & GWBUF_INFO_PARSED)
+#define GWBUF_IS_PARSED(b) \
+    ((b->sbuf->info & GWBUF_INFO_PARSED) && gwbuf_get_buffer_object_data(b, GWBUF_PARSING_INFO))
 
 /**
  * A structure for cleaning up memory allocations of structures which are
@@ -87,7 +88,9 @@ typedef enum
  */
 typedef enum
 {
-    GWBUF_PARSING_INFO
+    GWBUF_PARSING_INFO,
+    GWBUF_EXTERNAL_DATA,
+    GWBUF_CANONICAL_HASH
 } bufobj_id_t;
 
 typedef struct buffer_object_st buffer_object_t;
@@ -97,6 +100,7 @@ struct buffer_object_st
     bufobj_id_t      bo_id;
     void*            bo_data;
     void             (* bo_donefun_fp)(void*);
+    void*            bo_start;  /*< Start of the data the object was added for */
     buffer_object_t* bo_next;
 };
 
@@ -202,6 +206,27 @@ extern GWBUF* gwbuf_alloc(unsigned int size);
  */
 extern GWBUF* gwbuf_alloc_and_load(unsigned int size, const void* data);
 
+/**
+ * Allocate a new gateway buffer that refers to data it does not own.
+ *
+ * No copy of the data is made. The data must remain valid and must not be
+ * modified by its owner until @c release has been called, which happens when
+ * the last reference to the buffer, including clones, is freed.
+ *
+ * @param data     Pointer to the data
+ * @param size     The size in bytes of the data
+ * @param release  Function to be called with @c context when the data no
+ *                 longer is referred to
+ * @param context  Argument to be provided to @c release
+ *
+ * @return Pointer to the buffer structure or NULL if memory could not
+ *         be allocated.
+ */
+extern GWBUF* gwbuf_alloc_external(void* data,
+                                   unsigned int size,
+                                   void (* release)(void*),
+                                   void* context);
+
 /**
  * Free a chain of gateway buffers
  *
@@ -335,7 +360,8 @@ extern size_t gwbuf_copy_data(const GWBUF* buffer, size_t offset, size_t bytes,
  * @brief Split a buffer in two
  *
  * The returned value will be @c length bytes long. If the length of @c buf
- * exceeds @c length, the remaining buffers are stored in @buf.
+ * exceeds @c length, the remaining buffers are stored in @buf. A buffer that
+ * is split in the middle is not copied; both parts refer to the same data.
  *
  * @param buf Buffer chain to split
  * @param length Number of bytes that the returned buffer should contain
@@ -384,9 +410,31 @@ extern char* gwbuf_get_property(GWBUF* buf, const char* name);
  */
 extern GWBUF* gwbuf_make_contiguous(GWBUF* buf);
 
+/**
+ * Prepare a buffer for being retained for a long time
+ *
+ * A buffer split out of a larger read refers to the whole data it was read
+ * into. A small buffer that pins several times its own size is therefore
+ * copied into a buffer of its own, so that the larger data can be released.
+ * Other buffers are returned as such. The properties are copied and the
+ * buffer objects are moved to the copy, so clones of the original buffer no
+ * longer see them.
+ *
+ * @param orig  The buffer to compact, must not be used after the function call
+ *
+ * @return A buffer with the same contents as @c orig.
+ *
+ * @attention Never returns NULL, memory allocation failures abort the process
+ */
+extern GWBUF* gwbuf_make_compact(GWBUF* buf);
+
 /**
  * Add a buffer object to GWBUF buffer.
  *
+ * The object is associated with the data the buffer currently starts at, so
+ * it is visible to clones of the buffer but not to other buffers that refer
+ * to other parts of the same data.
+ *
  * @param buf         GWBUF where object is added
  * @param id          Type identifier for object
  * @param data        Object data
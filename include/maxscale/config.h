@@ -75,6 +75,7 @@ MXS_BEGIN_DECLS
 #define MXS_JSON_PTR_PARAM_SSL_VERSION           MXS_JSON_PTR_PARAMETERS "/ssl_version"
 #define MXS_JSON_PTR_PARAM_SSL_CERT_VERIFY_DEPTH MXS_JSON_PTR_PARAMETERS "/ssl_cert_verify_depth"
 #define MXS_JSON_PTR_PARAM_SSL_VERIFY_PEER_CERT  MXS_JSON_PTR_PARAMETERS "/ssl_verify_peer_certificate"
+#define MXS_JSON_PTR_PARAM_REUSEPORT             MXS_JSON_PTR_PARAMETERS "/reuseport"
 
 /** Non-parameter JSON pointers */
 #define MXS_JSON_PTR_ROUTER   "/data/attributes/router"
@@ -110,6 +111,7 @@ extern const char CN_AUTH_CONNECT_TIMEOUT[];
 extern const char CN_AUTH_READ_TIMEOUT[];
 extern const char CN_AUTH_WRITE_TIMEOUT[];
 extern const char CN_AUTO[];
+extern const char CN_CACHE_SHARED[];
 extern const char CN_CACHE_SIZE[];
 extern const char CN_CLASSIFY[];
 extern const char CN_CONNECTION_TIMEOUT[];
@@ -136,6 +138,7 @@ extern const char CN_LISTENER[];
 extern const char CN_LOAD_PERSISTED_CONFIGS[];
 extern const char CN_LOCALHOST_MATCH_WILDCARD_HOST[];
 extern const char CN_LOG_AUTH_WARNINGS[];
+extern const char CN_LOG_OVERFLOW[];
 extern const char CN_LOG_THROTTLING[];
 extern const char CN_MAXSCALE[];
 extern const char CN_MAX_CONNECTIONS[];
@@ -162,13 +165,17 @@ extern const char CN_PORT[];
 extern const char CN_PROTOCOL[];
 extern const char CN_QUERY_CLASSIFIER[];
 extern const char CN_QUERY_CLASSIFIER_ARGS[];
+extern const char CN_QUERY_CLASSIFIER_CACHE_SHARED[];
 extern const char CN_QUERY_CLASSIFIER_CACHE_SIZE[];
 extern const char CN_QUERY_RETRIES[];
 extern const char CN_QUERY_RETRY_TIMEOUT[];
 extern const char CN_RELATIONSHIPS[];
 extern const char CN_REQUIRED[];
+extern const char CN_REBALANCE_PERIOD[];
+extern const char CN_REBALANCE_THRESHOLD[];
 extern const char CN_RETAIN_LAST_STATEMENTS[];
 extern const char CN_RETRY_ON_FAILURE[];
+extern const char CN_REUSEPORT[];
 extern const char CN_ROUTER[];
 extern const char CN_ROUTER_DIAGNOSTICS[];
 extern const char CN_ROUTER_OPTIONS[];
@@ -299,6 +306,9 @@ typedef struct
     char             peer_password[MAX_ADMIN_HOST_LEN]; /**< Password for maxscale-to-maxscale traffic */
     mxb_log_target_t log_target;                        /**< Log type */
     bool             load_persisted_configs;            /**< Load persisted configuration files on startup */
+    time_t           rebalance_period;                  /**< How often the worker loads are balanced, 0 if
+                                                         * not at all */
+    int              rebalance_threshold;               /**< Load difference that triggers rebalancing */
 } MXS_CONFIG;
 
 /**
@@ -44,12 +44,13 @@ struct dcb;
  */
 typedef struct dcbstats
 {
-    int n_reads;        /*< Number of reads on this descriptor */
-    int n_writes;       /*< Number of writes on this descriptor */
-    int n_accepts;      /*< Number of accepts on this descriptor */
-    int n_buffered;     /*< Number of buffered writes */
-    int n_high_water;   /*< Number of crosses of high water mark */
-    int n_low_water;    /*< Number of crosses of low water mark */
+    int     n_reads;        /*< Number of reads on this descriptor */
+    int     n_writes;       /*< Number of write system calls on this descriptor */
+    int     n_accepts;      /*< Number of accepts on this descriptor */
+    int     n_buffered;     /*< Number of buffered writes */
+    int     n_high_water;   /*< Number of crosses of high water mark */
+    int     n_low_water;    /*< Number of crosses of low water mark */
+    int64_t n_bytes_written;/*< Number of bytes written to this descriptor */
 } DCBSTATS;
 
 #define DCBSTATS_INIT {0}
@@ -157,6 +158,18 @@ typedef enum
     SSL_HANDSHAKE_FAILED            /*< The SSL handshake failed */
 } SSL_STATE;
 
+/**
+ * A listening socket of a listener whose port is shared between the routing
+ * workers with SO_REUSEPORT. Each worker polls a socket of its own and the
+ * kernel distributes the incoming connections between them.
+ */
+typedef struct dcb_worker_socket
+{
+    MXB_POLL_DATA poll;     /**< The poll data, owned by the polling worker */
+    struct dcb*   dcb;      /**< The listener DCB */
+    int           fd;       /**< The listening socket */
+} DCB_WORKER_SOCKET;
+
 /**
  * Descriptor Control Block
  *
@@ -202,7 +215,8 @@ typedef struct dcb
     uint32_t fake_event;                                /**< Fake event to be delivered to handler */
 
     DCBSTATS    stats;                      /**< DCB related statistics */
-    struct dcb* nextpersistent;             /**< Next DCB in the persistent pool for SERVER */
+    struct dcb* nextpersistent;             /**< Next (older) DCB in the persistent pool for SERVER */
+    struct dcb* prevpersistent;             /**< Previous (newer) DCB in the persistent pool for SERVER */
     time_t      persistentstart;            /**<    0: Not in the persistent pool.
                                              *      -1: Evicted from the persistent pool and being closed.
                                              *   non-0: Time when placed in the persistent pool.
@@ -212,6 +226,7 @@ typedef struct dcb
     void*           authenticator_data;     /**< The authenticator data for this DCB */
     DCB_CALLBACK*   callbacks;              /**< The list of callbacks for the DCB */
     int64_t         last_read;              /*< Last time the DCB received data */
+    int64_t         connect_start;          /*< When the connection was created, in microseconds */
     struct server*  server;                 /**< The associated backend server */
     SSL*            ssl;                    /*< SSL struct for connection */
     bool            ssl_read_want_read;     /*< Flag */
@@ -229,6 +244,9 @@ typedef struct dcb
     uint32_t n_close;           /** How many times dcb_close has been called. */
     char*    path;              /** If a Unix socket, the path it was bound to. */
 
+    DCB_WORKER_SOCKET* worker_sockets;  /**< For a reuseport listener, the socket of each worker */
+    int                n_worker_sockets;/**< Number of worker sockets */
+
     uint64_t m_uid; /**< Unique identifier for this DCB */
 } DCB;
 
@@ -297,7 +315,7 @@ void dcb_printf(DCB*, const char*, ...) __attribute__ ((format(printf, 2, 3)));
 int dcb_add_callback(DCB*, DCB_REASON, int (*)(struct dcb*, DCB_REASON, void*), void*);
 int dcb_remove_callback(DCB*, DCB_REASON, int (*)(struct dcb*, DCB_REASON, void*), void*);
 int dcb_count_by_usage(DCB_USAGE);                      /* Return counts of DCBs */
-int      dcb_persistent_clean_count(DCB*, int, bool);   /* Clean persistent and return count */
+int      dcb_persistent_clean_count(struct server*, int, bool); /* Clean persistent and return count */
 void     dcb_hangup_foreach(struct server* server);
 uint64_t dcb_get_session_id(DCB* dcb);
 char*    dcb_role_name(DCB*);               /* Return the name of a role */
@@ -307,6 +325,15 @@ int      dcb_listen(DCB* listener, const char* config, const char* protocol_name
 void     dcb_enable_session_timeouts();
 void     dcb_process_idle_sessions(int thr);
 
+/**
+ * Called by the backend protocol when a new connection has been authenticated.
+ * Adds the time it took to connect and authenticate to the statistics of the
+ * server.
+ *
+ * @param dcb  The backend DCB.
+ */
+void dcb_backend_connected(DCB* dcb);
+
 /**
  * @brief Append a buffer the DCB's readqueue
  *
@@ -458,6 +485,8 @@ json_t* dcb_to_json(DCB* dcb);
  */
 #define DCBF_HUNG    0x0002     /*< Hangup has been dispatched */
 #define DCBF_REPLIED 0x0004     /*< DCB was written to */
+#define DCBF_POOLABLE 0x0008    /*< Backend DCB can be pooled even if its session is still alive */
+#define DCBF_PINGING  0x0010    /*< Pooled DCB is waiting for the reply to a ping */
 
 #define DCB_REPLIED(d) ((d)->flags & DCBF_REPLIED)
 
@@ -26,6 +26,13 @@ MXS_BEGIN_DECLS
 struct dcb;
 struct service;
 
+/**
+ * The number of buckets in the accept latency histogram of a listener. Bucket
+ * n counts the connections accepted in less than 2^n microseconds and the last
+ * bucket counts the rest.
+ */
+#define LISTENER_ACCEPT_LATENCY_BUCKETS 20
+
 /**
  * The servlistener structure is used to link a service to the protocols that
  * are used to support that service. It defines the name of the protocol module
@@ -48,6 +55,10 @@ typedef struct servlistener
     struct service*       service;  /**< The service which used by this listener */
     pthread_mutex_t       lock;
     int                   active;   /**< True if the port has not been deleted */
+    int64_t               n_writes; /**< Number of write system calls on client connections */
+    int64_t               n_bytes_written; /**< Number of bytes written to client connections */
+    bool                  reuseport; /**< True if each worker has a socket of its own */
+    int64_t               accept_latency[LISTENER_ACCEPT_LATENCY_BUCKETS]; /**< Accept latency histogram */
     struct  servlistener* next;     /**< Next service protocol */
 } SERV_LISTENER;                    // TODO: Rename to LISTENER
 
@@ -77,6 +88,15 @@ bool listener_serialize(const SERV_LISTENER* listener);
  */
 json_t* listener_to_json(const SERV_LISTENER* listener);
 
+/**
+ * @brief Record the latency of an accepted connection
+ *
+ * @param listener     The listener that accepted the connection
+ * @param microseconds The time it took from the listener becoming readable
+ *                     until the client connection was set up
+ */
+void listener_add_accept_latency(SERV_LISTENER* listener, int64_t microseconds);
+
 SERV_LISTENER* listener_alloc(struct service* service,
                               const char* name,
                               const char* protocol,
@@ -84,7 +104,8 @@ SERV_LISTENER* listener_alloc(struct service* service,
                               unsigned short port,
                               const char* authenticator,
                               const char* auth_options,
-                              SSL_LISTENER* ssl);
+                              SSL_LISTENER* ssl,
+                              bool reuseport);
 void listener_free(SERV_LISTENER* listener);
 int  listener_set_ssl_version(SSL_LISTENER* ssl_listener, const char* version);
 void listener_set_certificates(SSL_LISTENER* ssl_listener, char* cert, char* key, char* ca_cert);
@@ -222,6 +222,7 @@ typedef struct monitored_server
     uint64_t                 mon_prev_status;   /**< Status before starting the current monitor loop */
     uint64_t                 pending_status;    /**< Status during current monitor loop */
     int64_t                  disk_space_checked;/**< When was the disk space checked the last time */
+    int64_t                  probe_time;        /**< How long the latest probe took, in microseconds */
     struct monitored_server* next;              /**< The next server in the list */
 } MXS_MONITORED_SERVER;
 
@@ -257,6 +258,7 @@ struct mxs_monitor
     char*                 module_name;                      /**< Name of the monitor module */
     MXS_MONITOR_INSTANCE* instance;                         /**< Instance returned from startMonitor */
     size_t                interval;                         /**< The monitor interval */
+    int                   probe_threads;                    /**< How many servers are probed concurrently */
     int                   check_maintenance_flag;           /**< Set when admin requests a maintenance status
                                                              * change. */
     bool                   active;                          /**< True if monitor is active */
@@ -283,6 +285,7 @@ extern const char CN_DISK_SPACE_CHECK_INTERVAL[];
 extern const char CN_EVENTS[];
 extern const char CN_JOURNAL_MAX_AGE[];
 extern const char CN_MONITOR_INTERVAL[];
+extern const char CN_PROBE_THREADS[];
 extern const char CN_SCRIPT[];
 extern const char CN_SCRIPT_TIMEOUT[];
 
@@ -15,7 +15,10 @@
 #include <maxscale/ccdefs.hh>
 
 #include <atomic>
+#include <functional>
+#include <memory>
 #include <maxbase/semaphore.hh>
+#include <maxbase/stopwatch.hh>
 #include <maxbase/worker.hh>
 #include <maxscale/monitor.h>
 
@@ -218,16 +221,46 @@ protected:
      */
     virtual bool immediate_tick_required() const;
 
+    /**
+     * @brief Call a function concurrently for a number of items
+     *
+     * The calls are spread over the probe threads of the monitor and the calling
+     * thread, at most @c probe_threads calls are in progress at the same time.
+     * The function returns once all calls have returned. The probe threads are
+     * initialized for the connector, so the calls may use the connections of the
+     * monitored servers, as long as each call only uses the connection of one server.
+     *
+     * @param n     The number of calls to make.
+     * @param func  The function to call, with an index from 0 to @c n - 1.
+     */
+    void run_concurrently(size_t n, const std::function<void(size_t)>& func);
+
+    /**
+     * @brief Record how long the probing of a server took
+     *
+     * The latest probe time of each server is shown in the monitor diagnostics.
+     * A warning is logged when probing a server starts to take longer than the
+     * monitor interval.
+     *
+     * @param pMonitored_server  The monitored server.
+     * @param time               How long the probe took.
+     */
+    void record_probe_time(MXS_MONITORED_SERVER* pMonitored_server, mxb::Duration time);
+
     MXS_MONITOR*          m_monitor;    /**< The generic monitor structure. */
     MXS_MONITORED_SERVER* m_master;     /**< Master server */
 
 private:
+    class ProbeThreads;
+
     std::atomic<bool> m_thread_running; /**< Thread state. Only visible inside MonitorInstance. */
     int32_t           m_shutdown;       /**< Non-zero if the monitor should shut down. */
     bool              m_checked;        /**< Whether server access has been checked. */
     mxb::Semaphore    m_semaphore;      /**< Semaphore for synchronizing with monitor thread. */
     int64_t           m_loop_called;    /**< When was the loop called the last time. */
 
+    std::unique_ptr<ProbeThreads> m_probe_threads;  /**< Threads for probing servers concurrently. */
+
     bool pre_run() final;
     void post_run() final;
 
@@ -251,7 +284,9 @@ protected:
      * @brief Update server information
      *
      * The implementation should probe the server in question and update
-     * the server status bits.
+     * the server status bits. The function is called concurrently for
+     * different servers, so any state shared between the servers must
+     * be protected.
      */
     virtual void update_server_status(MXS_MONITORED_SERVER* pMonitored_server) = 0;
 
@@ -284,8 +319,12 @@ private:
      *     If there is not, the pending status will be updated accordingly and
      *     @c update_server_status() will *not* be called.
      *   - After the call, update the error count of the server if it is down.
+     *
+     * The servers are probed concurrently, see @c run_concurrently().
      */
     void tick();    // final
+
+    void probe_server(MXS_MONITORED_SERVER* pMonitored_server);
 };
 
 /**
@@ -178,6 +178,17 @@ typedef struct mxs_protocol
      * @return JSON representation of the DCB
      */
     json_t* (*diagnostics_json)(struct dcb* dcb);
+
+    /**
+     * Check whether a client connection is idle, used when moving sessions
+     * between workers. A connection is idle if no reply is pending and no
+     * transaction is open. If not provided, the sessions are never moved.
+     *
+     * @param dcb Client DCB to check
+     *
+     * @return True if the connection is idle
+     */
+    bool (* is_idle)(struct dcb* dcb);
 } MXS_PROTOCOL;
 
 /**
@@ -185,7 +196,7 @@ typedef struct mxs_protocol
  * the MXS_PROTOCOL structure is changed. See the rules defined in modinfo.h
  * that define how these numbers should change.
  */
-#define MXS_PROTOCOL_VERSION {2, 0, 0}
+#define MXS_PROTOCOL_VERSION {2, 1, 0}
 
 /**
  * Specifies capabilities specific for protocol.
@@ -318,6 +318,34 @@ typedef enum
  */
 static const char* const MXS_LAST_GTID = "last_gtid";
 
+/**
+ * The state of the reply to the latest command. Only followed if sessions are
+ * moved between workers, so that it is known when a session is idle.
+ */
+typedef enum
+{
+    MXS_REPLY_TRACK_DONE,       /*< No reply is pending */
+    MXS_REPLY_TRACK_START,      /*< Waiting for the first packet of a reply */
+    MXS_REPLY_TRACK_COLDEF,     /*< Column definitions of a result set */
+    MXS_REPLY_TRACK_COLDEF_EOF, /*< The EOF packet after the column definitions */
+    MXS_REPLY_TRACK_ROWS,       /*< Rows of a result set */
+    MXS_REPLY_TRACK_PREPARE,    /*< Parameter and column definitions of a prepared statement */
+    MXS_REPLY_TRACK_LOAD_DATA   /*< The client is sending the file of a LOAD DATA LOCAL INFILE */
+} mxs_reply_track_state_t;
+
+typedef struct
+{
+    bool                    enabled;    /*< Whether the replies are followed */
+    bool                    lost;       /*< The replies could not be followed, never idle */
+    mxs_reply_track_state_t state;      /*< State of the reply to the latest command */
+    uint8_t                 command;    /*< The latest command */
+    uint64_t                n_packets;  /*< Column definitions or prepared statement packets left */
+    bool                    skip_reply; /*< The next reply packet continues a large packet */
+    bool                    skip_request;   /*< The next client packet continues a large packet */
+    bool                    out_params; /*< The result set contains the OUT parameters of a procedure */
+    bool                    in_trx;     /*< The latest reply had SERVER_STATUS_IN_TRANS set */
+} MXS_REPLY_TRACKER;
+
 /**
  * MySQL Protocol specific state data.
  *
@@ -346,6 +374,7 @@ typedef struct
                                              * packet type */
     bool large_query;                       /*< Whether to ignore the command byte of the next
                                              * packet*/
+    MXS_REPLY_TRACKER reply_tracker;        /*< Client side only, the state of the replies */
 } MySQLProtocol;
 
 typedef struct
@@ -693,6 +722,36 @@ uint32_t mxs_mysql_extract_ps_id(GWBUF* buffer);
  */
 bool mxs_mysql_command_will_respond(uint8_t cmd);
 
+/**
+ * @brief Follow a packet sent by the client
+ *
+ * Only one command at a time is followed. If the client sends the next one
+ * before the reply has been received, the replies are no longer followed.
+ *
+ * @param tracker The reply tracker of the client protocol
+ * @param len     The payload length of the packet
+ * @param cmd     The first byte of the payload
+ */
+void mxs_mysql_track_request(MXS_REPLY_TRACKER* tracker, uint32_t len, uint8_t cmd);
+
+/**
+ * @brief Follow the packets of a reply
+ *
+ * @param tracker The reply tracker of the client protocol
+ * @param reply   Complete packets of the reply
+ */
+void mxs_mysql_track_reply(MXS_REPLY_TRACKER* tracker, GWBUF* reply);
+
+/**
+ * @brief Check whether a followed session is idle
+ *
+ * @param tracker The reply tracker of the client protocol
+ *
+ * @return True, if the reply to the latest command has been received and
+ *         no transaction is open
+ */
+bool mxs_mysql_reply_tracker_is_idle(const MXS_REPLY_TRACKER* tracker);
+
 /* Type of the kill-command sent by client. */
 typedef enum kill_type
 {
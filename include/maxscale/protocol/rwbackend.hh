@@ -12,6 +12,7 @@
  */
 #pragma once
 
+#include <deque>
 #include <map>
 #include <memory>
 
@@ -99,6 +100,54 @@ public:
      */
     bool write(GWBUF* buffer, response_type type = EXPECT_RESPONSE);
 
+    /**
+     * Check whether a query can be pipelined
+     *
+     * A query can be pipelined if it can be written to the backend before the
+     * reply to the current query is complete. Only queries that generate
+     * plain results, COM_QUERY and COM_STMT_EXECUTE without cursors, can be
+     * pipelined and only if the current query is also one of them.
+     *
+     * @param buffer The query to write
+     *
+     * @return True if the query can be written while waiting for a reply
+     */
+    bool can_pipeline(GWBUF* buffer) const;
+
+    /**
+     * Number of pipelined queries
+     *
+     * @return The number of queries written after the current one whose replies are expected
+     */
+    size_t pipelined_queries() const
+    {
+        return m_pipelined.size();
+    }
+
+    /**
+     * Measure the response time of the query that was written last
+     *
+     * The start time and the shape are kept with the query, so that they are
+     * available when its reply is complete even if other queries have been
+     * pipelined after it.
+     *
+     * @param shape The canonical hash of the query, 0 if it is not profiled
+     */
+    void measure_last_query(uint64_t shape);
+
+    /**
+     * The response time of the query whose reply was completed last
+     *
+     * @param pShape The canonical hash the query was measured with
+     *
+     * @return The response time or 0 if the query was not measured
+     */
+    maxbase::Duration completed_query_time(uint64_t* pShape) const
+    {
+        *pShape = m_completed_shape;
+        return m_completed_time;
+    }
+
     /**
      * Continue a previously started write
      *
@@ -131,6 +180,22 @@ public:
 
     void process_reply(GWBUF* buffer);
 
+    /**
+     * Process the reply to the current query
+     *
+     * If queries are pipelined, the buffer can also contain the replies to the
+     * queries that follow the current one. Only the reply to the current query
+     * is processed and the rest of the buffer is split off. Once the reply is
+     * complete, the next pipelined query becomes the current one.
+     *
+     * @param ppBuffer Buffer containing the response, on return contains only
+     *                 the part that belongs to the reply to the current query
+     *
+     * @return The part of the buffer that belongs to the replies to the
+     *         pipelined queries or NULL if the buffer had nothing else
+     */
+    GWBUF* process_next_reply(GWBUF** ppBuffer);
+
     /**
      * Check whether the response from the server is complete
      *
@@ -151,7 +216,7 @@ public:
         return m_reply_state != REPLY_STATE_START && m_reply_state != REPLY_STATE_DONE;
     }
 
-    void process_packets(GWBUF* buffer);
+    size_t process_packets(GWBUF* buffer);
     void process_reply_start(mxs::Buffer::iterator it);
 
     // Controlled by the session
@@ -168,6 +233,19 @@ private:
     uint64_t         m_num_coldefs = 0;
     bool             m_skip_next = false;
 
+    /** A query whose reply is expected */
+    struct Query
+    {
+        uint8_t            command;
+        maxbase::TimePoint start;   /**< When the query was sent, if it is measured */
+        uint64_t           shape;   /**< Canonical hash of the query, 0 if not profiled */
+    };
+
+    Query             m_current {0, maxbase::TimePoint(), 0};  /**< Timing of the current query */
+    std::deque<Query> m_pipelined;          /**< Queries written after the current one */
+    maxbase::Duration m_completed_time {0}; /**< Response time of the last completed query */
+    uint64_t          m_completed_shape = 0;
+
     inline bool is_opening_cursor() const
     {
         return m_opening_cursor;
@@ -476,6 +476,7 @@ typedef struct query_classifier
 typedef struct QC_CACHE_PROPERTIES
 {
     int64_t max_size;   /** The maximum size of the cache. */
+    bool    shared;     /** Whether the cache is shared by all threads. Only honoured by qc_setup(). */
 } QC_CACHE_PROPERTIES;
 
 /**
@@ -701,6 +702,18 @@ void qc_get_function_info(GWBUF* stmt, const QC_FUNCTION_INFO** infos, size_t* n
  */
 char* qc_get_canonical(GWBUF* stmt);
 
+/**
+ * Returns a hash of the canonical form of the statement. Statements that
+ * only differ in their literals have the same hash. If the statement has
+ * been classified using the classification cache, the hash calculated
+ * then is returned, otherwise it is calculated and stored in the buffer.
+ *
+ * @param stmt  A buffer containing a COM_QUERY or COM_STMT_PREPARE packet.
+ *
+ * @return The hash of the canonical statement.
+ */
+uint64_t qc_get_canonical_hash(GWBUF* stmt);
+
 /**
  * Returns the name of the created table.
  *
@@ -970,6 +983,13 @@ bool qc_get_cache_stats(QC_CACHE_STATS* stats);
  */
 json_t* qc_get_cache_stats_as_json();
 
+/**
+ * Get the statistics of each shard of the cache shared by all threads.
+ *
+ * @return An array, empty if the cache is not shared.
+ */
+json_t* qc_get_shared_cache_stats_as_json();
+
 /**
  * String represenation for the parse result.
  *
@@ -181,6 +181,17 @@ public:
         return m_route_info;
     }
 
+    /**
+     * @brief Set the current route info, for instance to one returned by an
+     *        earlier call to update_route_info().
+     *
+     * @param route_info  The route info.
+     */
+    void set_route_info(const RouteInfo& route_info)
+    {
+        m_route_info = route_info;
+    }
+
     void master_replaced()
     {
         // As the master has changed, we can reset the temporary table information
@@ -193,6 +204,11 @@ public:
         return m_large_query;
     }
 
+    bool have_tmp_tables() const
+    {
+        return m_have_tmp_tables;
+    }
+
     void set_large_query(bool large_query)
     {
         m_large_query = large_query;
@@ -304,11 +320,6 @@ private:
         m_load_data_sent = 0;
     }
 
-    bool have_tmp_tables() const
-    {
-        return m_have_tmp_tables;
-    }
-
     void set_have_tmp_tables(bool have_tmp_tables)
     {
         m_have_tmp_tables = have_tmp_tables;
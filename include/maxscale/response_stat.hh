@@ -33,7 +33,8 @@ public:
                  maxbase::Duration sync_duration = std::chrono::milliseconds(250));
 
     void              query_started();
-    void              query_ended();    // ok to call without a query_started
+    maxbase::Duration query_ended();    // ok to call without a query_started, returns 0 then
+    void              add_sample(maxbase::Duration duration);   // for queries timed by the caller
     bool              make_valid();     // make valid even if there are only filter_samples
     bool              is_valid() const;
     int               num_samples() const;
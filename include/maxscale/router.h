@@ -259,6 +259,8 @@ typedef enum router_capability
                                              *  users when the service is started */
     RCAP_TYPE_NO_AUTH        = 0x00040000,  /**< No `user` or `password` parameter required */
     RCAP_TYPE_RUNTIME_CONFIG = 0x00080000,  /**< Router supports runtime cofiguration */
+    RCAP_TYPE_SESSION_MIGRATION = 0x00100000,   /**< Idle router sessions hold no worker specific
+                                                 *  state and can be moved to another worker */
 } mxs_router_capability_t;
 
 typedef enum
@@ -98,6 +98,29 @@ public:
      */
     static bool remove_shared_fd(int fd);
 
+    /**
+     * Add a listening socket to the epoll instance of this worker. Unlike
+     * @c add_fd(), the socket is added in level-triggered mode so that a
+     * worker that accepts only a limited number of connections at a time
+     * will get the remaining ones on the next round. The owner of @c pData
+     * is set to this worker.
+     *
+     * @param fd     The listening socket.
+     * @param pData  The poll data associated with the socket.
+     *
+     * @return True, if the socket could be added, false otherwise.
+     */
+    bool add_listener_fd(int fd, MXB_POLL_DATA* pData);
+
+    /**
+     * Remove a listening socket added with @c add_listener_fd().
+     *
+     * @param fd  The listening socket.
+     *
+     * @return True on success, false on failure.
+     */
+    bool remove_listener_fd(int fd);
+
     /**
      * Returns the id of the routing worker
      *
@@ -124,6 +147,32 @@ public:
      */
     SessionsById& session_registry();
 
+    /**
+     * Register a session with this worker. Must be called by the worker.
+     *
+     * @param pSession  The session.
+     *
+     * @return True, if the session was added, false if it already was there.
+     */
+    bool register_session(MXS_SESSION* pSession);
+
+    /**
+     * Deregister a session from this worker. Must be called by the worker.
+     *
+     * @param id  The id of the session.
+     *
+     * @return True, if the session was removed, false if it was not found.
+     */
+    bool deregister_session(uint64_t id);
+
+    /**
+     * Return the number of sessions registered with this worker. May be
+     * called from any thread.
+     *
+     * @return The number of sessions.
+     */
+    int session_count() const;
+
     /**
      * Return the worker associated with the provided worker id.
      *
@@ -323,6 +372,11 @@ public:
     /**
      * Get next worker
      *
+     * The next worker in round-robin order is compared with the calling
+     * worker and the one with the lower load during the last second is
+     * returned. If the loads are close to each other, the one with fewer
+     * sessions is returned.
+     *
      * @return The worker where work should be assigned
      */
     static RoutingWorker* pick_worker();
@@ -489,15 +543,18 @@ private:
     class WatchdogNotifier;
     friend WatchdogNotifier;
 
-    const int    m_id;              /*< The id of the worker. */
-    SessionsById m_sessions;        /*< A mapping of session_id->MXS_SESSION. The map
+    const int      m_id;            /*< The id of the worker. */
+    SessionsById   m_sessions;      /*< A mapping of session_id->MXS_SESSION. The map
                                      *  should contain sessions exclusive to this
                                      *  worker and not e.g. listener sessions. For now,
                                      *  it's up to the protocol to decide whether a new
                                      *  session is added to the map. */
-    Zombies      m_zombies;         /*< DCBs to be deleted. */
-    LocalData    m_local_data;      /*< Data local to this worker */
-    DataDeleters m_data_deleters;   /*< Delete functions for the local data */
+    int            m_nSessions;     /*< The number of sessions in m_sessions. */
+    RoutingWorker* m_pMove_to;      /*< The worker to move sessions to at the end of the batch. */
+    int            m_nMove;         /*< The maximum number of sessions to move. */
+    Zombies        m_zombies;       /*< DCBs to be deleted. */
+    LocalData      m_local_data;    /*< Data local to this worker */
+    DataDeleters   m_data_deleters; /*< Delete functions for the local data */
 
     RoutingWorker();
     virtual ~RoutingWorker();
@@ -509,6 +566,10 @@ private:
     void epoll_tick();  // override
 
     void delete_zombies();
+    bool balance_workers(Worker::Call::action_t action);
+    bool maintain_persistent_pools(Worker::Call::action_t action);
+    void schedule_move(RoutingWorker* pTo, int nMax);
+    void move_sessions();
     void check_systemd_watchdog();
     void start_watchdog_workaround();
     void stop_watchdog_workaround();
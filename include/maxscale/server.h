@@ -38,7 +38,9 @@ MXS_BEGIN_DECLS
 extern const char CN_MONITORPW[];
 extern const char CN_MONITORUSER[];
 extern const char CN_PERSISTMAXTIME[];
+extern const char CN_PERSISTPINGTIME[];
 extern const char CN_PERSISTPOOLMAX[];
+extern const char CN_PERSISTPOOLMIN[];
 extern const char CN_PROXY_PROTOCOL[];
 
 /**
@@ -73,11 +75,25 @@ typedef struct
     int      n_current;     /**< Current connections */
     int      n_current_ops; /**< Current active operations */
     int      n_persistent;  /**< Current persistent pool */
-    uint64_t n_new_conn;    /**< Times the current pool was empty */
+    uint64_t n_new_conn;    /**< Times the pool had no connection for a session */
     uint64_t n_from_pool;   /**< Times when a connection was available from the pool */
+    uint64_t n_authenticated;   /**< Number of new connections that were authenticated */
+    uint64_t connect_time;      /**< Total time it took to connect and authenticate them, in microseconds */
     uint64_t packets;       /**< Number of packets routed to this server */
 } SERVER_STATS;
 
+/**
+ * The persistent connections to a server that a routing worker owns. The DCBs
+ * form a doubly linked list with the most recently pooled one first, so the
+ * oldest ones are at the tail.
+ */
+typedef struct server_pool
+{
+    DCB* head;  /**< The most recently pooled DCB */
+    DCB* tail;  /**< The least recently pooled DCB */
+    int  size;  /**< Number of DCBs in the pool */
+} SERVER_POOL;
+
 /**
  * The server version.
  */
@@ -137,6 +153,9 @@ typedef struct server
     char monpw[MAX_SERVER_MONPW_LEN];       /**< Monitor password, overrides monitor setting  */
     long persistpoolmax;                    /**< Maximum size of persistent connections pool */
     long persistmaxtime;                    /**< Maximum number of seconds connection can live */
+    long persistpoolmin;                    /**< Number of pooled connections per worker that are kept
+                                             * even if they are older than persistmaxtime */
+    long persistpingtime;                   /**< Seconds after which idle pooled connections are pinged */
     bool proxy_protocol;                    /**< Send proxy-protocol header to backends when connecting
                                              *   routing sessions. */
     SERVER_PARAM* parameters;               /**< Additional custom parameters which may affect routing
@@ -145,7 +164,7 @@ typedef struct server
     bool          is_active;        /**< Server is active and has not been "destroyed" */
     void*         auth_instance;    /**< Authenticator instance data */
     SSL_LISTENER* server_ssl;       /**< SSL data */
-    DCB**         persistent;       /**< List of unused persistent connections to the server */
+    SERVER_POOL*  persistent;       /**< Unused persistent connections to the server, per worker */
     uint8_t       charset;          /**< Server character set. Read from backend and sent to client. */
     // Statistics and events
     SERVER_STATS stats;         /**< The server statistics, e.g. number of connections */
@@ -47,6 +47,13 @@ public:
      */
     uint64_t get_position() const;
 
+    /**
+     * @brief Get the buffer containing the command
+     *
+     * @return The buffer
+     */
+    const mxs::Buffer& get_buffer() const;
+
     /**
      * @brief Creates a deep copy of the internal buffer
      *
@@ -19,6 +19,7 @@
 
 #include <maxscale/server.h>
 #include <maxbase/average.hh>
+#include <maxbase/histogram.hh>
 #include <maxbase/stopwatch.hh>
 
 namespace maxscale
@@ -44,6 +45,15 @@ public:
 
     CurrentStats current_stats() const;
 
+    /** Add the latency of a query */
+    void add_latency(maxbase::Duration latency);
+
+    /** The decaying histogram of the query latencies */
+    const maxbase::LatencyHistogram& latency() const
+    {
+        return m_latency;
+    }
+
     ServerStats& operator+=(const ServerStats& rhs);
 
     // These are exactly what they were in struct ServerStats, in readwritesplit.hh.
@@ -57,6 +67,7 @@ private:
     maxbase::CumulativeAverage m_ave_session_dur;
     maxbase::CumulativeAverage m_ave_active_dur;
     maxbase::CumulativeAverage m_num_ave_session_selects;
+    maxbase::LatencyHistogram  m_latency;
 };
 
 using SrvStatMap = std::unordered_map<SERVER*, ServerStats>;
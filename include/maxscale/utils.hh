@@ -634,6 +634,82 @@ static inline bool operator!=(const CRC32Checksum& lhs, const CRC32Checksum& rhs
     return !(lhs == rhs);
 }
 
+/**
+ * A 128-bit MurmurHash3 (x64 variant) checksum
+ *
+ * A fast non-cryptographic hash that can be used instead of SHA1 when the
+ * checksum only needs to detect accidental differences.
+ */
+class Murmur3Checksum : public Checksum
+{
+public:
+
+    typedef std::array<uint64_t, 2> Sum;
+
+    Murmur3Checksum()
+    {
+        reset();
+        m_sum.fill(0);
+    }
+
+    void update(GWBUF* buffer);
+
+    void finalize(GWBUF* buffer = NULL);
+
+    void reset()
+    {
+        m_h1 = 0;
+        m_h2 = 0;
+        m_length = 0;
+        m_tail_len = 0;
+    }
+
+    std::string hex() const
+    {
+        const uint8_t* start = reinterpret_cast<const uint8_t*>(&m_sum.front());
+        const uint8_t* end = start + sizeof(m_sum);
+        return mxs::to_hex(start, end);
+    }
+
+    bool eq(const Murmur3Checksum& rhs) const
+    {
+        return m_sum == rhs.m_sum;
+    }
+
+    /**
+     * Add bytes to the calculation
+     *
+     * @param pData Data to add
+     * @param len   Length of the data
+     */
+    void update(const uint8_t* pData, size_t len);
+
+private:
+    enum
+    {
+        BLOCK_SIZE = 16
+    };
+
+    void mix_block(const uint8_t* pBlock);
+
+    uint64_t m_h1;                      /**< Ongoing state, first half */
+    uint64_t m_h2;                      /**< Ongoing state, second half */
+    uint64_t m_length;                  /**< Number of bytes processed */
+    uint8_t  m_tail[BLOCK_SIZE];        /**< Bytes not yet forming a full block */
+    size_t   m_tail_len;                /**< Number of bytes in m_tail */
+    Sum      m_sum;                     /**< Final checksum */
+};
+
+static inline bool operator==(const Murmur3Checksum& lhs, const Murmur3Checksum& rhs)
+{
+    return lhs.eq(rhs);
+}
+
+static inline bool operator!=(const Murmur3Checksum& lhs, const Murmur3Checksum& rhs)
+{
+    return !(lhs == rhs);
+}
+
 /**
  * Read bytes into a 64-bit unsigned integer.
  *
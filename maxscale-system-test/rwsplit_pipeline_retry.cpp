@@ -0,0 +1,92 @@
+/**
+ * Pipelined queries with a retry
+ *
+ * A session command sent while a query is still executing on the master is
+ * classified when it arrives and queued until the reply to the query has been
+ * received. If the master fails meanwhile, the retried query must be routed
+ * as a query and the session command must still be routed to all servers.
+ */
+
+#include "testconnections.h"
+
+namespace
+{
+
+// Send two queries without waiting for the reply to the first one.
+void send_pipelined(TestConnections& test, MYSQL* conn, const char* zFirst, const char* zSecond)
+{
+    test.expect(mysql_send_query(conn, zFirst, strlen(zFirst)) == 0,
+                "Sending '%s' should work: %s", zFirst, mysql_error(conn));
+    test.expect(mysql_send_query(conn, zSecond, strlen(zSecond)) == 0,
+                "Sending '%s' should work: %s", zSecond, mysql_error(conn));
+}
+
+// Read the result of a query that returns one row with one value.
+void expect_value(TestConnections& test, MYSQL* conn, const char* zQuery, const char* zExpected)
+{
+    test.expect(mysql_read_query_result(conn) == 0, "'%s' should work: %s", zQuery, mysql_error(conn));
+
+    MYSQL_RES* res = mysql_store_result(conn);
+    test.expect(res != nullptr, "'%s' should return a resultset", zQuery);
+
+    if (res)
+    {
+        MYSQL_ROW row = mysql_fetch_row(res);
+        test.expect(mysql_num_fields(res) == 1, "'%s' should return one column", zQuery);
+        test.expect(row && row[0] && strcmp(row[0], zExpected) == 0,
+                    "'%s' should return '%s', not '%s'", zQuery, zExpected, row && row[0] ? row[0] : "NULL");
+        test.expect(mysql_fetch_row(res) == nullptr, "'%s' should return one row", zQuery);
+        mysql_free_result(res);
+    }
+}
+
+void expect_ok(TestConnections& test, MYSQL* conn, const char* zQuery)
+{
+    test.expect(mysql_read_query_result(conn) == 0, "'%s' should work: %s", zQuery, mysql_error(conn));
+    test.expect(mysql_field_count(conn) == 0, "'%s' should not return a resultset", zQuery);
+}
+}
+
+int main(int argc, char* argv[])
+{
+    TestConnections test(argc, argv);
+
+    test.tprintf("Pipeline a session command after a query");
+    MYSQL* conn = test.maxscales->open_rwsplit_connection();
+    send_pipelined(test, conn, "SELECT SLEEP(1) + 1", "SET @a = 1");
+    expect_value(test, conn, "SELECT SLEEP(1) + 1", "1");
+    expect_ok(test, conn, "SET @a = 1");
+    test.expect(execute_query_check_one(conn, "SELECT @a", "1") == 0, "@a should be 1");
+    mysql_close(conn);
+
+    test.tprintf("Pipeline a session command after a query that is retried");
+    conn = test.maxscales->open_rwsplit_connection();
+    test.try_query(conn, "SET @a = 0");
+
+    std::thread thr([&]() {
+                        sleep(2);
+                        test.tprintf("Block master");
+                        test.repl->block_node(0);
+                        test.maxscales->wait_for_monitor(2);
+                        test.tprintf("Unblock master");
+                        test.repl->unblock_node(0);
+                    });
+
+    test.set_timeout(60);
+    send_pipelined(test, conn, "SELECT SLEEP(5) + 2", "SET @a = 2");
+
+    // The query is retried once the master is back and returns the result of the first
+    // execution. Had it been routed to all servers, the result would be an OK packet.
+    expect_value(test, conn, "SELECT SLEEP(5) + 2", "2");
+    expect_ok(test, conn, "SET @a = 2");
+    test.expect(execute_query_check_one(conn, "SELECT @a", "2") == 0, "@a should be 2");
+    test.stop_timeout();
+
+    thr.join();
+    mysql_close(conn);
+
+    test.maxscales->wait_for_monitor();
+    test.check_maxscale_alive();
+
+    return test.global_result;
+}
@@ -0,0 +1,91 @@
+/**
+ * Check that sessions moved between workers keep working
+ *
+ * A few connections read large result sets to make the load of the workers
+ * uneven while the other connections execute short queries and transactions.
+ * MaxScale moves the idle sessions from the busiest worker to the least busy
+ * one every second. All queries must succeed and return correct results.
+ */
+
+#include "testconnections.h"
+#include <atomic>
+#include <thread>
+#include <vector>
+
+namespace
+{
+const int N_HEAVY = 8;
+const int N_LIGHT = 40;
+const int DURATION = 60;
+}
+
+int main(int argc, char* argv[])
+{
+    TestConnections test(argc, argv);
+
+    auto conn = test.maxscales->readconn_master();
+    test.expect(conn.connect(), "Connection should work: %s", conn.error());
+    test.expect(conn.query("CREATE OR REPLACE TABLE test.t1(id INT, thr INT)"), "CREATE should work: %s",
+                conn.error());
+
+    std::atomic<bool> running {true};
+    std::vector<std::thread> threads;
+
+    for (int i = 0; i < N_HEAVY; i++)
+    {
+        threads.emplace_back(
+            [&]() {
+                auto c = test.maxscales->readconn_master();
+                test.expect(c.connect(), "Connection should work: %s", c.error());
+
+                while (running && test.ok())
+                {
+                    test.expect(c.query("SELECT REPEAT('a', 1000) FROM seq_1_to_10000"),
+                                "Large SELECT should work: %s", c.error());
+                }
+            });
+    }
+
+    for (int i = 0; i < N_LIGHT; i++)
+    {
+        threads.emplace_back(
+            [&, i]() {
+                auto c = test.maxscales->readconn_master();
+                test.expect(c.connect(), "Connection should work: %s", c.error());
+                std::string thr = std::to_string(i);
+                int n = 0;
+
+                while (running && test.ok())
+                {
+                    // Session state that must survive the moving of the session
+                    test.expect(c.query("SET @a = " + std::to_string(n)), "SET should work: %s", c.error());
+                    test.expect(c.check("SELECT @a", std::to_string(n)), "@a should be %d", n);
+
+                    test.expect(c.query("BEGIN"), "BEGIN should work: %s", c.error());
+                    test.expect(c.query("INSERT INTO test.t1 VALUES (" + std::to_string(n) + ", " + thr + ")"),
+                                "INSERT should work: %s", c.error());
+                    test.expect(c.query("COMMIT"), "COMMIT should work: %s", c.error());
+
+                    ++n;
+                    test.expect(c.check("SELECT COUNT(*) FROM test.t1 WHERE thr = " + thr, std::to_string(n)),
+                                "Table should have %d rows for thread %s", n, thr.c_str());
+                    usleep(100000);
+                }
+            });
+    }
+
+    sleep(DURATION);
+    running = false;
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+
+    test.log_includes(0, "Moved [0-9]* sessions from worker");
+    test.check_maxscale_alive(0);
+
+    conn.query("DROP TABLE test.t1");
+
+    return test.global_result;
+}
@@ -0,0 +1,122 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxbase/ccdefs.hh>
+#include <array>
+#include <maxbase/stopwatch.hh>
+
+namespace maxbase
+{
+
+/**
+ * A decaying log-linear histogram of latencies.
+ *
+ * Each power of two of microseconds is split into four buckets, so the
+ * relative error of a percentile is at most 25% regardless of the magnitude
+ * of the latencies. The counts decay exponentially with the given half-life,
+ * which makes the percentiles follow the recent behaviour instead of the
+ * whole history. The decay is applied lazily, at most once per second.
+ */
+class LatencyHistogram
+{
+public:
+    enum
+    {
+        SUB_BUCKET_BITS = 2,
+        SUB_BUCKETS     = 1 << SUB_BUCKET_BITS,
+        N_BUCKETS       = 128   /*< Covers latencies up to ~2 hours. */
+    };
+
+    /**
+     * @param half_life  The time after which the weight of a sample is halved.
+     */
+    explicit LatencyHistogram(Duration half_life = std::chrono::seconds(10));
+
+    /**
+     * Add a sample.
+     *
+     * @param latency  The latency.
+     * @param now      The current time.
+     */
+    void add(Duration latency, TimePoint now = Clock::now());
+
+    /**
+     * The decayed number of samples.
+     *
+     * @param now  The current time.
+     *
+     * @return The number of samples, with the decay up until @c now applied.
+     */
+    double count(TimePoint now = Clock::now()) const;
+
+    /**
+     * Estimate a percentile. As the decay affects all buckets equally, the
+     * percentiles do not depend upon the time at which they are asked for.
+     *
+     * @param p  The percentile, between 0 and 100.
+     *
+     * @return The estimated latency, or 0 if there are no samples.
+     */
+    Duration percentile(double p) const;
+
+    /**
+     * Apply the decay up until a point in time.
+     *
+     * @param now  The current time.
+     */
+    void decay(TimePoint now);
+
+    /**
+     * Remove all samples.
+     */
+    void reset();
+
+    /**
+     * @return The (non-decayed) count of a bucket.
+     */
+    double bucket_count(int i) const
+    {
+        return m_buckets[i];
+    }
+
+    /**
+     * @return The smallest latency, in microseconds, that goes to a bucket.
+     */
+    static uint64_t bucket_lower_us(int i);
+
+    /**
+     * @return The smallest latency, in microseconds, that goes to the next bucket.
+     */
+    static uint64_t bucket_upper_us(int i);
+
+    /**
+     * @return The bucket of a latency.
+     */
+    static int bucket_of(uint64_t us);
+
+    /**
+     * Add the samples of another histogram. The samples of the histogram
+     * that was updated less recently are decayed first.
+     */
+    LatencyHistogram& operator+=(const LatencyHistogram& rhs);
+
+private:
+    double decay_factor(Duration elapsed) const;
+
+    Duration                      m_half_life;
+    TimePoint                     m_last_decay;
+    double                        m_total;
+    std::array<double, N_BUCKETS> m_buckets;
+};
+}
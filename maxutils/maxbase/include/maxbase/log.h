@@ -71,6 +71,18 @@ typedef struct MXB_LOG_THROTTLING
     size_t suppress_ms; // If exceeded, suppress such messages for this many ms.
 } MXB_LOG_THROTTLING;
 
+typedef enum mxb_log_overflow_t
+{
+    MXB_LOG_OVERFLOW_BLOCK, // Wait until the message can be written
+    MXB_LOG_OVERFLOW_DROP,  // Drop the message
+} mxb_log_overflow_t;
+
+typedef struct MXB_LOG_STATS
+{
+    uint64_t dropped;   // Messages dropped because the log could not keep up
+    uint64_t blocked;   // Times a thread had to wait for the log
+} MXB_LOG_STATS;
+
 /**
  * Prototype for function providing additional information.
  *
@@ -231,6 +243,27 @@ void mxb_log_set_throttling(const MXB_LOG_THROTTLING* throttling);
  */
 void mxb_log_get_throttling(MXB_LOG_THROTTLING* throttling);
 
+/**
+ * Set what is done to a message if the log cannot keep up.
+ *
+ * @param overflow The overflow policy.
+ */
+void mxb_log_set_overflow(mxb_log_overflow_t overflow);
+
+/**
+ * Get what is done to a message if the log cannot keep up.
+ *
+ * @return The overflow policy.
+ */
+mxb_log_overflow_t mxb_log_get_overflow();
+
+/**
+ * Get the statistics of the log.
+ *
+ * @param stats The statistics.
+ */
+void mxb_log_get_stats(MXB_LOG_STATS* stats);
+
 /**
  * Redirect  stdout to the log file
  *
@@ -14,10 +14,15 @@
 
 #include <maxbase/ccdefs.hh>
 
+#include <atomic>
+#include <condition_variable>
 #include <string>
 #include <mutex>
 #include <memory>
+#include <thread>
+#include <vector>
 
+#include <sys/uio.h>
 #include <unistd.h>
 
 namespace maxbase
@@ -30,6 +35,21 @@ public:
     Logger(const Logger&) = delete;
     Logger& operator=(const Logger&) = delete;
 
+    /**
+     * What to do with a message when the log cannot keep up.
+     */
+    enum class Overflow
+    {
+        BLOCK,  /**< Wait until the message can be written. */
+        DROP    /**< Drop the message and count it. */
+    };
+
+    struct Stats
+    {
+        uint64_t dropped = 0;   /**< Messages dropped since the log was opened. */
+        uint64_t blocked = 0;   /**< Times a thread had to wait for the log. */
+    };
+
     virtual ~Logger()
     {
     }
@@ -62,6 +82,32 @@ public:
      */
     virtual bool rotate() = 0;
 
+    /**
+     * Write all buffered messages to the log. When the function returns, all
+     * messages written by the calling thread have been written to the log.
+     * The default implementation does nothing.
+     */
+    virtual void flush()
+    {
+    }
+
+    /**
+     * Set the overflow policy. The default implementation does nothing.
+     *
+     * @param overflow  What to do when the log cannot keep up.
+     */
+    virtual void set_overflow(Overflow overflow)
+    {
+    }
+
+    /**
+     * @return The statistics of the log. The default implementation returns zeroes.
+     */
+    virtual Stats stats() const
+    {
+        return Stats();
+    }
+
     /**
      * Get the name of the log file
      *
@@ -106,29 +152,66 @@ public:
     /**
      * Write a message to the log
      *
+     * The message is copied to a buffer of the calling thread and written
+     * to the file by a separate writer thread, together with the messages
+     * of the other threads. The messages of one thread are written in the
+     * order they were logged in.
+     *
+     * If the buffer is full, the message is dropped or the calling thread
+     * writes out the buffered messages itself, depending on the overflow policy.
+     *
      * @param msg Message to write
      * @param len Length of message
      *
-     * @return True on success
+     * @return True on success, false if the message was dropped or could not be written
      */
     bool write(const char* msg, int len);
 
     /**
      * Rotate the logfile by reopening it
      *
+     * The buffered messages are written to the old file before it is closed.
+     *
      * @return True if the log was rotated. False if the opening of the new file
      *         descriptor failed in which case the old file descriptor will be used.
      */
     bool rotate();
 
+    void  flush();
+    void  set_overflow(Overflow overflow);
+    Stats stats() const;
+
 private:
-    int        m_fd;
-    std::mutex m_lock;
+    class Buffer;
+    typedef std::vector<std::shared_ptr<Buffer>> Buffers;
+
+    int                   m_fd;
+    std::mutex            m_lock;           /**< Protects m_fd and the reading of the buffers. */
+    const uint64_t        m_id;             /**< Identifies the logger for the thread local buffers. */
+    std::mutex            m_buffers_lock;   /**< Protects m_buffers. */
+    Buffers               m_buffers;        /**< The buffers of all threads that have logged. */
+    std::atomic<Overflow> m_overflow;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_blocked;
+    uint64_t              m_reported_dropped;   /**< Dropped messages that have been reported. */
+
+    std::thread             m_writer;
+    std::mutex              m_writer_lock;
+    std::condition_variable m_writer_cond;
+    std::atomic<bool>       m_writer_idle;
+    bool                    m_writer_stop;
 
     FileLogger(int fd, const std::string& filename);
-    bool write_header();
-    bool write_footer(const char* suffix);
-    void close(const char* msg);
+    bool    write_header();
+    bool    write_footer(const char* suffix);
+    void    close(const char* msg);
+    bool    write_fd(const char* msg, int len);
+    bool    writev_fd(struct iovec* iov, int n_iov, size_t len);
+    Buffer* local_buffer();
+    void    flush_buffers();
+    void    report_dropped();
+    void    wake_writer();
+    void    run_writer();
 };
 
 class StdoutLogger : public Logger
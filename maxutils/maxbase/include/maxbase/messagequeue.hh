@@ -13,6 +13,8 @@
 #pragma once
 
 #include <maxbase/ccdefs.hh>
+#include <atomic>
+#include <ctime>
 #include <maxbase/poll.hh>
 
 namespace maxbase
@@ -105,7 +107,10 @@ public:
 
 /**
  * The class @c MessageQueue provides a cross thread message queue implemented
- * on top of a pipe.
+ * as a bounded lock-free multi-producer single-consumer ring buffer. The
+ * consumer is woken up using an eventfd, which is written to only when the
+ * consumer is not already known to have been signalled. A burst of posted
+ * messages thus costs a single system call.
  */
 class MessageQueue : private mxb::PollData
 {
@@ -116,24 +121,40 @@ public:
     typedef MessageQueueHandler Handler;
     typedef MessageQueueMessage Message;
 
+    enum
+    {
+        // At least as many messages as fitted in the 1MB pipe that was used earlier.
+        DEFAULT_CAPACITY = 65536
+    };
+
+    struct Stats
+    {
+        uint64_t n_posted = 0;  /*< Number of posted messages */
+        uint64_t n_full = 0;    /*< Number of posts that found the queue full */
+        uint64_t n_dropped = 0; /*< Number of messages dropped because the queue stayed full */
+        uint64_t n_signals = 0; /*< Number of times the consumer was signalled */
+    };
+
     /**
      * Creates a @c MessageQueue with the provided handler.
      *
      * @param pHandler  The handler that will receive the messages sent over the
      *                  message queue. Note that the handler *must* remain valid
      *                  for the lifetime of the @c MessageQueue.
+     * @param capacity  The maximum number of messages that can be queued. Rounded
+     *                  up to the nearest power of two.
      *
      * @return A pointer to a new @c MessageQueue or NULL if an error occurred.
      *
      * @attention Before the message queue can be used, it must be added to
      *            a worker.
      */
-    static MessageQueue* create(Handler* pHandler);
+    static MessageQueue* create(Handler* pHandler, size_t capacity = DEFAULT_CAPACITY);
 
     /**
      * Destructor
      *
-     * Removes itself If still added to a worker and closes the pipe.
+     * Removes itself If still added to a worker and closes the eventfd.
      */
     ~MessageQueue();
 
@@ -146,13 +167,25 @@ public:
      *
      * @return True if the message could be posted, false otherwise. Note that
      *         a return value of true only means that the message could successfully
-     *         be posted, not that it has reached the handler.
+     *         be posted, not that it has reached the handler. If the queue stays
+     *         full, the message is dropped and only counted; the number of dropped
+     *         messages is logged later by the worker of the queue.
      *
      * @attention Note that the message queue must have been added to a worker
      *            before a message can be posted.
+     *
+     * @attention This function is signal safe.
      */
     bool post(const Message& message) const;
 
+    /**
+     * Returns the statistics of the queue. May be called from any thread, but
+     * the values of different fields are not mutually consistent.
+     *
+     * @return The statistics.
+     */
+    Stats get_stats() const;
+
     /**
      * Adds the message queue to a particular worker.
      *
@@ -181,7 +214,19 @@ private:
     static void finish();
 
 private:
-    MessageQueue(Handler* pHandler, int read_fd, int write_fd);
+    struct Cell
+    {
+        std::atomic<uint64_t> seq;  // Equal to the position when free, to position + 1 when full.
+        Message               message;
+    };
+
+    MessageQueue(Handler* pHandler, int event_fd, Cell* pCells, size_t capacity);
+
+    bool try_push(const Message& message) const;
+    bool try_pop(Message* pMessage);
+    bool is_ready() const;
+    void signal() const;
+    void log_dropped();
 
     uint32_t handle_poll_events(Worker* pWorker, uint32_t events);
 
@@ -189,8 +234,21 @@ private:
 
 private:
     Handler& m_handler;
-    int      m_read_fd;
-    int      m_write_fd;
+    int      m_event_fd;
     Worker*  m_pWorker;
+    Cell*    m_pCells;
+    size_t   m_mask;
+    uint64_t m_head;    // Only accessed by the consumer.
+    uint64_t m_nLogged; // Dropped messages already logged, only accessed by the consumer.
+    time_t   m_next_log;
+
+    // The producer side is kept apart from the consumer side, so that the
+    // producers do not invalidate the cache line of the consumer on every post.
+    char                          m_pad[64];
+    mutable std::atomic<uint64_t> m_tail;
+    mutable std::atomic<bool>     m_signalled;
+    mutable std::atomic<uint64_t> m_nFull;
+    mutable std::atomic<uint64_t> m_nDropped;
+    mutable std::atomic<uint64_t> m_nSignals;
 };
 }
@@ -363,6 +363,18 @@ public:
         return m_statistics;
     }
 
+    /**
+     * Returns the statistics of the message queue of this worker.
+     *
+     * @return The message queue statistics.
+     *
+     * @attentions The statistics may change at any time.
+     */
+    MessageQueue::Stats message_queue_statistics() const
+    {
+        return m_pQueue ? m_pQueue->get_stats() : MessageQueue::Stats();
+    }
+
     /**
      * Return the count of descriptors.
      *
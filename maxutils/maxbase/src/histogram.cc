@@ -0,0 +1,186 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxbase/histogram.hh>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+
+// How often the decay is applied when samples are added.
+const maxbase::Duration DECAY_INTERVAL = std::chrono::seconds(1);
+
+// Below this, whatever is left of the samples is dropped.
+const double MIN_TOTAL = 1e-3;
+}
+
+namespace maxbase
+{
+
+LatencyHistogram::LatencyHistogram(Duration half_life)
+    : m_half_life(half_life)
+    , m_last_decay()
+    , m_total(0)
+{
+    m_buckets.fill(0);
+}
+
+void LatencyHistogram::add(Duration latency, TimePoint now)
+{
+    if (now - m_last_decay >= DECAY_INTERVAL)
+    {
+        decay(now);
+    }
+
+    auto us = std::chrono::duration_cast<std::chrono::microseconds>(latency).count();
+
+    m_buckets[bucket_of(us > 0 ? us : 0)] += 1;
+    m_total += 1;
+}
+
+double LatencyHistogram::count(TimePoint now) const
+{
+    return now > m_last_decay ? m_total * decay_factor(now - m_last_decay) : m_total;
+}
+
+Duration LatencyHistogram::percentile(double p) const
+{
+    Duration rv(0);
+
+    if (m_total > 0)
+    {
+        double target = m_total * std::min(std::max(p, 0.0), 100.0) / 100;
+        double sum = 0;
+        int last = 0;
+
+        for (int i = 0; i < N_BUCKETS; ++i)
+        {
+            double n = m_buckets[i];
+
+            if (n > 0)
+            {
+                last = i;
+
+                if (sum + n >= target)
+                {
+                    break;
+                }
+
+                sum += n;
+            }
+        }
+
+        // Interpolate linearly within the bucket.
+        double n = m_buckets[last];
+        double fraction = n > 0 ? std::min((target - sum) / n, 1.0) : 1.0;
+        double lower = bucket_lower_us(last);
+        double upper = bucket_upper_us(last);
+
+        rv = std::chrono::microseconds(static_cast<int64_t>(lower + (upper - lower) * fraction));
+    }
+
+    return rv;
+}
+
+void LatencyHistogram::decay(TimePoint now)
+{
+    if (now > m_last_decay)
+    {
+        double factor = decay_factor(now - m_last_decay);
+
+        if (m_total * factor < MIN_TOTAL)
+        {
+            m_buckets.fill(0);
+            m_total = 0;
+        }
+        else
+        {
+            for (auto& n : m_buckets)
+            {
+                n *= factor;
+            }
+
+            m_total *= factor;
+        }
+
+        m_last_decay = now;
+    }
+}
+
+void LatencyHistogram::reset()
+{
+    m_buckets.fill(0);
+    m_total = 0;
+}
+
+// static
+uint64_t LatencyHistogram::bucket_lower_us(int i)
+{
+    uint64_t rv = i;
+
+    if (i >= SUB_BUCKETS)
+    {
+        int exponent = i / SUB_BUCKETS + SUB_BUCKET_BITS - 1;
+        uint64_t sub = i % SUB_BUCKETS;
+
+        rv = (SUB_BUCKETS + sub) << (exponent - SUB_BUCKET_BITS);
+    }
+
+    return rv;
+}
+
+// static
+uint64_t LatencyHistogram::bucket_upper_us(int i)
+{
+    return bucket_lower_us(i + 1);
+}
+
+// static
+int LatencyHistogram::bucket_of(uint64_t us)
+{
+    int rv = us;
+
+    if (us >= SUB_BUCKETS)
+    {
+        int exponent = 63 - __builtin_clzll(us);
+        int sub = (us >> (exponent - SUB_BUCKET_BITS)) & (SUB_BUCKETS - 1);
+
+        rv = std::min((exponent - SUB_BUCKET_BITS + 1) * SUB_BUCKETS + sub, (int)N_BUCKETS - 1);
+    }
+
+    return rv;
+}
+
+LatencyHistogram& LatencyHistogram::operator+=(const LatencyHistogram& rhs)
+{
+    TimePoint now = std::max(m_last_decay, rhs.m_last_decay);
+    decay(now);
+
+    double factor = now > rhs.m_last_decay ? decay_factor(now - rhs.m_last_decay) : 1.0;
+
+    for (int i = 0; i < N_BUCKETS; ++i)
+    {
+        m_buckets[i] += rhs.m_buckets[i] * factor;
+    }
+
+    m_total += rhs.m_total * factor;
+
+    return *this;
+}
+
+double LatencyHistogram::decay_factor(Duration elapsed) const
+{
+    return std::exp2(-elapsed.secs() / m_half_life.secs());
+}
+}
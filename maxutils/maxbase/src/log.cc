@@ -388,6 +388,7 @@ struct this_unit
     bool                             redirect_stdout;
     bool                             session_trace;
     MXB_LOG_THROTTLING               throttling;        // Can change during the lifetime of log_manager.
+    mxb_log_overflow_t               overflow;          // Can change during the lifetime of log_manager.
     std::unique_ptr<mxb::Logger>     sLogger;
     std::unique_ptr<MessageRegistry> sMessage_registry;
     size_t                           (* context_provider)(char* buffer, size_t len);
@@ -401,6 +402,7 @@ struct this_unit
     false,                      // redirect_stdout
     false,                      // session_trace
     DEFAULT_LOG_THROTTLING,     // throttling
+    MXB_LOG_OVERFLOW_BLOCK,     // overflow
 };
 
 class MessageRegistry
@@ -514,6 +516,7 @@ bool mxb_log_init(const char* ident,
 
     if (this_unit.sLogger && this_unit.sMessage_registry)
     {
+        mxb_log_set_overflow(this_unit.overflow);
         this_unit.context_provider = context_provider;
         this_unit.in_memory_log = in_memory_log;
 
@@ -614,6 +617,29 @@ void mxb_log_get_throttling(MXB_LOG_THROTTLING* throttling)
     *throttling = this_unit.throttling;
 }
 
+void mxb_log_set_overflow(mxb_log_overflow_t overflow)
+{
+    this_unit.overflow = overflow;
+
+    if (this_unit.sLogger)
+    {
+        this_unit.sLogger->set_overflow(overflow == MXB_LOG_OVERFLOW_DROP ?
+                                        mxb::Logger::Overflow::DROP : mxb::Logger::Overflow::BLOCK);
+    }
+}
+
+mxb_log_overflow_t mxb_log_get_overflow()
+{
+    return this_unit.overflow;
+}
+
+void mxb_log_get_stats(MXB_LOG_STATS* stats)
+{
+    mxb::Logger::Stats s = this_unit.sLogger->stats();
+    stats->dropped = s.dropped;
+    stats->blocked = s.blocked;
+}
+
 void mxs_log_redirect_stdout(bool redirect)
 {
     this_unit.redirect_stdout = redirect;
@@ -897,6 +923,13 @@ int mxb_log_message(int priority,
                 if (mxb_log_is_priority_enabled(level))
                 {
                     err = this_unit.sLogger->write(msg.c_str(), msg.length()) ? 0 : -1;
+
+                    if (level <= LOG_ERR)
+                    {
+                        // Errors are written out immediately, so that they are in the
+                        // log even if the process crashes right afterwards.
+                        this_unit.sLogger->flush();
+                    }
                 }
                 else
                 {
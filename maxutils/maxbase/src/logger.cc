@@ -15,8 +15,10 @@
 
 #include <syslog.h>
 #include <fcntl.h>
+#include <limits.h>
 #include <unistd.h>
 
+#include <algorithm>
 #include <cassert>
 #include <chrono>
 #include <cstring>
@@ -89,11 +91,109 @@ std::string get_ident()
 
     return this_unit.ident;
 }
+
+std::atomic<uint64_t> next_logger_id {1};
 }
 
 namespace maxbase
 {
 
+/**
+ * A single producer, single consumer ring buffer of log messages. The thread
+ * that owns the buffer appends messages to it without locking and the messages
+ * are read by whoever holds the lock of the logger.
+ */
+class FileLogger::Buffer
+{
+public:
+    Buffer(const Buffer&) = delete;
+    Buffer& operator=(const Buffer&) = delete;
+
+    static const size_t SIZE = 64 * 1024;
+
+    Buffer()
+    {
+    }
+
+    /**
+     * Append a message. Only called by the owning thread.
+     *
+     * @return True, if there was room for the message.
+     */
+    bool push(const char* msg, size_t len)
+    {
+        uint64_t head = m_head.load(std::memory_order_relaxed);
+        uint64_t tail = m_tail.load(std::memory_order_acquire);
+        bool rval = SIZE - (head - tail) >= len;
+
+        if (rval)
+        {
+            size_t offset = head % SIZE;
+            size_t n = std::min(len, SIZE - offset);
+
+            memcpy(m_data + offset, msg, n);
+            memcpy(m_data, msg + n, len - n);
+
+            m_head.store(head + len, std::memory_order_seq_cst);
+        }
+
+        return rval;
+    }
+
+    /**
+     * Get the buffered data. Only called with the lock of the logger held.
+     *
+     * @param iov  Array of at least two elements where the data is stored.
+     *
+     * @return The number of elements used, 0 if the buffer is empty.
+     */
+    int peek(struct iovec* iov) const
+    {
+        uint64_t head = m_head.load(std::memory_order_acquire);
+        uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        size_t len = head - tail;
+        size_t offset = tail % SIZE;
+        size_t n = std::min(len, SIZE - offset);
+        int n_iov = 0;
+
+        if (n > 0)
+        {
+            iov[n_iov].iov_base = const_cast<char*>(m_data + offset);
+            iov[n_iov].iov_len = n;
+            ++n_iov;
+        }
+
+        if (len > n)
+        {
+            iov[n_iov].iov_base = const_cast<char*>(m_data);
+            iov[n_iov].iov_len = len - n;
+            ++n_iov;
+        }
+
+        return n_iov;
+    }
+
+    /**
+     * Release data that has been written. Only called with the lock of the logger held.
+     */
+    void consume(size_t len)
+    {
+        m_tail.store(m_tail.load(std::memory_order_relaxed) + len, std::memory_order_release);
+    }
+
+    bool empty() const
+    {
+        return m_head.load(std::memory_order_seq_cst) == m_tail.load(std::memory_order_relaxed);
+    }
+
+    std::atomic<bool> orphaned {false};     /**< Set when the owning thread exits. */
+
+private:
+    std::atomic<uint64_t> m_head {0};       /**< Total bytes written, updated by the owner. */
+    std::atomic<uint64_t> m_tail {0};       /**< Total bytes read, updated by the reader. */
+    char                  m_data[SIZE];
+};
+
 //
 // Public methods
 //
@@ -124,6 +224,16 @@ std::unique_ptr<Logger> FileLogger::create(const std::string& filename)
         if (logger)
         {
             logger->write_header();
+
+            try
+            {
+                logger->m_writer = std::thread(&FileLogger::run_writer, logger.get());
+            }
+            catch (const std::system_error& x)
+            {
+                // Without the writer thread, the messages are written synchronously.
+                LOG_ERROR("Failed to start the log writer thread: %s\n", x.what());
+            }
         }
         else
         {
@@ -136,10 +246,22 @@ std::unique_ptr<Logger> FileLogger::create(const std::string& filename)
 
 FileLogger::~FileLogger()
 {
+    if (m_writer.joinable())
+    {
+        std::unique_lock<std::mutex> guard(m_writer_lock);
+        m_writer_stop = true;
+        m_writer_cond.notify_one();
+        guard.unlock();
+
+        m_writer.join();
+    }
+
     std::lock_guard<std::mutex> guard(m_lock);
     // As mxb_assert() logs to the log-file, it cannot be used here.
     assert(m_fd != -1);
 
+    flush_buffers();
+
     std::string suffix = get_ident();
     suffix += " is shut down.";
 
@@ -149,31 +271,38 @@ FileLogger::~FileLogger()
 bool FileLogger::write(const char* msg, int len)
 {
     bool rval = true;
-    std::lock_guard<std::mutex> guard(m_lock);
 
-    while (len > 0)
+    if (!m_writer.joinable() || len > (int)Buffer::SIZE)
     {
-        int rc;
-        do
+        // Either there is no writer or the message can never fit into a buffer. The
+        // buffered messages are written first so that the order is preserved.
+        std::lock_guard<std::mutex> guard(m_lock);
+        flush_buffers();
+        rval = write_fd(msg, len);
+    }
+    else
+    {
+        Buffer* pBuffer = local_buffer();
+
+        if (pBuffer->push(msg, len))
         {
-            rc = ::write(m_fd, msg, len);
+            wake_writer();
         }
-        while (rc == -1 && errno == EINTR);
-
-        if (rc == -1)
+        else if (m_overflow.load(std::memory_order_relaxed) == Overflow::DROP)
         {
-            if (should_log_error())     // Coarse error suppression
-            {
-                LOG_ERROR("Failed to write to log: %d, %s\n", errno, mxb_strerror(errno));
-            }
-
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
             rval = false;
-            break;
         }
+        else
+        {
+            // The writer cannot keep up, so this thread writes out the buffers itself.
+            m_blocked.fetch_add(1, std::memory_order_relaxed);
 
-        // If write only writes a part of the message, retry again
-        len -= rc;
-        msg += rc;
+            std::lock_guard<std::mutex> guard(m_lock);
+            flush_buffers();
+            rval = pBuffer->push(msg, len);
+            assert(rval);
+        }
     }
 
     return rval;
@@ -186,6 +315,7 @@ bool FileLogger::rotate()
 
     if (fd != -1)
     {
+        flush_buffers();
         close("File closed due to log rotation.");
         m_fd = fd;
     }
@@ -193,6 +323,25 @@ bool FileLogger::rotate()
     return fd != -1;
 }
 
+void FileLogger::flush()
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    flush_buffers();
+}
+
+void FileLogger::set_overflow(Overflow overflow)
+{
+    m_overflow.store(overflow, std::memory_order_relaxed);
+}
+
+Logger::Stats FileLogger::stats() const
+{
+    Stats stats;
+    stats.dropped = m_dropped.load(std::memory_order_relaxed);
+    stats.blocked = m_blocked.load(std::memory_order_relaxed);
+    return stats;
+}
+
 //
 // Private methods
 //
@@ -200,6 +349,13 @@ bool FileLogger::rotate()
 FileLogger::FileLogger(int fd, const std::string& filename)
     : Logger(filename)
     , m_fd(fd)
+    , m_id(next_logger_id.fetch_add(1, std::memory_order_relaxed))
+    , m_overflow(Overflow::BLOCK)
+    , m_dropped(0)
+    , m_blocked(0)
+    , m_reported_dropped(0)
+    , m_writer_idle(false)
+    , m_writer_stop(false)
 {
 }
 
@@ -210,6 +366,230 @@ void FileLogger::close(const char* msg)
     m_fd = -1;
 }
 
+bool FileLogger::write_fd(const char* msg, int len)
+{
+    struct iovec iov;
+    iov.iov_base = const_cast<char*>(msg);
+    iov.iov_len = len;
+
+    return writev_fd(&iov, 1, len);
+}
+
+bool FileLogger::writev_fd(struct iovec* iov, int n_iov, size_t len)
+{
+    bool rval = true;
+
+    while (len > 0)
+    {
+        ssize_t rc;
+        do
+        {
+            rc = ::writev(m_fd, iov, n_iov);
+        }
+        while (rc == -1 && errno == EINTR);
+
+        if (rc == -1)
+        {
+            if (should_log_error())     // Coarse error suppression
+            {
+                LOG_ERROR("Failed to write to log: %d, %s\n", errno, mxb_strerror(errno));
+            }
+
+            rval = false;
+            break;
+        }
+
+        // If writev only writes a part of the data, retry with the rest
+        len -= rc;
+
+        while (n_iov > 0 && (size_t)rc >= iov->iov_len)
+        {
+            rc -= iov->iov_len;
+            ++iov;
+            --n_iov;
+        }
+
+        if (n_iov > 0)
+        {
+            iov->iov_base = (char*)iov->iov_base + rc;
+            iov->iov_len -= rc;
+        }
+    }
+
+    return rval;
+}
+
+FileLogger::Buffer* FileLogger::local_buffer()
+{
+    struct Local
+    {
+        ~Local()
+        {
+            if (sBuffer)
+            {
+                sBuffer->orphaned.store(true, std::memory_order_release);
+            }
+        }
+
+        uint64_t                logger_id = 0;
+        std::shared_ptr<Buffer> sBuffer;
+    };
+
+    // A thread has a buffer only in the latest logger it has logged to. When the
+    // thread exits, the logger writes out what is left in the buffer and frees it.
+    static thread_local Local local;
+
+    if (local.logger_id != m_id)
+    {
+        if (local.sBuffer)
+        {
+            local.sBuffer->orphaned.store(true, std::memory_order_release);
+        }
+
+        local.sBuffer = std::make_shared<Buffer>();
+        local.logger_id = m_id;
+
+        std::lock_guard<std::mutex> guard(m_buffers_lock);
+        m_buffers.push_back(local.sBuffer);
+    }
+
+    return local.sBuffer.get();
+}
+
+// Must be called with m_lock held.
+void FileLogger::flush_buffers()
+{
+    const int MAX_BUFFERS = IOV_MAX / 2;    // A buffer needs at most two iovecs.
+    struct iovec iov[MAX_BUFFERS * 2];
+    std::pair<Buffer*, size_t> pending[MAX_BUFFERS];
+    size_t i = 0;
+
+    report_dropped();
+
+    // The buffers are only removed from m_buffers with m_lock held, so the
+    // pointers stay valid while m_buffers_lock is released for the write.
+    std::unique_lock<std::mutex> guard(m_buffers_lock);
+
+    while (i < m_buffers.size())
+    {
+        int n_iov = 0;
+        int n_pending = 0;
+        size_t total = 0;
+
+        for (; i < m_buffers.size() && n_pending < MAX_BUFFERS; ++i)
+        {
+            Buffer* pBuffer = m_buffers[i].get();
+            int n = pBuffer->peek(iov + n_iov);
+
+            if (n > 0)
+            {
+                size_t len = iov[n_iov].iov_len + (n > 1 ? iov[n_iov + 1].iov_len : 0);
+                pending[n_pending++] = std::make_pair(pBuffer, len);
+                n_iov += n;
+                total += len;
+            }
+        }
+
+        guard.unlock();
+
+        if (n_iov > 0)
+        {
+            writev_fd(iov, n_iov, total);
+        }
+
+        // The data is consumed even if the write failed, as there is nothing
+        // better to do with it.
+        for (int j = 0; j < n_pending; ++j)
+        {
+            pending[j].first->consume(pending[j].second);
+        }
+
+        guard.lock();
+    }
+
+    // Free the buffers of the threads that have exited.
+    m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(),
+                                   [](const std::shared_ptr<Buffer>& sBuffer) {
+                                       return sBuffer->orphaned.load(std::memory_order_acquire)
+                                              && sBuffer->empty();
+                                   }),
+                    m_buffers.end());
+}
+
+// Must be called with m_lock held.
+void FileLogger::report_dropped()
+{
+    uint64_t dropped = m_dropped.load(std::memory_order_relaxed);
+
+    if (dropped != m_reported_dropped)
+    {
+        time_t t = time(NULL);
+        struct tm tm;
+        localtime_r(&t, &tm);
+
+        char msg[128];
+        int len = snprintf(msg, sizeof(msg),
+                           "%04d-%02d-%02d %02d:%02d:%02d   warning: "
+                           "%lu log messages were dropped because the log could not keep up.\n",
+                           tm.tm_year + 1900, tm.tm_mon + 1, tm.tm_mday, tm.tm_hour, tm.tm_min, tm.tm_sec,
+                           dropped - m_reported_dropped);
+        write_fd(msg, len);
+        m_reported_dropped = dropped;
+    }
+}
+
+void FileLogger::wake_writer()
+{
+    // The writer marks itself idle before it checks the buffers one last time,
+    // so either it sees the message or the message sees that it is idle.
+    if (m_writer_idle.load(std::memory_order_seq_cst))
+    {
+        std::lock_guard<std::mutex> guard(m_writer_lock);
+        m_writer_cond.notify_one();
+    }
+}
+
+void FileLogger::run_writer()
+{
+    std::unique_lock<std::mutex> guard(m_writer_lock);
+
+    while (!m_writer_stop)
+    {
+        m_writer_idle.store(true, std::memory_order_seq_cst);
+
+        bool empty = true;
+        {
+            std::lock_guard<std::mutex> buffers_guard(m_buffers_lock);
+
+            for (const auto& sBuffer : m_buffers)
+            {
+                if (!sBuffer->empty())
+                {
+                    empty = false;
+                    break;
+                }
+            }
+        }
+
+        if (empty)
+        {
+            // The timeout is only a safety net, as the threads that log wake up the writer.
+            m_writer_cond.wait_for(guard, std::chrono::seconds(1));
+        }
+
+        m_writer_idle.store(false, std::memory_order_relaxed);
+        guard.unlock();
+
+        // While the messages are being written, more messages accumulate to the
+        // buffers and are written with one call the next time around.
+        std::unique_lock<std::mutex> lock(m_lock);
+        flush_buffers();
+        lock.unlock();
+
+        guard.lock();
+    }
+}
+
 // Nearly identical to the one in log_manager.cc
 bool FileLogger::write_header()
 {
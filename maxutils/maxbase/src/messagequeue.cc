@@ -13,10 +13,11 @@
 
 #include <maxbase/messagequeue.hh>
 #include <errno.h>
-#include <fcntl.h>
+#include <sched.h>
 #include <string.h>
+#include <time.h>
 #include <unistd.h>
-#include <fstream>
+#include <sys/eventfd.h>
 #include <maxbase/assert.h>
 #include <maxbase/log.h>
 #include <maxbase/string.h>
@@ -28,50 +29,62 @@ namespace
 static struct
 {
     bool initialized;
-    int  pipe_max_size;
 } this_unit =
 {
     false
 };
 
-int get_pipe_max_size()
+size_t round_up_to_power_of_two(size_t n)
 {
-    int size = 65536;   // Default value from pipe(7)
-    std::ifstream file("/proc/sys/fs/pipe-max-size");
+    size_t rv = 1;
 
-    if (file.good())
+    while (rv < n)
     {
-        file >> size;
+        rv <<= 1;
     }
 
-    return size;
+    return rv;
 }
 }
 
 namespace maxbase
 {
 
-MessageQueue::MessageQueue(Handler* pHandler, int read_fd, int write_fd)
+MessageQueue::MessageQueue(Handler* pHandler, int event_fd, Cell* pCells, size_t capacity)
     : mxb::PollData(&MessageQueue::poll_handler)
     , m_handler(*pHandler)
-    , m_read_fd(read_fd)
-    , m_write_fd(write_fd)
+    , m_event_fd(event_fd)
     , m_pWorker(NULL)
+    , m_pCells(pCells)
+    , m_mask(capacity - 1)
+    , m_head(0)
+    , m_nLogged(0)
+    , m_next_log(0)
+    , m_tail(0)
+    , m_signalled(false)
+    , m_nFull(0)
+    , m_nDropped(0)
+    , m_nSignals(0)
 {
     mxb_assert(pHandler);
-    mxb_assert(read_fd);
-    mxb_assert(write_fd);
+    mxb_assert(event_fd != -1);
+    mxb_assert((capacity & m_mask) == 0);
+
+    for (size_t i = 0; i < capacity; ++i)
+    {
+        m_pCells[i].seq.store(i, std::memory_order_relaxed);
+    }
 }
 
 MessageQueue::~MessageQueue()
 {
     if (m_pWorker)
     {
-        m_pWorker->remove_fd(m_read_fd);
+        m_pWorker->remove_fd(m_event_fd);
     }
 
-    close(m_read_fd);
-    close(m_write_fd);
+    close(m_event_fd);
+    delete [] m_pCells;
 }
 
 // static
@@ -80,7 +93,6 @@ bool MessageQueue::init()
     mxb_assert(!this_unit.initialized);
 
     this_unit.initialized = true;
-    this_unit.pipe_max_size = get_pipe_max_size();
 
     return this_unit.initialized;
 }
@@ -93,141 +105,188 @@ void MessageQueue::finish()
 }
 
 // static
-MessageQueue* MessageQueue::create(Handler* pHandler)
+MessageQueue* MessageQueue::create(Handler* pHandler, size_t capacity)
 {
     mxb_assert(this_unit.initialized);
 
-    /* From "man 7 pipe"
-     * ----
-     *
-     * O_NONBLOCK enabled, n <= PIPE_BUF
-     *   If  there  is room to write n bytes to the pipe, then write(2)
-     *   succeeds immediately, writing all n bytes; otherwise write(2)
-     *   fails, with errno set to EAGAIN.
-     *
-     * ... (On Linux, PIPE_BUF is 4096 bytes.)
-     *
-     * ----
-     *
-     * As O_NONBLOCK is set and the messages are less than 4096 bytes,
-     * O_DIRECT should not be needed and we should be safe without it.
-     *
-     * However, to be in the safe side, we first try whether it is supported,
-     * and if not, we create the pipe without O_DIRECT.
-     */
-
     MessageQueue* pThis = NULL;
 
-    int fds[2];
-
-    int rv = pipe2(fds, O_NONBLOCK | O_CLOEXEC | O_DIRECT);
+    int event_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
 
-    if ((rv != 0) && (errno == EINVAL))
+    if (event_fd != -1)
     {
-        // Ok, apparently the kernel does not support O_DIRECT. Let's try without.
-        rv = pipe2(fds, O_NONBLOCK | O_CLOEXEC);
+        capacity = round_up_to_power_of_two(capacity > 0 ? capacity : 1);
 
-        if (rv == 0)
-        {
-            // Succeeded, so apparently it was the missing support for O_DIRECT.
-            MXB_WARNING("Platform does not support O_DIRECT in conjunction with pipes, "
-                        "using without.");
-        }
-    }
+        Cell* pCells = new(std::nothrow) Cell[capacity];
 
-    if (rv == 0)
-    {
-        int read_fd = fds[0];
-        int write_fd = fds[1];
-#ifdef F_SETPIPE_SZ
-        /**
-         * Increase the pipe buffer size on systems that support it. Modifying
-         * the buffer size of one fd will also increase it for the other.
-         */
-        if (fcntl(fds[0], F_SETPIPE_SZ, this_unit.pipe_max_size) == -1)
+        if (pCells)
         {
-            MXB_WARNING("Failed to increase pipe buffer size to '%d': %d, %s",
-                        this_unit.pipe_max_size,
-                        errno,
-                        mxb_strerror(errno));
+            pThis = new(std::nothrow) MessageQueue(pHandler, event_fd, pCells, capacity);
+
+            if (!pThis)
+            {
+                delete [] pCells;
+            }
         }
-#endif
-        pThis = new(std::nothrow) MessageQueue(pHandler, read_fd, write_fd);
 
         if (!pThis)
         {
             MXB_OOM();
-            close(read_fd);
-            close(write_fd);
+            close(event_fd);
         }
     }
     else
     {
-        MXB_ERROR("Could not create pipe for worker: %s", mxb_strerror(errno));
+        MXB_ERROR("Could not create eventfd for worker: %s", mxb_strerror(errno));
     }
 
     return pThis;
 }
 
+/**
+ * Claim the cell at the tail and copy the message into it. Lock-free; a
+ * producer that is preempted between claiming and publishing a cell only
+ * delays the delivery of the messages posted after it.
+ */
+bool MessageQueue::try_push(const Message& message) const
+{
+    uint64_t pos = m_tail.load(std::memory_order_relaxed);
+
+    while (true)
+    {
+        Cell& cell = m_pCells[pos & m_mask];
+        uint64_t seq = cell.seq.load(std::memory_order_acquire);
+        int64_t diff = (int64_t)seq - (int64_t)pos;
+
+        if (diff == 0)
+        {
+            if (m_tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+            {
+                cell.message = message;
+                cell.seq.store(pos + 1, std::memory_order_release);
+                return true;
+            }
+        }
+        else if (diff < 0)
+        {
+            // The consumer has not yet emptied the cell, the queue is full.
+            return false;
+        }
+        else
+        {
+            pos = m_tail.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+bool MessageQueue::try_pop(Message* pMessage)
+{
+    Cell& cell = m_pCells[m_head & m_mask];
+
+    if (cell.seq.load(std::memory_order_acquire) != m_head + 1)
+    {
+        return false;
+    }
+
+    *pMessage = cell.message;
+    cell.seq.store(m_head + m_mask + 1, std::memory_order_release);
+    ++m_head;
+
+    return true;
+}
+
+bool MessageQueue::is_ready() const
+{
+    return m_pCells[m_head & m_mask].seq.load(std::memory_order_acquire) == m_head + 1;
+}
+
+void MessageQueue::signal() const
+{
+    // Pairs with the fence in handle_poll_events(); either the consumer sees
+    // the published message or we see the flag cleared and write the eventfd.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    if (!m_signalled.exchange(true, std::memory_order_seq_cst))
+    {
+        uint64_t one = 1;
+        MXB_AT_DEBUG(ssize_t n = ) write(m_event_fd, &one, sizeof(one));
+        mxb_assert(n == sizeof(one));
+        m_nSignals.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MessageQueue::log_dropped()
+{
+    // Posting may be done from a signal handler, so the dropped messages are
+    // only counted there and logged here, in the context of the worker. A queue
+    // that is full drops messages in bursts, so this is done at most once every
+    // ten seconds.
+    const time_t interval = 10;
+    uint64_t nDropped = m_nDropped.load(std::memory_order_relaxed);
+
+    if (nDropped != m_nLogged)
+    {
+        time_t now = time(NULL);
+
+        if (now >= m_next_log)
+        {
+            MXB_ERROR("Message queue is full, %lu messages have been dropped, %lu since the "
+                      "last report. The worker is not keeping up with the messages posted to it.",
+                      nDropped, nDropped - m_nLogged);
+            m_nLogged = nDropped;
+            m_next_log = now + interval;
+        }
+    }
+}
+
 bool MessageQueue::post(const Message& message) const
 {
-    // NOTE: No logging here, this function must be signal safe.
     bool rv = false;
 
     mxb_assert(m_pWorker);
     if (m_pWorker)
     {
         /**
-         * This is a stopgap measure to solve MXS-1983 that causes Resource temporarily
-         * unavailable errors. The errors are caused by the pipe buffer being too small to
-         * hold all worker messages. By retrying a limited number of times before giving
-         * up, the success rate for posted messages under heavy load increases
-         * significantly.
+         * If the queue is full, retry a limited number of times before giving
+         * up. The consumer is signalled in any case, so that it keeps draining.
          */
         int fast = 0;
         int slow = 0;
         const int fast_size = 100;
         const int slow_limit = 3;
-        ssize_t n;
 
-        while (true)
+        while (!(rv = try_push(message)))
         {
-            n = write(m_write_fd, &message, sizeof(message));
-            rv = (n == sizeof(message));
+            if (fast == 0 && slow == 0)
+            {
+                // Counted once per post, not once per retry.
+                m_nFull.fetch_add(1, std::memory_order_relaxed);
+            }
 
-            if (n == -1 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            signal();
+
+            if (++fast > fast_size)
             {
-                if (++fast > fast_size)
+                fast = 0;
+
+                if (++slow >= slow_limit)
                 {
-                    fast = 0;
-
-                    if (++slow >= slow_limit)
-                    {
-                        break;
-                    }
-                    else
-                    {
-                        sched_yield();
-                    }
+                    break;
+                }
+                else
+                {
+                    sched_yield();
                 }
-            }
-            else
-            {
-                break;
             }
         }
 
-        if (n == -1)
+        if (rv)
         {
-            MXB_ERROR("Failed to write message: %d, %s", errno, mxb_strerror(errno));
-
-            static bool warn_pipe_buffer_size = true;
-
-            if ((errno == EAGAIN || errno == EWOULDBLOCK) && warn_pipe_buffer_size)
-            {
-                MXB_ERROR("Consider increasing pipe buffer size (sysctl fs.pipe-max-size)");
-                warn_pipe_buffer_size = false;
-            }
+            signal();
+        }
+        else
+        {
+            m_nDropped.fetch_add(1, std::memory_order_relaxed);
         }
     }
     else
@@ -238,15 +297,26 @@ bool MessageQueue::post(const Message& message) const
     return rv;
 }
 
+MessageQueue::Stats MessageQueue::get_stats() const
+{
+    Stats stats;
+    stats.n_posted = m_tail.load(std::memory_order_relaxed);
+    stats.n_full = m_nFull.load(std::memory_order_relaxed);
+    stats.n_dropped = m_nDropped.load(std::memory_order_relaxed);
+    stats.n_signals = m_nSignals.load(std::memory_order_relaxed);
+
+    return stats;
+}
+
 bool MessageQueue::add_to_worker(Worker* pWorker)
 {
     if (m_pWorker)
     {
-        m_pWorker->remove_fd(m_read_fd);
+        m_pWorker->remove_fd(m_event_fd);
         m_pWorker = NULL;
     }
 
-    if (pWorker->add_fd(m_read_fd, EPOLLIN, this))
+    if (pWorker->add_fd(m_event_fd, EPOLLIN, this))
     {
         m_pWorker = pWorker;
     }
@@ -260,7 +330,7 @@ Worker* MessageQueue::remove_from_worker()
 
     if (m_pWorker)
     {
-        m_pWorker->remove_fd(m_read_fd);
+        m_pWorker->remove_fd(m_event_fd);
         m_pWorker = NULL;
     }
 
@@ -278,39 +348,34 @@ uint32_t MessageQueue::handle_poll_events(Worker* pWorker, uint32_t events)
 
     if (events & EPOLLIN)
     {
-        Message message;
+        uint64_t value;
 
-        ssize_t n;
+        if (read(m_event_fd, &value, sizeof(value)) == -1 && errno != EWOULDBLOCK)
+        {
+            MXB_ERROR("Worker could not read from eventfd: %s", mxb_strerror(errno));
+        }
+
+        // Producers posting from now on must signal again.
+        m_signalled.store(false, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        // At most one queue worth of messages is handled per wakeup, so that
+        // a handler that posts to its own worker cannot starve other events.
+        size_t n = 0;
+        Message message;
 
-        do
+        while (n <= m_mask && try_pop(&message))
         {
-            n = read(m_read_fd, &message, sizeof(message));
+            m_handler.handle_message(*this, message);
+            ++n;
+        }
 
-            if (n == sizeof(message))
-            {
-                m_handler.handle_message(*this, message);
-            }
-            else if (n == -1)
-            {
-                if (errno != EWOULDBLOCK)
-                {
-                    MXB_ERROR("Worker could not read from pipe: %s", mxb_strerror(errno));
-                }
-            }
-            else if (n != 0)
-            {
-                // This really should not happen as the pipe is in message mode. We
-                // should either get a message, nothing at all or an error. In non-debug
-                // mode we continue reading in order to empty the pipe as otherwise the
-                // thread may hang.
-                MXB_ERROR("MessageQueue could only read %ld bytes from pipe, although "
-                          "expected %lu bytes.",
-                          n,
-                          sizeof(message));
-                mxb_assert(!true);
-            }
+        if (is_ready())
+        {
+            signal();
         }
-        while ((n != 0) && (n != -1));
+
+        log_dropped();
 
         rc = MXB_POLL_READ;
     }
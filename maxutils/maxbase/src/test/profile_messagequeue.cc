@@ -0,0 +1,140 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxbase/ccdefs.hh>
+#include <sched.h>
+#include <unistd.h>
+#include <atomic>
+#include <iomanip>
+#include <iostream>
+#include <thread>
+#include <vector>
+#include <maxbase/maxbase.hh>
+#include <maxbase/stopwatch.hh>
+#include <maxbase/worker.hh>
+
+using namespace std;
+
+namespace
+{
+
+char USAGE[] = "usage: profile_messagequeue -n count [-p producers]\n";
+
+struct Consumer
+{
+    int64_t total;
+    int64_t received;
+};
+
+void receive(MXB_WORKER* pWorker, void* pData)
+{
+    Consumer* pConsumer = static_cast<Consumer*>(pData);
+
+    if (++pConsumer->received == pConsumer->total)
+    {
+        static_cast<mxb::Worker*>(pWorker)->shutdown();
+    }
+}
+
+/**
+ * Post @c nCount messages to the worker. If the queue is full, the producer
+ * backs off and tries again, which is counted as a retry.
+ */
+void produce(mxb::Worker* pWorker, Consumer* pConsumer, int64_t nCount, std::atomic<int64_t>* pRetries)
+{
+    int64_t nRetries = 0;
+
+    for (int64_t i = 0; i < nCount; ++i)
+    {
+        while (!pWorker->post_message(MXB_WORKER_MSG_CALL, (intptr_t)receive, (intptr_t)pConsumer))
+        {
+            ++nRetries;
+            sched_yield();
+        }
+    }
+
+    pRetries->fetch_add(nRetries);
+}
+
+void profile(int64_t nCount, int nProducers)
+{
+    mxb::Worker worker;
+    Consumer consumer = {nCount * nProducers, 0};
+    std::atomic<int64_t> retries(0);
+
+    worker.start();
+
+    mxb::StopWatch sw;
+
+    vector<thread> producers;
+
+    for (int i = 0; i < nProducers; ++i)
+    {
+        producers.emplace_back(produce, &worker, &consumer, nCount, &retries);
+    }
+
+    for (auto& producer : producers)
+    {
+        producer.join();
+    }
+
+    worker.join();
+
+    mxb::Duration d = sw.split();
+
+    cout << nProducers << " producers, " << consumer.received << " messages: "
+         << fixed << setprecision(3) << d.secs() << "s, "
+         << setprecision(0) << consumer.received / d.secs() << " messages/s, "
+         << setprecision(1) << (d.secs() * 1e9) / consumer.received << "ns per message, "
+         << retries.load() << " retries" << endl;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rc = EXIT_SUCCESS;
+
+    int64_t nCount = 0;
+    int nProducers = 1;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:p:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            nCount = atoll(optarg);
+            break;
+
+        case 'p':
+            nProducers = atoi(optarg);
+            break;
+
+        default:
+            rc = EXIT_FAILURE;
+        }
+    }
+
+    if ((rc == EXIT_SUCCESS) && (nCount > 0) && (nProducers > 0))
+    {
+        mxb::MaxBase mxb(MXB_LOG_TARGET_STDOUT);
+
+        profile(nCount, nProducers);
+    }
+    else
+    {
+        cout << USAGE << endl;
+    }
+
+    return rc;
+}
@@ -0,0 +1,200 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#if !defined (SS_DEBUG)
+#define SS_DEBUG
+#endif
+#if defined (NDEBUG)
+#undef NDEBUG
+#endif
+
+#include <maxbase/ccdefs.hh>
+#include <iostream>
+#include <maxbase/histogram.hh>
+
+using namespace maxbase;
+using namespace std;
+
+namespace
+{
+
+int64_t us(Duration d)
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+}
+
+int test_buckets()
+{
+    int rv = 0;
+
+    cout << "Testing bucket boundaries." << endl;
+
+    for (int i = 0; i < LatencyHistogram::N_BUCKETS - 1; ++i)
+    {
+        uint64_t lower = LatencyHistogram::bucket_lower_us(i);
+        uint64_t upper = LatencyHistogram::bucket_upper_us(i);
+
+        if (lower >= upper
+            || LatencyHistogram::bucket_of(lower) != i
+            || LatencyHistogram::bucket_of(upper - 1) != i
+            || LatencyHistogram::bucket_of(upper) != i + 1)
+        {
+            cout << "error: Bucket " << i << " [" << lower << ", " << upper << ") is not consistent." << endl;
+            ++rv;
+        }
+    }
+
+    if (LatencyHistogram::bucket_of(UINT64_MAX) != LatencyHistogram::N_BUCKETS - 1)
+    {
+        cout << "error: Large latencies do not go to the last bucket." << endl;
+        ++rv;
+    }
+
+    return rv;
+}
+
+int test_percentiles()
+{
+    int rv = 0;
+
+    cout << "Testing percentiles." << endl;
+
+    LatencyHistogram h;
+    TimePoint now = Clock::now();
+
+    if (h.percentile(50) != Duration(0))
+    {
+        cout << "error: An empty histogram has a non-zero percentile." << endl;
+        ++rv;
+    }
+
+    // 1000 samples, 1ms..1000ms
+    for (int i = 1; i <= 1000; ++i)
+    {
+        h.add(std::chrono::milliseconds(i), now);
+    }
+
+    const struct
+    {
+        double  p;
+        int64_t expected_us;
+    } cases[] =
+    {
+        {50, 500000 },
+        {90, 900000 },
+        {99, 990000 },
+    };
+
+    for (const auto& c : cases)
+    {
+        int64_t value = us(h.percentile(c.p));
+
+        // The buckets are a quarter of a power of two wide.
+        if (value < c.expected_us * 3 / 4 || value > c.expected_us * 5 / 4)
+        {
+            cout << "error: p" << c.p << " is " << value << "us, expected ~" << c.expected_us << "us." << endl;
+            ++rv;
+        }
+    }
+
+    return rv;
+}
+
+int test_decay()
+{
+    int rv = 0;
+
+    cout << "Testing decay." << endl;
+
+    LatencyHistogram h(std::chrono::seconds(10));
+    TimePoint now = Clock::now();
+
+    for (int i = 0; i < 100; ++i)
+    {
+        h.add(std::chrono::milliseconds(100), now);
+    }
+
+    double count = h.count(now + std::chrono::seconds(10));
+
+    if (count < 49 || count > 51)
+    {
+        cout << "error: After one half-life the count is " << count << ", expected 50." << endl;
+        ++rv;
+    }
+
+    // Much later, the latency is lower. The old samples should hardly matter.
+    now += std::chrono::seconds(120);
+
+    for (int i = 0; i < 100; ++i)
+    {
+        h.add(std::chrono::milliseconds(1), now);
+    }
+
+    if (us(h.percentile(99)) > 1500)
+    {
+        cout << "error: Old samples still affect p99: " << us(h.percentile(99)) << "us." << endl;
+        ++rv;
+    }
+
+    return rv;
+}
+
+int test_add()
+{
+    int rv = 0;
+
+    cout << "Testing aggregation." << endl;
+
+    TimePoint now = Clock::now();
+    LatencyHistogram h1;
+    LatencyHistogram h2;
+
+    for (int i = 0; i < 100; ++i)
+    {
+        h1.add(std::chrono::milliseconds(1), now);
+        h2.add(std::chrono::milliseconds(100), now);
+    }
+
+    LatencyHistogram sum;
+    sum += h1;
+    sum += h2;
+
+    if (sum.count(now) < 199 || sum.count(now) > 201)
+    {
+        cout << "error: The sum has " << sum.count(now) << " samples, expected 200." << endl;
+        ++rv;
+    }
+
+    if (us(sum.percentile(25)) > 1500 || us(sum.percentile(75)) < 75000)
+    {
+        cout << "error: The percentiles of the sum are wrong." << endl;
+        ++rv;
+    }
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = 0;
+
+    rv += test_buckets();
+    rv += test_percentiles();
+    rv += test_decay();
+    rv += test_add();
+
+    cout << (rv == 0 ? "OK" : "FAILED") << endl;
+
+    return rv;
+}
@@ -0,0 +1,199 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#if !defined (SS_DEBUG)
+#define SS_DEBUG
+#endif
+#if defined (NDEBUG)
+#undef NDEBUG
+#endif
+
+#include <maxbase/ccdefs.hh>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <vector>
+#include <maxbase/logger.hh>
+
+using namespace maxbase;
+using namespace std;
+
+namespace
+{
+
+const char FILENAME[] = "test_logger.log";
+const int N_THREADS = 8;
+const int N_MESSAGES = 10000;
+
+void log_messages(Logger* pLogger, int thread)
+{
+    for (int i = 0; i < N_MESSAGES; ++i)
+    {
+        ostringstream os;
+        os << "thread " << thread << " message " << i << "\n";
+        string msg = os.str();
+        pLogger->write(msg.c_str(), msg.length());
+    }
+}
+
+void log_concurrently(Logger* pLogger)
+{
+    vector<thread> threads;
+
+    for (int i = 0; i < N_THREADS; ++i)
+    {
+        threads.emplace_back(log_messages, pLogger, i);
+    }
+
+    for (auto& t : threads)
+    {
+        t.join();
+    }
+}
+
+/**
+ * Check the messages in the log file.
+ *
+ * @param expect_all  Whether all messages should be in the file.
+ * @param pN_found    The number of messages found in the file.
+ *
+ * @return Number of errors.
+ */
+int check_log(bool expect_all, int* pN_found)
+{
+    int rv = 0;
+    vector<int> next(N_THREADS, 0);
+    ifstream file(FILENAME);
+    string word;
+    int thread;
+    int message;
+    int n_found = 0;
+
+    while (file >> word)
+    {
+        if (word == "thread" && file >> thread >> word >> message)
+        {
+            // Messages may be missing only if they were dropped, but the
+            // messages of a thread must always be in order.
+            if (message < next[thread] || (expect_all && message != next[thread]))
+            {
+                cout << "error: Message " << message << " of thread " << thread
+                     << " is out of order, expected " << next[thread] << "." << endl;
+                ++rv;
+            }
+
+            next[thread] = message + 1;
+            ++n_found;
+        }
+    }
+
+    if (expect_all && n_found != N_THREADS * N_MESSAGES)
+    {
+        cout << "error: Expected " << N_THREADS * N_MESSAGES << " messages, found " << n_found << "." << endl;
+        ++rv;
+    }
+
+    *pN_found = n_found;
+    return rv;
+}
+
+int test_block()
+{
+    int rv = 0;
+    int n_found;
+
+    cout << "Testing concurrent logging with the block policy." << endl;
+    unlink(FILENAME);
+
+    unique_ptr<Logger> sLogger = FileLogger::create(FILENAME);
+    log_concurrently(sLogger.get());
+
+    if (sLogger->stats().dropped != 0)
+    {
+        cout << "error: Messages were dropped with the block policy." << endl;
+        ++rv;
+    }
+
+    sLogger.reset();
+    rv += check_log(true, &n_found);
+
+    return rv;
+}
+
+int test_drop()
+{
+    int rv = 0;
+    int n_found;
+
+    cout << "Testing concurrent logging with the drop policy." << endl;
+    unlink(FILENAME);
+
+    unique_ptr<Logger> sLogger = FileLogger::create(FILENAME);
+    sLogger->set_overflow(Logger::Overflow::DROP);
+    log_concurrently(sLogger.get());
+
+    uint64_t dropped = sLogger->stats().dropped;
+    sLogger.reset();
+    rv += check_log(false, &n_found);
+
+    if (n_found + dropped != N_THREADS * N_MESSAGES)
+    {
+        cout << "error: " << n_found << " messages were written and " << dropped
+             << " dropped, expected " << N_THREADS * N_MESSAGES << " in total." << endl;
+        ++rv;
+    }
+
+    return rv;
+}
+
+int test_rotate()
+{
+    int rv = 0;
+    int n_found;
+
+    cout << "Testing that buffered messages are written before rotation." << endl;
+    unlink(FILENAME);
+
+    unique_ptr<Logger> sLogger = FileLogger::create(FILENAME);
+    log_messages(sLogger.get(), 0);
+    rename(FILENAME, "test_logger.log.1");
+    sLogger->rotate();
+    sLogger.reset();
+
+    rename("test_logger.log.1", FILENAME);
+    rv += check_log(false, &n_found);
+
+    if (n_found != N_MESSAGES)
+    {
+        cout << "error: Expected " << N_MESSAGES << " messages in the rotated file, found "
+             << n_found << "." << endl;
+        ++rv;
+    }
+
+    return rv;
+}
+}
+
+int main()
+{
+    int rv = 0;
+
+    rv += test_block();
+    rv += test_drop();
+    rv += test_rotate();
+
+    unlink(FILENAME);
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -22,6 +22,7 @@
 #include <signal.h>
 #include <string.h>
 #include <algorithm>
+#include <atomic>
 #include <map>
 #include <new>
 #include <string>
@@ -243,16 +244,18 @@ class QcSqliteInfo : public QC_STMT_INFO
     QcSqliteInfo& operator=(const QcSqliteInfo&);
 
 public:
+    // The reference count is atomic, as the core may share an info object
+    // between threads once it has been completely collected.
     void inc_ref()
     {
         mxb_assert(m_refs > 0);
-        ++m_refs;
+        m_refs.fetch_add(1, std::memory_order_relaxed);
     }
 
     void dec_ref()
     {
         mxb_assert(m_refs > 0);
-        if (--m_refs == 0)
+        if (m_refs.fetch_sub(1, std::memory_order_acq_rel) == 1)
         {
             delete this;
         }
@@ -3387,7 +3390,7 @@ private:
 
 public:
     // TODO: Make these private once everything's been updated.
-    int32_t m_refs;                             // The reference count.
+    std::atomic<int32_t> m_refs;                // The reference count.
     qc_parse_result_t m_status;                 // The validity of the information in this structure.
     qc_parse_result_t m_status_cap;             // The cap on 'm_status', it won't be set to higher than this.
     uint32_t m_collect;                         // What information should be collected.
@@ -14,6 +14,7 @@
 #include <maxscale/buffer.h>
 
 #include <errno.h>
+#include <stddef.h>
 #include <stdlib.h>
 #include <sstream>
 
@@ -24,8 +25,44 @@
 #include <maxscale/utils.h>
 #include <maxscale/routingworker.hh>
 
+#include "internal/bufferpool.hh"
+
+using mxs::BufferPool;
 using mxs::RoutingWorker;
 
+namespace
+{
+
+/**
+ * The header of a buffer and the shared buffer it was created with are
+ * allocated as one block. The block is released when the last reference
+ * to the shared buffer goes away.
+ */
+struct gwbuf_block
+{
+    GWBUF      buf;
+    size_t     size;    /*< The size of the data the block was allocated for */
+    SHARED_BUF sbuf;
+};
+
+inline gwbuf_block* gwbuf_block_of(SHARED_BUF* sbuf)
+{
+    return (gwbuf_block*)((char*)sbuf - offsetof(gwbuf_block, sbuf));
+}
+
+/**
+ * Check whether the header of a buffer is embedded in the block of its shared buffer.
+ *
+ * @param buf  A buffer.
+ *
+ * @return True, if the header was allocated together with the shared buffer.
+ */
+inline bool gwbuf_is_embedded(const GWBUF* buf)
+{
+    return buf == &gwbuf_block_of(buf->sbuf)->buf;
+}
+}
+
 static void             gwbuf_free_one(GWBUF* buf);
 static buffer_object_t* gwbuf_remove_buffer_object(GWBUF* buf,
                                                    buffer_object_t* bufobj);
@@ -33,9 +70,8 @@ static buffer_object_t* gwbuf_remove_buffer_object(GWBUF* buf,
 /**
  * Allocate a new gateway buffer structure of size bytes.
  *
- * For now we allocate memory directly from malloc for buffer the management
- * structure and the actual data buffer itself. We may swap at a future date
- * to a more efficient mechanism.
+ * The buffer management structure and the actual data buffer are allocated
+ * as one block from the buffer pool of the current routing worker.
  *
  * @param       size The size in bytes of the data area required
  * @return      Pointer to the buffer structure or NULL if memory could not
@@ -43,17 +79,18 @@ static buffer_object_t* gwbuf_remove_buffer_object(GWBUF* buf,
  */
 GWBUF* gwbuf_alloc(unsigned int size)
 {
-    size_t sbuf_size = sizeof(SHARED_BUF) + (size ? size - 1 : 0);
-    GWBUF* rval = (GWBUF*)MXS_MALLOC(sizeof(GWBUF));
-    SHARED_BUF* sbuf = (SHARED_BUF*)MXS_MALLOC(sbuf_size);
+    size_t block_size = sizeof(gwbuf_block) + (size ? size - 1 : 0);
+    gwbuf_block* block = (gwbuf_block*)BufferPool::alloc(block_size);
 
-    if (rval == NULL || sbuf == NULL)
+    if (block == NULL)
     {
-        MXS_FREE(rval);
-        MXS_FREE(sbuf);
         return NULL;
     }
 
+    GWBUF* rval = &block->buf;
+    SHARED_BUF* sbuf = &block->sbuf;
+
+    block->size = size;
     sbuf->refcount = 1;
     sbuf->info = GWBUF_INFO_NONE;
     sbuf->bufobj = NULL;
@@ -94,6 +131,37 @@ GWBUF* gwbuf_alloc_and_load(unsigned int size, const void* data)
     return rval;
 }
 
+GWBUF* gwbuf_alloc_external(void* data, unsigned int size, void (* release)(void*), void* context)
+{
+    GWBUF* rval = gwbuf_alloc(0);
+
+    if (rval)
+    {
+        buffer_object_t* bo = (buffer_object_t*)MXS_MALLOC(sizeof(buffer_object_t));
+
+        if (bo)
+        {
+            bo->bo_id = GWBUF_EXTERNAL_DATA;
+            bo->bo_data = context;
+            bo->bo_donefun_fp = release;
+            bo->bo_start = data;
+            bo->bo_next = NULL;
+
+            // The object is not a parsing info, so GWBUF_INFO_PARSED is not set.
+            rval->sbuf->bufobj = bo;
+            rval->start = data;
+            rval->end = (char*)data + size;
+        }
+        else
+        {
+            gwbuf_free(rval);
+            rval = NULL;
+        }
+    }
+
+    return rval;
+}
+
 /**
  * Free a list of gateway buffers
  *
@@ -117,18 +185,19 @@ void gwbuf_free(GWBUF* buf)
  */
 static void gwbuf_free_one(GWBUF* buf)
 {
-    --buf->sbuf->refcount;
+    SHARED_BUF* sbuf = buf->sbuf;
+    bool embedded = gwbuf_is_embedded(buf);
+
+    --sbuf->refcount;
 
-    if (buf->sbuf->refcount == 0)
+    if (sbuf->refcount == 0)
     {
-        buffer_object_t* bo = buf->sbuf->bufobj;
+        buffer_object_t* bo = sbuf->bufobj;
 
         while (bo != NULL)
         {
             bo = gwbuf_remove_buffer_object(buf, bo);
         }
-
-        MXS_FREE(buf->sbuf);
     }
 
     while (buf->properties)
@@ -147,7 +216,17 @@ static void gwbuf_free_one(GWBUF* buf)
         hint_free(h);
     }
 
-    MXS_FREE(buf);
+    // An embedded header is released together with the shared buffer, which
+    // may still be referred to by clones.
+    if (sbuf->refcount == 0)
+    {
+        BufferPool::free(gwbuf_block_of(sbuf));
+    }
+
+    if (!embedded)
+    {
+        BufferPool::free(buf);
+    }
 }
 
 /**
@@ -162,13 +241,15 @@ static void gwbuf_free_one(GWBUF* buf)
  */
 static GWBUF* gwbuf_clone_one(GWBUF* buf)
 {
-    GWBUF* rval = (GWBUF*)MXS_CALLOC(1, sizeof(GWBUF));
+    GWBUF* rval = (GWBUF*)BufferPool::alloc(sizeof(GWBUF));
 
     if (rval == NULL)
     {
         return NULL;
     }
 
+    memset(rval, 0, sizeof(GWBUF));
+
     mxb_assert(buf->owner == RoutingWorker::get_current_id());
     ++buf->sbuf->refcount;
 #ifdef SS_DEBUG
@@ -261,7 +342,7 @@ static GWBUF *gwbuf_clone_portion(GWBUF* buf,
     mxb_assert(buf->owner == RoutingWorker::get_current_id());
     mxb_assert(start_offset + length <= GWBUF_LENGTH(buf));
 
-    GWBUF* clonebuf = (GWBUF*)MXS_MALLOC(sizeof(GWBUF));
+    GWBUF* clonebuf = (GWBUF*)BufferPool::alloc(sizeof(GWBUF));
 
     if (clonebuf == NULL)
     {
@@ -321,7 +402,7 @@ GWBUF* gwbuf_split(GWBUF** buf, size_t length)
             if (length > 0)
             {
                 mxb_assert(GWBUF_LENGTH(buffer) > length);
-                GWBUF* partial = gwbuf_deep_clone_portion(buffer, length);
+                GWBUF* partial = gwbuf_clone_portion(buffer, 0, length);
 
                 /** If the head points to the original head of the buffer chain
                  * and we are splitting a contiguous buffer, we only need to return
@@ -570,6 +651,7 @@ void gwbuf_add_buffer_object(GWBUF* buf,
     newb->bo_id = id;
     newb->bo_data = data;
     newb->bo_donefun_fp = donefun_fp;
+    newb->bo_start = buf->start;
     newb->bo_next = NULL;
 
     buffer_object_t** p_b = &buf->sbuf->bufobj;
@@ -588,7 +670,7 @@ void* gwbuf_get_buffer_object_data(GWBUF* buf, bufobj_id_t id)
     mxb_assert(buf->owner == RoutingWorker::get_current_id());
     buffer_object_t* bo = buf->sbuf->bufobj;
 
-    while (bo != NULL && bo->bo_id != id)
+    while (bo != NULL && (bo->bo_id != id || bo->bo_start != buf->start))
     {
         bo = bo->bo_next;
     }
@@ -674,6 +756,68 @@ GWBUF* gwbuf_make_contiguous(GWBUF* orig)
     return newbuf;
 }
 
+GWBUF* gwbuf_make_compact(GWBUF* orig)
+{
+    mxb_assert_message(orig != NULL, "gwbuf_make_compact: NULL buffer");
+    mxb_assert(orig->owner == RoutingWorker::get_current_id());
+
+    // Larger buffers use most of the data they refer to anyway.
+    const size_t COMPACT_LIMIT = 8192;
+    // Only a buffer that pins several times its own size is worth copying.
+    const size_t PIN_FACTOR = 4;
+
+    size_t len = gwbuf_length(orig);
+    size_t pinned = 0;
+
+    for (GWBUF* b = orig; b; b = b->next)
+    {
+        pinned += gwbuf_block_of(b->sbuf)->size;
+    }
+
+    if (len > COMPACT_LIMIT || pinned < PIN_FACTOR * len)
+    {
+        return orig;
+    }
+
+    GWBUF* newbuf = gwbuf_alloc(len);
+    MXS_ABORT_IF_NULL(newbuf);
+
+    newbuf->gwbuf_type = orig->gwbuf_type;
+    newbuf->server = orig->server;
+    newbuf->hint = hint_dup(orig->hint);
+    gwbuf_copy_data(orig, 0, len, GWBUF_DATA(newbuf));
+
+    for (BUF_PROPERTY* prop = orig->properties; prop; prop = prop->next)
+    {
+        gwbuf_add_property(newbuf, prop->name, prop->value);
+    }
+
+    // The buffer objects of the data, e.g. the parsing information, move along with it.
+    buffer_object_t** pp = &orig->sbuf->bufobj;
+
+    while (*pp)
+    {
+        buffer_object_t* bo = *pp;
+
+        if (bo->bo_start == orig->start && bo->bo_id != GWBUF_EXTERNAL_DATA)
+        {
+            *pp = bo->bo_next;
+            bo->bo_start = newbuf->start;
+            bo->bo_next = newbuf->sbuf->bufobj;
+            newbuf->sbuf->bufobj = bo;
+            newbuf->sbuf->info |= orig->sbuf->info & GWBUF_INFO_PARSED;
+        }
+        else
+        {
+            pp = &bo->bo_next;
+        }
+    }
+
+    gwbuf_free(orig);
+
+    return newbuf;
+}
+
 size_t gwbuf_copy_data(const GWBUF* buffer, size_t offset, size_t bytes, uint8_t* dest)
 {
     uint32_t buflen;
@@ -0,0 +1,365 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "internal/bufferpool.hh"
+
+#include <atomic>
+#include <maxbase/assert.h>
+#include <maxscale/alloc.h>
+#include <maxscale/limits.h>
+
+using maxscale::BufferPool;
+
+namespace
+{
+
+/**
+ * The header in front of every block handed out by the pool. It is 16 bytes
+ * so that the memory returned to the caller retains the alignment of malloc.
+ */
+struct Chunk
+{
+    Chunk*  next;       // Free list link, only used while the chunk is free.
+    int32_t pool_id;    // The id of the owning pool, HEAP if allocated from the heap.
+    int32_t size_class; // The size class of the chunk.
+};
+
+static_assert(sizeof(Chunk) == 16, "The chunk header must retain malloc alignment.");
+
+const int HEAP = -1;
+
+// The usable sizes of the size classes. The smallest one is large enough for
+// the buffer header of a clone and for small MySQL packets.
+const size_t CLASS_SIZES[] =
+{
+    128,
+    512,
+    2048,
+    8192,
+    32768
+};
+
+const int N_CLASSES = sizeof(CLASS_SIZES) / sizeof(CLASS_SIZES[0]);
+
+// The maximum number of bytes cached per size class and pool.
+const size_t MAX_CACHED_BYTES_PER_CLASS = 4 * 1024 * 1024;
+
+int size_class_of(size_t size)
+{
+    for (int i = 0; i < N_CLASSES; ++i)
+    {
+        if (size <= CLASS_SIZES[i])
+        {
+            return i;
+        }
+    }
+
+    return HEAP;
+}
+
+size_t max_cached(int size_class)
+{
+    return MAX_CACHED_BYTES_PER_CLASS / CLASS_SIZES[size_class];
+}
+
+class Pool
+{
+public:
+    Pool()
+        : m_remote(nullptr)
+        , m_active(false)
+    {
+        for (int i = 0; i < N_CLASSES; ++i)
+        {
+            m_free[i] = nullptr;
+            m_nFree[i] = 0;
+        }
+    }
+
+    void activate(int id)
+    {
+        m_id = id;
+        m_active.store(true, std::memory_order_release);
+    }
+
+    void deactivate()
+    {
+        // Sequentially consistent, so that a concurrent push_remote() either sees
+        // the pool as inactive or pushes the chunk before the list is released.
+        m_active.store(false);
+        release_remote();
+
+        for (int i = 0; i < N_CLASSES; ++i)
+        {
+            while (m_free[i])
+            {
+                Chunk* pChunk = m_free[i];
+                m_free[i] = pChunk->next;
+                MXS_FREE(pChunk);
+            }
+
+            m_nFree[i] = 0;
+        }
+
+        m_stats.n_cached = 0;
+        m_stats.n_cached_bytes = 0;
+    }
+
+    int id() const
+    {
+        return m_id;
+    }
+
+    Chunk* pop(int size_class)
+    {
+        ++m_stats.n_alloc;
+
+        if (!m_free[size_class])
+        {
+            reclaim();
+        }
+
+        Chunk* pChunk = m_free[size_class];
+
+        if (pChunk)
+        {
+            m_free[size_class] = pChunk->next;
+            --m_nFree[size_class];
+            --m_stats.n_cached;
+            m_stats.n_cached_bytes -= CLASS_SIZES[size_class];
+            ++m_stats.n_hit;
+        }
+        else
+        {
+            ++m_stats.n_miss;
+        }
+
+        return pChunk;
+    }
+
+    void push_local(Chunk* pChunk)
+    {
+        ++m_stats.n_free;
+        push(pChunk);
+    }
+
+    void push_remote(Chunk* pChunk)
+    {
+        if (m_active.load(std::memory_order_acquire))
+        {
+            // Multiple producers, single consumer. The consumer always takes
+            // the whole list, so there is no ABA problem.
+            Chunk* pHead = m_remote.load(std::memory_order_relaxed);
+
+            do
+            {
+                pChunk->next = pHead;
+            }
+            while (!m_remote.compare_exchange_weak(pHead, pChunk,
+                                                   std::memory_order_seq_cst,
+                                                   std::memory_order_relaxed));
+
+            if (!m_active.load())
+            {
+                // The pool was deactivated while the chunk was being pushed and
+                // the owner will not reclaim the list anymore.
+                release_remote();
+            }
+        }
+        else
+        {
+            MXS_FREE(pChunk);
+        }
+    }
+
+    void reclaim()
+    {
+        Chunk* pChunk = m_remote.exchange(nullptr, std::memory_order_acquire);
+
+        while (pChunk)
+        {
+            Chunk* pNext = pChunk->next;
+            ++m_stats.n_remote_free;
+            push(pChunk);
+            pChunk = pNext;
+        }
+    }
+
+    void release_remote()
+    {
+        Chunk* pChunk = m_remote.exchange(nullptr);
+
+        while (pChunk)
+        {
+            Chunk* pNext = pChunk->next;
+            MXS_FREE(pChunk);
+            pChunk = pNext;
+        }
+    }
+
+    const BufferPool::Stats& stats() const
+    {
+        return m_stats;
+    }
+
+private:
+    void push(Chunk* pChunk)
+    {
+        int size_class = pChunk->size_class;
+
+        if (m_nFree[size_class] < max_cached(size_class))
+        {
+            pChunk->next = m_free[size_class];
+            m_free[size_class] = pChunk;
+            ++m_nFree[size_class];
+            ++m_stats.n_cached;
+            m_stats.n_cached_bytes += CLASS_SIZES[size_class];
+        }
+        else
+        {
+            MXS_FREE(pChunk);
+        }
+    }
+
+    int                 m_id = HEAP;
+    Chunk*              m_free[N_CLASSES];
+    size_t              m_nFree[N_CLASSES];
+    std::atomic<Chunk*> m_remote;
+    std::atomic<bool>   m_active;
+    BufferPool::Stats   m_stats;
+};
+
+// The pools are never deleted, as buffers may be released after the workers
+// have been shut down.
+Pool this_unit_pools[MXS_MAX_THREADS];
+
+thread_local struct
+{
+    Pool* pPool;    // The pool of the current thread, NULL if the thread has none.
+} this_thread =
+{
+    nullptr
+};
+}
+
+namespace maxscale
+{
+
+// static
+void BufferPool::thread_init(int id)
+{
+    mxb_assert(id >= 0 && id < MXS_MAX_THREADS);
+    mxb_assert(!this_thread.pPool);
+
+    this_thread.pPool = &this_unit_pools[id];
+    this_thread.pPool->activate(id);
+}
+
+// static
+void BufferPool::thread_finish()
+{
+    if (this_thread.pPool)
+    {
+        this_thread.pPool->deactivate();
+        this_thread.pPool = nullptr;
+    }
+}
+
+// static
+void BufferPool::tick()
+{
+    if (this_thread.pPool)
+    {
+        this_thread.pPool->reclaim();
+    }
+}
+
+// static
+void* BufferPool::alloc(size_t size)
+{
+    Pool* pPool = this_thread.pPool;
+    int size_class = pPool ? size_class_of(size) : HEAP;
+    Chunk* pChunk = nullptr;
+
+    if (size_class != HEAP)
+    {
+        pChunk = pPool->pop(size_class);
+    }
+
+    if (!pChunk)
+    {
+        size_t n = (size_class != HEAP) ? CLASS_SIZES[size_class] : size;
+        pChunk = static_cast<Chunk*>(MXS_MALLOC(sizeof(Chunk) + n));
+
+        if (!pChunk)
+        {
+            return nullptr;
+        }
+
+        pChunk->pool_id = (size_class != HEAP) ? pPool->id() : HEAP;
+        pChunk->size_class = size_class;
+    }
+
+    return pChunk + 1;
+}
+
+// static
+void BufferPool::free(void* ptr)
+{
+    if (ptr)
+    {
+        Chunk* pChunk = static_cast<Chunk*>(ptr) - 1;
+
+        if (pChunk->pool_id == HEAP)
+        {
+            MXS_FREE(pChunk);
+        }
+        else
+        {
+            Pool* pOwner = &this_unit_pools[pChunk->pool_id];
+
+            if (pOwner == this_thread.pPool)
+            {
+                pOwner->push_local(pChunk);
+            }
+            else
+            {
+                pOwner->push_remote(pChunk);
+            }
+        }
+    }
+}
+
+// static
+BufferPool::Stats BufferPool::get_stats()
+{
+    return this_thread.pPool ? this_thread.pPool->stats() : Stats();
+}
+
+// static
+json_t* BufferPool::get_stats_as_json()
+{
+    Stats stats = get_stats();
+
+    json_t* pStats = json_object();
+    json_object_set_new(pStats, "allocations", json_integer(stats.n_alloc));
+    json_object_set_new(pStats, "hits", json_integer(stats.n_hit));
+    json_object_set_new(pStats, "misses", json_integer(stats.n_miss));
+    json_object_set_new(pStats, "frees", json_integer(stats.n_free));
+    json_object_set_new(pStats, "remote_frees", json_integer(stats.n_remote_free));
+    json_object_set_new(pStats, "cached_blocks", json_integer(stats.n_cached));
+    json_object_set_new(pStats, "cached_bytes", json_integer(stats.n_cached_bytes));
+
+    return pStats;
+}
+}
@@ -91,6 +91,7 @@ const char CN_AUTH_CONNECT_TIMEOUT[] = "auth_connect_timeout";
 const char CN_AUTH_READ_TIMEOUT[] = "auth_read_timeout";
 const char CN_AUTH_WRITE_TIMEOUT[] = "auth_write_timeout";
 const char CN_AUTO[] = "auto";
+const char CN_CACHE_SHARED[] = "cache_shared";
 const char CN_CACHE_SIZE[] = "cache_size";
 const char CN_CLASSIFY[] = "classify";
 const char CN_CONNECTION_TIMEOUT[] = "connection_timeout";
@@ -118,6 +119,7 @@ const char CN_LOAD_PERSISTED_CONFIGS[] = "load_persisted_configs";
 const char CN_LOCALHOST_MATCH_WILDCARD_HOST[] = "localhost_match_wildcard_host";
 const char CN_LOCAL_ADDRESS[] = "local_address";
 const char CN_LOG_AUTH_WARNINGS[] = "log_auth_warnings";
+const char CN_LOG_OVERFLOW[] = "log_overflow";
 const char CN_LOG_THROTTLING[] = "log_throttling";
 const char CN_MAXSCALE[] = "maxscale";
 const char CN_MAX_CONNECTIONS[] = "max_connections";
@@ -144,13 +146,17 @@ const char CN_PORT[] = "port";
 const char CN_PROTOCOL[] = "protocol";
 const char CN_QUERY_CLASSIFIER[] = "query_classifier";
 const char CN_QUERY_CLASSIFIER_ARGS[] = "query_classifier_args";
+const char CN_QUERY_CLASSIFIER_CACHE_SHARED[] = "query_classifier_cache_shared";
 const char CN_QUERY_CLASSIFIER_CACHE_SIZE[] = "query_classifier_cache_size";
 const char CN_QUERY_RETRIES[] = "query_retries";
 const char CN_QUERY_RETRY_TIMEOUT[] = "query_retry_timeout";
 const char CN_RELATIONSHIPS[] = "relationships";
 const char CN_REQUIRED[] = "required";
+const char CN_REBALANCE_PERIOD[] = "rebalance_period";
+const char CN_REBALANCE_THRESHOLD[] = "rebalance_threshold";
 const char CN_RETAIN_LAST_STATEMENTS[] = "retain_last_statements";
 const char CN_RETRY_ON_FAILURE[] = "retry_on_failure";
+const char CN_REUSEPORT[] = "reuseport";
 const char CN_ROUTER[] = "router";
 const char CN_ROUTER_DIAGNOSTICS[] = "router_diagnostics";
 const char CN_ROUTER_OPTIONS[] = "router_options";
@@ -350,6 +356,7 @@ const MXS_MODULE_PARAM config_listener_params[] =
      ssl_version_values},
     {CN_SSL_CERT_VERIFY_DEPTH,       MXS_MODULE_PARAM_COUNT,   "9"},
     {CN_SSL_VERIFY_PEER_CERTIFICATE, MXS_MODULE_PARAM_BOOL,    "true"},
+    {CN_REUSEPORT,                   MXS_MODULE_PARAM_BOOL,    "false"},
     {NULL}
 };
 
@@ -371,6 +378,7 @@ const MXS_MODULE_PARAM config_monitor_params[] =
     {CN_BACKEND_READ_TIMEOUT,      MXS_MODULE_PARAM_COUNT,  "1"},
     {CN_BACKEND_WRITE_TIMEOUT,     MXS_MODULE_PARAM_COUNT,  "2"},
     {CN_BACKEND_CONNECT_ATTEMPTS,  MXS_MODULE_PARAM_COUNT,  "1"},
+    {CN_PROBE_THREADS,             MXS_MODULE_PARAM_COUNT,  "8"},
 
     {CN_JOURNAL_MAX_AGE,           MXS_MODULE_PARAM_COUNT,  "28800"},
     {CN_DISK_SPACE_THRESHOLD,      MXS_MODULE_PARAM_STRING},
@@ -414,6 +422,8 @@ const MXS_MODULE_PARAM config_server_params[] =
     {CN_MONITORPW,                   MXS_MODULE_PARAM_STRING},
     {CN_PERSISTPOOLMAX,              MXS_MODULE_PARAM_COUNT,  "0"},
     {CN_PERSISTMAXTIME,              MXS_MODULE_PARAM_COUNT,  "0"},
+    {CN_PERSISTPOOLMIN,              MXS_MODULE_PARAM_COUNT,  "0"},
+    {CN_PERSISTPINGTIME,             MXS_MODULE_PARAM_COUNT,  "300"},
     {CN_PROXY_PROTOCOL,              MXS_MODULE_PARAM_BOOL,   "false"},
     {CN_SSL,                         MXS_MODULE_PARAM_ENUM,   "false",
      MXS_MODULE_OPT_ENUM_UNIQUE,
@@ -2351,6 +2361,10 @@ static int handle_global_item(const char* name, const char* value)
             return 0;
         }
     }
+    else if (strcmp(name, CN_QUERY_CLASSIFIER_CACHE_SHARED) == 0)
+    {
+        gateway.qc_cache_properties.shared = config_truth_value(value);
+    }
     else if (strcmp(name, "sql_mode") == 0)
     {
         if (strcasecmp(value, "default") == 0)
@@ -2462,6 +2476,23 @@ static int handle_global_item(const char* name, const char* value)
             MXS_FREE(v);
         }
     }
+    else if (strcmp(name, CN_LOG_OVERFLOW) == 0)
+    {
+        if (strcmp(value, "block") == 0)
+        {
+            mxb_log_set_overflow(MXB_LOG_OVERFLOW_BLOCK);
+        }
+        else if (strcmp(value, "drop") == 0)
+        {
+            mxb_log_set_overflow(MXB_LOG_OVERFLOW_DROP);
+        }
+        else
+        {
+            MXS_ERROR("Invalid value for '%s': %s. Allowed values are 'block' and 'drop'.",
+                      CN_LOG_OVERFLOW, value);
+            return 0;
+        }
+    }
     else if (strcmp(name, CN_ADMIN_PORT) == 0)
     {
         gateway.admin_port = atoi(value);
@@ -2569,6 +2600,34 @@ static int handle_global_item(const char* name, const char* value)
         }
         MXS_NOTICE("Writeq low water mark set to: %lu", gateway.writeq_low_water);
     }
+    else if (strcmp(name, CN_REBALANCE_PERIOD) == 0)
+    {
+        char* endptr;
+        int intval = strtol(value, &endptr, 0);
+        if (*endptr == '\0' && intval >= 0)
+        {
+            gateway.rebalance_period = intval;
+        }
+        else
+        {
+            MXS_ERROR("Invalid value for '%s': %s", CN_REBALANCE_PERIOD, value);
+            return 0;
+        }
+    }
+    else if (strcmp(name, CN_REBALANCE_THRESHOLD) == 0)
+    {
+        char* endptr;
+        int intval = strtol(value, &endptr, 0);
+        if (*endptr == '\0' && intval > 0 && intval <= 100)
+        {
+            gateway.rebalance_threshold = intval;
+        }
+        else
+        {
+            MXS_ERROR("Invalid value for '%s': %s", CN_REBALANCE_THRESHOLD, value);
+            return 0;
+        }
+    }
     else if (strcmp(name, CN_RETAIN_LAST_STATEMENTS) == 0)
     {
         char* endptr;
@@ -2716,6 +2775,7 @@ bool config_can_modify_at_runtime(const char* name)
         CN_ADMIN_HOST,
         CN_ADMIN_PORT,
         CN_LOG_THROTTLING,
+        CN_LOG_OVERFLOW,
         "sql_mode",
         CN_QUERY_CLASSIFIER_ARGS,
         CN_QUERY_CLASSIFIER,
@@ -2853,6 +2913,8 @@ void config_set_global_defaults()
     gateway.promoted_at = 0;
     gateway.load_persisted_configs = true;
     gateway.users_refresh_time = USERS_REFRESH_TIME_DEFAULT;
+    gateway.rebalance_period = 0;
+    gateway.rebalance_threshold = DEFAULT_REBALANCE_THRESHOLD;
 
     gateway.peer_hosts[0] = '\0';
     gateway.peer_user[0] = '\0';
@@ -2867,6 +2929,8 @@ void config_set_global_defaults()
         gateway.qc_cache_properties.max_size = -1;
     }
 
+    gateway.qc_cache_properties.shared = false;
+
     gateway.thread_stack_size = 0;
     gateway.writeq_high_water = 0;
     gateway.writeq_low_water = 0;
@@ -4014,7 +4078,8 @@ int create_new_listener(CONFIG_CONTEXT* obj)
                                   0,
                                   authenticator,
                                   authenticator_options,
-                                  ssl_info);
+                                  ssl_info,
+                                  false);
         }
         else if (port)
         {
@@ -4025,7 +4090,8 @@ int create_new_listener(CONFIG_CONTEXT* obj)
                                   atoi(port),
                                   authenticator,
                                   authenticator_options,
-                                  ssl_info);
+                                  ssl_info,
+                                  config_get_bool(obj->parameters, CN_REUSEPORT));
         }
     }
 
@@ -4576,7 +4642,12 @@ json_t* config_maxscale_to_json(const char* host)
     json_object_set_new(param,
                         CN_QUERY_CLASSIFIER_CACHE_SIZE,
                         json_integer(cnf->qc_cache_properties.max_size));
+    json_object_set_new(param,
+                        CN_QUERY_CLASSIFIER_CACHE_SHARED,
+                        json_boolean(cnf->qc_cache_properties.shared));
 
+    json_object_set_new(param, CN_REBALANCE_PERIOD, json_integer(cnf->rebalance_period));
+    json_object_set_new(param, CN_REBALANCE_THRESHOLD, json_integer(cnf->rebalance_threshold));
     json_object_set_new(param, CN_RETAIN_LAST_STATEMENTS, json_integer(session_get_retain_last_statements()));
     json_object_set_new(param, CN_DUMP_LAST_STATEMENTS, json_string(session_get_dump_statements_str()));
     json_object_set_new(param, CN_SESSION_TRACE, json_integer(session_get_session_trace()));
@@ -514,6 +514,20 @@ bool runtime_alter_server(SERVER* server, const char* key, const char* value)
             server->persistmaxtime = atoi(value);
         }
     }
+    else if (strcmp(key, CN_PERSISTPOOLMIN) == 0)
+    {
+        if (is_valid_integer(value))
+        {
+            server->persistpoolmin = atoi(value);
+        }
+    }
+    else if (strcmp(key, CN_PERSISTPINGTIME) == 0)
+    {
+        if (is_valid_integer(value))
+        {
+            server->persistpingtime = atoi(value);
+        }
+    }
     else
     {
         /**
@@ -630,6 +644,13 @@ bool do_alter_monitor(MXS_MONITOR* monitor, const char* key, const char* value)
                                         CN_BACKEND_CONNECT_ATTEMPTS);
         }
     }
+    else if (strcmp(key, CN_PROBE_THREADS) == 0)
+    {
+        if (auto ival = get_positive_int(value))
+        {
+            monitor_set_probe_threads(monitor, ival);
+        }
+    }
     else if (strcmp(key, CN_JOURNAL_MAX_AGE) == 0)
     {
         if (auto ival = get_positive_int(value))
@@ -1054,7 +1075,8 @@ bool runtime_create_listener(Service* service,
                              const char* ssl_ca,
                              const char* ssl_version,
                              const char* ssl_depth,
-                             const char* verify_ssl)
+                             const char* verify_ssl,
+                             const char* reuseport)
 {
 
     if (addr == NULL || strcasecmp(addr, CN_DEFAULT) == 0)
@@ -1082,6 +1104,21 @@ bool runtime_create_listener(Service* service,
         auth_opt = NULL;
     }
 
+    bool reuse = false;
+
+    if (reuseport && strcasecmp(reuseport, CN_DEFAULT) != 0)
+    {
+        int value = config_truth_value(reuseport);
+
+        if (value == -1)
+        {
+            config_runtime_error("Invalid value for '%s': %s", CN_REUSEPORT, reuseport);
+            return false;
+        }
+
+        reuse = value;
+    }
+
     unsigned short u_port = atoi(port);
     bool rval = false;
 
@@ -1114,7 +1151,8 @@ bool runtime_create_listener(Service* service,
                                                             u_port,
                                                             auth,
                                                             auth_opt,
-                                                            ssl);
+                                                            ssl,
+                                                            reuse);
 
             if (listener && listener_serialize(listener))
             {
@@ -2596,6 +2634,7 @@ bool validate_logs_json(json_t* json)
             && runtime_is_bool_or_null(param, "log_warning")
             && runtime_is_bool_or_null(param, "log_notice")
             && runtime_is_bool_or_null(param, "log_debug")
+            && runtime_is_string_or_null(param, CN_LOG_OVERFLOW)
             && runtime_is_count_or_null(param, "throttling/count")
             && runtime_is_count_or_null(param, "throttling/suppress_ms")
             && runtime_is_count_or_null(param, "throttling/window_ms");
@@ -2649,6 +2688,25 @@ bool runtime_alter_logs_from_json(json_t* json)
             mxs_log_set_priority_enabled(LOG_DEBUG, json_boolean_value(value));
         }
 
+        if ((value = mxs_json_pointer(param, CN_LOG_OVERFLOW)))
+        {
+            const char* overflow = json_string_value(value);
+
+            if (strcmp(overflow, "block") == 0)
+            {
+                mxb_log_set_overflow(MXB_LOG_OVERFLOW_BLOCK);
+            }
+            else if (strcmp(overflow, "drop") == 0)
+            {
+                mxb_log_set_overflow(MXB_LOG_OVERFLOW_DROP);
+            }
+            else
+            {
+                config_runtime_error("Invalid value for '%s': %s", CN_LOG_OVERFLOW, overflow);
+                rval = false;
+            }
+        }
+
         if ((param = mxs_json_pointer(param, "throttling")) && json_is_object(param))
         {
             MXS_LOG_THROTTLING throttle;
@@ -2701,6 +2759,7 @@ static bool validate_listener_json(json_t* json)
              && runtime_is_string_or_null(param, CN_ADDRESS)
              && runtime_is_string_or_null(param, CN_AUTHENTICATOR)
              && runtime_is_string_or_null(param, CN_AUTHENTICATOR_OPTIONS)
+             && runtime_is_bool_or_null(param, CN_REUSEPORT)
              && (!have_ssl_json(param) || validate_ssl_json(param, OT_LISTENER)))
     {
         rval = true;
@@ -2731,6 +2790,7 @@ bool runtime_create_listener_from_json(Service* service, json_t* json)
             get_string_or_null(json, MXS_JSON_PTR_PARAM_SSL_CERT_VERIFY_DEPTH);
         const char* ssl_verify_peer_certificate = get_string_or_null(json,
                                                                      MXS_JSON_PTR_PARAM_SSL_VERIFY_PEER_CERT);
+        json_t* reuseport = mxs_json_pointer(json, MXS_JSON_PTR_PARAM_REUSEPORT);
 
         rval = runtime_create_listener(service,
                                        id,
@@ -2744,7 +2804,8 @@ bool runtime_create_listener_from_json(Service* service, json_t* json)
                                        ssl_ca_cert,
                                        ssl_version,
                                        ssl_cert_verify_depth,
-                                       ssl_verify_peer_certificate);
+                                       ssl_verify_peer_certificate,
+                                       reuseport ? (json_is_true(reuseport) ? "true" : "false") : NULL);
     }
 
     return rval;
@@ -25,6 +25,7 @@
 #include <arpa/inet.h>
 #include <errno.h>
 #include <inttypes.h>
+#include <limits.h>
 #include <netinet/tcp.h>
 #include <signal.h>
 #include <stdarg.h>
@@ -35,12 +36,14 @@
 #include <sys/ioctl.h>
 #include <sys/socket.h>
 #include <sys/stat.h>
+#include <sys/uio.h>
 #include <sys/un.h>
 #include <time.h>
 
 #include <maxscale/alloc.h>
 #include <maxbase/atomic.h>
 #include <maxbase/atomic.hh>
+#include <maxbase/stopwatch.hh>
 #include <maxscale/clock.h>
 #include <maxscale/limits.h>
 #include <maxscale/listener.h>
@@ -86,9 +89,41 @@ static struct
 
 static thread_local struct
 {
-    long next_timeout_check;/** When to next check for idle sessions. */
-    DCB* current_dcb;       /** The DCB currently being handled by event handlers. */
+    long   next_timeout_check;/** When to next check for idle sessions. */
+    DCB*   current_dcb;       /** The DCB currently being handled by event handlers. */
+    GWBUF* read_buffer;       /** Recycled buffer into which sockets are read. */
+    DCB_WORKER_SOCKET* accept_socket; /** The worker socket being accepted from, if any. */
+    int64_t accept_start;     /** When the listener event being handled was received, in microseconds. */
+    int     n_accepted;       /** Connections accepted from the worker socket during this event. */
 } this_thread;
+
+/**
+ * The size of the buffer into which a socket is read. Reads that do not fill
+ * the buffer drain the socket, so no FIONREAD probe is needed.
+ */
+const int DCB_READ_BUFFER_SIZE = 16 * 1024;
+
+/**
+ * Reads of at most this many bytes are copied to an exactly sized buffer and
+ * the read buffer is reused. Larger reads are handed over as such, so that
+ * the packets in them can be split off without copying.
+ */
+const int DCB_READ_COPY_LIMIT = 2 * 1024;
+
+/**
+ * The maximum number of connections a worker accepts from its own listening
+ * socket before it returns to epoll_wait(). The socket is level-triggered, so
+ * the remaining connections are accepted on the next round, after the events
+ * of the already established connections have been handled.
+ */
+const int DCB_ACCEPT_BATCH = 64;
+
+int64_t dcb_clock_us()
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+}
 }
 
 static void        dcb_initialize(DCB* dcb);
@@ -99,22 +134,19 @@ static int         dcb_null_auth(DCB* dcb, SERVER* server, MXS_SESSION* session,
 static inline DCB* dcb_find_in_list(DCB* dcb);
 static void        dcb_stop_polling_and_shutdown(DCB* dcb);
 static bool        dcb_maybe_add_persistent(DCB*);
+static void        pool_push_front(SERVER_POOL* pool, DCB* dcb);
 static inline bool dcb_write_parameter_check(DCB* dcb, GWBUF* queue);
-static int         dcb_read_no_bytes_available(DCB* dcb, int nreadtotal);
 static int         dcb_create_SSL(DCB* dcb, SSL_LISTENER* ssl);
 static int         dcb_read_SSL(DCB* dcb, GWBUF** head);
-static GWBUF*      dcb_basic_read(DCB* dcb,
-                                  int bytesavailable,
-                                  int maxbytes,
-                                  int nreadtotal,
-                                  int* nsingleread);
+static GWBUF*      dcb_basic_read(DCB* dcb, int maxbytes, int* nsingleread, bool* drained);
 static GWBUF* dcb_basic_read_SSL(DCB* dcb, int* nsingleread);
 static void   dcb_log_write_failure(DCB* dcb, GWBUF* queue, int eno);
-static int    gw_write(DCB* dcb, GWBUF* writeq, bool* stop_writing);
+static ssize_t gw_write(DCB* dcb, GWBUF* writeq, bool* stop_writing);
 static int    gw_write_SSL(DCB* dcb, GWBUF* writeq, bool* stop_writing);
 static int    dcb_log_errors_SSL(DCB* dcb, int ret);
 static int    dcb_accept_one_connection(DCB* dcb, struct sockaddr* client_conn);
-static int    dcb_listen_create_socket_inet(const char* host, uint16_t port);
+static int    dcb_listen_create_socket_inet(const char* host, uint16_t port, bool reuseport);
+static bool   dcb_listen_create_worker_sockets(DCB* dcb, const char* host, uint16_t port, int fd);
 static int    dcb_listen_create_socket_unix(const char* path);
 static int    dcb_set_socket_option(int sockfd, int level, int optname, void* optval, socklen_t optlen);
 static void   dcb_add_to_all_list(DCB* dcb);
@@ -124,6 +156,7 @@ static DCB*   dcb_find_free();
 static void   dcb_remove_from_list(DCB* dcb);
 
 static uint32_t dcb_poll_handler(MXB_POLL_DATA* data, MXB_WORKER* worker, uint32_t events);
+static uint32_t dcb_worker_socket_handler(MXB_POLL_DATA* data, MXB_WORKER* worker, uint32_t events);
 static uint32_t dcb_process_poll_events(DCB* dcb, uint32_t ev);
 static bool     dcb_session_check(DCB* dcb, const char*);
 static int      upstream_throttle_callback(DCB* dcb, DCB_REASON reason, void* userdata);
@@ -348,6 +381,8 @@ void dcb_free_all_memory(DCB* dcb)
         MXS_FREE(dcb->path);
     }
 
+    MXS_FREE(dcb->worker_sockets);
+
     // Ensure that id is immediately the wrong one.
     dcb->poll.owner = reinterpret_cast<MXB_WORKER*>(0xdeadbeef);
     MXS_FREE(dcb);
@@ -409,13 +444,20 @@ DCB* dcb_connect(SERVER* server, MXS_SESSION* session, const char* protocol)
             MXS_DEBUG("Reusing a persistent connection, dcb %p", dcb);
             dcb->persistentstart = 0;
             dcb->was_persistent = true;
+            dcb->flags &= ~DCBF_POOLABLE;
             dcb->last_read = mxs_clock();
+            dcb->connect_start = 0;
             mxb::atomic::add(&server->stats.n_from_pool, 1, mxb::atomic::RELAXED);
             return dcb;
         }
         else
         {
             MXS_DEBUG("Failed to find a reusable persistent connection");
+
+            if (server->persistpoolmax)
+            {
+                mxb::atomic::add(&server->stats.n_new_conn, 1, mxb::atomic::RELAXED);
+            }
         }
     }
 
@@ -496,6 +538,8 @@ DCB* dcb_connect(SERVER* server, MXS_SESSION* session, const char* protocol)
     dcb->server = server;
 
     dcb->was_persistent = false;
+    dcb->connect_start = std::chrono::duration_cast<std::chrono::microseconds>(
+        mxb::Clock::now().time_since_epoch()).count();
 
     /**
      * backend_dcb is connected to backend server, and once backend_dcb
@@ -559,7 +603,9 @@ DCB* dcb_connect(SERVER* server, MXS_SESSION* session, const char* protocol)
  * @param dcb       The DCB to read from
  * @param head      Pointer to linked list to append data to
  * @param maxbytes  Maximum bytes to read (0 = no limit)
- * @return          -1 on error, otherwise the total number of bytes read
+ * @return          -1 on error, otherwise the total number of bytes read. On error,
+ *                  the list is freed and *head is set to NULL, as the data read
+ *                  before the error is of no use once the connection has failed.
  */
 int dcb_read(DCB* dcb,
              GWBUF** head,
@@ -593,43 +639,41 @@ int dcb_read(DCB* dcb,
         return 0;
     }
 
-    while (0 == maxbytes || nreadtotal < maxbytes)
+    bool drained = false;
+
+    while (!drained && (0 == maxbytes || nreadtotal < maxbytes))
     {
-        int bytes_available;
+        GWBUF* buffer;
+        dcb->last_read = mxs_clock();
 
-        bytes_available = dcb_bytes_readable(dcb);
-        if (bytes_available <= 0)
+        buffer = dcb_basic_read(dcb, maxbytes == 0 ? 0 : maxbytes - nreadtotal, &nsingleread, &drained);
+        if (buffer)
         {
-            return bytes_available < 0 ? -1
-                                       :/** Handle closed client socket */
-                   dcb_read_no_bytes_available(dcb, nreadtotal);
+            nreadtotal += nsingleread;
+            MXS_DEBUG("Read %d bytes from dcb %p in state %s fd %d.",
+                      nsingleread,
+                      dcb,
+                      STRDCBSTATE(dcb->state),
+                      dcb->fd);
+
+            /*< Assign the target server for the gwbuf */
+            buffer->server = dcb->server;
+            /*< Append read data to the gwbuf */
+            *head = gwbuf_append(*head, buffer);
         }
         else
         {
-            GWBUF* buffer;
-            dcb->last_read = mxs_clock();
-
-            buffer = dcb_basic_read(dcb, bytes_available, maxbytes, nreadtotal, &nsingleread);
-            if (buffer)
+            if (nsingleread < 0)
             {
-                nreadtotal += nsingleread;
-                MXS_DEBUG("Read %d bytes from dcb %p in state %s fd %d.",
-                          nsingleread,
-                          dcb,
-                          STRDCBSTATE(dcb->state),
-                          dcb->fd);
-
-                /*< Assign the target server for the gwbuf */
-                buffer->server = dcb->server;
-                /*< Append read data to the gwbuf */
-                *head = gwbuf_append(*head, buffer);
-            }
-            else
-            {
-                break;
+                /** The protocol handles the error, whatever the role of the DCB. The
+                 * callers only free the data they get on success. */
+                gwbuf_free(*head);
+                *head = NULL;
+                return -1;
             }
+            break;
         }
-    }   /*< while (0 == maxbytes || nreadtotal < maxbytes) */
+    }   /*< while (!drained && (0 == maxbytes || nreadtotal < maxbytes)) */
 
     return nreadtotal;
 }
@@ -661,64 +705,55 @@ int dcb_bytes_readable(DCB* dcb)
     }
 }
 
-/**
- * Determine the return code needed when read has run out of data
- *
- * @param dcb           The DCB to read from
- * @param nreadtotal    Number of bytes that have been read
- * @return              -1 on error, 0 for conditions not treated as error
- */
-static int dcb_read_no_bytes_available(DCB* dcb, int nreadtotal)
+void dcb_thread_finish()
 {
-    /** Handle closed client socket */
-    if (nreadtotal == 0 && DCB_ROLE_CLIENT_HANDLER == dcb->dcb_role)
-    {
-        char c;
-        int l_errno = 0;
-        long r = -1;
-
-        /* try to read 1 byte, without consuming the socket buffer */
-        r = recv(dcb->fd, &c, sizeof(char), MSG_PEEK);
-        l_errno = errno;
-
-        if (r <= 0
-            && l_errno != EAGAIN
-            && l_errno != EWOULDBLOCK
-            && l_errno != 0)
-        {
-            return -1;
-        }
-    }
-    return nreadtotal;
+    gwbuf_free(this_thread.read_buffer);
+    this_thread.read_buffer = NULL;
 }
 
 /**
  * Basic read function to carry out a single read operation on the DCB socket.
  *
+ * The data is read into a buffer recycled by the thread. Small reads are
+ * copied out of it, large ones take the buffer over.
+ *
  * @param dcb               The DCB to read from
- * @param bytesavailable    Pointer to linked list to append data to
  * @param maxbytes          Maximum bytes to read (0 = no limit)
- * @param nreadtotal        Total number of bytes already read
- * @param nsingleread       To be set as the number of bytes read this time
+ * @param nsingleread       To be set as the number of bytes read this time,
+ *                          -1 if the socket is in error
+ * @param drained           Set to true if the socket was drained
  * @return                  GWBUF* buffer containing new data, or null.
  */
-static GWBUF* dcb_basic_read(DCB* dcb, int bytesavailable, int maxbytes, int nreadtotal, int* nsingleread)
+static GWBUF* dcb_basic_read(DCB* dcb, int maxbytes, int* nsingleread, bool* drained)
 {
-    GWBUF* buffer;
-    int bufsize = maxbytes == 0 ? bytesavailable : MXS_MIN(bytesavailable, maxbytes - nreadtotal);
+    GWBUF* buffer = NULL;
+    int bufsize = maxbytes == 0 ? DCB_READ_BUFFER_SIZE : MXS_MIN(DCB_READ_BUFFER_SIZE, maxbytes);
 
-    if ((buffer = gwbuf_alloc(bufsize)) == NULL)
+    if (this_thread.read_buffer == NULL
+        && (this_thread.read_buffer = gwbuf_alloc(DCB_READ_BUFFER_SIZE)) == NULL)
     {
-        *nsingleread = -1;
+        *nsingleread = 0;
+        *drained = true;
+        return NULL;
     }
-    else
+
+    GWBUF* read_buffer = this_thread.read_buffer;
+
+    errno = 0;
+    *nsingleread = read(dcb->fd, GWBUF_DATA(read_buffer), bufsize);
+    dcb->stats.n_reads++;
+
+    if (*nsingleread <= 0)
     {
-        *nsingleread = read(dcb->fd, GWBUF_DATA(buffer), bufsize);
-        dcb->stats.n_reads++;
+        *drained = true;
 
-        if (*nsingleread <= 0)
+        if (*nsingleread < 0)
         {
-            if (errno != 0 && errno != EAGAIN && errno != EWOULDBLOCK)
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+            {
+                *nsingleread = 0;
+            }
+            else
             {
                 MXS_ERROR("Read failed, dcb %p in state %s fd %d: %d, %s",
                           dcb,
@@ -727,10 +762,29 @@ static GWBUF* dcb_basic_read(DCB* dcb, int bytesavailable, int maxbytes, int nre
                           errno,
                           mxs_strerror(errno));
             }
-            gwbuf_free(buffer);
-            buffer = NULL;
         }
     }
+    else
+    {
+        *drained = *nsingleread < bufsize;
+
+        if (*nsingleread <= DCB_READ_COPY_LIMIT)
+        {
+            buffer = gwbuf_alloc_and_load(*nsingleread, GWBUF_DATA(read_buffer));
+
+            if (buffer == NULL)
+            {
+                *nsingleread = -1;
+            }
+        }
+        else
+        {
+            buffer = read_buffer;
+            buffer->end = (char*)buffer->start + *nsingleread;
+            this_thread.read_buffer = NULL;
+        }
+    }
+
     return buffer;
 }
 
@@ -783,7 +837,15 @@ static int dcb_read_SSL(DCB* dcb, GWBUF** head)
 
     mxb_assert(gwbuf_length(*head) == (size_t)(start_length + nreadtotal));
 
-    return nsingleread < 0 ? nsingleread : nreadtotal;
+    if (nsingleread < 0)
+    {
+        // As in dcb_read(), the data read before the error is discarded.
+        gwbuf_free(*head);
+        *head = NULL;
+        return nsingleread;
+    }
+
+    return nreadtotal;
 }
 
 /**
@@ -1014,13 +1076,14 @@ int dcb_drain_writeq(DCB* dcb)
         poll_fake_read_event(dcb);
     }
 
-    int total_written = 0;
+    size_t total_written = 0;
+    int n_writes = dcb->stats.n_writes;
     GWBUF* local_writeq = dcb->writeq;
     dcb->writeq = NULL;
 
     while (local_writeq)
     {
-        int written;
+        ssize_t written;
         bool stop_writing = false;
         /* The value put into written will be >= 0 */
         if (dcb->ssl)
@@ -1056,8 +1119,15 @@ int dcb_drain_writeq(DCB* dcb)
         dcb_call_callback(dcb, DCB_REASON_DRAINED);
     }
 
-    mxb_assert(dcb->writeqlen >= (uint32_t)total_written);
+    mxb_assert(dcb->writeqlen >= total_written);
     dcb->writeqlen -= total_written;
+    dcb->stats.n_bytes_written += total_written;
+
+    if (dcb->dcb_role == DCB_ROLE_CLIENT_HANDLER && dcb->listener && total_written > 0)
+    {
+        mxb::atomic::add(&dcb->listener->n_writes, dcb->stats.n_writes - n_writes, mxb::atomic::RELAXED);
+        mxb::atomic::add(&dcb->listener->n_bytes_written, total_written, mxb::atomic::RELAXED);
+    }
 
     if (dcb->high_water_reached && DCB_BELOW_LOW_WATER(dcb))
     {
@@ -1066,7 +1136,7 @@ int dcb_drain_writeq(DCB* dcb)
         dcb->stats.n_low_water++;
     }
 
-    return total_written;
+    return std::min<size_t>(total_written, INT_MAX);
 }
 
 static void log_illegal_dcb(DCB* dcb)
@@ -1260,6 +1330,8 @@ void dcb_final_close(DCB* dcb)
             mxb_assert(rc > 0);
         }
 
+        dcb_close_worker_sockets(dcb);
+
         if (dcb->fd > 0)
         {
             // TODO: How could we get this far with a dcb->fd <= 0?
@@ -1316,12 +1388,12 @@ static bool dcb_maybe_add_persistent(DCB* dcb)
         && strlen(dcb->user)
         && dcb->server
         && dcb->session
-        && session_valid_for_pool(dcb->session)
+        && (session_valid_for_pool(dcb->session) || (dcb->flags & DCBF_POOLABLE))
         && dcb->server->persistpoolmax
         && (dcb->server->status & SERVER_RUNNING)
         && !dcb->dcb_errhandle_called
         && !(dcb->flags & DCBF_HUNG)
-        && dcb_persistent_clean_count(dcb, owner->id(), false) < dcb->server->persistpoolmax)
+        && dcb_persistent_clean_count(dcb->server, owner->id(), false) < dcb->server->persistpoolmax)
     {
         if (!mxb::atomic::add_limited(&dcb->server->stats.n_persistent, 1, (int)dcb->server->persistpoolmax))
         {
@@ -1361,8 +1433,7 @@ static bool dcb_maybe_add_persistent(DCB* dcb)
         dcb->delayq = NULL;
         dcb->writeq = NULL;
 
-        dcb->nextpersistent = dcb->server->persistent[owner->id()];
-        dcb->server->persistent[owner->id()] = dcb;
+        pool_push_front(&dcb->server->persistent[owner->id()], dcb);
         MXB_AT_DEBUG(int rc = ) mxb::atomic::add(&dcb->server->stats.n_current, -1, mxb::atomic::RELAXED);
         mxb_assert(rc > 0);
         return true;
@@ -1428,6 +1499,8 @@ void printDCB(DCB* dcb)
            dcb->stats.n_reads);
     printf("\t\tNo. of Writes:                      %d\n",
            dcb->stats.n_writes);
+    printf("\t\tNo. of Bytes Written:               %" PRId64 "\n",
+           dcb->stats.n_bytes_written);
     printf("\t\tNo. of Buffered Writes:             %d\n",
            dcb->stats.n_buffered);
     printf("\t\tNo. of Accepts:                     %d\n",
@@ -1539,6 +1612,7 @@ void dprintOneDCB(DCB* pdcb, DCB* dcb)
     dcb_printf(pdcb, "\tStatistics:\n");
     dcb_printf(pdcb, "\t\tNo. of Reads:             %d\n", dcb->stats.n_reads);
     dcb_printf(pdcb, "\t\tNo. of Writes:            %d\n", dcb->stats.n_writes);
+    dcb_printf(pdcb, "\t\tNo. of Bytes Written:     %" PRId64 "\n", dcb->stats.n_bytes_written);
     dcb_printf(pdcb, "\t\tNo. of Buffered Writes:   %d\n", dcb->stats.n_buffered);
     dcb_printf(pdcb, "\t\tNo. of Accepts:           %d\n", dcb->stats.n_accepts);
     dcb_printf(pdcb, "\t\tNo. of High Water Events: %d\n", dcb->stats.n_high_water);
@@ -1709,6 +1783,9 @@ void dprintDCB(DCB* pdcb, DCB* dcb)
     dcb_printf(pdcb,
                "\t\tNo. of Writes:                    %d\n",
                dcb->stats.n_writes);
+    dcb_printf(pdcb,
+               "\t\tNo. of Bytes Written:             %" PRId64 "\n",
+               dcb->stats.n_bytes_written);
     dcb_printf(pdcb,
                "\t\tNo. of Buffered Writes:           %d\n",
                dcb->stats.n_buffered);
@@ -1810,6 +1887,7 @@ static int gw_write_SSL(DCB* dcb, GWBUF* writeq, bool* stop_writing)
     int written;
 
     written = SSL_write(dcb->ssl, GWBUF_DATA(writeq), GWBUF_LENGTH(writeq));
+    dcb->stats.n_writes++;
 
     *stop_writing = false;
     switch ((SSL_get_error(dcb->ssl, written)))
@@ -1864,24 +1942,36 @@ static int gw_write_SSL(DCB* dcb, GWBUF* writeq, bool* stop_writing)
 /**
  * Write data to a DCB. The data is taken from the DCB's write queue.
  *
+ * As many buffers of the queue as fit into one vectored write are written
+ * with a single system call. The caller consumes the written bytes from the
+ * queue, which takes care of any partially written buffer.
+ *
  * @param dcb           The DCB to write buffer
  * @param writeq        A buffer list containing the data to be written
  * @param stop_writing  Set to true if the caller should stop writing, false otherwise
  * @return              Number of written bytes
  */
-static int gw_write(DCB* dcb, GWBUF* writeq, bool* stop_writing)
+static ssize_t gw_write(DCB* dcb, GWBUF* writeq, bool* stop_writing)
 {
-    int written = 0;
+    ssize_t written = 0;
     int fd = dcb->fd;
-    size_t nbytes = GWBUF_LENGTH(writeq);
-    void* buf = GWBUF_DATA(writeq);
+    struct iovec iov[IOV_MAX];
+    int niov = 0;
     int saved_errno;
 
+    for (GWBUF* buf = writeq; buf && niov < IOV_MAX; buf = buf->next)
+    {
+        iov[niov].iov_base = GWBUF_DATA(buf);
+        iov[niov].iov_len = GWBUF_LENGTH(buf);
+        ++niov;
+    }
+
     errno = 0;
 
     if (fd > 0)
     {
-        written = write(fd, buf, nbytes);
+        written = writev(fd, iov, niov);
+        dcb->stats.n_writes++;
     }
 
     saved_errno = errno;
@@ -2076,73 +2166,268 @@ void dcb_hangup_foreach(struct server* server)
     RoutingWorker::broadcast_message(MXB_WORKER_MSG_CALL, arg1, arg2);
 }
 
+/**
+ * Add a DCB to the front of a persistent pool
+ *
+ * @param pool  The pool
+ * @param dcb   The DCB to add
+ */
+static void pool_push_front(SERVER_POOL* pool, DCB* dcb)
+{
+    dcb->prevpersistent = NULL;
+    dcb->nextpersistent = pool->head;
+
+    if (pool->head)
+    {
+        pool->head->prevpersistent = dcb;
+    }
+    else
+    {
+        pool->tail = dcb;
+    }
+
+    pool->head = dcb;
+    pool->size++;
+}
+
+/**
+ * Remove a DCB from a persistent pool
+ *
+ * @param pool  The pool
+ * @param dcb   The DCB to remove, must be in the pool
+ */
+static void pool_remove(SERVER_POOL* pool, DCB* dcb)
+{
+    if (dcb->prevpersistent)
+    {
+        dcb->prevpersistent->nextpersistent = dcb->nextpersistent;
+    }
+    else
+    {
+        pool->head = dcb->nextpersistent;
+    }
+
+    if (dcb->nextpersistent)
+    {
+        dcb->nextpersistent->prevpersistent = dcb->prevpersistent;
+    }
+    else
+    {
+        pool->tail = dcb->prevpersistent;
+    }
+
+    dcb->nextpersistent = NULL;
+    dcb->prevpersistent = NULL;
+    pool->size--;
+    mxb::atomic::add(&dcb->server->stats.n_persistent, -1);
+}
+
+/**
+ * Close DCBs that have been removed from a persistent pool
+ *
+ * @param disposals  The DCBs, linked with nextpersistent
+ */
+static void pool_dispose(DCB* disposals)
+{
+    while (disposals)
+    {
+        DCB* next = disposals->nextpersistent;
+        disposals->nextpersistent = NULL;
+        disposals->persistentstart = -1;
+        if (DCB_STATE_POLLING == disposals->state)
+        {
+            dcb_stop_polling_and_shutdown(disposals);
+        }
+        dcb_close(disposals);
+        disposals = next;
+    }
+}
+
+/**
+ * Check whether a pooled DCB can no longer be used
+ *
+ * @param dcb  A DCB in the persistent pool
+ *
+ * @return True, if the DCB must be closed
+ */
+static bool pool_dcb_is_broken(const DCB* dcb)
+{
+    return dcb->dcb_errhandle_called || (dcb->flags & DCBF_HUNG);
+}
+
 /**
  * Check persistent pool for expiry or excess size and count
  *
- * @param dcb           The DCB being closed.
+ * The DCBs are in the order they were pooled in, so the expired ones are
+ * removed from the tail of the pool without looking at the rest of it.
+ * Connections that have failed while in the pool are removed by
+ * dcb_persistent_maintain().
+ *
+ * @param server        The server whose pool is checked
  * @param id            Thread ID
- * @param cleanall      Boolean, if true the whole pool is cleared for the
- *                      server related to the given DCB
+ * @param cleanall      Boolean, if true the whole pool is cleared
  * @return              A count of the DCBs remaining in the pool
  */
-int dcb_persistent_clean_count(DCB* dcb, int id, bool cleanall)
+int dcb_persistent_clean_count(SERVER* server, int id, bool cleanall)
 {
-    int count = 0;
-    if (dcb && dcb->server)
+    SERVER_POOL* pool = &server->persistent[id];
+    DCB* disposals = NULL;
+    time_t now = time(NULL);
+
+    if (!(server->status & SERVER_RUNNING))
     {
-        SERVER* server = dcb->server;
-        DCB* previousdcb = NULL;
-        DCB* persistentdcb, * nextdcb;
-        DCB* disposals = NULL;
+        cleanall = true;
+    }
 
-        persistentdcb = server->persistent[id];
-        while (persistentdcb)
+    while (DCB* dcb = pool->tail)
+    {
+        if (cleanall
+            || pool->size > server->persistpoolmax
+            || pool_dcb_is_broken(dcb)
+            || (pool->size > server->persistpoolmin
+                && (now - dcb->persistentstart) > server->persistmaxtime))
+        {
+            pool_remove(pool, dcb);
+            /* Add removed DCBs to disposal list for processing outside the loop */
+            dcb->nextpersistent = disposals;
+            disposals = dcb;
+        }
+        else
         {
-            nextdcb = persistentdcb->nextpersistent;
-            if (cleanall
-                || persistentdcb->dcb_errhandle_called
-                || count >= server->persistpoolmax
-                || persistentdcb->server == NULL
-                || !(persistentdcb->server->status & SERVER_RUNNING)
-                || (time(NULL) - persistentdcb->persistentstart) > server->persistmaxtime)
+            break;
+        }
+    }
+
+    server->persistmax = MXS_MAX(server->persistmax, pool->size);
+
+    /** Call possible callback for this DCB in case of close */
+    pool_dispose(disposals);
+
+    return pool->size;
+}
+
+DCB* dcb_persistent_take(SERVER* server, int id, const char* user, const char* ip, const char* protocol)
+{
+    SERVER_POOL* pool = &server->persistent[id];
+
+    for (DCB* dcb = pool->head; dcb; dcb = dcb->nextpersistent)
+    {
+        if (dcb->user
+            && dcb->protoname
+            && dcb->remote
+            && ip
+            && !pool_dcb_is_broken(dcb)
+            && !(dcb->flags & DCBF_PINGING)
+            && 0 == strcmp(dcb->user, user)
+            && 0 == strcmp(dcb->remote, ip)
+            && 0 == strcmp(dcb->protoname, protocol))
+        {
+            pool_remove(pool, dcb);
+            return dcb;
+        }
+        else
+        {
+            MXS_DEBUG("%lu [server_get_persistent] Rejected dcb "
+                      "%p from pool, user %s looking for %s, protocol %s "
+                      "looking for %s, hung flag %s, error handle called %s.",
+                      pthread_self(),
+                      dcb,
+                      dcb->user ? dcb->user : "NULL",
+                      user,
+                      dcb->protoname ? dcb->protoname : "NULL",
+                      protocol,
+                      (dcb->flags & DCBF_HUNG) ? "true" : "false",
+                      dcb->dcb_errhandle_called ? "true" : "false");
+        }
+    }
+
+    return NULL;
+}
+
+/**
+ * Send a COM_PING to a pooled DCB. The reply is consumed by the protocol
+ * module, which clears DCBF_PINGING when it arrives.
+ *
+ * @param dcb  A DCB in the persistent pool
+ *
+ * @return True, if the ping was written
+ */
+static bool pool_ping(DCB* dcb)
+{
+    static const uint8_t com_ping_packet[] =
+    {
+        0x01, 0x00, 0x00, 0x00, 0x0e
+    };
+
+    GWBUF* buf = gwbuf_alloc_and_load(sizeof(com_ping_packet), com_ping_packet);
+    bool rval = buf && dcb_write(dcb, buf);
+
+    if (rval)
+    {
+        dcb->flags |= DCBF_PINGING;
+    }
+
+    return rval;
+}
+
+void dcb_persistent_maintain(SERVER* server, int id)
+{
+    SERVER_POOL* pool = &server->persistent[id];
+    DCB* disposals = NULL;
+    int64_t now = mxs_clock();
+    /** Each heartbeat is 1/10th of a second */
+    int64_t ping_time = server->persistpingtime * 10;
+
+    for (DCB* dcb = pool->head; dcb;)
+    {
+        DCB* next = dcb->nextpersistent;
+
+        if (pool_dcb_is_broken(dcb))
+        {
+            pool_remove(pool, dcb);
+            dcb->nextpersistent = disposals;
+            disposals = dcb;
+        }
+        else if (ping_time && now - dcb->last_read > ping_time)
+        {
+            if (dcb->flags & DCBF_PINGING)
             {
-                /* Remove from persistent pool */
-                if (previousdcb)
-                {
-                    previousdcb->nextpersistent = nextdcb;
-                }
-                else
-                {
-                    server->persistent[id] = nextdcb;
-                }
-                /* Add removed DCBs to disposal list for processing outside spinlock */
-                persistentdcb->nextpersistent = disposals;
-                disposals = persistentdcb;
-                mxb::atomic::add(&server->stats.n_persistent, -1);
+                // No reply to the previous ping
+                MXS_INFO("Pooled connection to '%s' did not respond to a ping, closing it.", server->name);
+                dcb->dcb_errhandle_called = true;
+                pool_remove(pool, dcb);
+                dcb->nextpersistent = disposals;
+                disposals = dcb;
             }
-            else
+            else if (!pool_ping(dcb))
             {
-                count++;
-                previousdcb = persistentdcb;
+                dcb->dcb_errhandle_called = true;
             }
-            persistentdcb = nextdcb;
-        }
-        server->persistmax = MXS_MAX(server->persistmax, count);
-
-        /** Call possible callback for this DCB in case of close */
-        while (disposals)
-        {
-            nextdcb = disposals->nextpersistent;
-            disposals->persistentstart = -1;
-            if (DCB_STATE_POLLING == disposals->state)
+            else
             {
-                dcb_stop_polling_and_shutdown(disposals);
+                // The reply updates last_read, this gives the server the same time to reply
+                dcb->last_read = now;
             }
-            dcb_close(disposals);
-            disposals = nextdcb;
         }
+
+        dcb = next;
+    }
+
+    pool_dispose(disposals);
+    dcb_persistent_clean_count(server, id, false);
+}
+
+void dcb_backend_connected(DCB* dcb)
+{
+    if (dcb->server && dcb->connect_start)
+    {
+        int64_t now = std::chrono::duration_cast<std::chrono::microseconds>(
+            mxb::Clock::now().time_since_epoch()).count();
+
+        mxb::atomic::add(&dcb->server->stats.connect_time, now - dcb->connect_start, mxb::atomic::RELAXED);
+        mxb::atomic::add(&dcb->server->stats.n_authenticated, 1, mxb::atomic::RELAXED);
+        dcb->connect_start = 0;
     }
-    return count;
 }
 
 struct dcb_usage_count
@@ -2527,6 +2812,11 @@ DCB* dcb_accept(DCB* dcb)
     if (client_dcb)
     {
         mxb::atomic::add(&client_dcb->service->client_count, 1);
+
+        if (this_thread.accept_start)
+        {
+            listener_add_accept_latency(dcb->listener, dcb_clock_us() - this_thread.accept_start);
+        }
     }
 
     return client_dcb;
@@ -2544,7 +2834,21 @@ DCB* dcb_accept(DCB* dcb)
  */
 static int dcb_accept_one_connection(DCB* dcb, struct sockaddr* client_conn)
 {
-    int c_sock;
+    int c_sock = -1;
+    int fd = dcb->fd;
+
+    if (this_thread.accept_socket)
+    {
+        mxb_assert(this_thread.accept_socket->dcb == dcb);
+
+        if (this_thread.n_accepted == DCB_ACCEPT_BATCH)
+        {
+            // The rest will be accepted once the worker has been around epoll_wait().
+            return -1;
+        }
+
+        fd = this_thread.accept_socket->fd;
+    }
 
     /* Try up to 10 times to get a file descriptor by use of accept */
     for (int i = 0; i < 10; i++)
@@ -2553,9 +2857,10 @@ static int dcb_accept_one_connection(DCB* dcb, struct sockaddr* client_conn)
         int eno = 0;
 
         /* new connection from client */
-        c_sock = accept(dcb->fd,
-                        client_conn,
-                        &client_len);
+        c_sock = accept4(fd,
+                         client_conn,
+                         &client_len,
+                         SOCK_NONBLOCK | SOCK_CLOEXEC);
         eno = errno;
         errno = 0;
 
@@ -2607,6 +2912,7 @@ static int dcb_accept_one_connection(DCB* dcb, struct sockaddr* client_conn)
         }
         else
         {
+            ++this_thread.n_accepted;
             break;
         }
     }
@@ -2641,6 +2947,7 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
     }
 
     int listener_socket = -1;
+    bool reuseport = false;
 
     if (strchr(host, '/'))
     {
@@ -2653,7 +2960,8 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
     }
     else if (port > 0)
     {
-        listener_socket = dcb_listen_create_socket_inet(host, port);
+        reuseport = dcb->listener && dcb->listener->reuseport;
+        listener_socket = dcb_listen_create_socket_inet(host, port, reuseport);
 
         if (listener_socket == -1 && strcmp(host, "::") == 0)
         {
@@ -2661,7 +2969,7 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
             MXS_WARNING("Failed to bind on default IPv6 host '::', attempting "
                         "to bind on IPv4 version '0.0.0.0'");
             strcpy(host, "0.0.0.0");
-            listener_socket = dcb_listen_create_socket_inet(host, port);
+            listener_socket = dcb_listen_create_socket_inet(host, port, reuseport);
         }
     }
     else
@@ -2695,7 +3003,17 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
         return -1;
     }
 
-    MXS_NOTICE("Listening for connections at [%s]:%u with protocol %s", host, port, protocol_name);
+    if (reuseport && !dcb_listen_create_worker_sockets(dcb, host, port, listener_socket))
+    {
+        close(listener_socket);
+        return -1;
+    }
+
+    MXS_NOTICE("Listening for connections at [%s]:%u with protocol %s%s",
+               host,
+               port,
+               protocol_name,
+               reuseport ? ", with a socket per worker" : "");
 
     // assign listener_socket to dcb
     dcb->fd = listener_socket;
@@ -2717,10 +3035,97 @@ int dcb_listen(DCB* dcb, const char* config, const char* protocol_name)
  * @param port The port to listen on
  * @return     The opened socket or -1 on error
  */
-static int dcb_listen_create_socket_inet(const char* host, uint16_t port)
+static int dcb_listen_create_socket_inet(const char* host, uint16_t port, bool reuseport)
 {
     struct sockaddr_storage server_address = {};
-    return open_network_socket(MXS_SOCKET_LISTENER, &server_address, host, port);
+    return open_network_socket(reuseport ? MXS_SOCKET_LISTENER_REUSEPORT : MXS_SOCKET_LISTENER,
+                               &server_address,
+                               host,
+                               port);
+}
+
+/**
+ * @brief Create a listening socket for each routing worker
+ *
+ * All sockets are bound to the same port with SO_REUSEPORT. The already
+ * created socket of the listener is used as the socket of the first worker.
+ *
+ * @param dcb  The listener DCB
+ * @param host The network address to listen on
+ * @param port The port to listen on
+ * @param fd   The listening socket of the listener
+ *
+ * @return True, if all sockets could be created
+ */
+static bool dcb_listen_create_worker_sockets(DCB* dcb, const char* host, uint16_t port, int fd)
+{
+    int n = config_threadcount();
+    DCB_WORKER_SOCKET* sockets = (DCB_WORKER_SOCKET*)MXS_CALLOC(n, sizeof(DCB_WORKER_SOCKET));
+
+    if (!sockets)
+    {
+        return false;
+    }
+
+    sockets[0].fd = fd;
+    int n_created = 1;
+
+    while (n_created < n)
+    {
+        int so = dcb_listen_create_socket_inet(host, port, true);
+
+        if (so == -1)
+        {
+            break;
+        }
+        else if (listen(so, INT_MAX) != 0)
+        {
+            MXS_ERROR("Failed to start listening on [%s]:%u: %d, %s",
+                      host,
+                      port,
+                      errno,
+                      mxs_strerror(errno));
+            close(so);
+            break;
+        }
+
+        sockets[n_created++].fd = so;
+    }
+
+    if (n_created != n)
+    {
+        for (int i = 1; i < n_created; i++)
+        {
+            close(sockets[i].fd);
+        }
+
+        MXS_FREE(sockets);
+        return false;
+    }
+
+    for (int i = 0; i < n; i++)
+    {
+        sockets[i].poll.handler = dcb_worker_socket_handler;
+        sockets[i].dcb = dcb;
+    }
+
+    dcb->worker_sockets = sockets;
+    dcb->n_worker_sockets = n;
+
+    return true;
+}
+
+void dcb_close_worker_sockets(DCB* dcb)
+{
+    // The socket of the first worker is the listening socket of the DCB itself.
+    for (int i = 1; i < dcb->n_worker_sockets; i++)
+    {
+        if (dcb->worker_sockets[i].fd != -1)
+        {
+            close(dcb->worker_sockets[i].fd);
+            dcb->worker_sockets[i].fd = -1;
+        }
+    }
 }
 
 /**
@@ -2901,6 +3306,58 @@ static void dcb_remove_from_list(DCB* dcb)
     dcb->thread.tail = NULL;
 }
 
+bool dcb_can_be_moved(const DCB* dcb)
+{
+    mxb_assert(dcb->poll.owner == RoutingWorker::get_current());
+
+    return dcb->state == DCB_STATE_POLLING
+           && dcb->n_close == 0
+           && dcb->persistentstart == 0
+           && dcb->ssl_state != SSL_HANDSHAKE_REQUIRED
+           && !dcb->writeq
+           && !dcb->delayq
+           && !dcb->readq
+           && !dcb->fakeq
+           && dcb->fake_event == 0
+           && !dcb->high_water_reached;
+}
+
+bool dcb_detach_from_worker(DCB* dcb)
+{
+    Worker* worker = static_cast<Worker*>(dcb->poll.owner);
+    mxb_assert(worker == RoutingWorker::get_current());
+    mxb_assert(dcb->state == DCB_STATE_POLLING);
+
+    bool rv = worker->remove_fd(dcb->fd);
+
+    if (rv)
+    {
+        dcb_remove_from_list(dcb);
+    }
+
+    return rv;
+}
+
+bool dcb_attach_to_worker(DCB* dcb)
+{
+    RoutingWorker* worker = RoutingWorker::get_current();
+    mxb_assert(worker);
+
+    dcb->poll.owner = worker;
+    dcb_add_to_list(dcb);
+
+    // If data arrived while the DCB was detached, adding the descriptor
+    // generates an event for it.
+    bool rv = worker->add_fd(dcb->fd, poll_events, (MXB_POLL_DATA*)dcb);
+
+    if (!rv)
+    {
+        dcb->state = DCB_STATE_NOPOLLING;
+    }
+
+    return rv;
+}
+
 /**
  * Enable the timing out of idle connections.
  */
@@ -3119,8 +3576,13 @@ static uint32_t dcb_process_poll_events(DCB* dcb, uint32_t events)
 
             if (dcb_session_check(dcb, "accept"))
             {
+                this_thread.accept_start = dcb_clock_us();
+                this_thread.n_accepted = 0;
+
                 DCB_EH_NOTICE("Calling dcb->func.accept(%p)", dcb);
                 dcb->func.accept(dcb);
+
+                this_thread.accept_start = 0;
             }
         }
         else
@@ -3273,6 +3735,27 @@ static uint32_t dcb_poll_handler(MXB_POLL_DATA* data, MXB_WORKER* worker, uint32
     return rval;
 }
 
+/**
+ * The handler of the listening socket of a worker. The events are handled as
+ * if they were events of the listener DCB itself, except that connections
+ * are accepted from the socket of the worker.
+ */
+static uint32_t dcb_worker_socket_handler(MXB_POLL_DATA* data, MXB_WORKER* worker, uint32_t events)
+{
+    uint32_t rval = 0;
+    DCB_WORKER_SOCKET* socket = (DCB_WORKER_SOCKET*)data;
+    DCB* dcb = socket->dcb;
+
+    if (dcb->n_close == 0)
+    {
+        this_thread.accept_socket = socket;
+        rval = dcb_handler(dcb, events);
+        this_thread.accept_socket = NULL;
+    }
+
+    return rval;
+}
+
 static bool dcb_is_still_valid(DCB* target, int id)
 {
     bool rval = false;
@@ -3506,6 +3989,42 @@ static bool add_fd_to_routing_workers(int fd, uint32_t events, MXB_POLL_DATA* da
     return rv;
 }
 
+static bool add_worker_sockets_to_routing_workers(DCB* dcb)
+{
+    int n_added = 0;
+
+    while (n_added < dcb->n_worker_sockets)
+    {
+        DCB_WORKER_SOCKET* socket = &dcb->worker_sockets[n_added];
+
+        if (!RoutingWorker::get(n_added)->add_listener_fd(socket->fd, &socket->poll))
+        {
+            break;
+        }
+
+        ++n_added;
+    }
+
+    bool rv = (n_added == dcb->n_worker_sockets);
+
+    if (rv)
+    {
+        // As with shared listening sockets, the DCB itself appears on the
+        // list of the calling thread or, at startup, of the main worker.
+        RoutingWorker* worker = RoutingWorker::get_current();
+        dcb->poll.owner = worker ? worker : RoutingWorker::get(RoutingWorker::MAIN);
+    }
+    else
+    {
+        while (n_added-- > 0)
+        {
+            RoutingWorker::get(n_added)->remove_listener_fd(dcb->worker_sockets[n_added].fd);
+        }
+    }
+
+    return rv;
+}
+
 static bool dcb_add_to_worker(Worker* worker, DCB* dcb, uint32_t events)
 {
     bool rv = false;
@@ -3516,7 +4035,11 @@ static bool dcb_add_to_worker(Worker* worker, DCB* dcb, uint32_t events)
         mxb_assert(dcb->dcb_role == DCB_ROLE_SERVICE_LISTENER);
 
         // A listening DCB, we add it immediately.
-        if (add_fd_to_routing_workers(dcb->fd, events, (MXB_POLL_DATA*)dcb))
+        bool added = dcb->worker_sockets ?
+            add_worker_sockets_to_routing_workers(dcb) :
+            add_fd_to_routing_workers(dcb->fd, events, (MXB_POLL_DATA*)dcb);
+
+        if (added)
         {
             // If this takes place on the main thread (all listening DCBs are
             // stored on the main thread)...
@@ -3705,7 +4228,19 @@ int poll_remove_dcb(DCB* dcb)
     {
         rc = -1;
 
-        if (dcb->dcb_role == DCB_ROLE_SERVICE_LISTENER)
+        if (dcb->dcb_role == DCB_ROLE_SERVICE_LISTENER && dcb->worker_sockets)
+        {
+            rc = 0;
+
+            for (int i = 0; i < dcb->n_worker_sockets; i++)
+            {
+                if (!RoutingWorker::get(i)->remove_listener_fd(dcb->worker_sockets[i].fd))
+                {
+                    rc = -1;
+                }
+            }
+        }
+        else if (dcb->dcb_role == DCB_ROLE_SERVICE_LISTENER)
         {
             if (RoutingWorker::remove_shared_fd(dcbfd))
             {
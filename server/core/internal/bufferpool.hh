@@ -0,0 +1,94 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <maxscale/jansson.hh>
+
+namespace maxscale
+{
+
+/**
+ * @class BufferPool
+ *
+ * A per-thread slab allocator used for the memory of GWBUFs. Each routing
+ * worker has its own pool with a free list per size class. Memory allocated
+ * by a worker and released by another thread is pushed to a lock-free list
+ * of the owning pool, from where the owner reclaims it.
+ *
+ * Threads that have not been bound to a pool allocate directly from the heap.
+ */
+class BufferPool
+{
+public:
+    struct Stats
+    {
+        uint64_t n_alloc = 0;       /*< Number of allocations */
+        uint64_t n_hit = 0;         /*< Allocations served from the pool */
+        uint64_t n_miss = 0;        /*< Allocations served from the heap */
+        uint64_t n_free = 0;        /*< Number of frees by the owning thread */
+        uint64_t n_remote_free = 0; /*< Number of frees reclaimed from other threads */
+        uint64_t n_cached = 0;      /*< Number of blocks currently cached */
+        uint64_t n_cached_bytes = 0;/*< Number of bytes currently cached */
+    };
+
+    /**
+     * Bind the pool of a worker to the calling thread.
+     *
+     * @param id  The id of the routing worker.
+     */
+    static void thread_init(int id);
+
+    /**
+     * Unbind the pool from the calling thread and release the cached memory.
+     */
+    static void thread_finish();
+
+    /**
+     * Reclaim the memory released by other threads. To be called regularly
+     * by the owning thread.
+     */
+    static void tick();
+
+    /**
+     * Allocate memory.
+     *
+     * @param size  The number of bytes needed.
+     *
+     * @return Pointer to memory suitably aligned for any type, or NULL if
+     *         the memory could not be allocated.
+     */
+    static void* alloc(size_t size);
+
+    /**
+     * Release memory returned by @c alloc. May be called from any thread.
+     *
+     * @param ptr  The memory to release, may be NULL.
+     */
+    static void free(void* ptr);
+
+    /**
+     * Return the statistics of the pool of the calling thread.
+     *
+     * @return The statistics, all zeroes if the thread has no pool.
+     */
+    static Stats get_stats();
+
+    /**
+     * Return the statistics of the pool of the calling thread as json.
+     *
+     * @return A json object.
+     */
+    static json_t* get_stats_as_json();
+};
+}
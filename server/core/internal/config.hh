@@ -30,6 +30,7 @@
 #define DEFAULT_NTHREADS            1       /**< Default number of polling threads */
 #define DEFAULT_QUERY_RETRIES       1       /**< Number of retries for interrupted queries */
 #define DEFAULT_QUERY_RETRY_TIMEOUT 5       /**< Timeout for query retries */
+#define DEFAULT_REBALANCE_THRESHOLD 20      /**< Worker load difference that triggers rebalancing */
 #define MIN_WRITEQ_HIGH_WATER       4096UL  /**< Min high water mark of dcb write queue */
 #define MIN_WRITEQ_LOW_WATER        512UL   /**< Min low water mark of dcb write queue */
 
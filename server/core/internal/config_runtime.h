@@ -181,6 +181,7 @@ bool runtime_alter_maxscale(const char* name, const char* value);
  * @param ssl_version SSL version, NULL for default of "MAX"
  * @param ssl_depth   SSL cert verification depth, NULL for default
  * @param verify_ssl  SSL peer certificate verification, NULL for default
+ * @param reuseport   Socket per worker, NULL for default of false
  *
  * @return True if the listener was successfully created and started
  */
@@ -196,7 +197,8 @@ bool runtime_create_listener(Service* service,
                              const char* ssl_ca,
                              const char* ssl_version,
                              const char* ssl_depth,
-                             const char* verify_ssl);
+                             const char* verify_ssl,
+                             const char* reuseport);
 
 /**
  * @brief Destroy a listener
@@ -13,10 +13,80 @@
 #pragma once
 
 #include <maxscale/dcb.h>
+#include <maxscale/server.h>
 
 MXS_BEGIN_DECLS
 
 void dcb_free_all_memory(DCB* dcb);
 void dcb_final_close(DCB* dcb);
 
+/**
+ * Release the resources the calling thread has allocated for DCB handling.
+ */
+void dcb_thread_finish();
+
+/**
+ * Close the sockets the routing workers use for accepting connections to a
+ * listener that uses SO_REUSEPORT. The listening socket of the DCB itself is
+ * not closed.
+ *
+ * @param dcb  A listener DCB.
+ */
+void dcb_close_worker_sockets(DCB* dcb);
+
+/**
+ * Check whether a DCB can be moved to another worker. That is the case if it
+ * is being polled and has no queued data.
+ *
+ * @param dcb  A client or backend DCB, owned by the calling worker.
+ *
+ * @return True, if the DCB can be moved.
+ */
+bool dcb_can_be_moved(const DCB* dcb);
+
+/**
+ * Remove a DCB from the epoll instance and the DCB list of the calling
+ * worker, so that it can be attached to another worker.
+ *
+ * @param dcb  A DCB owned by the calling worker.
+ *
+ * @return True, if the DCB could be detached.
+ */
+bool dcb_detach_from_worker(DCB* dcb);
+
+/**
+ * Add a detached DCB to the epoll instance and the DCB list of the calling
+ * worker, which becomes the owner of the DCB.
+ *
+ * @param dcb  A DCB detached with dcb_detach_from_worker().
+ *
+ * @return True, if the DCB could be attached. If not, the DCB is owned by
+ *         the calling worker but not polled, and should be closed.
+ */
+bool dcb_attach_to_worker(DCB* dcb);
+
+/**
+ * Take a DCB from the persistent pool of the calling worker.
+ *
+ * @param server    The server.
+ * @param id        The id of the calling worker.
+ * @param user      The user the connection is needed for.
+ * @param ip        The address of the client.
+ * @param protocol  The protocol of the connection.
+ *
+ * @return A DCB that was authenticated with @c user for a client from @c ip,
+ *         or NULL if the pool has none.
+ */
+DCB* dcb_persistent_take(SERVER* server, int id, const char* user, const char* ip, const char* protocol);
+
+/**
+ * Check the health of the pooled connections of a worker. Connections that have
+ * failed or not replied to a ping are closed, connections that have been idle for
+ * longer than `persistpingtime` are pinged and the expired ones are evicted.
+ *
+ * @param server  The server.
+ * @param id      The id of the calling worker.
+ */
+void dcb_persistent_maintain(SERVER* server, int id);
+
 MXS_END_DECLS
@@ -124,6 +124,7 @@ void monitor_set_interval(MXS_MONITOR*, unsigned long);
 bool monitor_set_network_timeout(MXS_MONITOR*, int, int, const char*);
 void monitor_set_journal_max_age(MXS_MONITOR* mon, time_t value);
 void monitor_set_script_timeout(MXS_MONITOR* mon, uint32_t value);
+void monitor_set_probe_threads(MXS_MONITOR* mon, int value);
 
 /**
  * @brief Serialize a monitor to a file
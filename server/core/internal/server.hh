@@ -56,3 +56,11 @@ private:
 };
 
 void server_free(Server* server);
+
+/**
+ * Check the persistent connections of all servers that belong to a worker.
+ * Called periodically by every routing worker.
+ *
+ * @param id  The id of the calling worker
+ */
+void server_maintain_persistent_pools(int id);
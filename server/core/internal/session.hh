@@ -144,6 +144,32 @@ public:
         return m_dcb_set;
     }
 
+    /**
+     * Check whether the session can be moved to another worker. Only sessions
+     * of routers that declare RCAP_TYPE_SESSION_MIGRATION and that have no
+     * filters can be moved, and only if the client protocol reports the
+     * connection as idle and no transaction is open.
+     *
+     * @return True, if the session can be moved.
+     */
+    bool can_be_moved() const;
+
+    /**
+     * Detach the client and backend DCBs of the session from the calling
+     * worker. If not all of them can be detached, none is.
+     *
+     * @return True, if the DCBs were detached.
+     */
+    bool detach_from_worker();
+
+    /**
+     * Attach the DCBs of a detached session to the calling worker.
+     *
+     * @return True, if all DCBs could be attached. If not, the session
+     *         should be closed.
+     */
+    bool attach_to_worker();
+
 private:
     FilterList        m_filters;
     SessionVarsByName m_variables;
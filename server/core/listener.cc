@@ -33,6 +33,7 @@
 #include <fcntl.h>
 #include <string>
 
+#include <maxbase/atomic.hh>
 #include <maxscale/listener.h>
 #include <maxscale/paths.h>
 #include <maxscale/ssl.h>
@@ -56,6 +57,7 @@ static RSA* tmp_rsa_callback(SSL* s, int is_export, int keylength);
  * @param authenticator Name of the authenticator to be used
  * @param options       Authenticator options
  * @param ssl           SSL configuration
+ * @param reuseport     Whether each worker listens with a socket of its own
  * @return      New listener object or NULL if unable to allocate
  */
 SERV_LISTENER* listener_alloc(struct service* service,
@@ -65,7 +67,8 @@ SERV_LISTENER* listener_alloc(struct service* service,
                               unsigned short port,
                               const char* authenticator,
                               const char* auth_options,
-                              SSL_LISTENER* ssl)
+                              SSL_LISTENER* ssl,
+                              bool reuseport)
 {
     char* my_address = NULL;
     if (address)
@@ -142,6 +145,10 @@ SERV_LISTENER* listener_alloc(struct service* service,
     proto->users = NULL;
     proto->next = NULL;
     proto->auth_instance = auth_instance;
+    proto->n_writes = 0;
+    proto->n_bytes_written = 0;
+    proto->reuseport = reuseport;
+    memset(proto->accept_latency, 0, sizeof(proto->accept_latency));
     pthread_mutex_init(&proto->lock, NULL);
 
     return proto;
@@ -500,6 +507,11 @@ static bool create_listener_config(const SERV_LISTENER* listener, const char* fi
         dprintf(file, "authenticator_options=%s\n", listener->auth_options);
     }
 
+    if (listener->reuseport)
+    {
+        dprintf(file, "%s=true\n", CN_REUSEPORT);
+    }
+
     if (listener->ssl)
     {
         write_ssl_config(file, listener->ssl);
@@ -560,6 +572,7 @@ json_t* listener_to_json(const SERV_LISTENER* listener)
     json_object_set_new(param, "protocol", json_string(listener->protocol));
     json_object_set_new(param, "authenticator", json_string(listener->authenticator));
     json_object_set_new(param, "auth_options", json_string(listener->auth_options));
+    json_object_set_new(param, CN_REUSEPORT, json_boolean(listener->reuseport));
 
     if (listener->ssl)
     {
@@ -578,6 +591,31 @@ json_t* listener_to_json(const SERV_LISTENER* listener)
     json_object_set_new(attr, CN_STATE, json_string(listener_state_to_string(listener)));
     json_object_set_new(attr, CN_PARAMETERS, param);
 
+    int64_t n_writes = mxb::atomic::load(&listener->n_writes, mxb::atomic::RELAXED);
+    int64_t n_bytes = mxb::atomic::load(&listener->n_bytes_written, mxb::atomic::RELAXED);
+
+    json_t* stats = json_object();
+    json_object_set_new(stats, "writes", json_integer(n_writes));
+    json_object_set_new(stats, "bytes_written", json_integer(n_bytes));
+    json_object_set_new(stats, "writes_per_kilobyte",
+                        json_real(n_bytes ? (1024.0 * n_writes) / n_bytes : 0.0));
+
+    json_t* latency = json_array();
+
+    for (int i = 0; i < LISTENER_ACCEPT_LATENCY_BUCKETS; i++)
+    {
+        json_t* bucket = json_object();
+        bool last = i == LISTENER_ACCEPT_LATENCY_BUCKETS - 1;
+        int64_t count = mxb::atomic::load(&listener->accept_latency[i], mxb::atomic::RELAXED);
+
+        json_object_set_new(bucket, "below_microseconds", last ? json_null() : json_integer(1 << i));
+        json_object_set_new(bucket, "count", json_integer(count));
+        json_array_append_new(latency, bucket);
+    }
+
+    json_object_set_new(stats, "accept_latency", latency);
+    json_object_set_new(attr, "statistics", stats);
+
     if (listener->listener->authfunc.diagnostic_json)
     {
         json_t* diag = listener->listener->authfunc.diagnostic_json(listener);
@@ -596,6 +634,18 @@ json_t* listener_to_json(const SERV_LISTENER* listener)
     return rval;
 }
 
+void listener_add_accept_latency(SERV_LISTENER* listener, int64_t microseconds)
+{
+    int i = 0;
+
+    while (i < LISTENER_ACCEPT_LATENCY_BUCKETS - 1 && microseconds >= (1 << i))
+    {
+        ++i;
+    }
+
+    mxb::atomic::add(&listener->accept_latency[i], 1, mxb::atomic::RELAXED);
+}
+
 void listener_set_active(SERV_LISTENER* listener, bool active)
 {
     atomic_store_int32(&listener->active, active ? 1 : 0);
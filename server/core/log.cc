@@ -125,11 +125,18 @@ json_t* mxs_logs_to_json(const char* host)
     json_object_set_new(param, "log_info", json_boolean(mxb_log_is_priority_enabled(LOG_INFO)));
     json_object_set_new(param, "log_debug", json_boolean(mxb_log_is_priority_enabled(LOG_DEBUG)));
     json_object_set_new(param, "log_to_shm", json_boolean(false));
+    json_object_set_new(param, CN_LOG_OVERFLOW,
+                        json_string(mxb_log_get_overflow() == MXB_LOG_OVERFLOW_DROP ? "drop" : "block"));
+
+    MXB_LOG_STATS stats;
+    mxb_log_get_stats(&stats);
 
     json_t* attr = json_object();
     json_object_set_new(attr, CN_PARAMETERS, param);
     json_object_set_new(attr, "log_file", json_string(mxb_log_get_filename()));
     json_object_set_new(attr, "log_priorities", get_log_priorities());
+    json_object_set_new(attr, "dropped_messages", json_integer(stats.dropped));
+    json_object_set_new(attr, "blocked_writes", json_integer(stats.blocked));
 
     json_t* data = json_object();
     json_object_set_new(data, CN_ATTRIBUTES, attr);
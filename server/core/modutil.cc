@@ -23,6 +23,13 @@
 #include <mutex>
 #include <functional>
 #include <cctype>
+#include <vector>
+
+#if defined (__AVX2__)
+#include <immintrin.h>
+#elif defined (__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include <maxscale/alloc.h>
 #include <maxscale/buffer.h>
@@ -1426,11 +1433,423 @@ mxs::Buffer::iterator find_char(mxs::Buffer::iterator it, const mxs::Buffer::ite
     return it;
 }
 
+/**
+ * The contiguous fast path of get_canonical(). The logic is identical to that
+ * of the iterator based version below, but runs of ordinary characters, quoted
+ * strings and comments are located using memchr() or vector instructions and
+ * the result is assembled in a reusable thread-local buffer.
+ */
+namespace canonical
+{
+
+// Above this size the thread-local buffer is released after use, so that a
+// single huge statement does not pin the memory for the lifetime of the thread.
+const size_t MAX_RETAINED_SIZE = 1024 * 1024;
+
+thread_local std::vector<char> this_thread_buffer;
+
+#if defined (__AVX2__) || defined (__SSE2__)
+#if defined (__AVX2__)
+typedef __m256i vec_t;
+#define VEC_LOADU(p)      _mm256_loadu_si256((const __m256i*)(p))
+#define VEC_STOREU(p, a)  _mm256_storeu_si256((__m256i*)(p), a)
+#define VEC_SET1(c)       _mm256_set1_epi8(c)
+#define VEC_CMPEQ(a, b)   _mm256_cmpeq_epi8(a, b)
+#define VEC_OR(a, b)      _mm256_or_si256(a, b)
+#define VEC_AND(a, b)     _mm256_and_si256(a, b)
+#define VEC_MIN(a, b)     _mm256_min_epu8(a, b)
+#define VEC_MAX(a, b)     _mm256_max_epu8(a, b)
+#define VEC_MOVEMASK(a)   (uint32_t)_mm256_movemask_epi8(a)
+#else
+typedef __m128i vec_t;
+#define VEC_LOADU(p)      _mm_loadu_si128((const __m128i*)(p))
+#define VEC_STOREU(p, a)  _mm_storeu_si128((__m128i*)(p), a)
+#define VEC_SET1(c)       _mm_set1_epi8(c)
+#define VEC_CMPEQ(a, b)   _mm_cmpeq_epi8(a, b)
+#define VEC_OR(a, b)      _mm_or_si128(a, b)
+#define VEC_AND(a, b)     _mm_and_si128(a, b)
+#define VEC_MIN(a, b)     _mm_min_epu8(a, b)
+#define VEC_MAX(a, b)     _mm_max_epu8(a, b)
+#define VEC_MOVEMASK(a)   (uint32_t)_mm_movemask_epi8(a)
+#endif
+
+const size_t VEC_SIZE = sizeof(vec_t);
+
+// True for the bytes within [lo, hi].
+static inline vec_t in_range(vec_t v, char lo, char hi)
+{
+    return VEC_AND(VEC_CMPEQ(VEC_MAX(v, VEC_SET1(lo)), v),
+                   VEC_CMPEQ(VEC_MIN(v, VEC_SET1(hi)), v));
+}
+
+// The vector equivalent of is_special(), valid for the C locale.
+static inline uint32_t special_mask(vec_t v)
+{
+    vec_t m = VEC_OR(in_range(v, '0', '9'), in_range(v, '\t', '\r'));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1(' ')));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1('"')));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1('\'')));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1('`')));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1('#')));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1('-')));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1('/')));
+    m = VEC_OR(m, VEC_CMPEQ(v, VEC_SET1('\\')));
+    return VEC_MOVEMASK(m);
+}
+#else
+const size_t VEC_SIZE = 0;
+#endif
+
+// Runs shorter than this, which dominate in e.g. the VALUES list of an INSERT,
+// are faster to handle one character at a time.
+const ptrdiff_t SCALAR_PREFIX = 8;
+
+/**
+ * Copy characters up to the first one for which is_special() is true. Whole
+ * vectors are stored, so the output must have VEC_SIZE bytes of slack.
+ *
+ * @param it    Start of input.
+ * @param end   End of input.
+ * @param pOut  The output, advanced past the copied characters.
+ *
+ * @return The first special character or @c end.
+ */
+static inline const uint8_t* copy_until_special(const uint8_t* it, const uint8_t* end, char** pOut)
+{
+    char* out = *pOut;
+    const uint8_t* prefix_end = it + std::min(SCALAR_PREFIX, end - it);
+
+    while (it != prefix_end && !is_special(*it))
+    {
+        *out++ = *it++;
+    }
+
+#if defined (__AVX2__) || defined (__SSE2__)
+    if (it == prefix_end)
+    {
+        while (end - it >= (ptrdiff_t)VEC_SIZE)
+        {
+            vec_t v = VEC_LOADU(it);
+            uint32_t mask = special_mask(v);
+            VEC_STOREU(out, v);
+
+            if (mask)
+            {
+                int n = __builtin_ctz(mask);
+                it += n;
+                out += n;
+                *pOut = out;
+                return it;
+            }
+
+            it += VEC_SIZE;
+            out += VEC_SIZE;
+        }
+    }
+#endif
+
+    while (it != end && !is_special(*it))
+    {
+        *out++ = *it++;
+    }
+
+    *pOut = out;
+    return it;
+}
+
+/**
+ * Find the first occurrence of either @c a or @c b.
+ */
+static inline const uint8_t* find_either(const uint8_t* it, const uint8_t* end, char a, char b)
+{
+    const uint8_t* prefix_end = it + std::min(SCALAR_PREFIX, end - it);
+
+    for (; it != prefix_end; ++it)
+    {
+        if (*it == a || *it == b)
+        {
+            return it;
+        }
+    }
+
+#if defined (__AVX2__) || defined (__SSE2__)
+    vec_t va = VEC_SET1(a);
+    vec_t vb = VEC_SET1(b);
+
+    while (end - it >= (ptrdiff_t)VEC_SIZE)
+    {
+        vec_t v = VEC_LOADU(it);
+        uint32_t mask = VEC_MOVEMASK(VEC_OR(VEC_CMPEQ(v, va), VEC_CMPEQ(v, vb)));
+
+        if (mask)
+        {
+            return it + __builtin_ctz(mask);
+        }
+
+        it += VEC_SIZE;
+    }
+#endif
+
+    while (it != end && *it != a && *it != b)
+    {
+        ++it;
+    }
+
+    return it;
+}
+
+// The equivalent of find_char().
+static inline const uint8_t* find_char(const uint8_t* it, const uint8_t* end, char c)
+{
+    while ((it = find_either(it, end, c, '\\')) != end && *it == '\\')
+    {
+        if (++it == end)
+        {
+            break;
+        }
+
+        ++it;
+    }
+
+    return it;
+}
+
+static inline bool is_next(const uint8_t* it, const uint8_t* end, const char* zStr)
+{
+    mxb_assert(it != end);
+    size_t len = strlen(zStr);
+    return (size_t)(end - it) >= len && memcmp(it, zStr, len) == 0;
+}
+
+// The equivalent of probe_number(). Returns NULL if the digits do not form a number.
+static const uint8_t* probe_number(const uint8_t* it, const uint8_t* end)
+{
+    mxb_assert(it != end);
+    mxb_assert(is_digit(*it));
+    const uint8_t* last = it;
+    bool is_hex = *it == '0';
+    bool allow_hex = false;
+
+    // Skip the first character, we know it's a number
+    it++;
+
+    while (it != end)
+    {
+        if (is_digit(*it) || (allow_hex && is_xdigit(*it)))
+        {
+            // Digit or hex-digit, skip it
+        }
+        else if (is_hex && (*it == 'x' || *it == 'X'))
+        {
+            is_hex = false;
+            allow_hex = true;
+        }
+        else if (*it == 'e')
+        {
+            // Possible scientific notation number
+            const uint8_t* next_it = it + 1;
+
+            if (next_it == end || (!is_digit(*next_it) && *next_it != '-'))
+            {
+                return nullptr;
+            }
+
+            // Skip over the minus if we have one
+            if (*next_it == '-')
+            {
+                it++;
+            }
+        }
+        else if (*it == '.')
+        {
+            // Possible decimal number
+            const uint8_t* next_it = it + 1;
+
+            if (next_it != end && !is_digit(*next_it))
+            {
+                return nullptr;
+            }
+        }
+        else
+        {
+            // If we have a non-text character, we treat it as a number
+            return is_alpha(*it) ? nullptr : last;
+        }
+
+        last = it;
+        it++;
+    }
+
+    return last;
+}
+
+static std::string get_canonical(const uint8_t* it, const uint8_t* end)
+{
+    std::vector<char>& buffer = this_thread_buffer;
+
+    if (buffer.size() < (size_t)(end - it) + VEC_SIZE)
+    {
+        buffer.resize((end - it) + VEC_SIZE);
+    }
+
+    char* rval = buffer.data();
+    int i = 0;
+
+    while (it != end)
+    {
+        char* out = rval + i;
+        it = copy_until_special(it, end, &out);
+        i = out - rval;
+
+        if (it == end)
+        {
+            break;
+        }
+
+        if (*it == '\\')
+        {
+            // Jump over any escaped values
+            rval[i++] = *it++;
+
+            if (it != end)
+            {
+                rval[i++] = *it;
+            }
+            else
+            {
+                // Query that ends with a backslash
+                break;
+            }
+        }
+        else if (is_space(*it))
+        {
+            if (i == 0 || is_space(rval[i - 1]))
+            {
+                // Leading or repeating whitespace, skip it
+            }
+            else
+            {
+                rval[i++] = ' ';
+            }
+        }
+        else if (*it == '/' && is_next(it, end, "/*"))
+        {
+            const uint8_t* comment_start = it + 2;
+
+            if (comment_start == end)
+            {
+                break;
+            }
+            else if (*comment_start != '!' && *comment_start != 'M')
+            {
+                // Non-executable comment, continue after the end marker
+                const uint8_t* star = it;
+
+                while ((star = (const uint8_t*)memchr(star, '*', end - star)) && !is_next(star, end, "*/"))
+                {
+                    ++star;
+                }
+
+                if (!star)
+                {
+                    break;
+                }
+
+                it = star + 1;
+            }
+            else
+            {
+                // Executable comment, treat it as normal SQL
+                rval[i++] = *it;
+            }
+        }
+        else if ((*it == '#' || *it == '-') && (is_next(it, end, "# ") || is_next(it, end, "-- ")))
+        {
+            // End-of-line comment, jump to the next line if one exists
+            it = find_either(it, end, '\n', '\r');
+
+            if (it == end)
+            {
+                break;
+            }
+            else if (*it == '\r' && is_next(it, end, "\r\n"))
+            {
+                ++it;
+            }
+        }
+        else if (is_digit(*it) && (i == 0 || (!is_alnum(rval[i - 1]) && rval[i - 1] != '_')))
+        {
+            const uint8_t* num_end = probe_number(it, end);
+
+            if (num_end)
+            {
+                if (i > 0 && rval[i - 1] == '-')
+                {
+                    // Remove the sign, see is_negation().
+                    i--;
+                }
+                rval[i++] = '?';
+                it = num_end;
+            }
+        }
+        else if (*it == '\'' || *it == '"')
+        {
+            if ((it = find_char(it + 1, end, *it)) == end)
+            {
+                break;
+            }
+            rval[i++] = '?';
+        }
+        else if (*it == '`')
+        {
+            const uint8_t* start = it;
+
+            if ((it = find_char(it + 1, end, '`')) == end)
+            {
+                break;
+            }
+            memcpy(rval + i, start, it - start);
+            i += it - start;
+            rval[i++] = '`';
+        }
+        else
+        {
+            rval[i++] = *it;
+        }
+
+        mxb_assert(it != end);
+        ++it;
+    }
+
+    // Remove trailing whitespace
+    while (i > 0 && is_space(rval[i - 1]))
+    {
+        --i;
+    }
+
+    std::string canonical(rval, i);
+
+    if (buffer.size() > MAX_RETAINED_SIZE)
+    {
+        std::vector<char>().swap(buffer);
+    }
+
+    return canonical;
+}
+}
+
 namespace maxscale
 {
 
 std::string get_canonical(GWBUF* querybuf)
 {
+    if (GWBUF_IS_CONTIGUOUS(querybuf) && GWBUF_LENGTH(querybuf) > MYSQL_HEADER_LEN)
+    {
+        const uint8_t* data = GWBUF_DATA(querybuf);
+        // Skip packet header and command
+        return canonical::get_canonical(data + MYSQL_HEADER_LEN + 1, data + GWBUF_LENGTH(querybuf));
+    }
+
     std::string rval;
     int i = 0;
     rval.resize(gwbuf_length(querybuf) - MYSQL_HEADER_LEN + 1);
@@ -28,6 +28,8 @@
 #include <sys/stat.h>
 #include <vector>
 #include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include <maxscale/alloc.h>
 #include <maxbase/atomic.hh>
@@ -77,6 +79,7 @@ const char CN_DISK_SPACE_CHECK_INTERVAL[] = "disk_space_check_interval";
 const char CN_EVENTS[] = "events";
 const char CN_JOURNAL_MAX_AGE[] = "journal_max_age";
 const char CN_MONITOR_INTERVAL[] = "monitor_interval";
+const char CN_PROBE_THREADS[] = "probe_threads";
 const char CN_SCRIPT[] = "script";
 const char CN_SCRIPT_TIMEOUT[] = "script_timeout";
 
@@ -136,6 +139,7 @@ MXS_MONITOR* monitor_create(const char* name, const char* module, MXS_CONFIG_PAR
     mon->connect_timeout = config_get_integer(params, CN_BACKEND_CONNECT_TIMEOUT);
     mon->connect_attempts = config_get_integer(params, CN_BACKEND_CONNECT_ATTEMPTS);
     mon->interval = config_get_integer(params, CN_MONITOR_INTERVAL);
+    mon->probe_threads = config_get_integer(params, CN_PROBE_THREADS);
     mon->journal_max_age = config_get_integer(params, CN_JOURNAL_MAX_AGE);
     mon->script_timeout = config_get_integer(params, CN_SCRIPT_TIMEOUT);
     mon->script = config_get_string(params, CN_SCRIPT);
@@ -386,6 +390,7 @@ bool monitor_add_server(MXS_MONITOR* mon, SERVER* server)
         db->log_version_err = true;
         // Pretend disk space was just checked.
         db->disk_space_checked = maxscale::MonitorInstance::get_time_ms();
+        db->probe_time = 0;
 
 
         /** Server status is uninitialized */
@@ -558,6 +563,7 @@ void monitor_show(DCB* dcb, MXS_MONITOR* monitor)
     dcb_printf(dcb, "Read Timeout:           %i seconds\n", monitor->read_timeout);
     dcb_printf(dcb, "Write Timeout:          %i seconds\n", monitor->write_timeout);
     dcb_printf(dcb, "Connect attempts:       %i \n", monitor->connect_attempts);
+    dcb_printf(dcb, "Probe threads:          %i \n", monitor->probe_threads);
     dcb_printf(dcb, "Monitored servers:      ");
 
     const char* sep = "";
@@ -568,6 +574,18 @@ void monitor_show(DCB* dcb, MXS_MONITOR* monitor)
         sep = ", ";
     }
 
+    dcb_printf(dcb, "\n");
+    dcb_printf(dcb, "Latest probe times:     ");
+
+    sep = "";
+
+    for (MXS_MONITORED_SERVER* db = monitor->monitored_servers; db; db = db->next)
+    {
+        dcb_printf(dcb, "%s%s: %.1fms", sep, db->server->name,
+                   mxb::atomic::load(&db->probe_time, mxb::atomic::RELAXED) / 1000.0);
+        sep = ", ";
+    }
+
     dcb_printf(dcb, "\n");
 
     if (monitor->instance)
@@ -685,6 +703,11 @@ void monitor_set_script_timeout(MXS_MONITOR* mon, uint32_t value)
     mon->script_timeout = value;
 }
 
+void monitor_set_probe_threads(MXS_MONITOR* mon, int value)
+{
+    mon->probe_threads = value;
+}
+
 /**
  * Set Monitor timeouts for connect/read/write
  *
@@ -1817,6 +1840,16 @@ json_t* monitor_json_data(const MXS_MONITOR* monitor, const char* host)
     /** Monitor parameters */
     json_object_set_new(attr, CN_PARAMETERS, monitor_parameters_to_json(monitor));
 
+    json_t* probe_times = json_object();
+
+    for (MXS_MONITORED_SERVER* db = monitor->monitored_servers; db; db = db->next)
+    {
+        json_object_set_new(probe_times, db->server->name,
+                            json_integer(mxb::atomic::load(&db->probe_time, mxb::atomic::RELAXED)));
+    }
+
+    json_object_set_new(attr, "probe_times", probe_times);
+
     if (monitor->instance && monitor->api->diagnostics_json
         && monitor->state == MONITOR_STATE_RUNNING)
     {
@@ -2516,6 +2549,135 @@ void monitor_debug_wait()
 namespace maxscale
 {
 
+/**
+ * Threads that help the monitor thread to probe the servers. The work of one
+ * round of probing is handed out one item at a time, so a slow server only
+ * occupies one thread.
+ */
+class MonitorInstance::ProbeThreads
+{
+public:
+    ProbeThreads(const ProbeThreads&) = delete;
+    ProbeThreads& operator=(const ProbeThreads&) = delete;
+
+    ProbeThreads(const char* zName, int n_threads)
+    {
+        for (int i = 0; i < n_threads; ++i)
+        {
+            try
+            {
+                m_threads.emplace_back(&ProbeThreads::run, this);
+            }
+            catch (const std::system_error& x)
+            {
+                MXS_WARNING("Could create only %d of the %d probe threads of monitor '%s': %s",
+                            i, n_threads, zName, x.what());
+                break;
+            }
+        }
+    }
+
+    ~ProbeThreads()
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_stop = true;
+        guard.unlock();
+
+        m_work_cond.notify_all();
+
+        for (auto& thread : m_threads)
+        {
+            thread.join();
+        }
+    }
+
+    void execute(size_t n, const std::function<void(size_t)>& func)
+    {
+        std::unique_lock<std::mutex> guard(m_lock);
+        m_func = &func;
+        m_n = n;
+        m_next = 0;
+        m_pending = n;
+        m_work_cond.notify_all();
+
+        // The calling thread takes part in the work as well.
+        size_t i;
+
+        while (take(&i))
+        {
+            guard.unlock();
+            func(i);
+            guard.lock();
+            --m_pending;
+        }
+
+        m_done_cond.wait(guard, [this]() {
+                             return m_pending == 0;
+                         });
+        m_func = nullptr;
+    }
+
+private:
+    // Must be called with m_lock held.
+    bool take(size_t* pIndex)
+    {
+        bool rval = m_func && m_next < m_n;
+
+        if (rval)
+        {
+            *pIndex = m_next++;
+        }
+
+        return rval;
+    }
+
+    void run()
+    {
+        if (mysql_thread_init() != 0)
+        {
+            MXS_ERROR("mysql_thread_init() failed for a monitor probe thread.");
+            return;
+        }
+
+        std::unique_lock<std::mutex> guard(m_lock);
+
+        while (!m_stop)
+        {
+            size_t i;
+
+            if (take(&i))
+            {
+                const auto& func = *m_func;
+                guard.unlock();
+                func(i);
+                guard.lock();
+
+                if (--m_pending == 0)
+                {
+                    m_done_cond.notify_one();
+                }
+            }
+            else
+            {
+                m_work_cond.wait(guard);
+            }
+        }
+
+        guard.unlock();
+        mysql_thread_end();
+    }
+
+    std::vector<std::thread>           m_threads;
+    std::mutex                         m_lock;
+    std::condition_variable            m_work_cond;         /**< Signaled when there is work or on stop */
+    std::condition_variable            m_done_cond;         /**< Signaled when all work is done */
+    const std::function<void(size_t)>* m_func = nullptr;    /**< The current work, if any */
+    size_t                             m_n = 0;             /**< Number of calls to make */
+    size_t                             m_next = 0;          /**< Index of the next call */
+    size_t                             m_pending = 0;       /**< Calls that have not returned yet */
+    bool                               m_stop = false;
+};
+
 MonitorInstance::MonitorInstance(MXS_MONITOR* pMonitor)
     : m_monitor(pMonitor)
     , m_master(NULL)
@@ -2549,6 +2711,7 @@ void MonitorInstance::stop()
     Worker::shutdown();
     Worker::join();
     m_thread_running.store(false, std::memory_order_release);
+    m_probe_threads.reset();
 }
 
 void MonitorInstance::diagnostics(DCB* pDcb) const
@@ -2593,6 +2756,12 @@ bool MonitorInstance::start(const MXS_CONFIG_PARAMETER* pParams)
 
         if (configure(pParams))
         {
+            // The monitor thread is one of the threads that probe the servers.
+            if (m_monitor->probe_threads > 1)
+            {
+                m_probe_threads.reset(new ProbeThreads(m_monitor->name, m_monitor->probe_threads - 1));
+            }
+
             m_loop_called = get_time_ms() - m_monitor->interval; // Next tick should happen immediately.
             if (!Worker::start())
             {
@@ -2610,6 +2779,7 @@ bool MonitorInstance::start(const MXS_CONFIG_PARAMETER* pParams)
                     // Ok, so the initialization failed and the thread will exit.
                     // We need to wait on it so that the thread resources will not leak.
                     Worker::join();
+                    m_probe_threads.reset();
                 }
             }
         }
@@ -2617,6 +2787,36 @@ bool MonitorInstance::start(const MXS_CONFIG_PARAMETER* pParams)
     return started;
 }
 
+void MonitorInstance::run_concurrently(size_t n, const std::function<void(size_t)>& func)
+{
+    if (m_probe_threads && n > 1)
+    {
+        m_probe_threads->execute(n, func);
+    }
+    else
+    {
+        for (size_t i = 0; i < n; ++i)
+        {
+            func(i);
+        }
+    }
+}
+
+void MonitorInstance::record_probe_time(MXS_MONITORED_SERVER* pMs, mxb::Duration time)
+{
+    int64_t us = std::chrono::duration_cast<std::chrono::microseconds>(time).count();
+    int64_t interval_us = m_monitor->interval * 1000;
+
+    if (us > interval_us && mxb::atomic::load(&pMs->probe_time, mxb::atomic::RELAXED) <= interval_us)
+    {
+        MXS_WARNING("Probing server '%s' took %s, which is longer than the monitor interval "
+                    "of %lu milliseconds.", pMs->server->name, mxb::to_string(time).c_str(),
+                    m_monitor->interval);
+    }
+
+    mxb::atomic::store(&pMs->probe_time, us, mxb::atomic::RELAXED);
+}
+
 // static
 int64_t MonitorInstance::get_time_ms()
 {
@@ -2811,78 +3011,91 @@ void MonitorInstanceSimple::tick()
 {
     pre_tick();
 
+    std::vector<MXS_MONITORED_SERVER*> servers;
+
     for (MXS_MONITORED_SERVER* pMs = m_monitor->monitored_servers; pMs; pMs = pMs->next)
     {
         if (!server_is_in_maint(pMs->server))
         {
-            pMs->mon_prev_status = pMs->server->status;
-            pMs->pending_status = pMs->server->status;
+            servers.push_back(pMs);
+        }
+    }
 
-            mxs_connect_result_t rval = mon_ping_or_connect_to_db(m_monitor, pMs);
+    run_concurrently(servers.size(), [this, &servers](size_t i) {
+                         mxb::StopWatch timer;
+                         probe_server(servers[i]);
+                         record_probe_time(servers[i], timer.split());
+                     });
 
-            if (mon_connection_is_ok(rval))
-            {
-                monitor_clear_pending_status(pMs, SERVER_AUTH_ERROR);
-                monitor_set_pending_status(pMs, SERVER_RUNNING);
+    post_tick();
+}
 
-                if (should_update_disk_space_status(pMs))
-                {
-                    update_disk_space_status(pMs);
-                }
+void MonitorInstanceSimple::probe_server(MXS_MONITORED_SERVER* pMs)
+{
+    pMs->mon_prev_status = pMs->server->status;
+    pMs->pending_status = pMs->server->status;
 
-                update_server_status(pMs);
-            }
-            else
-            {
-                /**
-                 * TODO: Move the bits that do not represent a state out of
-                 * the server state bits. This would allow clearing the state by
-                 * zeroing it out.
-                 */
-                const uint64_t bits_to_clear = ~SERVER_WAS_MASTER;
+    mxs_connect_result_t rval = mon_ping_or_connect_to_db(m_monitor, pMs);
 
-                monitor_clear_pending_status(pMs, bits_to_clear);
+    if (mon_connection_is_ok(rval))
+    {
+        monitor_clear_pending_status(pMs, SERVER_AUTH_ERROR);
+        monitor_set_pending_status(pMs, SERVER_RUNNING);
 
-                if (mysql_errno(pMs->con) == ER_ACCESS_DENIED_ERROR)
-                {
-                    monitor_set_pending_status(pMs, SERVER_AUTH_ERROR);
-                }
-                else
-                {
-                    monitor_clear_pending_status(pMs, SERVER_AUTH_ERROR);
-                }
+        if (should_update_disk_space_status(pMs))
+        {
+            update_disk_space_status(pMs);
+        }
 
-                if (mon_status_changed(pMs) && mon_print_fail_status(pMs))
-                {
-                    mon_log_connect_error(pMs, rval);
-                }
-            }
+        update_server_status(pMs);
+    }
+    else
+    {
+        /**
+         * TODO: Move the bits that do not represent a state out of
+         * the server state bits. This would allow clearing the state by
+         * zeroing it out.
+         */
+        const uint64_t bits_to_clear = ~SERVER_WAS_MASTER;
 
-#if defined (SS_DEBUG)
-            if (mon_status_changed(pMs) || mon_print_fail_status(pMs))
-            {
-                // The current status is still in pMs->pending_status.
-                SERVER server = {};
-                server.status = pMs->pending_status;
-                MXS_DEBUG("Backend server [%s]:%d state : %s",
-                          pMs->server->address,
-                          pMs->server->port,
-                          STRSRVSTATUS(&server));
-            }
-#endif
+        monitor_clear_pending_status(pMs, bits_to_clear);
 
-            if (server_is_down(pMs->server))
-            {
-                pMs->mon_err_count += 1;
-            }
-            else
-            {
-                pMs->mon_err_count = 0;
-            }
+        if (mysql_errno(pMs->con) == ER_ACCESS_DENIED_ERROR)
+        {
+            monitor_set_pending_status(pMs, SERVER_AUTH_ERROR);
+        }
+        else
+        {
+            monitor_clear_pending_status(pMs, SERVER_AUTH_ERROR);
+        }
+
+        if (mon_status_changed(pMs) && mon_print_fail_status(pMs))
+        {
+            mon_log_connect_error(pMs, rval);
         }
     }
 
-    post_tick();
+#if defined (SS_DEBUG)
+    if (mon_status_changed(pMs) || mon_print_fail_status(pMs))
+    {
+        // The current status is still in pMs->pending_status.
+        SERVER server = {};
+        server.status = pMs->pending_status;
+        MXS_DEBUG("Backend server [%s]:%d state : %s",
+                  pMs->server->address,
+                  pMs->server->port,
+                  STRSRVSTATUS(&server));
+    }
+#endif
+
+    if (server_is_down(pMs->server))
+    {
+        pMs->mon_err_count += 1;
+    }
+    else
+    {
+        pMs->mon_err_count = 0;
+    }
 }
 
 void MonitorInstance::pre_loop()
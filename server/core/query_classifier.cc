@@ -15,6 +15,7 @@
 #include <inttypes.h>
 #include <algorithm>
 #include <atomic>
+#include <mutex>
 #include <random>
 #include <unordered_map>
 #include <maxscale/alloc.h>
@@ -54,6 +55,8 @@ struct type_name_info
 const char DEFAULT_QC_NAME[] = "qc_sqlite";
 const char QC_TRX_PARSE_USING[] = "QC_TRX_PARSE_USING";
 
+class QCSharedInfoCache;
+
 class ThisUnit
 {
 public:
@@ -61,6 +64,7 @@ public:
         : classifier(nullptr)
         , qc_trx_parse_using(QC_TRX_PARSE_USING_PARSER)
         , qc_sql_mode(QC_SQL_MODE_DEFAULT)
+        , pShared_cache(nullptr)
         , m_cache_max_size(std::numeric_limits<int64_t>::max())
     {
     }
@@ -71,6 +75,7 @@ public:
     QUERY_CLASSIFIER*    classifier;
     qc_trx_parse_using_t qc_trx_parse_using;
     qc_sql_mode_t        qc_sql_mode;
+    QCSharedInfoCache*   pShared_cache;     // The cache shared by all threads, NULL if not used.
 
     int64_t cache_max_size() const
     {
@@ -104,6 +109,209 @@ static thread_local struct
 };
 
 
+// 0xffffff is the maximum packet size, 4 is for packet header and 1 is for command byte. These are
+// MariaDB/MySQL protocol specific values that are also defined in <maxscale/protocol/mysql.h> but
+// should not be exposed to the core.
+constexpr int64_t MAX_ENTRY_SIZE = 0xffffff - 5;
+
+struct QCCacheEntry
+{
+    QCCacheEntry(QC_STMT_INFO* pInfo, qc_sql_mode_t sql_mode, uint32_t options)
+        : pInfo(pInfo)
+        , sql_mode(sql_mode)
+        , options(options)
+    {
+    }
+
+    QC_STMT_INFO* pInfo;
+    qc_sql_mode_t sql_mode;
+    uint32_t      options;
+};
+
+/**
+ * @class QCSharedInfoCache
+ *
+ * A cache of classification results shared by all threads. The cache is
+ * divided into shards selected by the hash of the canonical statement, each
+ * protected by a mutex of its own, so threads rarely contend with each other.
+ * The size limit of the cache is divided evenly between the shards.
+ *
+ * An entry is placed in the shared cache only after the statement has been
+ * parsed with QC_COLLECT_ALL. Thereafter the classifier never modifies it, so
+ * it can be used concurrently by several threads.
+ */
+class QCSharedInfoCache
+{
+public:
+    QCSharedInfoCache(const QCSharedInfoCache&) = delete;
+    QCSharedInfoCache& operator=(const QCSharedInfoCache&) = delete;
+
+    enum
+    {
+        N_SHARDS = 64
+    };
+
+    QCSharedInfoCache()
+    {
+    }
+
+    ~QCSharedInfoCache()
+    {
+        mxb_assert(this_unit.classifier);
+
+        for (auto& shard : m_shards)
+        {
+            for (auto a : shard.infos)
+            {
+                this_unit.classifier->qc_info_close(a.second.pInfo);
+            }
+        }
+    }
+
+    QC_STMT_INFO* get(const std::string& canonical_stmt, uint32_t options)
+    {
+        QC_STMT_INFO* pInfo = nullptr;
+        Shard& shard = shard_of(canonical_stmt);
+        std::lock_guard<std::mutex> guard(shard.lock);
+
+        auto i = shard.infos.find(canonical_stmt);
+
+        // An entry whose sql_mode or options differ is left in place, as it
+        // may be valid for other threads. It is replaced on the next insert.
+        if (i != shard.infos.end()
+            && i->second.sql_mode == this_unit.qc_sql_mode
+            && i->second.options == options)
+        {
+            mxb_assert(this_unit.classifier);
+            this_unit.classifier->qc_info_dup(i->second.pInfo);
+            pInfo = i->second.pInfo;
+
+            ++shard.stats.hits;
+        }
+        else
+        {
+            ++shard.stats.misses;
+        }
+
+        return pInfo;
+    }
+
+    bool insert(const std::string& canonical_stmt, QC_STMT_INFO* pInfo, uint32_t options)
+    {
+        mxb_assert(this_unit.classifier);
+
+        bool inserted = false;
+        int64_t cache_max_size = this_unit.cache_max_size() / N_SHARDS;
+        int64_t size = canonical_stmt.size();
+
+        if (size < MAX_ENTRY_SIZE && size <= cache_max_size)
+        {
+            Shard& shard = shard_of(canonical_stmt);
+            std::lock_guard<std::mutex> guard(shard.lock);
+
+            auto i = shard.infos.find(canonical_stmt);
+
+            if (i != shard.infos.end())
+            {
+                if (i->second.sql_mode == this_unit.qc_sql_mode && i->second.options == options)
+                {
+                    // Another thread got here first.
+                    return false;
+                }
+
+                shard.erase(i);
+            }
+
+            int64_t required_space = (shard.stats.size + size) - cache_max_size;
+
+            if (required_space > 0)
+            {
+                shard.make_space(required_space);
+            }
+
+            if (shard.stats.size + size <= cache_max_size)
+            {
+                this_unit.classifier->qc_info_dup(pInfo);
+
+                shard.infos.emplace(canonical_stmt, QCCacheEntry(pInfo, this_unit.qc_sql_mode, options));
+
+                ++shard.stats.inserts;
+                shard.stats.size += size;
+                inserted = true;
+            }
+        }
+
+        return inserted;
+    }
+
+    void get_stats(std::vector<QC_CACHE_STATS>* pStats)
+    {
+        pStats->resize(N_SHARDS);
+
+        for (int i = 0; i < N_SHARDS; ++i)
+        {
+            std::lock_guard<std::mutex> guard(m_shards[i].lock);
+            (*pStats)[i] = m_shards[i].stats;
+        }
+    }
+
+private:
+    typedef std::unordered_map<std::string, QCCacheEntry> InfosByStmt;
+
+    struct Shard
+    {
+        Shard()
+            : reng(std::random_device()())
+        {
+            memset(&stats, 0, sizeof(stats));
+        }
+
+        void erase(InfosByStmt::iterator i)
+        {
+            stats.size -= i->first.size();
+
+            mxb_assert(this_unit.classifier);
+            this_unit.classifier->qc_info_close(i->second.pInfo);
+
+            infos.erase(i);
+
+            ++stats.evictions;
+        }
+
+        void make_space(int64_t required_space)
+        {
+            int64_t freed_space = 0;
+
+            std::uniform_int_distribution<> dis(0, infos.bucket_count() - 1);
+
+            while ((freed_space < required_space) && !infos.empty())
+            {
+                // Remove the first entry of a random bucket, as QCInfoCache does.
+                int bucket = dis(reng);
+                auto i = infos.begin(bucket);
+
+                if (i != infos.end(bucket))
+                {
+                    freed_space += i->first.size();
+                    erase(infos.find(i->first));
+                }
+            }
+        }
+
+        std::mutex     lock;
+        InfosByStmt    infos;
+        QC_CACHE_STATS stats;
+        std::mt19937   reng;
+    };
+
+    Shard& shard_of(const std::string& canonical_stmt)
+    {
+        return m_shards[std::hash<std::string>()(canonical_stmt) % N_SHARDS];
+    }
+
+    Shard m_shards[N_SHARDS];
+};
+
 /**
  * @class QCInfoCache
  *
@@ -147,7 +355,7 @@ public:
 
         if (i != m_infos.end())
         {
-            const Entry& entry = i->second;
+            const QCCacheEntry& entry = i->second;
 
             if ((entry.sql_mode == this_unit.qc_sql_mode) &&
                 (entry.options == this_thread.options))
@@ -179,15 +387,10 @@ public:
         mxb_assert(peek(canonical_stmt) == nullptr);
         mxb_assert(this_unit.classifier);
 
-        // 0xffffff is the maximum packet size, 4 is for packet header and 1 is for command byte. These are
-        // MariaDB/MySQL protocol specific values that are also defined in <maxscale/protocol/mysql.h> but
-        // should not be exposed to the core.
-        constexpr int64_t max_entry_size = 0xffffff - 5;
-
         int64_t cache_max_size = this_unit.cache_max_size() / config_get_global_options()->n_threads;
         int64_t size = canonical_stmt.size();
 
-        if (size < max_entry_size && size <= cache_max_size)
+        if (size < MAX_ENTRY_SIZE && size <= cache_max_size)
         {
             int64_t required_space = (m_stats.size + size) - cache_max_size;
 
@@ -200,7 +403,7 @@ public:
             {
                 this_unit.classifier->qc_info_dup(pInfo);
 
-                m_infos.emplace(canonical_stmt, Entry(pInfo, this_unit.qc_sql_mode, this_thread.options));
+                m_infos.emplace(canonical_stmt, QCCacheEntry(pInfo, this_unit.qc_sql_mode, this_thread.options));
 
                 ++m_stats.inserts;
                 m_stats.size += size;
@@ -208,27 +411,40 @@ public:
         }
     }
 
-    void get_stats(QC_CACHE_STATS* pStats)
+    QC_STMT_INFO* get_shared(const std::string& canonical_stmt)
     {
-        *pStats = m_stats;
+        mxb_assert(this_unit.pShared_cache);
+        QC_STMT_INFO* pInfo = this_unit.pShared_cache->get(canonical_stmt, this_thread.options);
+
+        if (pInfo)
+        {
+            ++m_stats.hits;
+        }
+        else
+        {
+            ++m_stats.misses;
+        }
+
+        return pInfo;
     }
 
-private:
-    struct Entry
+    void insert_shared(const std::string& canonical_stmt, QC_STMT_INFO* pInfo)
     {
-        Entry(QC_STMT_INFO* pInfo, qc_sql_mode_t sql_mode, uint32_t options)
-            : pInfo(pInfo)
-            , sql_mode(sql_mode)
-            , options(options)
+        mxb_assert(this_unit.pShared_cache);
+
+        if (this_unit.pShared_cache->insert(canonical_stmt, pInfo, this_thread.options))
         {
+            ++m_stats.inserts;
         }
+    }
 
-        QC_STMT_INFO* pInfo;
-        qc_sql_mode_t sql_mode;
-        uint32_t      options;
-    };
+    void get_stats(QC_CACHE_STATS* pStats)
+    {
+        *pStats = m_stats;
+    }
 
-    typedef std::unordered_map<std::string, Entry> InfosByStmt;
+private:
+    typedef std::unordered_map<std::string, QCCacheEntry> InfosByStmt;
 
     void erase(InfosByStmt::iterator& i)
     {
@@ -317,6 +533,52 @@ void info_object_close(void* pData)
     this_unit.classifier->qc_info_close(static_cast<QC_STMT_INFO*>(pData));
 }
 
+void canonical_hash_close(void* pData)
+{
+    // The hash is stored in the pointer itself.
+}
+
+/**
+ * The canonical statement, as used as key in the classification cache.
+ */
+std::string get_cache_key(GWBUF* pStmt)
+{
+    std::string canonical = mxs::get_canonical(pStmt);
+
+    if (modutil_is_SQL_prepare(pStmt))
+    {
+        // P as in prepare, and appended so as not to cause a
+        // need for copying the data.
+        canonical += ":P";
+    }
+
+    return canonical;
+}
+
+uint64_t get_canonical_hash(GWBUF* pStmt)
+{
+    void* pData = gwbuf_get_buffer_object_data(pStmt, GWBUF_CANONICAL_HASH);
+
+    return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(pData));
+}
+
+uint64_t add_canonical_hash(GWBUF* pStmt, const std::string& canonical)
+{
+    uint64_t hash = std::hash<std::string>()(canonical);
+
+    if (hash == 0)
+    {
+        // 0 signifies that the hash is not present.
+        hash = 1;
+    }
+
+    gwbuf_add_buffer_object(pStmt, GWBUF_CANONICAL_HASH,
+                            reinterpret_cast<void*>(static_cast<uintptr_t>(hash)),
+                            canonical_hash_close);
+
+    return hash;
+}
+
 
 /**
  * @class QCInfoCacheScope
@@ -338,19 +600,27 @@ public:
 
     QCInfoCacheScope(GWBUF* pStmt)
         : m_pStmt(pStmt)
+        , m_shared(false)
     {
         if (use_cached_result() && has_not_been_parsed(m_pStmt))
         {
-            m_canonical = mxs::get_canonical(m_pStmt);
+            m_canonical = get_cache_key(m_pStmt);
+
+            if (get_canonical_hash(m_pStmt) == 0)
+            {
+                add_canonical_hash(m_pStmt, m_canonical);
+            }
 
-            if (modutil_is_SQL_prepare(pStmt))
+            if (!modutil_is_SQL_prepare(pStmt))
             {
-                // P as in prepare, and appended so as not to cause a
-                // need for copying the data.
-                m_canonical += ":P";
+                // The result of a prepare refers to the preparable statement,
+                // which is parsed on demand, so it is never shared.
+                m_shared = this_unit.pShared_cache != nullptr;
             }
 
-            QC_STMT_INFO* pInfo = this_thread.pInfo_cache->get(m_canonical);
+            QC_STMT_INFO* pInfo = m_shared ?
+                this_thread.pInfo_cache->get_shared(m_canonical) :
+                this_thread.pInfo_cache->get(m_canonical);
 
             if (pInfo)
             {
@@ -364,16 +634,33 @@ public:
     {
         if (!m_canonical.empty())
         {
+            if (m_shared)
+            {
+                // Collect everything now, so that the result is never modified
+                // once other threads can access it. If everything was already
+                // collected, this is a no-op.
+                int32_t result;
+                this_unit.classifier->qc_parse(m_pStmt, QC_COLLECT_ALL, &result);
+            }
+
             void* pData = gwbuf_get_buffer_object_data(m_pStmt, GWBUF_PARSING_INFO);
             mxb_assert(pData);
             QC_STMT_INFO* pInfo = static_cast<QC_STMT_INFO*>(pData);
 
-            this_thread.pInfo_cache->insert(m_canonical, pInfo);
+            if (m_shared)
+            {
+                this_thread.pInfo_cache->insert_shared(m_canonical, pInfo);
+            }
+            else
+            {
+                this_thread.pInfo_cache->insert(m_canonical, pInfo);
+            }
         }
     }
 
 private:
     GWBUF*      m_pStmt;
+    bool        m_shared;
     std::string m_canonical;
 };
 }
@@ -407,7 +694,13 @@ bool qc_setup(const QC_CACHE_PROPERTIES* cache_properties,
             int64_t cache_max_size = (cache_properties ? cache_properties->max_size : 0);
             mxb_assert(cache_max_size >= 0);
 
-            if (cache_max_size)
+            if (cache_max_size && cache_properties->shared)
+            {
+                this_unit.pShared_cache = new QCSharedInfoCache;
+                MXS_NOTICE("Query classification results are cached and reused by all threads. "
+                           "Memory used: %s", mxb::to_binary_size(cache_max_size).c_str());
+            }
+            else if (cache_max_size)
             {
                 int64_t size_per_thr = cache_max_size / config_get_global_options()->n_threads;
                 MXS_NOTICE("Query classification results are cached and reused. "
@@ -504,6 +797,13 @@ void qc_process_end(uint32_t kind)
     QC_TRACE();
     mxb_assert(this_unit.classifier);
 
+    if (kind & QC_INIT_SELF)
+    {
+        // The cached results must be released while the plugin is still usable.
+        delete this_unit.pShared_cache;
+        this_unit.pShared_cache = nullptr;
+    }
+
     if (kind & QC_INIT_PLUGIN)
     {
         this_unit.classifier->qc_process_end();
@@ -704,6 +1004,20 @@ char* qc_get_canonical(GWBUF* query)
     return rval;
 }
 
+uint64_t qc_get_canonical_hash(GWBUF* query)
+{
+    QC_TRACE();
+
+    uint64_t hash = get_canonical_hash(query);
+
+    if (hash == 0)
+    {
+        hash = add_canonical_hash(query, get_cache_key(query));
+    }
+
+    return hash;
+}
+
 bool qc_query_has_clause(GWBUF* query)
 {
     QC_TRACE();
@@ -1313,6 +1627,7 @@ bool qc_set_options(uint32_t options)
 void qc_get_cache_properties(QC_CACHE_PROPERTIES* properties)
 {
     properties->max_size = this_unit.cache_max_size();
+    properties->shared = this_unit.pShared_cache != nullptr;
 }
 
 bool qc_set_cache_properties(const QC_CACHE_PROPERTIES* properties)
@@ -1371,14 +1686,44 @@ json_t* qc_get_cache_stats_as_json()
     return pStats;
 }
 
+json_t* qc_get_shared_cache_stats_as_json()
+{
+    json_t* pShards = json_array();
+
+    if (this_unit.pShared_cache)
+    {
+        std::vector<QC_CACHE_STATS> all_stats;
+        this_unit.pShared_cache->get_stats(&all_stats);
+
+        for (const auto& stats : all_stats)
+        {
+            json_t* pStats = json_object();
+            json_object_set_new(pStats, "size", json_integer(stats.size));
+            json_object_set_new(pStats, "inserts", json_integer(stats.inserts));
+            json_object_set_new(pStats, "hits", json_integer(stats.hits));
+            json_object_set_new(pStats, "misses", json_integer(stats.misses));
+            json_object_set_new(pStats, "evictions", json_integer(stats.evictions));
+            json_array_append_new(pShards, pStats);
+        }
+    }
+
+    return pShards;
+}
+
 std::unique_ptr<json_t> qc_as_json(const char* zHost)
 {
     json_t* pParams = json_object();
     json_object_set_new(pParams, CN_CACHE_SIZE, json_integer(this_unit.cache_max_size()));
+    json_object_set_new(pParams, CN_CACHE_SHARED, json_boolean(this_unit.pShared_cache != nullptr));
 
     json_t* pAttributes = json_object();
     json_object_set_new(pAttributes, CN_PARAMETERS, pParams);
 
+    if (this_unit.pShared_cache)
+    {
+        json_object_set_new(pAttributes, "shared_cache_stats", qc_get_shared_cache_stats_as_json());
+    }
+
     json_t* pSelf = json_object();
     json_object_set_new(pSelf, CN_ID, json_string(CN_QUERY_CLASSIFIER));
     json_object_set_new(pSelf, CN_TYPE, json_string(CN_QUERY_CLASSIFIER));
@@ -33,14 +33,23 @@ void ResponseStat::query_started()
     m_last_start = maxbase::Clock::now();
 }
 
-void ResponseStat::query_ended()
+maxbase::Duration ResponseStat::query_ended()
 {
     if (m_last_start == maxbase::TimePoint())
     {
         // m_last_start is defaulted. Ignore, avoids extra logic at call sites.
-        return;
+        return maxbase::Duration(0);
     }
-    m_samples[m_sample_count] = maxbase::Clock::now() - m_last_start;
+    maxbase::Duration duration = maxbase::Clock::now() - m_last_start;
+    add_sample(duration);
+    m_last_start = maxbase::TimePoint();
+
+    return duration;
+}
+
+void ResponseStat::add_sample(maxbase::Duration duration)
+{
+    m_samples[m_sample_count] = duration;
 
     if (++m_sample_count == m_num_filter_samples)
     {
@@ -49,7 +58,6 @@ void ResponseStat::query_ended()
         m_average.add(std::chrono::duration<double>(new_sample).count());
         m_sample_count = 0;
     }
-    m_last_start = maxbase::TimePoint();
 }
 
 bool ResponseStat::make_valid()
@@ -21,6 +21,8 @@
 #ifdef HAVE_SYSTEMD
 #include <systemd/sd-daemon.h>
 #endif
+#include <algorithm>
+#include <climits>
 #include <vector>
 #include <sstream>
 
@@ -34,16 +36,20 @@
 #include <maxscale/utils.hh>
 #include <maxscale/statistics.hh>
 
+#include "internal/bufferpool.hh"
 #include "internal/dcb.h"
 #include "internal/modules.h"
 #include "internal/poll.hh"
+#include "internal/server.hh"
 #include "internal/service.hh"
+#include "internal/session.hh"
 
 #define WORKER_ABSENT_ID -1
 
 using maxbase::Semaphore;
 using maxbase::Worker;
 using maxbase::WorkerLoad;
+using maxscale::BufferPool;
 using maxscale::RoutingWorker;
 using maxscale::Closer;
 using std::vector;
@@ -88,6 +94,62 @@ int next_worker_id()
     return mxb::atomic::add(&this_unit.next_worker_id, 1, mxb::atomic::RELAXED);
 }
 
+/**
+ * Workers whose loads differ less than this many percentage points are
+ * considered equally loaded, in which case the number of sessions decides.
+ */
+const int LOAD_MARGIN = 10;
+
+/**
+ * The maximum number of sessions moved from one worker to another when the
+ * workers are balanced.
+ */
+const int MAX_MOVED_SESSIONS = 100;
+
+/**
+ * Check whether a worker is less loaded than another.
+ *
+ * @param pA  A worker.
+ * @param pB  Another worker.
+ *
+ * @return True, if @c pA is less loaded than @c pB.
+ */
+bool is_less_loaded(RoutingWorker* pA, RoutingWorker* pB)
+{
+    int a = pA->load(Worker::Load::ONE_SECOND);
+    int b = pB->load(Worker::Load::ONE_SECOND);
+
+    if (abs(a - b) >= LOAD_MARGIN)
+    {
+        return a < b;
+    }
+
+    return pA->session_count() < pB->session_count();
+}
+
+struct MoveCandidates
+{
+    std::vector<mxs::Session*> sessions;
+    size_t                     max;
+};
+
+bool collect_movable_session(DCB* dcb, void* data)
+{
+    MoveCandidates* pCandidates = static_cast<MoveCandidates*>(data);
+
+    if (dcb->dcb_role == DCB_ROLE_CLIENT_HANDLER && dcb->session)
+    {
+        mxs::Session* pSession = static_cast<mxs::Session*>(dcb->session);
+
+        if (pSession->client_dcb == dcb && pSession->can_be_moved())
+        {
+            pCandidates->sessions.push_back(pSession);
+        }
+    }
+
+    return pCandidates->sessions.size() < pCandidates->max;
+}
+
 thread_local struct this_thread
 {
     int current_worker_id;      // The worker id of the current thread
@@ -252,6 +314,9 @@ private:
 
 RoutingWorker::RoutingWorker()
     : m_id(next_worker_id())
+    , m_nSessions(0)
+    , m_pMove_to(nullptr)
+    , m_nMove(0)
     , m_alive(true)
     , m_pWatchdog_notifier(nullptr)
 {
@@ -439,6 +504,41 @@ bool RoutingWorker::remove_shared_fd(int fd)
     return rv;
 }
 
+bool RoutingWorker::add_listener_fd(int fd, MXB_POLL_DATA* pData)
+{
+    bool rv = true;
+
+    struct epoll_event ev;
+
+    ev.events = EPOLLIN;
+    ev.data.ptr = pData;
+
+    pData->owner = this;
+
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &ev) != 0)
+    {
+        Worker::resolve_poll_error(fd, errno, EPOLL_CTL_ADD);
+        rv = false;
+    }
+
+    return rv;
+}
+
+bool RoutingWorker::remove_listener_fd(int fd)
+{
+    bool rv = true;
+
+    struct epoll_event ev = {};
+
+    if (epoll_ctl(m_epoll_fd, EPOLL_CTL_DEL, fd, &ev) != 0)
+    {
+        Worker::resolve_poll_error(fd, errno, EPOLL_CTL_DEL);
+        rv = false;
+    }
+
+    return rv;
+}
+
 bool mxs_worker_should_shutdown(MXB_WORKER* pWorker)
 {
     return static_cast<RoutingWorker*>(pWorker)->should_shutdown();
@@ -536,6 +636,204 @@ RoutingWorker::SessionsById& RoutingWorker::session_registry()
     return m_sessions;
 }
 
+bool RoutingWorker::register_session(MXS_SESSION* pSession)
+{
+    mxb_assert(this == RoutingWorker::get_current());
+    bool rv = m_sessions.add(pSession);
+
+    if (rv)
+    {
+        mxb::atomic::add(&m_nSessions, 1, mxb::atomic::RELAXED);
+    }
+
+    return rv;
+}
+
+bool RoutingWorker::deregister_session(uint64_t id)
+{
+    mxb_assert(this == RoutingWorker::get_current());
+    bool rv = m_sessions.remove(id);
+
+    if (rv)
+    {
+        mxb::atomic::add(&m_nSessions, -1, mxb::atomic::RELAXED);
+    }
+
+    return rv;
+}
+
+int RoutingWorker::session_count() const
+{
+    return mxb::atomic::load(&m_nSessions, mxb::atomic::RELAXED);
+}
+
+/**
+ * Check the health of the persistent connections owned by this worker.
+ * Called once a second by every worker.
+ */
+bool RoutingWorker::maintain_persistent_pools(Worker::Call::action_t action)
+{
+    if (action == Worker::Call::EXECUTE)
+    {
+        server_maintain_persistent_pools(m_id);
+    }
+
+    return true;
+}
+
+/**
+ * Find the most and the least loaded worker and, if the difference between
+ * their loads exceeds the threshold, move idle sessions from the former to
+ * the latter. Called periodically by the main worker.
+ */
+bool RoutingWorker::balance_workers(Worker::Call::action_t action)
+{
+    if (action == Worker::Call::EXECUTE)
+    {
+        RoutingWorker* pFrom = nullptr;
+        RoutingWorker* pTo = nullptr;
+        int max_load = -1;
+        int min_load = INT_MAX;
+
+        for (int i = this_unit.id_min_worker; i <= this_unit.id_max_worker; ++i)
+        {
+            RoutingWorker* pWorker = this_unit.ppWorkers[i];
+            int load = pWorker->load(Worker::Load::ONE_SECOND);
+
+            if (load > max_load)
+            {
+                max_load = load;
+                pFrom = pWorker;
+            }
+
+            if (load < min_load)
+            {
+                min_load = load;
+                pTo = pWorker;
+            }
+        }
+
+        if (pFrom != pTo && max_load - min_load >= config_get_global_options()->rebalance_threshold)
+        {
+            // Move at most a tenth of the sessions per round, so that the roles
+            // of the workers are not simply swapped.
+            int nMax = std::min(std::max(pFrom->session_count() / 10, 1), MAX_MOVED_SESSIONS);
+
+            pFrom->execute([pFrom, pTo, nMax]() {
+                               pFrom->schedule_move(pTo, nMax);
+                           }, Worker::EXECUTE_QUEUED);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Schedule idle sessions to be moved from this worker to another. Must be
+ * called by this worker. The sessions are not moved here, as this is called
+ * while the events of an epoll batch are being handled and the remaining events
+ * of the batch may refer to the DCBs of the sessions.
+ *
+ * @param pTo   The worker to move the sessions to.
+ * @param nMax  The maximum number of sessions to move.
+ */
+void RoutingWorker::schedule_move(RoutingWorker* pTo, int nMax)
+{
+    mxb_assert(this == RoutingWorker::get_current());
+
+    m_pMove_to = pTo;
+    m_nMove = nMax;
+}
+
+/**
+ * Move the sessions scheduled with schedule_move(). Called in epoll_tick(),
+ * once all events of the batch have been handled and the zombies deleted.
+ * The sessions are detached here and attached by the other worker. They
+ * remain registered with this worker until the other worker has registered
+ * them, and a reference is held until then so that they are not freed while
+ * still registered here.
+ */
+void RoutingWorker::move_sessions()
+{
+    mxb_assert(this == RoutingWorker::get_current());
+
+    RoutingWorker* pTo = m_pMove_to;
+    m_pMove_to = nullptr;
+
+    MoveCandidates candidates;
+    candidates.max = m_nMove;
+    dcb_foreach_local(collect_movable_session, &candidates);
+
+    std::vector<mxs::Session*> moved;
+
+    for (auto pSession : candidates.sessions)
+    {
+        if (pSession->detach_from_worker())
+        {
+            session_get_ref(pSession);
+            moved.push_back(pSession);
+        }
+    }
+
+    if (moved.empty())
+    {
+        return;
+    }
+
+    RoutingWorker* pFrom = this;
+
+    auto release = [pFrom, moved]() {
+            for (auto pSession : moved)
+            {
+                pFrom->deregister_session(pSession->ses_id);
+                session_put_ref(pSession);
+            }
+        };
+
+    auto attach = [pFrom, moved, release]() {
+            RoutingWorker* pWorker = RoutingWorker::get_current();
+
+            for (auto pSession : moved)
+            {
+                if (pWorker != pFrom)
+                {
+                    pWorker->register_session(pSession);
+                }
+
+                if (!pSession->attach_to_worker())
+                {
+                    MXS_ERROR("Could not add the connections of session %lu to worker %d, "
+                              "closing the session.", pSession->ses_id, pWorker->id());
+                    dcb_close(pSession->client_dcb);
+                }
+            }
+
+            if (pWorker == pFrom)
+            {
+                // The sessions were not moved and remain registered here.
+                for (auto pSession : moved)
+                {
+                    session_put_ref(pSession);
+                }
+            }
+            else if (!pFrom->execute(release, Worker::EXECUTE_QUEUED))
+            {
+                MXS_ERROR("Could not deregister %lu moved sessions from worker %d.",
+                          moved.size(), pFrom->id());
+            }
+        };
+
+    if (pTo->execute(attach, Worker::EXECUTE_QUEUED))
+    {
+        MXS_INFO("Moved %lu sessions from worker %d to worker %d.", moved.size(), m_id, pTo->id());
+    }
+    else
+    {
+        MXS_ERROR("Could not move sessions to worker %d.", pTo->id());
+        attach();
+    }
+}
+
 void RoutingWorker::register_zombie(DCB* pDcb)
 {
     mxb_assert(pDcb->poll.owner == this);
@@ -559,14 +857,27 @@ void RoutingWorker::delete_zombies()
 bool RoutingWorker::pre_run()
 {
     this_thread.current_worker_id = m_id;
+    BufferPool::thread_init(m_id);
 
     bool rv = modules_thread_init() && service_thread_init() && qc_thread_init(QC_INIT_SELF);
 
     if (!rv)
     {
         MXS_ERROR("Could not perform thread initialization for all modules. Thread exits.");
+        BufferPool::thread_finish();
         this_thread.current_worker_id = WORKER_ABSENT_ID;
     }
+    else
+    {
+        delayed_call(1000, &RoutingWorker::maintain_persistent_pools, this);
+
+        if (m_id == this_unit.id_main_worker && config_get_global_options()->rebalance_period > 0)
+        {
+            delayed_call(config_get_global_options()->rebalance_period * 1000,
+                         &RoutingWorker::balance_workers,
+                         this);
+        }
+    }
 
     return rv;
 }
@@ -576,6 +887,8 @@ void RoutingWorker::post_run()
     modules_thread_finish();
     qc_thread_end(QC_INIT_SELF);
     // TODO: Add service_thread_finish().
+    dcb_thread_finish();
+    BufferPool::thread_finish();
     this_thread.current_worker_id = WORKER_ABSENT_ID;
 }
 
@@ -639,6 +952,13 @@ void RoutingWorker::epoll_tick()
 
     delete_zombies();
 
+    if (m_pMove_to)
+    {
+        move_sessions();
+    }
+
+    BufferPool::tick();
+
     check_systemd_watchdog();
 }
 
@@ -1067,7 +1387,21 @@ RoutingWorker* RoutingWorker::pick_worker()
     static int id_generator = 0;
     int id = this_unit.id_min_worker
         + (mxb::atomic::add(&id_generator, 1, mxb::atomic::RELAXED) % this_unit.nWorkers);
-    return get(id);
+    RoutingWorker* pWorker = get(id);
+
+    // Comparing only two candidates, instead of picking the least loaded of
+    // all, prevents a burst of connections from all ending up on the same
+    // worker before its load and session count have been updated. Preferring
+    // the current worker also keeps connections accepted by a worker of its
+    // own, as with listeners using SO_REUSEPORT, on that worker.
+    RoutingWorker* pCurrent = get_current();
+
+    if (pCurrent && pCurrent != pWorker && !is_less_loaded(pWorker, pCurrent))
+    {
+        pWorker = pCurrent;
+    }
+
+    return pWorker;
 }
 
 // static
@@ -1153,14 +1487,14 @@ bool mxs_rworker_register_session(MXS_SESSION* session)
 {
     RoutingWorker* pWorker = RoutingWorker::get_current();
     mxb_assert(pWorker);
-    return pWorker->session_registry().add(session);
+    return pWorker->register_session(session);
 }
 
 bool mxs_rworker_deregister_session(uint64_t id)
 {
     RoutingWorker* pWorker = RoutingWorker::get_current();
     mxb_assert(pWorker);
-    return pWorker->session_registry().remove(id);
+    return pWorker->deregister_session(id);
 }
 
 MXS_SESSION* mxs_rworker_find_session(uint64_t id)
@@ -1220,6 +1554,7 @@ public:
         rworker.get_descriptor_counts(&nCurrent, &nTotal);
         json_object_set_new(pStats, "current_descriptors", json_integer(nCurrent));
         json_object_set_new(pStats, "total_descriptors", json_integer(nTotal));
+        json_object_set_new(pStats, "sessions", json_integer(rworker.session_count()));
 
         json_t* load = json_object();
         json_object_set_new(load, "last_second", json_integer(rworker.load(Worker::Load::ONE_SECOND)));
@@ -1227,6 +1562,16 @@ public:
         json_object_set_new(load, "last_hour", json_integer(rworker.load(Worker::Load::ONE_HOUR)));
         json_object_set_new(pStats, "load", load);
 
+        json_object_set_new(pStats, "buffer_pool", BufferPool::get_stats_as_json());
+
+        mxb::MessageQueue::Stats mq = rworker.message_queue_statistics();
+        json_t* pQueue = json_object();
+        json_object_set_new(pQueue, "posted", json_integer(mq.n_posted));
+        json_object_set_new(pQueue, "full", json_integer(mq.n_full));
+        json_object_set_new(pQueue, "dropped", json_integer(mq.n_dropped));
+        json_object_set_new(pQueue, "signals", json_integer(mq.n_signals));
+        json_object_set_new(pStats, "message_queue", pQueue);
+
         json_t* qc = qc_get_cache_stats_as_json();
 
         if (qc)
@@ -29,6 +29,7 @@
 #include <list>
 #include <mutex>
 #include <sstream>
+#include <vector>
 #include <mutex>
 
 #include <maxbase/atomic.hh>
@@ -54,6 +55,7 @@
 #include "internal/monitor.h"
 #include "internal/poll.hh"
 #include "internal/config.hh"
+#include "internal/dcb.h"
 #include "internal/service.hh"
 #include "internal/modules.h"
 
@@ -70,7 +72,9 @@ using Guard = std::lock_guard<std::mutex>;
 const char CN_MONITORPW[] = "monitorpw";
 const char CN_MONITORUSER[] = "monitoruser";
 const char CN_PERSISTMAXTIME[] = "persistmaxtime";
+const char CN_PERSISTPINGTIME[] = "persistpingtime";
 const char CN_PERSISTPOOLMAX[] = "persistpoolmax";
+const char CN_PERSISTPOOLMIN[] = "persistpoolmin";
 const char CN_PROXY_PROTOCOL[] = "proxy_protocol";
 
 static std::mutex server_lock;
@@ -130,7 +134,7 @@ SERVER* server_alloc(const char* name, MXS_CONFIG_PARAMETER* params)
     char* my_name = MXS_STRDUP(name);
     char* my_protocol = MXS_STRDUP(protocol);
     char* my_authenticator = MXS_STRDUP(authenticator);
-    DCB** persistent = (DCB**)MXS_CALLOC(config_threadcount(), sizeof(*persistent));
+    SERVER_POOL* persistent = (SERVER_POOL*)MXS_CALLOC(config_threadcount(), sizeof(*persistent));
 
     if (!server || !my_name || !my_protocol || !my_authenticator || !persistent)
     {
@@ -161,6 +165,8 @@ SERVER* server_alloc(const char* name, MXS_CONFIG_PARAMETER* params)
     server->monpw[0] = '\0';
     server->persistpoolmax = config_get_integer(params, CN_PERSISTPOOLMAX);
     server->persistmaxtime = config_get_integer(params, CN_PERSISTMAXTIME);
+    server->persistpoolmin = config_get_integer(params, CN_PERSISTPOOLMIN);
+    server->persistpingtime = config_get_integer(params, CN_PERSISTPINGTIME);
     server->proxy_protocol = config_get_bool(params, CN_PROXY_PROTOCOL);
     server->parameters = NULL;
     server->is_active = true;
@@ -233,7 +239,7 @@ void server_free(Server* server)
 
         for (int i = 0; i < nthr; i++)
         {
-            dcb_persistent_clean_count(server->persistent[i], i, true);
+            dcb_persistent_clean_count(server, i, true);
         }
         MXS_FREE(server->persistent);
     }
@@ -255,59 +261,45 @@ void server_free(Server* server)
  */
 DCB* server_get_persistent(SERVER* server, const char* user, const char* ip, const char* protocol, int id)
 {
-    DCB* dcb, * previous = NULL;
+    DCB* dcb = NULL;
 
-    if (server->persistent[id]
-        && dcb_persistent_clean_count(server->persistent[id], id, false)
-        && server->persistent[id]   // Check after cleaning
+    if (server->persistent[id].head
+        && dcb_persistent_clean_count(server, id, false)
         && (server->status & SERVER_RUNNING))
     {
-        dcb = server->persistent[id];
-        while (dcb)
+        if ((dcb = dcb_persistent_take(server, id, user, ip, protocol)))
         {
-            if (dcb->user
-                && dcb->protoname
-                && dcb->remote
-                && ip
-                && !dcb->dcb_errhandle_called
-                && !(dcb->flags & DCBF_HUNG)
-                && 0 == strcmp(dcb->user, user)
-                && 0 == strcmp(dcb->remote, ip)
-                && 0 == strcmp(dcb->protoname, protocol))
-            {
-                if (NULL == previous)
-                {
-                    server->persistent[id] = dcb->nextpersistent;
-                }
-                else
-                {
-                    previous->nextpersistent = dcb->nextpersistent;
-                }
-                MXS_FREE(dcb->user);
-                dcb->user = NULL;
-                mxb::atomic::add(&server->stats.n_persistent, -1);
-                mxb::atomic::add(&server->stats.n_current, 1, mxb::atomic::RELAXED);
-                return dcb;
-            }
-            else
+            MXS_FREE(dcb->user);
+            dcb->user = NULL;
+            mxb::atomic::add(&server->stats.n_current, 1, mxb::atomic::RELAXED);
+        }
+    }
+
+    return dcb;
+}
+
+void server_maintain_persistent_pools(int id)
+{
+    std::vector<Server*> servers;
+
+    {
+        // The pools of a worker are only accessed by the worker itself, so the lock
+        // is needed only while the servers with pooled connections are collected.
+        Guard guard(server_lock);
+
+        for (Server* server : all_servers)
+        {
+            if (server->is_active && server->persistent[id].head)
             {
-                MXS_DEBUG("%lu [server_get_persistent] Rejected dcb "
-                          "%p from pool, user %s looking for %s, protocol %s "
-                          "looking for %s, hung flag %s, error handle called %s.",
-                          pthread_self(),
-                          dcb,
-                          dcb->user ? dcb->user : "NULL",
-                          user,
-                          dcb->protoname ? dcb->protoname : "NULL",
-                          protocol,
-                          (dcb->flags & DCBF_HUNG) ? "true" : "false",
-                          dcb->dcb_errhandle_called ? "true" : "false");
+                servers.push_back(server);
             }
-            previous = dcb;
-            dcb = dcb->nextpersistent;
         }
     }
-    return NULL;
+
+    for (Server* server : servers)
+    {
+        dcb_persistent_maintain(server, id);
+    }
 }
 
 /**
@@ -478,7 +470,7 @@ public:
         mxb_assert(&rworker == RoutingWorker::get_current());
 
         int thread_id = rworker.id();
-        dcb_persistent_clean_count(m_server->persistent[thread_id], thread_id, false);
+        dcb_persistent_clean_count(const_cast<SERVER*>(m_server), thread_id, false);
     }
 
 private:
@@ -575,6 +567,14 @@ void dprintServer(DCB* dcb, const SERVER* srv)
     }
     dcb_printf(dcb, "\tAdaptive avg. select time:           %s\n", ave_os.str().c_str());
 
+    if (server->stats.n_authenticated)
+    {
+        maxbase::Duration connect_ave(server->stats.connect_time / server->stats.n_authenticated / 1000000.0);
+        std::ostringstream connect_os;
+        connect_os << connect_ave;
+        dcb_printf(dcb, "\tAverage connection time:             %s\n", connect_os.str().c_str());
+    }
+
     if (server->persistpoolmax)
     {
         dcb_printf(dcb, "\tPersistent pool size:                %d\n", server->stats.n_persistent);
@@ -583,7 +583,10 @@ void dprintServer(DCB* dcb, const SERVER* srv)
         dcb_printf(dcb, "\tPersistent actual size max:          %d\n", server->persistmax);
         dcb_printf(dcb, "\tPersistent pool size limit:          %ld\n", server->persistpoolmax);
         dcb_printf(dcb, "\tPersistent max time (secs):          %ld\n", server->persistmaxtime);
+        dcb_printf(dcb, "\tPersistent pool minimum size:        %ld\n", server->persistpoolmin);
+        dcb_printf(dcb, "\tPersistent ping time (secs):         %ld\n", server->persistpingtime);
         dcb_printf(dcb, "\tConnections taken from pool:         %lu\n", server->stats.n_from_pool);
+        dcb_printf(dcb, "\tConnections not found in pool:       %lu\n", server->stats.n_new_conn);
         double d = (double)server->stats.n_from_pool / (double)(server->stats.n_connections
                                                                 + server->stats.n_from_pool + 1);
         dcb_printf(dcb, "\tPool availability:                   %0.2lf%%\n", d * 100.0);
@@ -1457,12 +1460,20 @@ static json_t* server_json_attributes(const SERVER* server)
     json_object_set_new(stats, "connections", json_integer(server->stats.n_current));
     json_object_set_new(stats, "total_connections", json_integer(server->stats.n_connections));
     json_object_set_new(stats, "persistent_connections", json_integer(server->stats.n_persistent));
+    json_object_set_new(stats, "pool_hits", json_integer(server->stats.n_from_pool));
+    json_object_set_new(stats, "pool_misses", json_integer(server->stats.n_new_conn));
     json_object_set_new(stats, "active_operations", json_integer(server->stats.n_current_ops));
     json_object_set_new(stats, "routed_packets", json_integer(server->stats.packets));
 
     maxbase::Duration response_ave(server_response_time_average(server));
     json_object_set_new(stats, "adaptive_avg_select_time", json_string(to_string(response_ave).c_str()));
 
+    uint64_t n_authenticated = mxb::atomic::load(&server->stats.n_authenticated, mxb::atomic::RELAXED);
+    maxbase::Duration connect_ave(n_authenticated ?
+                                  mxb::atomic::load(&server->stats.connect_time, mxb::atomic::RELAXED)
+                                  / n_authenticated / 1000000.0 : 0.0);
+    json_object_set_new(stats, "avg_connect_time", json_string(to_string(connect_ave).c_str()));
+
     json_object_set_new(attr, "statistics", stats);
 
     return attr;
@@ -58,6 +58,7 @@
 #include <maxscale/routingworker.hh>
 
 #include "internal/config.hh"
+#include "internal/dcb.h"
 #include "internal/filter.hh"
 #include "internal/modules.h"
 #include "internal/service.hh"
@@ -755,6 +756,7 @@ bool service_remove_listener(Service* service, const char* target)
 
                 // TODO: This is not pretty but it works, revise when listeners are refactored. This is
                 // thread-safe as the listener is freed on the same thread that closes the socket.
+                dcb_close_worker_sockets(listener->listener);
                 close(listener->listener->fd);
                 listener->listener->fd = -1;
             }
@@ -774,6 +776,7 @@ bool service_remove_listener(Service* service, const char* target)
  * @param port          The port to listen on
  * @param authenticator Name of the authenticator to be used
  * @param ssl           SSL configuration
+ * @param reuseport     Whether each worker listens with a socket of its own
  *
  * @return Created listener or NULL on error
  */
@@ -784,7 +787,8 @@ SERV_LISTENER* serviceCreateListener(Service* service,
                                      unsigned short port,
                                      const char* authenticator,
                                      const char* options,
-                                     SSL_LISTENER* ssl)
+                                     SSL_LISTENER* ssl,
+                                     bool reuseport)
 {
     SERV_LISTENER* proto = listener_alloc(service,
                                           name,
@@ -793,7 +797,8 @@ SERV_LISTENER* serviceCreateListener(Service* service,
                                           port,
                                           authenticator,
                                           options,
-                                          ssl);
+                                          ssl,
+                                          reuseport);
 
     if (proto)
     {
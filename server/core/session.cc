@@ -1583,6 +1583,66 @@ void Session::retain_statement(GWBUF* pBuffer)
     }
 }
 
+bool Session::can_be_moved() const
+{
+    // Retained statements are buffers owned by the worker.
+    bool rv = state == SESSION_STATE_ROUTER_READY
+        && m_filters.empty()
+        && m_last_queries.empty()
+        && !session_trx_is_active(this)
+        && rcap_type_required(service_get_capabilities(service), RCAP_TYPE_SESSION_MIGRATION)
+        && client_dcb->func.is_idle
+        && client_dcb->func.is_idle(client_dcb)
+        && dcb_can_be_moved(client_dcb);
+
+    for (auto it = m_dcb_set.begin(); rv && it != m_dcb_set.end(); ++it)
+    {
+        rv = dcb_can_be_moved(*it);
+    }
+
+    return rv;
+}
+
+bool Session::detach_from_worker()
+{
+    std::vector<DCB*> dcbs(m_dcb_set.begin(), m_dcb_set.end());
+    dcbs.push_back(client_dcb);
+
+    size_t n_detached = 0;
+
+    while (n_detached < dcbs.size() && dcb_detach_from_worker(dcbs[n_detached]))
+    {
+        ++n_detached;
+    }
+
+    bool rv = (n_detached == dcbs.size());
+
+    if (!rv)
+    {
+        for (size_t i = 0; i < n_detached; ++i)
+        {
+            dcb_attach_to_worker(dcbs[i]);
+        }
+    }
+
+    return rv;
+}
+
+bool Session::attach_to_worker()
+{
+    bool rv = dcb_attach_to_worker(client_dcb);
+
+    for (auto dcb : m_dcb_set)
+    {
+        if (!dcb_attach_to_worker(dcb))
+        {
+            rv = false;
+        }
+    }
+
+    return rv;
+}
+
 void Session::book_server_response(SERVER* pServer, bool final_response)
 {
     if (m_retain_last_statements && !m_last_queries.empty())
@@ -29,6 +29,11 @@ uint64_t SessionCommand::get_position() const
     return m_pos;
 }
 
+const mxs::Buffer& SessionCommand::get_buffer() const
+{
+    return m_buffer;
+}
+
 GWBUF* SessionCommand::deep_copy_buffer()
 {
     GWBUF* temp = m_buffer.release();
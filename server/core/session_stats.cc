@@ -28,6 +28,11 @@ void maxscale::ServerStats::end_session(maxbase::Duration sess_duration,
     m_num_ave_session_selects.add(num_selects);
 }
 
+void maxscale::ServerStats::add_latency(maxbase::Duration latency)
+{
+    m_latency.add(latency);
+}
+
 maxscale::ServerStats& maxscale::ServerStats::operator+=(const maxscale::ServerStats& rhs)
 {
     total += rhs.total;
@@ -36,6 +41,7 @@ maxscale::ServerStats& maxscale::ServerStats::operator+=(const maxscale::ServerS
     m_ave_session_dur += rhs.m_ave_session_dur;
     m_ave_active_dur += rhs.m_ave_active_dur;
     m_num_ave_session_selects += rhs.m_num_ave_session_selects;
+    m_latency += rhs.m_latency;
 
     return *this;
 }
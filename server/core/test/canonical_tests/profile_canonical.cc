@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxscale/ccdefs.hh>
+#include <unistd.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <maxbase/stopwatch.hh>
+#include <maxscale/buffer.hh>
+#include <maxscale/modutil.hh>
+#include <maxscale/protocol/mysql.h>
+
+using namespace std;
+
+namespace
+{
+
+char USAGE[] =
+    "usage: profile_canonical [-n iterations] [-b rows] [file.sql ...]\n"
+    "\n"
+    "Each line of each file is a statement. With -b, a bulk INSERT of the\n"
+    "given number of rows is profiled as well.\n";
+
+GWBUF* create_packet(const string& stmt)
+{
+    size_t payload = stmt.size() + 1;
+    GWBUF* pPacket = gwbuf_alloc(MYSQL_HEADER_LEN + payload);
+    uint8_t* pData = GWBUF_DATA(pPacket);
+
+    gw_mysql_set_byte3(pData, payload);
+    pData[3] = 0;
+    pData[4] = MXS_COM_QUERY;
+    memcpy(pData + MYSQL_HEADER_LEN + 1, stmt.data(), stmt.size());
+
+    return pPacket;
+}
+
+/**
+ * Split a packet into a chain of small buffers, which forces get_canonical()
+ * to use the iterator based path.
+ */
+GWBUF* fragment(GWBUF* pPacket)
+{
+    GWBUF* pChain = nullptr;
+    size_t len = gwbuf_length(pPacket);
+    size_t offset = 0;
+
+    for (size_t n = 1; offset < len; n = n % 7 + 1)
+    {
+        size_t chunk = std::min(n, len - offset);
+        GWBUF* pChunk = gwbuf_alloc_and_load(chunk, GWBUF_DATA(pPacket) + offset);
+        pChain = gwbuf_append(pChain, pChunk);
+        offset += chunk;
+    }
+
+    return pChain;
+}
+
+string create_bulk_insert(int nRows)
+{
+    string stmt = "INSERT INTO t1 (id, name, description, price, created) VALUES ";
+
+    for (int i = 0; i < nRows; ++i)
+    {
+        if (i != 0)
+        {
+            stmt += ", ";
+        }
+
+        stmt += "(" + to_string(i) + ", 'name-" + to_string(i * 7919) + "', "
+            + "'Product description that is long enough to be typical of a text column', "
+            + to_string(i) + ".25, '2018-11-" + to_string(i % 28 + 1) + "')";
+    }
+
+    return stmt;
+}
+
+bool verify(const vector<GWBUF*>& contiguous, const vector<GWBUF*>& fragmented)
+{
+    bool rv = true;
+
+    for (size_t i = 0; i < contiguous.size(); ++i)
+    {
+        string fast = mxs::get_canonical(contiguous[i]);
+        string slow = mxs::get_canonical(fragmented[i]);
+
+        if (fast != slow)
+        {
+            cout << "Mismatch:\n  contiguous: " << fast << "\n  fragmented: " << slow << endl;
+            rv = false;
+        }
+    }
+
+    return rv;
+}
+
+double profile(const vector<GWBUF*>& packets, int nIterations)
+{
+    size_t total = 0;
+    mxb::StopWatch sw;
+
+    for (int i = 0; i < nIterations; ++i)
+    {
+        for (auto pPacket : packets)
+        {
+            total += mxs::get_canonical(pPacket).size();
+        }
+    }
+
+    mxb::Duration d = sw.split();
+    mxb_assert(total > 0);
+
+    return d.secs();
+}
+
+bool run(const string& name, const vector<string>& stmts, int nIterations)
+{
+    vector<GWBUF*> contiguous;
+    vector<GWBUF*> fragmented;
+    size_t bytes = 0;
+
+    for (const auto& stmt : stmts)
+    {
+        contiguous.push_back(create_packet(stmt));
+        fragmented.push_back(fragment(contiguous.back()));
+        bytes += stmt.size();
+    }
+
+    bool rv = verify(contiguous, fragmented);
+
+    if (rv && bytes > 0)
+    {
+        double fast = profile(contiguous, nIterations);
+        double slow = profile(fragmented, nIterations);
+        double mb = (double)bytes * nIterations / (1024 * 1024);
+
+        cout << name << ": " << stmts.size() << " statements, " << bytes << " bytes\n"
+             << "  contiguous: " << fixed << setprecision(3) << fast << "s, "
+             << setprecision(1) << mb / fast << " MiB/s\n"
+             << "  fragmented: " << setprecision(3) << slow << "s, "
+             << setprecision(1) << mb / slow << " MiB/s" << endl;
+    }
+
+    for (auto pPacket : contiguous)
+    {
+        gwbuf_free(pPacket);
+    }
+
+    for (auto pPacket : fragmented)
+    {
+        gwbuf_free(pPacket);
+    }
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rc = EXIT_SUCCESS;
+
+    int nIterations = 1000;
+    int nRows = 0;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            nIterations = atoi(optarg);
+            break;
+
+        case 'b':
+            nRows = atoi(optarg);
+            break;
+
+        default:
+            rc = EXIT_FAILURE;
+        }
+    }
+
+    if (rc == EXIT_SUCCESS && nIterations > 0 && (optind < argc || nRows > 0))
+    {
+        for (int i = optind; i < argc; ++i)
+        {
+            ifstream in(argv[i]);
+            vector<string> stmts;
+
+            for (string line; getline(in, line);)
+            {
+                if (!line.empty())
+                {
+                    stmts.push_back(line);
+                }
+            }
+
+            if (!run(argv[i], stmts, nIterations))
+            {
+                rc = EXIT_FAILURE;
+            }
+        }
+
+        if (nRows > 0 && !run("bulk insert", {create_bulk_insert(nRows)}, nIterations))
+        {
+            rc = EXIT_FAILURE;
+        }
+    }
+    else
+    {
+        cout << USAGE << endl;
+        rc = EXIT_FAILURE;
+    }
+
+    return rc;
+}
@@ -0,0 +1,113 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxscale/ccdefs.hh>
+#include <iomanip>
+#include <iostream>
+#include <vector>
+#include <maxbase/log.hh>
+#include <maxbase/stopwatch.hh>
+#include <maxscale/buffer.h>
+#include "../internal/bufferpool.hh"
+
+using namespace std;
+
+namespace
+{
+
+char USAGE[] = "usage: profile_buffer -n count -s size [-b batch]\n";
+
+/**
+ * Allocate and free buffers, @c batch buffers at a time, which is roughly
+ * what happens when a chain of packets is read and then written.
+ */
+void run(int nCount, size_t size, size_t batch)
+{
+    vector<GWBUF*> buffers(batch);
+
+    for (int i = 0; i < nCount; ++i)
+    {
+        for (auto& pBuffer : buffers)
+        {
+            pBuffer = gwbuf_alloc(size);
+            MXS_ABORT_IF_NULL(pBuffer);
+        }
+
+        for (auto pBuffer : buffers)
+        {
+            gwbuf_free(pBuffer);
+        }
+    }
+}
+
+void profile(const char* zName, int nCount, size_t size, size_t batch)
+{
+    mxb::StopWatch sw;
+    run(nCount, size, batch);
+    mxb::Duration d = sw.split();
+
+    cout << zName << ": " << fixed << setprecision(3) << d.secs() << "s, "
+         << setprecision(1) << (d.secs() * 1e9) / (nCount * batch) << "ns per buffer" << endl;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rc = EXIT_SUCCESS;
+
+    int nCount = 0;
+    size_t size = 0;
+    size_t batch = 1;
+
+    int c;
+    while ((c = getopt(argc, argv, "n:s:b:")) != -1)
+    {
+        switch (c)
+        {
+        case 'n':
+            nCount = atoi(optarg);
+            break;
+
+        case 's':
+            size = atoi(optarg);
+            break;
+
+        case 'b':
+            batch = atoi(optarg);
+            break;
+
+        default:
+            rc = EXIT_FAILURE;
+        }
+    }
+
+    if ((rc == EXIT_SUCCESS) && (nCount > 0) && (size > 0) && (batch > 0))
+    {
+        mxb::Log log;
+
+        profile("heap", nCount, size, batch);
+
+        mxs::BufferPool::thread_init(0);
+        profile("pool", nCount, size, batch);
+
+        mxs::BufferPool::Stats stats = mxs::BufferPool::get_stats();
+        cout << "pool hits: " << stats.n_hit << ", misses: " << stats.n_miss << endl;
+        mxs::BufferPool::thread_finish();
+    }
+    else
+    {
+        cout << USAGE << endl;
+    }
+
+    return rc;
+}
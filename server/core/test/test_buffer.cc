@@ -32,6 +32,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <thread>
 
 #include <maxbase/assert.h>
 #include <maxbase/log.hh>
@@ -39,6 +40,8 @@
 #include <maxscale/buffer.h>
 #include <maxscale/hint.h>
 
+#include "../internal/bufferpool.hh"
+
 /**
  * Generate predefined test data
  *
@@ -458,6 +461,132 @@ void test_clone()
     gwbuf_free(original);
 }
 
+static void free_object(void* data)
+{
+    *static_cast<int*>(data) += 1;
+}
+
+void test_split_view()
+{
+    GWBUF* buffer = gwbuf_alloc_and_load(10, "0123456789");
+    GWBUF* head = gwbuf_split(&buffer, 4);
+
+    mxb_assert_message(head->sbuf == buffer->sbuf, "Splitting should not copy the data");
+    mxb_assert(memcmp(GWBUF_DATA(head), "0123", 4) == 0);
+    mxb_assert(memcmp(GWBUF_DATA(buffer), "456789", 6) == 0);
+
+    int n_freed = 0;
+    gwbuf_add_buffer_object(head, GWBUF_PARSING_INFO, &n_freed, free_object);
+    mxb_assert(GWBUF_IS_PARSED(head));
+    mxb_assert_message(!GWBUF_IS_PARSED(buffer), "A buffer object should not be seen by other parts");
+
+    GWBUF* clone = gwbuf_clone(head);
+    mxb_assert_message(GWBUF_IS_PARSED(clone), "A buffer object should be seen by clones");
+
+    gwbuf_free(head);
+    gwbuf_free(clone);
+    mxb_assert(n_freed == 0);
+    gwbuf_free(buffer);
+    mxb_assert_message(n_freed == 1, "The object should be freed with the data");
+}
+
+void test_compact()
+{
+    const size_t size = 16 * 1024;
+    GWBUF* buffer = gwbuf_alloc(size);
+    memset(GWBUF_DATA(buffer), 'a', size);
+    GWBUF* head = gwbuf_split(&buffer, 10);
+    gwbuf_set_type(head, GWBUF_TYPE_COLLECT_RESULT);
+    gwbuf_add_property(head, "name", "value");
+    int n_freed = 0;
+    gwbuf_add_buffer_object(head, GWBUF_PARSING_INFO, &n_freed, free_object);
+    SHARED_BUF* sbuf = buffer->sbuf;
+    mxb_assert(head->sbuf == sbuf && sbuf->refcount == 2);
+
+    head = gwbuf_make_compact(head);
+    mxb_assert_message(head->sbuf != sbuf, "A small view of a large buffer should be copied");
+    mxb_assert_message(sbuf->refcount == 1, "The original data should be released");
+    mxb_assert(gwbuf_length(head) == 10 && memcmp(GWBUF_DATA(head), "aaaaaaaaaa", 10) == 0);
+    mxb_assert(GWBUF_SHOULD_COLLECT_RESULT(head));
+    mxb_assert_message(strcmp(gwbuf_get_property(head, "name"), "value") == 0,
+                       "The properties should be copied");
+    mxb_assert_message(n_freed == 0 && GWBUF_IS_PARSED(head), "The buffer objects should be moved");
+    gwbuf_free(head);
+    mxb_assert_message(n_freed == 1, "The buffer object should be freed with the copy");
+
+    GWBUF* small = gwbuf_alloc(10);
+    mxb_assert_message(gwbuf_make_compact(small) == small, "A buffer of its own should not be copied");
+    gwbuf_free(small);
+
+    GWBUF* medium = gwbuf_split(&buffer, 6 * 1024);
+    GWBUF* compacted = gwbuf_make_compact(medium);
+    mxb_assert_message(compacted == medium, "A view of a good part of a buffer should not be copied");
+    gwbuf_free(compacted);
+
+    GWBUF* large = gwbuf_make_compact(buffer);
+    mxb_assert_message(large == buffer, "A large buffer should not be copied");
+    gwbuf_free(large);
+}
+
+void test_external()
+{
+    char data[] = "0123456789";
+    int n_released = 0;
+
+    GWBUF* buffer = gwbuf_alloc_external(data, 10, free_object, &n_released);
+    mxb_assert_message(GWBUF_DATA(buffer) == (uint8_t*)data, "External data should not be copied");
+    mxb_assert(gwbuf_length(buffer) == 10);
+    mxb_assert(!GWBUF_IS_PARSED(buffer));
+
+    GWBUF* clone = gwbuf_clone(buffer);
+    gwbuf_free(buffer);
+    mxb_assert_message(n_released == 0, "The data should be referred to by the clone");
+
+    clone = gwbuf_consume(clone, 4);
+    mxb_assert(memcmp(GWBUF_DATA(clone), "456789", 6) == 0);
+    gwbuf_free(clone);
+    mxb_assert_message(n_released == 1, "The data should be released with the last reference");
+}
+
+void test_pool()
+{
+    mxs::BufferPool::thread_init(0);
+
+    // The original is freed before the clone, so the block must outlive its embedded header.
+    GWBUF* original = gwbuf_alloc_and_load(5, "12345");
+    GWBUF* clone = gwbuf_clone(original);
+    gwbuf_free(original);
+    mxb_assert(memcmp(GWBUF_DATA(clone), "12345", 5) == 0);
+    gwbuf_free(clone);
+
+    GWBUF* buf = gwbuf_alloc(100);
+    gwbuf_free(buf);
+
+    mxs::BufferPool::Stats before = mxs::BufferPool::get_stats();
+    buf = gwbuf_alloc(100);
+    mxs::BufferPool::Stats after = mxs::BufferPool::get_stats();
+    mxb_assert_message(after.n_hit == before.n_hit + 1, "A released block should be reused");
+
+    // Buffers released by another thread are returned to the owning pool.
+    std::thread([buf]() {
+                    gwbuf_free(buf);
+                }).join();
+
+    before = mxs::BufferPool::get_stats();
+    mxs::BufferPool::tick();
+    after = mxs::BufferPool::get_stats();
+    mxb_assert_message(after.n_remote_free == before.n_remote_free + 1,
+                       "A remotely released block should be reclaimed");
+
+    // Large buffers bypass the size classes.
+    buf = gwbuf_alloc(1024 * 1024);
+    mxb_assert(buf);
+    gwbuf_free(buf);
+
+    mxs::BufferPool::thread_finish();
+    mxb_assert(mxs::BufferPool::get_stats().n_cached == 0);
+}
+
 /**
  * test1    Allocate a buffer and do lots of things
  *
@@ -577,6 +706,10 @@ static int test1()
     test_consume();
     test_compare();
     test_clone();
+    test_split_view();
+    test_compact();
+    test_external();
+    test_pool();
 
     return 0;
 }
@@ -81,7 +81,8 @@ static int test1()
                                              9876,
                                              "MySQLAuth",
                                              NULL,
-                                             NULL),
+                                             NULL,
+                                             false),
                        "Add Protocol should succeed");
     mxb_assert_message(0 != serviceHasListener(service, "TestProtocol", "mariadbclient", "localhost", 9876),
                        "Service should have new protocol as requested");
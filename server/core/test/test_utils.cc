@@ -169,6 +169,47 @@ int test_checksums()
     return 0;
 }
 
+int test_murmur3()
+{
+    const char data[] = "The quick brown fox jumps over the lazy dog";
+    const size_t len = sizeof(data) - 1;
+    int rv = 0;
+
+    mxs::Murmur3Checksum sum;
+    sum.update(reinterpret_cast<const uint8_t*>(data), len);
+    sum.finalize();
+
+    // The reference value of MurmurHash3_x64_128 with a zero seed
+    if (sum.hex() != "6c1b07bc7bbc4be347939ac4a93c437a")
+    {
+        cout << "Unexpected MurmurHash3 value: " << sum.hex() << endl;
+        ++rv;
+    }
+
+    // Feeding the data in pieces must not affect the result
+    for (size_t step = 1; step <= len; ++step)
+    {
+        GWBUF* buf = NULL;
+
+        for (size_t i = 0; i < len; i += step)
+        {
+            buf = gwbuf_append(buf, gwbuf_alloc_and_load(std::min(step, len - i), data + i));
+        }
+
+        mxs::Murmur3Checksum other;
+        other.finalize(buf);
+        gwbuf_free(buf);
+
+        if (other != sum)
+        {
+            cout << "MurmurHash3 value depends on the buffer layout, step " << step << endl;
+            ++rv;
+        }
+    }
+
+    return rv;
+}
+
 int main(int argc, char* argv[])
 {
     int rv = 0;
@@ -178,6 +219,8 @@ int main(int argc, char* argv[])
     rv += test_trim_trailing();
     rv += test_checksums<mxs::SHA1Checksum>();
     rv += test_checksums<mxs::CRC32Checksum>();
+    rv += test_checksums<mxs::Murmur3Checksum>();
+    rv += test_murmur3();
 
     return rv;
 }
@@ -1001,12 +1001,13 @@ bool configure_network_socket(int so, int type)
     return setnonblocking(so) == 0;
 }
 
-static bool configure_listener_socket(int so)
+static bool configure_listener_socket(int so, bool reuseport)
 {
     int one = 1;
 
     if (setsockopt(so, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one)) != 0
-        || setsockopt(so, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) != 0)
+        || setsockopt(so, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one)) != 0
+        || (reuseport && setsockopt(so, SOL_SOCKET, SO_REUSEPORT, &one, sizeof(one)) != 0))
     {
         MXS_ERROR("Failed to set socket option: %d, %s.", errno, mxs_strerror(errno));
         return false;
@@ -1039,7 +1040,9 @@ int open_network_socket(enum mxs_socket_type type,
                         const char* host,
                         uint16_t port)
 {
-    mxb_assert(type == MXS_SOCKET_NETWORK || type == MXS_SOCKET_LISTENER);
+    mxb_assert(type == MXS_SOCKET_NETWORK || type == MXS_SOCKET_LISTENER
+               || type == MXS_SOCKET_LISTENER_REUSEPORT);
+    bool listener = type != MXS_SOCKET_NETWORK;
     struct addrinfo* ai = NULL, hint = {};
     int so = 0, rc = 0;
     hint.ai_socktype = SOCK_STREAM;
@@ -1065,12 +1068,12 @@ int open_network_socket(enum mxs_socket_type type,
             set_port(addr, port);
 
             if ((type == MXS_SOCKET_NETWORK && !configure_network_socket(so, addr->ss_family))
-                || (type == MXS_SOCKET_LISTENER && !configure_listener_socket(so)))
+                || (listener && !configure_listener_socket(so, type == MXS_SOCKET_LISTENER_REUSEPORT)))
             {
                 close(so);
                 so = -1;
             }
-            else if (type == MXS_SOCKET_LISTENER && bind(so, (struct sockaddr*)addr, sizeof(*addr)) < 0)
+            else if (listener && bind(so, (struct sockaddr*)addr, sizeof(*addr)) < 0)
             {
                 MXS_ERROR("Failed to bind on '%s:%u': %d, %s",
                           host,
@@ -1208,6 +1211,131 @@ std::string to_hex(uint8_t value)
     return out;
 }
 
+namespace
+{
+
+const uint64_t MURMUR3_C1 = 0x87c37b91114253d5ULL;
+const uint64_t MURMUR3_C2 = 0x4cf5ad432745937fULL;
+
+inline uint64_t rotl64(uint64_t x, int r)
+{
+    return (x << r) | (x >> (64 - r));
+}
+
+inline uint64_t fmix64(uint64_t k)
+{
+    k ^= k >> 33;
+    k *= 0xff51afd7ed558ccdULL;
+    k ^= k >> 33;
+    k *= 0xc4ceb9fe1a85ec53ULL;
+    k ^= k >> 33;
+    return k;
+}
+}
+
+void Murmur3Checksum::mix_block(const uint8_t* pBlock)
+{
+    uint64_t k1 = get_byteN(pBlock, 8);
+    uint64_t k2 = get_byteN(pBlock + 8, 8);
+
+    k1 *= MURMUR3_C1;
+    k1 = rotl64(k1, 31);
+    k1 *= MURMUR3_C2;
+    m_h1 ^= k1;
+
+    m_h1 = rotl64(m_h1, 27);
+    m_h1 += m_h2;
+    m_h1 = m_h1 * 5 + 0x52dce729;
+
+    k2 *= MURMUR3_C2;
+    k2 = rotl64(k2, 33);
+    k2 *= MURMUR3_C1;
+    m_h2 ^= k2;
+
+    m_h2 = rotl64(m_h2, 31);
+    m_h2 += m_h1;
+    m_h2 = m_h2 * 5 + 0x38495ab5;
+}
+
+void Murmur3Checksum::update(const uint8_t* pData, size_t len)
+{
+    m_length += len;
+
+    if (m_tail_len > 0)
+    {
+        size_t n = std::min(len, (size_t)BLOCK_SIZE - m_tail_len);
+        memcpy(m_tail + m_tail_len, pData, n);
+        m_tail_len += n;
+        pData += n;
+        len -= n;
+
+        if (m_tail_len == BLOCK_SIZE)
+        {
+            mix_block(m_tail);
+            m_tail_len = 0;
+        }
+    }
+
+    for (; len >= BLOCK_SIZE; len -= BLOCK_SIZE, pData += BLOCK_SIZE)
+    {
+        mix_block(pData);
+    }
+
+    if (len > 0)
+    {
+        memcpy(m_tail, pData, len);
+        m_tail_len = len;
+    }
+}
+
+void Murmur3Checksum::update(GWBUF* buffer)
+{
+    for (GWBUF* b = buffer; b; b = b->next)
+    {
+        update(GWBUF_DATA(b), GWBUF_LENGTH(b));
+    }
+}
+
+void Murmur3Checksum::finalize(GWBUF* buffer)
+{
+    update(buffer);
+
+    uint64_t k1 = get_byteN(m_tail, std::min(m_tail_len, (size_t)8));
+    uint64_t k2 = m_tail_len > 8 ? get_byteN(m_tail + 8, m_tail_len - 8) : 0;
+
+    if (m_tail_len > 8)
+    {
+        k2 *= MURMUR3_C2;
+        k2 = rotl64(k2, 33);
+        k2 *= MURMUR3_C1;
+        m_h2 ^= k2;
+    }
+
+    if (m_tail_len > 0)
+    {
+        k1 *= MURMUR3_C1;
+        k1 = rotl64(k1, 31);
+        k1 *= MURMUR3_C2;
+        m_h1 ^= k1;
+    }
+
+    m_h1 ^= m_length;
+    m_h2 ^= m_length;
+
+    m_h1 += m_h2;
+    m_h2 += m_h1;
+
+    m_h1 = fmix64(m_h1);
+    m_h2 = fmix64(m_h2);
+
+    m_h1 += m_h2;
+    m_h2 += m_h1;
+
+    m_sum[0] = m_h1;
+    m_sum[1] = m_h2;
+    reset();
+}
+
 uint64_t get_byteN(const uint8_t* ptr, int bytes)
 {
     uint64_t rval = 0;
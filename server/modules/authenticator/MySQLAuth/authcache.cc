@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "authcache.hh"
+
+using std::string;
+
+const string* AuthCache::find(const SUserIndex& users, const string& key)
+{
+    check_users(users);
+
+    Entries::iterator it = m_current.find(key);
+
+    if (it == m_current.end())
+    {
+        Entries::iterator prev = m_previous.find(key);
+
+        if (prev == m_previous.end())
+        {
+            return nullptr;
+        }
+
+        // Still in use, move it to the current generation. The value is copied
+        // as the previous generation is replaced if the current one is full.
+        string password = std::move(prev->second);
+        m_previous.erase(prev);
+        insert(users, key, password);
+        it = m_current.find(key);
+    }
+
+    return &it->second;
+}
+
+void AuthCache::insert(const SUserIndex& users, const string& key, const string& password)
+{
+    check_users(users);
+
+    if (m_current.size() >= MAX_ENTRIES / 2)
+    {
+        m_previous = std::move(m_current);
+        m_current.clear();
+    }
+
+    m_current[key] = password;
+}
+
+// static
+string AuthCache::make_key(const char* user, const char* host, const char* db)
+{
+    string key(user);
+    key += '\0';
+    key += host;
+    key += '\0';
+    key += db;
+    return key;
+}
+
+void AuthCache::check_users(const SUserIndex& users)
+{
+    if (m_users != users)
+    {
+        m_users = users;
+        m_current.clear();
+        m_previous.clear();
+    }
+}
@@ -0,0 +1,78 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <string>
+#include <unordered_map>
+#include "userindex.hh"
+
+/**
+ * A bounded cache of the successful user lookups of one worker. The key is
+ * the user, the client address and the default database and the value is the
+ * password hash the client was authenticated with, so a cached login skips
+ * the user lookup, the hostname resolution and the database check but
+ * still verifies the scramble.
+ *
+ * The entries are valid only for the users they were looked up from, so
+ * the cache is emptied whenever the users have been reloaded. The entries
+ * are kept in two generations: when the current one is full, it replaces
+ * the previous one, which drops the entries that have not been used since.
+ */
+class AuthCache
+{
+public:
+    enum
+    {
+        MAX_ENTRIES = 4096
+    };
+
+    /**
+     * Find the password hash of a login.
+     *
+     * @param users The current users.
+     * @param key   Key created with make_key().
+     *
+     * @return The password hash, or NULL if the login is not in the cache.
+     */
+    const std::string* find(const SUserIndex& users, const std::string& key);
+
+    /**
+     * Add a successful login.
+     *
+     * @param users    The users the login was authenticated with.
+     * @param key      Key created with make_key().
+     * @param password The password hash of the login.
+     */
+    void insert(const SUserIndex& users, const std::string& key, const std::string& password);
+
+    /**
+     * Create the key of a login.
+     *
+     * @param user The user name.
+     * @param host The client address.
+     * @param db   The default database.
+     *
+     * @return The key.
+     */
+    static std::string make_key(const char* user, const char* host, const char* db);
+
+private:
+    typedef std::unordered_map<std::string, std::string> Entries;
+
+    void check_users(const SUserIndex& users);
+
+    SUserIndex m_users;     /*< The users the entries were looked up from. */
+    Entries    m_current;
+    Entries    m_previous;
+};
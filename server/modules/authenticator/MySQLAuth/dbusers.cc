@@ -253,40 +253,9 @@ static bool check_password(const char* output,
     return memcmp(final_step, stored_token, stored_token_len) == 0;
 }
 
-/** Callback for check_database() */
-static int database_cb(void* data, int columns, char** rows, char** row_names)
+static bool check_database(MYSQL_AUTH* instance, const UserIndex& users, const char* database)
 {
-    bool* rval = (bool*)data;
-    *rval = true;
-    return 0;
-}
-
-static bool check_database(MYSQL_AUTH* instance, sqlite3* handle, const char* database)
-{
-    bool rval = true;
-
-    if (*database)
-    {
-        rval = false;
-        const char* query = instance->lower_case_table_names ?
-            mysqlauth_validate_database_query_lower :
-            mysqlauth_validate_database_query;
-        size_t len = strlen(query) + strlen(database) + 1;
-        char sql[len];
-
-        sprintf(sql, query, database);
-
-        char* err;
-
-        if (sqlite3_exec(handle, sql, database_cb, &rval, &err) != SQLITE_OK)
-        {
-            MXS_ERROR("Failed to execute auth query: %s", err);
-            sqlite3_free(err);
-            rval = false;
-        }
-    }
-
-    return rval;
+    return !*database || users.has_database(database, instance->lower_case_table_names);
 }
 
 static bool no_password_required(const char* result, size_t tok_len)
@@ -294,20 +263,18 @@ static bool no_password_required(const char* result, size_t tok_len)
     return *result == '\0' && tok_len == 0;
 }
 
-/** Used to detect empty result sets */
-struct user_query_result
-{
-    bool ok;
-    char output[SHA_DIGEST_LENGTH * 2 + 1];
-};
-
-/** @brief Callback for sqlite3_exec() */
-static int auth_cb(void* data, int columns, char** rows, char** row_names)
+static bool check_user_password(const std::string& password,
+                                MYSQL_session* session,
+                                uint8_t* scramble,
+                                size_t   scramble_len)
 {
-    struct user_query_result* res = (struct user_query_result*)data;
-    strcpy(res->output, rows[0] ? rows[0] : "");
-    res->ok = true;
-    return 0;
+    return no_password_required(password.c_str(), session->auth_token_len)
+           || check_password(password.c_str(),
+                             session->auth_token,
+                             session->auth_token_len,
+                             scramble,
+                             scramble_len,
+                             session->client_sha1);
 }
 
 int validate_mysql_user(MYSQL_AUTH* instance,
@@ -316,97 +283,48 @@ int validate_mysql_user(MYSQL_AUTH* instance,
                         uint8_t* scramble,
                         size_t   scramble_len)
 {
-    sqlite3* handle = get_handle(instance);
-    const char* validate_query = instance->lower_case_table_names ?
-        mysqlauth_validate_user_query_lower :
-        mysqlauth_validate_user_query;
-    size_t len = strlen(validate_query) + 1 + strlen(session->user) * 2
-        + strlen(session->db) * 2 + MYSQL_HOST_MAXLEN + session->auth_token_len * 4 + 1;
-    char sql[len + 1];
-    int rval = MXS_AUTH_FAILED;
-    char* err;
+    SUserIndex users = get_user_index(instance);
+    AuthCache& cache = *instance->cache;
+    std::string key = AuthCache::make_key(session->user, instance->skip_auth ? "" : dcb->remote, session->db);
 
-    if (instance->skip_auth)
+    if (const std::string* cached = cache.find(users, key))
     {
-        sprintf(sql, mysqlauth_skip_auth_query, session->user, session->db, session->db);
-    }
-    else
-    {
-        sprintf(sql,
-                validate_query,
-                session->user,
-                dcb->remote,
-                dcb->remote,
-                session->db,
-                session->db);
+        // The user and the database have already been checked, only the password
+        // needs to be checked as the scramble is different for each connection.
+        return check_user_password(*cached, session, scramble, scramble_len) ?
+               MXS_AUTH_SUCCEEDED : MXS_AUTH_FAILED;
     }
 
-    struct user_query_result res = {};
+    bool lower_case = instance->lower_case_table_names;
+    int rval = MXS_AUTH_FAILED;
+    std::string password;
+    bool found;
 
-    if (sqlite3_exec(handle, sql, auth_cb, &res, &err) != SQLITE_OK)
+    if (instance->skip_auth)
     {
-        MXS_ERROR("Failed to execute auth query: %s", err);
-        sqlite3_free(err);
+        found = users->find_user(session->user, NULL, session->db, lower_case, &password);
     }
-
-    /** Check for IPv6 mapped IPv4 address */
-    if (!res.ok && strchr(dcb->remote, ':') && strchr(dcb->remote, '.'))
+    else
     {
-        const char* ipv4 = strrchr(dcb->remote, ':') + 1;
-        sprintf(sql,
-                validate_query,
-                session->user,
-                ipv4,
-                ipv4,
-                session->db,
-                session->db);
-
-        if (sqlite3_exec(handle, sql, auth_cb, &res, &err) != SQLITE_OK)
-        {
-            MXS_ERROR("Failed to execute auth query: %s", err);
-            sqlite3_free(err);
-        }
-    }
+        auto hostname = [dcb]() {
+                char client_hostname[MYSQL_HOST_MAXLEN] = "";
+                get_hostname(dcb, client_hostname, sizeof(client_hostname) - 1);
+                return std::string(client_hostname);
+            };
 
-    if (!res.ok)
-    {
-        /**
-         * Try authentication with the hostname instead of the IP. We do this only
-         * as a last resort so we avoid the high cost of the DNS lookup.
-         */
-        char client_hostname[MYSQL_HOST_MAXLEN] = "";
-        get_hostname(dcb, client_hostname, sizeof(client_hostname) - 1);
-
-        sprintf(sql,
-                validate_query,
-                session->user,
-                client_hostname,
-                client_hostname,
-                session->db,
-                session->db);
-
-        if (sqlite3_exec(handle, sql, auth_cb, &res, &err) != SQLITE_OK)
-        {
-            MXS_ERROR("Failed to execute auth query: %s", err);
-            sqlite3_free(err);
-        }
+        found = users->find_client(session->user, dcb->remote, session->db, lower_case, hostname, &password);
     }
 
-    if (res.ok)
+    if (found)
     {
-        /** Found a matching row */
-
-        if (no_password_required(res.output, session->auth_token_len)
-            || check_password(res.output,
-                              session->auth_token,
-                              session->auth_token_len,
-                              scramble,
-                              scramble_len,
-                              session->client_sha1))
+        /** Found a matching grant */
+
+        if (check_user_password(password, session, scramble, scramble_len))
         {
             /** Password is OK, check that the database exists */
-            if (check_database(instance, handle, session->db))
+            if (check_database(instance, *users, session->db))
             {
+                cache.insert(users, key, password);
                 rval = MXS_AUTH_SUCCEEDED;
             }
             else
@@ -419,114 +337,13 @@ int validate_mysql_user(MYSQL_AUTH* instance,
     return rval;
 }
 
-/**
- * @brief Delete all users
- *
- * @param handle SQLite handle
- */
-static bool delete_mysql_users(sqlite3* handle)
-{
-    bool rval = true;
-    char* err;
-
-    if (sqlite3_exec(handle, delete_users_query, NULL, NULL, &err) != SQLITE_OK
-        || sqlite3_exec(handle, delete_databases_query, NULL, NULL, &err) != SQLITE_OK)
-    {
-        MXS_ERROR("Failed to delete old users: %s", err);
-        sqlite3_free(err);
-        rval = false;
-    }
-
-    return rval;
-}
-
-/**
- * If the hostname is of form a.b.c.d/e.f.g.h where e-h is 255 or 0, replace
- * the zeros in the first part with '%' and remove the second part. This does
- * not yet support netmasks completely, but should be sufficient for most
- * situations. In case of error, the hostname may end in an invalid state, which
- * will cause an error later on.
- *
- * @param host  The hostname, which is modified in-place. If merging is unsuccessful,
- *              it may end up garbled.
- */
-static void merge_netmask(char* host)
-{
-    char* delimiter_loc = strchr(host, '/');
-    if (delimiter_loc == NULL)
-    {
-        return;     // Nothing to do
-    }
-    /* If anything goes wrong, we put the '/' back in to ensure the hostname
-     * cannot be used.
-     */
-    *delimiter_loc = '\0';
-
-    char* ip_token_loc = host;
-    char* mask_token_loc = delimiter_loc + 1;   // This is at minimum a \0
-
-    while (ip_token_loc && mask_token_loc)
-    {
-        if (strncmp(mask_token_loc, "255", 3) == 0)
-        {
-            // Skip
-        }
-        else if (*mask_token_loc == '0' && *ip_token_loc == '0')
-        {
-            *ip_token_loc = '%';
-        }
-        else
-        {
-            /* Any other combination is considered invalid. This may leave the
-             * hostname in a partially modified state.
-             * TODO: handle more cases
-             */
-            *delimiter_loc = '/';
-            MXS_ERROR("Unrecognized IP-bytes in host/mask-combination. "
-                      "Merge incomplete: %s",
-                      host);
-            return;
-        }
-
-        ip_token_loc = strchr(ip_token_loc, '.');
-        mask_token_loc = strchr(mask_token_loc, '.');
-        if (ip_token_loc && mask_token_loc)
-        {
-            ip_token_loc++;
-            mask_token_loc++;
-        }
-    }
-    if (ip_token_loc || mask_token_loc)
-    {
-        *delimiter_loc = '/';
-        MXS_ERROR("Unequal number of IP-bytes in host/mask-combination. "
-                  "Merge incomplete: %s",
-                  host);
-    }
-}
-
-void add_mysql_user(sqlite3* handle,
+void add_mysql_user(UserIndex* users,
                     const char* user,
                     const char* host,
                     const char* db,
                     bool anydb,
                     const char* pw)
 {
-    size_t dblen = db && *db ? strlen(db) + 2 : sizeof(null_token);     /** +2 for single quotes */
-    char dbstr[dblen + 1];
-
-    if (db && *db)
-    {
-        sprintf(dbstr, "'%s'", db);
-    }
-    else
-    {
-        strcpy(dbstr, null_token);
-    }
-
-    size_t pwlen = pw && *pw ? strlen(pw) + 2 : sizeof(null_token);     /** +2 for single quotes */
-    char pwstr[pwlen + 1];
-
     if (pw && *pw)
     {
         if (strlen(pw) == 16)
@@ -544,41 +361,12 @@ void add_mysql_user(sqlite3* handle,
         {
             pw++;
         }
-        sprintf(pwstr, "'%s'", pw);
     }
-    else
-    {
-        strcpy(pwstr, null_token);
-    }
-
-    size_t len = sizeof(insert_user_query) + strlen(user) + strlen(host) + dblen + pwlen + 1;
 
-    char insert_sql[len + 1];
-    sprintf(insert_sql, insert_user_query, user, host, dbstr, anydb ? "1" : "0", pwstr);
-
-    char* err;
-    if (sqlite3_exec(handle, insert_sql, NULL, NULL, &err) != SQLITE_OK)
-    {
-        MXS_ERROR("Failed to insert user: %s", err);
-        sqlite3_free(err);
-    }
+    users->add_user(user, host, db, anydb, pw);
 
-    MXS_INFO("Added user: %s", insert_sql);
-}
-
-static void add_database(sqlite3* handle, const char* db)
-{
-    size_t len = sizeof(insert_database_query) + strlen(db) + 1;
-    char insert_sql[len + 1];
-
-    sprintf(insert_sql, insert_database_query, db);
-
-    char* err;
-    if (sqlite3_exec(handle, insert_sql, NULL, NULL, &err) != SQLITE_OK)
-    {
-        MXS_ERROR("Failed to insert database: %s", err);
-        sqlite3_free(err);
-    }
+    MXS_INFO("Added user: '%s'@'%s', database: %s, any database: %s",
+             user, host, db && *db ? db : "NULL", anydb ? "yes" : "no");
 }
 
 /**
@@ -990,7 +778,7 @@ static bool have_mdev13453_problem(MYSQL* con, SERVER* server)
     return rval;
 }
 
-bool query_and_process_users(const char* query, MYSQL* con, sqlite3* handle, SERVICE* service, int* users)
+bool query_and_process_users(const char* query, MYSQL* con, UserIndex* index, SERVICE* service, int* users)
 {
     bool rval = false;
 
@@ -1010,12 +798,7 @@ bool query_and_process_users(const char* query, MYSQL* con, sqlite3* handle, SER
                     strip_escape_chars(row[2]);
                 }
 
-                if (strchr(row[1], '/'))
-                {
-                    merge_netmask(row[1]);
-                }
-
-                add_mysql_user(handle, row[0], row[1], row[2],
+                add_mysql_user(index, row[0], row[1], row[2],
                                row[3] && strcmp(row[3], "Y") == 0, row[4]);
                 (*users)++;
             }
@@ -1028,7 +811,7 @@ bool query_and_process_users(const char* query, MYSQL* con, sqlite3* handle, SER
     return rval;
 }
 
-int get_users_from_server(MYSQL* con, SERVER* server, SERVICE* service, SERV_LISTENER* listener)
+int get_users_from_server(MYSQL* con, SERVER* server, SERVICE* service, UserIndex* index)
 {
     if (server->version_string[0] == 0)
     {
@@ -1040,11 +823,9 @@ int get_users_from_server(MYSQL* con, SERVER* server, SERVICE* service, SERV_LIS
                                   service->enable_root,
                                   roles_are_available(con, service, server));
 
-    MYSQL_AUTH* instance = (MYSQL_AUTH*)listener->auth_instance;
-    sqlite3* handle = get_handle(instance);
     int users = 0;
 
-    bool rv = query_and_process_users(query, con, handle, service, &users);
+    bool rv = query_and_process_users(query, con, index, service, &users);
 
     if (!rv && have_mdev13453_problem(con, server))
     {
@@ -1054,7 +835,7 @@ int get_users_from_server(MYSQL* con, SERVER* server, SERVICE* service, SERV_LIS
          */
         MXS_FREE(query);
         query = get_users_query(server->version_string, 100110, service->enable_root, true);
-        rv = query_and_process_users(query, con, handle, service, &users);
+        rv = query_and_process_users(query, con, index, service, &users);
     }
 
     if (!rv)
@@ -1073,7 +854,7 @@ int get_users_from_server(MYSQL* con, SERVER* server, SERVICE* service, SERV_LIS
             MYSQL_ROW row;
             while ((row = mysql_fetch_row(result)))
             {
-                add_database(handle, row[0]);
+                index->add_database(row[0]);
             }
 
             mysql_free_result(result);
@@ -1132,10 +913,9 @@ static int get_users(SERV_LISTENER* listener, bool skip_local, SERVER** srv)
         return -1;
     }
 
-    /** Delete the old users */
+    /** The old users are replaced even if no new users could be loaded */
     MYSQL_AUTH* instance = (MYSQL_AUTH*)listener->auth_instance;
-    sqlite3* handle = get_handle(instance);
-    delete_mysql_users(handle);
+    std::shared_ptr<UserIndex> users = std::make_shared<UserIndex>();
 
     int total_users = -1;
     auto candidates = get_candidates(service, skip_local);
@@ -1154,12 +934,12 @@ static int get_users(SERV_LISTENER* listener, bool skip_local, SERVER** srv)
             else
             {
                 /** Successfully connected to a server */
-                int users = get_users_from_server(con, server, service, listener);
+                int n_users = get_users_from_server(con, server, service, users.get());
 
-                if (users > total_users)
+                if (n_users > total_users)
                 {
                     *srv = server;
-                    total_users = users;
+                    total_users = n_users;
                 }
 
                 mysql_close(con);
@@ -1174,6 +954,9 @@ static int get_users(SERV_LISTENER* listener, bool skip_local, SERVER** srv)
 
     MXS_FREE(dpwd);
 
+    users->finalize();
+    replace_user_index(instance, users);
+
     if (candidates.empty())
     {
         // This service has no servers or all servers are local MaxScale services
@@ -31,6 +31,7 @@
 #include <maxscale/authenticator.h>
 #include <maxscale/alloc.h>
 #include <maxscale/event.hh>
+#include <maxscale/maxscale.h>
 #include <maxscale/poll.h>
 #include <maxscale/paths.h>
 #include <maxscale/secrets.h>
@@ -119,43 +120,56 @@ extern "C"
     }
 }
 
-static bool open_instance_database(const char* path, sqlite3** handle)
+SUserIndex get_user_index(MYSQL_AUTH* instance)
 {
-    int rc = sqlite3_open_v2(path, handle, db_flags, NULL);
+    std::lock_guard<std::mutex> guard(instance->lock);
+    return instance->users;
+}
 
-    if (rc != SQLITE_OK)
-    {
-        MXS_ERROR("Failed to open SQLite3 handle: %d", rc);
-        return false;
-    }
+void replace_user_index(MYSQL_AUTH* instance, SUserIndex users)
+{
+    std::lock_guard<std::mutex> guard(instance->lock);
+    instance->users = users;
+}
 
-    char* err;
+/**
+ * @brief Reload the users after a failed authentication
+ *
+ * Only one worker reloads the users at a time. A worker never waits for
+ * another one to finish a reload, as that would block all of its clients
+ * for the duration of the reload: if a reload is in progress, the failed
+ * authentication is retried only if the users have already changed. The
+ * reloads are also limited to one every `users_refresh_time` seconds for the
+ * whole authenticator instance.
+ *
+ * @param instance Authenticator instance
+ * @param service  The service of the client
+ * @param users    The users the authentication failed with
+ *
+ * @return True if the users changed and the authentication should be retried
+ */
+static bool reload_users(MYSQL_AUTH* instance, SERVICE* service, const SUserIndex& users)
+{
+    std::unique_lock<std::mutex> guard(instance->reload_lock, std::try_to_lock);
 
-    if (sqlite3_exec(*handle, users_create_sql, NULL, NULL, &err) != SQLITE_OK
-        || sqlite3_exec(*handle, databases_create_sql, NULL, NULL, &err) != SQLITE_OK
-        || sqlite3_exec(*handle, pragma_sql, NULL, NULL, &err) != SQLITE_OK)
+    if (!guard.owns_lock() || get_user_index(instance) != users)
     {
-        MXS_ERROR("Failed to create database: %s", err);
-        sqlite3_free(err);
-        sqlite3_close_v2(*handle);
-        return false;
+        // Another worker is reloading or has reloaded the users
+        return get_user_index(instance) != users;
     }
 
-    return true;
-}
-
-sqlite3* get_handle(MYSQL_AUTH* instance)
-{
-    int i = mxs_rworker_get_current_id();
-    mxb_assert(i >= 0);
+    time_t now = time(NULL);
+    time_t limit = config_get_global_options()->users_refresh_time;
 
-    if (instance->handles[i] == NULL)
+    // Repeated reloads are allowed while MaxScale is starting up
+    if (now > maxscale_started() + limit && now < instance->last_reload + limit)
     {
-        MXB_AT_DEBUG(bool rval = ) open_instance_database(":memory:", &instance->handles[i]);
-        mxb_assert(rval);
+        return false;
     }
 
-    return instance->handles[i];
+    instance->last_reload = now;
+
+    return service_refresh_users(service) == 0;
 }
 
 /**
@@ -179,12 +193,13 @@ static bool should_check_permissions(MYSQL_AUTH* instance)
  */
 static void* mysql_auth_init(char** options)
 {
-    MYSQL_AUTH* instance = static_cast<MYSQL_AUTH*>(MXS_MALLOC(sizeof(*instance)));
+    MYSQL_AUTH* instance = new(std::nothrow) MYSQL_AUTH;
 
-    if (instance
-        && (instance->handles = static_cast<sqlite3**>(MXS_CALLOC(config_threadcount(), sizeof(sqlite3*)))))
+    if (instance)
     {
         bool error = false;
+        instance->users = std::make_shared<UserIndex>();
+        instance->last_reload = 0;
         instance->cache_dir = NULL;
         instance->inject_service_user = true;
         instance->skip_auth = false;
@@ -235,16 +250,10 @@ static void* mysql_auth_init(char** options)
         if (error)
         {
             MXS_FREE(instance->cache_dir);
-            MXS_FREE(instance->handles);
-            MXS_FREE(instance);
+            delete instance;
             instance = NULL;
         }
     }
-    else if (instance)
-    {
-        MXS_FREE(instance);
-        instance = NULL;
-    }
 
     return instance;
 }
@@ -340,6 +349,7 @@ static int mysql_auth_authenticate(DCB* dcb)
             }
         }
 
+        SUserIndex users = get_user_index(instance);
         auth_ret = validate_mysql_user(instance,
                                        dcb,
                                        client_data,
@@ -347,7 +357,7 @@ static int mysql_auth_authenticate(DCB* dcb)
                                        sizeof(protocol->scramble));
 
         if (auth_ret != MXS_AUTH_SUCCEEDED
-            && service_refresh_users(dcb->service) == 0)
+            && reload_users(instance, dcb->service, users))
         {
             auth_ret = validate_mysql_user(instance,
                                            dcb,
@@ -730,9 +740,11 @@ static bool add_service_user(SERV_LISTENER* port)
         if (newpw)
         {
             MYSQL_AUTH* inst = (MYSQL_AUTH*)port->auth_instance;
-            sqlite3* handle = get_handle(inst);
-            add_mysql_user(handle, user, "%", "", "Y", newpw);
-            add_mysql_user(handle, user, "localhost", "", "Y", newpw);
+            std::shared_ptr<UserIndex> users = std::make_shared<UserIndex>(*get_user_index(inst));
+            add_mysql_user(users.get(), user, "%", "", true, newpw);
+            add_mysql_user(users.get(), user, "localhost", "", true, newpw);
+            users->finalize();
+            replace_user_index(inst, users);
             MXS_FREE(newpw);
             rval = true;
         }
@@ -862,9 +874,10 @@ int mysql_auth_reauthenticate(DCB* dcb,
     temp.auth_token_len = token_len;
 
     MYSQL_AUTH* instance = (MYSQL_AUTH*)dcb->listener->auth_instance;
+    SUserIndex users = get_user_index(instance);
     int rc = validate_mysql_user(instance, dcb, &temp, scramble, scramble_len);
 
-    if (rc != MXS_AUTH_SUCCEEDED && service_refresh_users(dcb->service) == 0)
+    if (rc != MXS_AUTH_SUCCEEDED && reload_users(instance, dcb->service, users))
     {
         rc = validate_mysql_user(instance, dcb, &temp, scramble, scramble_len);
     }
@@ -878,59 +891,26 @@ int mysql_auth_reauthenticate(DCB* dcb,
     return rval;
 }
 
-int diag_cb(void* data, int columns, char** row, char** field_names)
-{
-    DCB* dcb = (DCB*)data;
-    dcb_printf(dcb, "%s@%s ", row[0], row[1]);
-    return 0;
-}
-
 void mysql_auth_diagnostic(DCB* dcb, SERV_LISTENER* port)
 {
     MYSQL_AUTH* instance = (MYSQL_AUTH*)port->auth_instance;
-    sqlite3* handle = get_handle(instance);
-    char* err;
-
-    if (sqlite3_exec(handle,
-                     "SELECT user, host FROM " MYSQLAUTH_USERS_TABLE_NAME,
-                     diag_cb,
-                     dcb,
-                     &err) != SQLITE_OK)
-    {
-        dcb_printf(dcb, "Could not access users: %s", err);
-        MXS_ERROR("Could not access users: %s", err);
-        sqlite3_free(err);
-    }
-}
-
-int diag_cb_json(void* data, int columns, char** row, char** field_names)
-{
-    json_t* obj = json_object();
-    json_object_set_new(obj, "user", json_string(row[0]));
-    json_object_set_new(obj, "host", json_string(row[1]));
 
-    json_t* arr = (json_t*)data;
-    json_array_append_new(arr, obj);
-    return 0;
+    get_user_index(instance)->for_each([dcb](const std::string& user, const std::string& host) {
+                                           dcb_printf(dcb, "%s@%s ", user.c_str(), host.c_str());
+                                       });
 }
 
 json_t* mysql_auth_diagnostic_json(const SERV_LISTENER* port)
 {
     json_t* rval = json_array();
-
     MYSQL_AUTH* instance = (MYSQL_AUTH*)port->auth_instance;
-    char* err;
-    sqlite3* handle = get_handle(instance);
-
-    if (sqlite3_exec(handle,
-                     "SELECT user, host FROM " MYSQLAUTH_USERS_TABLE_NAME,
-                     diag_cb_json,
-                     rval,
-                     &err) != SQLITE_OK)
-    {
-        MXS_ERROR("Failed to print users: %s", err);
-        sqlite3_free(err);
-    }
+
+    get_user_index(instance)->for_each([rval](const std::string& user, const std::string& host) {
+                                           json_t* obj = json_object();
+                                           json_object_set_new(obj, "user", json_string(user.c_str()));
+                                           json_object_set_new(obj, "host", json_string(host.c_str()));
+                                           json_array_append_new(rval, obj);
+                                       });
 
     return rval;
 }
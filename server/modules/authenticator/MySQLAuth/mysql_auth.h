@@ -28,6 +28,7 @@
 
 #include <stdint.h>
 #include <arpa/inet.h>
+#include <mutex>
 
 #include <maxscale/authenticator.h>
 #include <maxscale/dcb.h>
@@ -35,6 +36,10 @@
 #include <maxscale/service.h>
 #include <maxscale/sqlite3.h>
 #include <maxscale/protocol/mysql.h>
+#include <maxscale/routingworker.hh>
+
+#include "authcache.hh"
+#include "userindex.hh"
 
 MXS_BEGIN_DECLS
 
@@ -42,86 +47,19 @@ MXS_BEGIN_DECLS
 static const char DBUSERS_DIR[] = "cache";
 static const char DBUSERS_FILE[] = "dbusers.db";
 
-/** The table name where we store the users */
-#define MYSQLAUTH_USERS_TABLE_NAME "mysqlauth_users"
-
-/** The table name where we store the users */
-#define MYSQLAUTH_DATABASES_TABLE_NAME "mysqlauth_databases"
-
-/** CREATE TABLE statement for the in-memory users table */
-static const char users_create_sql[] =
-    "CREATE TABLE IF NOT EXISTS " MYSQLAUTH_USERS_TABLE_NAME
-    "(user varchar(255), host varchar(255), db varchar(255), anydb boolean, password text)";
-
-/** CREATE TABLE statement for the in-memory databases table */
-static const char databases_create_sql[] =
-    "CREATE TABLE IF NOT EXISTS " MYSQLAUTH_DATABASES_TABLE_NAME "(db varchar(255))";
-
-/** PRAGMA configuration options for SQLite */
-static const char pragma_sql[] = "PRAGMA JOURNAL_MODE=NONE";
-
-/** Query that checks if there's a grant for the user being authenticated */
-static const char mysqlauth_validate_user_query[] =
-    "SELECT password FROM " MYSQLAUTH_USERS_TABLE_NAME
-    " WHERE user = '%s' AND ( '%s' = host OR '%s' LIKE host)"
-    " AND (anydb = '1' OR '%s' IN ('', 'information_schema') OR '%s' LIKE db)"
-    " LIMIT 1";
-
-/** Query that checks if there's a grant for the user being authenticated */
-static const char mysqlauth_validate_user_query_lower[] =
-    "SELECT password FROM " MYSQLAUTH_USERS_TABLE_NAME
-    " WHERE user = '%s' AND ( '%s' = host OR '%s' LIKE host)"
-    " AND (anydb = '1' OR LOWER('%s') IN ('', 'information_schema') OR LOWER('%s') LIKE LOWER(db))"
-    " LIMIT 1";
-
-/** Query that only checks if there's a matching user */
-static const char mysqlauth_skip_auth_query[] =
-    "SELECT password FROM " MYSQLAUTH_USERS_TABLE_NAME
-    " WHERE user = '%s' AND (anydb = '1' OR '%s' IN ('', 'information_schema') OR '%s' LIKE db)"
-    " LIMIT 1";
-
-/** Query that checks that the database exists */
-static const char mysqlauth_validate_database_query[] =
-    "SELECT * FROM " MYSQLAUTH_DATABASES_TABLE_NAME " WHERE db = '%s' LIMIT 1";
-static const char mysqlauth_validate_database_query_lower[] =
-    "SELECT * FROM " MYSQLAUTH_DATABASES_TABLE_NAME " WHERE LOWER(db) = LOWER('%s') LIMIT 1";
-
-/** Delete query used to clean up the database before loading new users */
-static const char delete_users_query[] = "DELETE FROM " MYSQLAUTH_USERS_TABLE_NAME;
-
-/** Delete query used to clean up the database before loading new users */
-static const char delete_databases_query[] = "DELETE FROM " MYSQLAUTH_DATABASES_TABLE_NAME;
-
-/** The insert query template which adds users to the mysqlauth_users table */
-static const char insert_user_query[] =
-    "INSERT OR REPLACE INTO " MYSQLAUTH_USERS_TABLE_NAME " VALUES ('%s', '%s', %s, %s, %s)";
-
-/** The insert query template which adds the databases to the table */
-static const char insert_database_query[] =
-    "INSERT OR REPLACE INTO " MYSQLAUTH_DATABASES_TABLE_NAME " VALUES ('%s')";
-
-static const char dump_users_query[] =
-    "SELECT user, host, db, anydb, password FROM " MYSQLAUTH_USERS_TABLE_NAME;
-
-static const char dump_databases_query[] =
-    "SELECT db FROM " MYSQLAUTH_DATABASES_TABLE_NAME;
-
-/** Used for NULL value creation in the INSERT query */
-static const char null_token[] = "NULL";
-
-/** Flags for sqlite3_open_v2() */
-static int db_flags = SQLITE_OPEN_READWRITE
-    | SQLITE_OPEN_CREATE
-    | SQLITE_OPEN_NOMUTEX;
-
 typedef struct mysql_auth
 {
-    sqlite3** handles;              /**< SQLite3 database handle */
-    char*     cache_dir;            /**< Custom cache directory location */
-    bool      inject_service_user;  /**< Inject the service user into the list of users */
-    bool      skip_auth;            /**< Authentication will always be successful */
-    bool      check_permissions;
-    bool      lower_case_table_names;   /**< Disable database case-sensitivity */
+    std::mutex                    lock;                     /**< Protects @c users */
+    SUserIndex                    users;                    /**< The users, shared by all workers */
+    std::mutex                    reload_lock;              /**< Held by the worker reloading after a failed login */
+    time_t                        last_reload;              /**< When a failed login reloaded the users */
+    mxs::rworker_local<AuthCache> cache;                    /**< Successful logins of each worker */
+    char*                         cache_dir;                /**< Custom cache directory location */
+    bool                          inject_service_user;      /**< Inject the service user into the list of
+                                                             * users */
+    bool                          skip_auth;                /**< Authentication will always be successful */
+    bool                          check_permissions;
+    bool                          lower_case_table_names;   /**< Disable database case-sensitivity */
 } MYSQL_AUTH;
 
 /**
@@ -137,24 +75,32 @@ typedef struct mysql_user_host_key
 } MYSQL_USER_HOST;
 
 /**
- * @brief Get the thread-specific SQLite handle
+ * @brief Get the current users
  *
  * @param instance Authenticator instance
  *
- * @return The thread-specific handle
+ * @return The users
+ */
+SUserIndex get_user_index(MYSQL_AUTH* instance);
+
+/**
+ * @brief Replace the current users
+ *
+ * @param instance Authenticator instance
+ * @param users    The new users, finalized
  */
-sqlite3* get_handle(MYSQL_AUTH* instance);
+void replace_user_index(MYSQL_AUTH* instance, SUserIndex users);
 
 /**
  * @brief Add new MySQL user to the internal user database
  *
- * @param handle Database handle
+ * @param users  The users being loaded
  * @param user   Username
  * @param host   Host
  * @param db     Database
  * @param anydb  Global access to databases
  */
-void add_mysql_user(sqlite3* handle,
+void add_mysql_user(UserIndex* users,
                     const char* user,
                     const char* host,
                     const char* db,
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../authcache.hh"
+
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+
+const size_t GENERATION = AuthCache::MAX_ENTRIES / 2;
+
+string key(size_t i)
+{
+    return AuthCache::make_key("user", "127.0.0.1", to_string(i).c_str());
+}
+
+string password(size_t i)
+{
+    return "password" + to_string(i);
+}
+
+bool found(AuthCache& cache, const SUserIndex& users, size_t i)
+{
+    const string* pPassword = cache.find(users, key(i));
+    return pPassword && *pPassword == password(i);
+}
+
+int expect(bool cond, const string& what)
+{
+    if (!cond)
+    {
+        cout << "error: " << what << endl;
+    }
+
+    return cond ? 0 : 1;
+}
+
+int test_keys()
+{
+    int rv = 0;
+
+    rv += expect(AuthCache::make_key("a", "b", "c") == AuthCache::make_key("a", "b", "c"),
+                 "Equal logins should have equal keys");
+    rv += expect(AuthCache::make_key("ab", "", "c") != AuthCache::make_key("a", "b", "c"),
+                 "The fields of a key should be separated");
+    rv += expect(AuthCache::make_key("a", "b", "") != AuthCache::make_key("a", "b", "c"),
+                 "The database should be part of the key");
+
+    return rv;
+}
+
+int test_users()
+{
+    int rv = 0;
+    AuthCache cache;
+    SUserIndex users = std::make_shared<UserIndex>();
+
+    rv += expect(!found(cache, users, 0), "An empty cache should not find a login");
+
+    cache.insert(users, key(0), password(0));
+    rv += expect(found(cache, users, 0), "An inserted login should be found");
+    rv += expect(!found(cache, users, 1), "Another login should not be found");
+
+    SUserIndex reloaded = std::make_shared<UserIndex>();
+    rv += expect(!found(cache, reloaded, 0), "A login should not be found after the users were reloaded");
+    rv += expect(!found(cache, users, 0), "A login should not be found after the cache was emptied");
+
+    return rv;
+}
+
+int test_generations()
+{
+    int rv = 0;
+    AuthCache cache;
+    SUserIndex users = std::make_shared<UserIndex>();
+
+    // Fill the current generation and start a new one.
+    for (size_t i = 0; i <= GENERATION; ++i)
+    {
+        cache.insert(users, key(i), password(i));
+    }
+
+    // Using a login of the previous generation moves it to the current one.
+    rv += expect(found(cache, users, 0), "A login of the previous generation should be found");
+
+    // Fill the current generation again, which drops the previous one.
+    for (size_t i = GENERATION + 1; i < 2 * GENERATION; ++i)
+    {
+        cache.insert(users, key(i), password(i));
+    }
+
+    rv += expect(found(cache, users, 0), "A login used in the previous generation should be kept");
+    rv += expect(!found(cache, users, 1), "A login not used in the previous generation should be dropped");
+    rv += expect(found(cache, users, GENERATION), "The first login of the previous generation should be kept");
+
+    return rv;
+}
+
+int test_max_entries()
+{
+    int rv = 0;
+    AuthCache cache;
+    SUserIndex users = std::make_shared<UserIndex>();
+    const size_t n = 10 * AuthCache::MAX_ENTRIES + GENERATION / 2;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        cache.insert(users, key(i), password(i));
+    }
+
+    // The latest logins are in the current generation, so finding them moves nothing.
+    size_t n_latest = 0;
+
+    for (size_t i = n - n % GENERATION; i < n; ++i)
+    {
+        n_latest += found(cache, users, i);
+    }
+
+    rv += expect(n_latest == n % GENERATION, "The latest logins should be found");
+
+    size_t n_found = 0;
+
+    for (size_t i = 0; i < n; ++i)
+    {
+        n_found += found(cache, users, i);
+    }
+
+    rv += expect(n_found >= n_latest && n_found <= AuthCache::MAX_ENTRIES,
+                 "The cache should hold at most MAX_ENTRIES logins");
+    rv += expect(!found(cache, users, 0), "The oldest login should have been evicted");
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = 0;
+
+    rv += test_keys();
+    rv += test_users();
+    rv += test_generations();
+    rv += test_max_entries();
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
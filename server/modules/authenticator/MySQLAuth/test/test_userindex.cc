@@ -0,0 +1,257 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../userindex.hh"
+
+#include <iostream>
+
+using namespace std;
+
+namespace
+{
+
+int expect(bool cond, const string& what)
+{
+    if (!cond)
+    {
+        cout << "error: " << what << endl;
+    }
+
+    return cond ? 0 : 1;
+}
+
+// The password of the grant matching a client, or "-" if none matches.
+string find(const UserIndex& index, const char* user, const char* host,
+            const char* db = "", bool lower_case = false)
+{
+    string password;
+    return index.find_user(user, host, db, lower_case, &password) ? password : "-";
+}
+
+int test_like()
+{
+    struct
+    {
+        const char* zStr;
+        const char* zPattern;
+        bool        match;
+    } tests[] =
+    {
+        {"",             "",              true },
+        {"",             "%",             true },
+        {"",             "_",             false},
+        {"abc",          "abc",           true },
+        {"ABC",          "abc",           true },
+        {"abc",          "ab",            false},
+        {"ab",           "abc",           false},
+        {"abc",          "a_c",           true },
+        {"ac",           "a_c",           false},
+        {"abc",          "a%",            true },
+        {"abc",          "%c",            true },
+        {"abc",          "%b%",           true },
+        {"abc",          "%%",            true },
+        {"abc",          "a%c%",          true },
+        {"abcbc",        "a%bc",          true },
+        {"abcbd",        "a%bc",          false},
+        {"a_c",          "a\\_c",         true },
+        {"abc",          "a\\_c",         false},
+        {"a%c",          "a\\%c",         true },
+        {"abc",          "a\\%c",         false},
+        {"a\\c",         "a\\\\c",        true },
+        {"my_db",        "my\\_%",        true },
+        {"mydb",         "my\\_%",        false},
+        {"192.168.0.1",  "192.168.%",     true },
+        {"192.168.0.1",  "192.168._.1",   true },
+        {"192.168.10.1", "192.168._.1",   false},
+    };
+
+    int rv = 0;
+
+    for (const auto& t : tests)
+    {
+        rv += expect(UserIndex::like(t.zStr, t.zPattern) == t.match,
+                     string("'") + t.zStr + "' LIKE '" + t.zPattern + "' should be "
+                     + (t.match ? "true" : "false"));
+    }
+
+    return rv;
+}
+
+int test_hosts()
+{
+    UserIndex index;
+    index.add_user("bob", "localhost", nullptr, true, "exact");
+    index.add_user("bob", "10.0.0.0/255.255.0.0", nullptr, true, "netmask");
+    index.add_user("bob", "192.168.%", nullptr, true, "wildcard");
+    index.add_user("bob", "192.168.1._", nullptr, true, "single");
+    index.add_user("bob", "10.1.0.0/not.a.mask", nullptr, true, "invalid");
+    index.add_user("bob", "db\\_1.example.com", nullptr, true, "escaped");
+    index.add_user("alice", "%", nullptr, true, "any");
+    index.finalize();
+
+    int rv = 0;
+
+    rv += expect(index.size() == 7, "The index should have 7 grants");
+
+    rv += expect(find(index, "bob", "localhost") == "exact", "Exact host should match");
+    rv += expect(find(index, "bob", "LOCALHOST") == "exact", "Hosts should be case-insensitive");
+    rv += expect(find(index, "bob", "localhost2") == "-", "Exact host should not match a prefix");
+
+    rv += expect(find(index, "bob", "10.0.200.3") == "netmask", "Address in the netmask should match");
+    rv += expect(find(index, "bob", "10.1.0.1") == "-", "Address outside the netmask should not match");
+    rv += expect(find(index, "bob", "10.0.0.x") == "-", "A non-address should not match a netmask");
+
+    rv += expect(find(index, "bob", "192.168.1.5") == "single", "'_' should match one character");
+    rv += expect(find(index, "bob", "192.168.1.55") == "wildcard", "'%' should match any characters");
+    rv += expect(find(index, "bob", "192.169.1.5") == "-", "The literal prefix should be compared");
+
+    rv += expect(find(index, "bob", "db_1.example.com") == "escaped", "An escaped '_' should match itself");
+    rv += expect(find(index, "bob", "dbx1.example.com") == "-", "An escaped '_' should not be a wildcard");
+
+    rv += expect(find(index, "alice", "anything") == "any", "'%' should match any host");
+    rv += expect(find(index, "carol", "localhost") == "-", "Unknown user should not match");
+    rv += expect(find(index, "Bob", "localhost") == "-", "User names should be case-sensitive");
+    rv += expect(find(index, "bob", nullptr) == "exact", "NULL host should match any grant");
+
+    int n = 0;
+    index.for_each([&n](const string& user, const string& host) {
+                       ++n;
+                   });
+    rv += expect(n == 7, "for_each should visit all grants");
+
+    return rv;
+}
+
+int test_order()
+{
+    // Added from the least to the most specific.
+    UserIndex index;
+    index.add_user("bob", "%", nullptr, true, "any");
+    index.add_user("bob", "192.%", nullptr, true, "short");
+    index.add_user("bob", "192.168.%", nullptr, true, "long");
+    index.add_user("bob", "192.168.%.1", nullptr, true, "long-second");
+    index.add_user("bob", "192.168.0.0/255.255.0.0", nullptr, true, "netmask");
+    index.add_user("bob", "192.168.0.1", nullptr, true, "exact");
+    index.finalize();
+
+    int rv = 0;
+
+    rv += expect(find(index, "bob", "192.168.0.1") == "exact", "Exact host should be matched first");
+    rv += expect(find(index, "bob", "192.168.1.1") == "netmask", "Netmask should be matched before wildcards");
+    rv += expect(find(index, "bob", "192.168.x.1") == "long",
+                 "Of equally long prefixes, the first added should be matched first");
+    rv += expect(find(index, "bob", "192.1.1.1") == "short", "Longer literal prefix should be matched first");
+    rv += expect(find(index, "bob", "10.0.0.1") == "any", "'%' should be matched last");
+
+    return rv;
+}
+
+int test_databases()
+{
+    UserIndex index;
+    index.add_user("bob", "%", "Test", false, "test");
+    index.add_user("bob", "%", "app\\_%", false, "app");
+    index.add_user("root", "%", nullptr, true, "root");
+    index.add_user("nodb", "%", nullptr, false, "nodb");
+    index.add_database("Test");
+    index.add_database("app_1");
+    index.finalize();
+
+    int rv = 0;
+
+    rv += expect(find(index, "bob", "h", "") == "test", "No database should match any grant");
+    rv += expect(find(index, "bob", "h", "Test") == "test", "Granted database should match");
+    rv += expect(find(index, "bob", "h", "test") == "test", "Grant databases should be case-insensitive");
+    rv += expect(find(index, "bob", "h", "app_1") == "app", "Database pattern should match");
+    rv += expect(find(index, "bob", "h", "appx1") == "-", "An escaped '_' should not match any character");
+    rv += expect(find(index, "bob", "h", "other") == "-", "Other databases should not match");
+    rv += expect(find(index, "root", "h", "other") == "root", "Access to all databases should match");
+    rv += expect(find(index, "nodb", "h", "other") == "-", "A user without grants should not match");
+
+    rv += expect(find(index, "nodb", "h", "information_schema") == "nodb",
+                 "information_schema should always be accessible");
+    rv += expect(find(index, "nodb", "h", "INFORMATION_SCHEMA") == "-",
+                 "information_schema should be case-sensitive without lower_case_table_names");
+    rv += expect(find(index, "nodb", "h", "INFORMATION_SCHEMA", true) == "nodb",
+                 "information_schema should be case-insensitive with lower_case_table_names");
+
+    rv += expect(index.has_database("Test", false), "Database should exist");
+    rv += expect(!index.has_database("test", false),
+                 "Databases should be case-sensitive without lower_case_table_names");
+    rv += expect(index.has_database("TEST", true),
+                 "Databases should be case-insensitive with lower_case_table_names");
+    rv += expect(!index.has_database("app_2", true), "Unknown database should not exist");
+
+    return rv;
+}
+
+int test_client()
+{
+    UserIndex index;
+    index.add_user("bob", "127.0.0.1", nullptr, true, "ipv4");
+    index.add_user("bob", "::1", nullptr, true, "ipv6");
+    index.add_user("alice", "%.example.com", nullptr, true, "hostname");
+    index.finalize();
+
+    int rv = 0;
+    int lookups = 0;
+    string password;
+
+    auto hostname = [&lookups]() {
+            ++lookups;
+            return string("client.example.com");
+        };
+
+    auto no_hostname = [&lookups]() {
+            ++lookups;
+            return string();
+        };
+
+    auto find_client = [&](const char* user, const char* remote, bool resolve) {
+            password.clear();
+            return resolve ?
+                   index.find_client(user, remote, "", false, hostname, &password) :
+                   index.find_client(user, remote, "", false, no_hostname, &password);
+        };
+
+    rv += expect(find_client("bob", "127.0.0.1", true) && password == "ipv4", "IPv4 address should match");
+    rv += expect(find_client("bob", "::1", true) && password == "ipv6", "IPv6 address should match");
+    rv += expect(lookups == 0, "The hostname should not be resolved if the address matches");
+
+    rv += expect(find_client("bob", "::ffff:127.0.0.1", true) && password == "ipv4",
+                 "IPv6-mapped IPv4 address should match the IPv4 address");
+    rv += expect(lookups == 0, "The hostname should not be resolved if the IPv4 address matches");
+
+    rv += expect(find_client("alice", "::ffff:10.0.0.1", true) && password == "hostname",
+                 "The hostname should be tried last");
+    rv += expect(lookups == 1, "The hostname should be resolved once");
+
+    rv += expect(!find_client("alice", "10.0.0.1", false), "Unresolved hostname should not match");
+    rv += expect(!find_client("bob", "10.0.0.1", true), "No grant should match");
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = 0;
+
+    rv += test_like();
+    rv += test_hosts();
+    rv += test_order();
+    rv += test_databases();
+    rv += test_client();
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
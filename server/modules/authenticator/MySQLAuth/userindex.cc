@@ -0,0 +1,214 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "userindex.hh"
+
+#include <arpa/inet.h>
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+#include <algorithm>
+
+using std::string;
+
+namespace
+{
+
+string to_lower(const char* str)
+{
+    string rval(str);
+    std::transform(rval.begin(), rval.end(), rval.begin(), ::tolower);
+    return rval;
+}
+
+bool parse_ipv4(const string& str, uint32_t* pAddress)
+{
+    struct in_addr addr;
+    bool rval = inet_pton(AF_INET, str.c_str(), &addr) == 1;
+
+    if (rval)
+    {
+        *pAddress = ntohl(addr.s_addr);
+    }
+
+    return rval;
+}
+}
+
+UserIndex::UserIndex()
+    : m_size(0)
+{
+}
+
+void UserIndex::add_user(const char* user, const char* host, const char* db, bool anydb, const char* password)
+{
+    Grant grant;
+    grant.host = host;
+    grant.pattern = to_lower(host);
+    grant.prefix = grant.pattern.find_first_of("%_\\");
+    grant.address = 0;
+    grant.netmask = 0;
+    grant.has_db = db && *db;
+    grant.db = grant.has_db ? to_lower(db) : "";
+    grant.anydb = anydb;
+    grant.password = password ? password : "";
+
+    string::size_type slash = grant.pattern.find('/');
+
+    if (slash != string::npos)
+    {
+        grant.type = parse_ipv4(grant.pattern.substr(0, slash), &grant.address)
+            && parse_ipv4(grant.pattern.substr(slash + 1), &grant.netmask) ?
+            HOST_NETMASK : HOST_INVALID;
+    }
+    else if (grant.prefix == string::npos)
+    {
+        grant.type = HOST_EXACT;
+    }
+    else
+    {
+        grant.type = HOST_WILDCARD;
+    }
+
+    m_users[user].push_back(std::move(grant));
+    ++m_size;
+}
+
+void UserIndex::add_database(const char* db)
+{
+    m_databases.insert(db);
+    m_lower_databases.insert(to_lower(db));
+}
+
+void UserIndex::finalize()
+{
+    for (auto& user : m_users)
+    {
+        // A stable sort keeps the grants in the order they were loaded in when
+        // the host patterns are equally specific.
+        std::stable_sort(user.second.begin(), user.second.end(), [](const Grant& lhs, const Grant& rhs) {
+                             return lhs.type != rhs.type ?
+                             lhs.type < rhs.type :
+                             lhs.type == HOST_WILDCARD && lhs.prefix > rhs.prefix;
+                         });
+    }
+}
+
+bool UserIndex::find_user(const char* user,
+                          const char* host,
+                          const char* db,
+                          bool lower_case,
+                          std::string* pPassword) const
+{
+    Users::const_iterator it = m_users.find(user);
+
+    if (it != m_users.end())
+    {
+        for (const Grant& grant : it->second)
+        {
+            if ((!host || grant.host_matches(host)) && grant.db_matches(db, lower_case))
+            {
+                *pPassword = grant.password;
+                return true;
+            }
+        }
+    }
+
+    return false;
+}
+
+bool UserIndex::has_database(const char* db, bool lower_case) const
+{
+    return lower_case ? m_lower_databases.count(to_lower(db)) : m_databases.count(db);
+}
+
+bool UserIndex::Grant::host_matches(const char* host) const
+{
+    bool rval = false;
+    uint32_t client;
+
+    switch (type)
+    {
+    case HOST_EXACT:
+        rval = strcasecmp(host, pattern.c_str()) == 0;
+        break;
+
+    case HOST_NETMASK:
+        rval = parse_ipv4(host, &client) && (client & netmask) == address;
+        break;
+
+    case HOST_WILDCARD:
+        rval = strncasecmp(host, pattern.c_str(), prefix) == 0
+            && like(host + prefix, pattern.c_str() + prefix);
+        break;
+
+    case HOST_INVALID:
+        break;
+    }
+
+    return rval;
+}
+
+bool UserIndex::Grant::db_matches(const char* client_db, bool lower_case) const
+{
+    if (anydb || !*client_db)
+    {
+        return true;
+    }
+
+    int (* compare)(const char*, const char*) = lower_case ? strcasecmp : strcmp;
+
+    return compare(client_db, "information_schema") == 0 || (has_db && like(client_db, db.c_str()));
+}
+
+// static
+bool UserIndex::like(const char* str, const char* pattern)
+{
+    const char* star_str = nullptr;
+    const char* star_pattern = nullptr;
+
+    while (*str)
+    {
+        // A character following a backslash is not a wildcard
+        size_t len = (*pattern == '\\' && pattern[1]) ? 2 : 1;
+        char c = pattern[len - 1];
+
+        if (*pattern == '%')
+        {
+            star_pattern = ++pattern;
+            star_str = str;
+        }
+        else if (*pattern && ((len == 1 && c == '_') || c == tolower((unsigned char)*str)))
+        {
+            pattern += len;
+            ++str;
+        }
+        else if (star_pattern)
+        {
+            // Let the last '%' consume one more character and try again
+            pattern = star_pattern;
+            str = ++star_str;
+        }
+        else
+        {
+            return false;
+        }
+    }
+
+    while (*pattern == '%')
+    {
+        ++pattern;
+    }
+
+    return *pattern == '\0';
+}
@@ -0,0 +1,205 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <stdint.h>
+#include <string.h>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+/**
+ * An in-memory index of the users and databases that a MySQLAuth instance
+ * authenticates against. The index is built once whenever the users are
+ * loaded and is immutable afterwards, so that all workers can use it
+ * concurrently.
+ *
+ * The grants of a user are kept sorted so that the most specific host
+ * patterns are tried first: plain hostnames and addresses, then netmasks
+ * and last the wildcard patterns, the ones with the longest literal prefix
+ * first.
+ */
+class UserIndex
+{
+public:
+    UserIndex();
+
+    /**
+     * Add a grant of a user.
+     *
+     * @param user     The user name.
+     * @param host     The host pattern, a hostname or an address that may contain
+     *                 the wildcards '%' and '_', escaped with a backslash, or an
+     *                 IPv4 address with a netmask.
+     * @param db       The database the grant is for, may be NULL.
+     * @param anydb    Whether the user has access to all databases.
+     * @param password The password hash as a hex string without the leading '*'.
+     */
+    void add_user(const char* user, const char* host, const char* db, bool anydb, const char* password);
+
+    /**
+     * Add a database.
+     *
+     * @param db The database name.
+     */
+    void add_database(const char* db);
+
+    /**
+     * Sort the host patterns. Must be called after all users have been added
+     * and before the index is used.
+     */
+    void finalize();
+
+    /**
+     * Find the password of a user.
+     *
+     * @param user       The user name.
+     * @param host       The client address or hostname, NULL to accept any host.
+     * @param db         The default database of the client, an empty string if none.
+     * @param lower_case Whether the names of databases are compared case-insensitively.
+     * @param pPassword  On success, the password hash of the first matching grant.
+     *
+     * @return True, if there is a grant that matches.
+     */
+    bool find_user(const char* user,
+                   const char* host,
+                   const char* db,
+                   bool lower_case,
+                   std::string* pPassword) const;
+
+    /**
+     * Find the password of a client. If no grant matches the address of the
+     * client, the IPv4 address of an IPv6-mapped address and, as a last resort
+     * as it requires a DNS lookup, the hostname of the client are tried.
+     *
+     * @param user         The user name.
+     * @param remote       The client address.
+     * @param db           The default database of the client, an empty string if none.
+     * @param lower_case   Whether the names of databases are compared case-insensitively.
+     * @param get_hostname Function that returns the hostname of the client as a
+     *                     @c std::string, empty if it cannot be resolved.
+     * @param pPassword    On success, the password hash of the first matching grant.
+     *
+     * @return True, if there is a grant that matches.
+     */
+    template<class GetHostname>
+    bool find_client(const char* user,
+                     const char* remote,
+                     const char* db,
+                     bool lower_case,
+                     GetHostname get_hostname,
+                     std::string* pPassword) const
+    {
+        bool found = find_user(user, remote, db, lower_case, pPassword);
+
+        /** Check for IPv6 mapped IPv4 address */
+        if (!found && strchr(remote, ':') && strchr(remote, '.'))
+        {
+            const char* ipv4 = strrchr(remote, ':') + 1;
+            found = find_user(user, ipv4, db, lower_case, pPassword);
+        }
+
+        if (!found)
+        {
+            std::string hostname = get_hostname();
+            found = !hostname.empty() && find_user(user, hostname.c_str(), db, lower_case, pPassword);
+        }
+
+        return found;
+    }
+
+    /**
+     * Check whether a database exists.
+     *
+     * @param db         The database name.
+     * @param lower_case Whether the database name is compared case-insensitively.
+     *
+     * @return True, if the database exists.
+     */
+    bool has_database(const char* db, bool lower_case) const;
+
+    /**
+     * @return The number of grants in the index.
+     */
+    size_t size() const
+    {
+        return m_size;
+    }
+
+    /**
+     * Call a function for every grant.
+     *
+     * @param func Function called with the user and the host pattern of the grant.
+     */
+    template<class Func>
+    void for_each(Func func) const
+    {
+        for (const auto& user : m_users)
+        {
+            for (const auto& grant : user.second)
+            {
+                func(user.first, grant.host);
+            }
+        }
+    }
+
+    /**
+     * Match a string against an SQL LIKE pattern. The comparison is case-insensitive
+     * for ASCII characters, as in SQLite. A backslash makes the character following
+     * it match only itself, as in the database names of the grant tables.
+     *
+     * @param str     The string to match.
+     * @param pattern The pattern, in lower case.
+     *
+     * @return True, if the string matches the pattern.
+     */
+    static bool like(const char* str, const char* pattern);
+
+private:
+    enum HostType
+    {
+        HOST_EXACT,     /*< No wildcards, compared as is. */
+        HOST_NETMASK,   /*< An IPv4 address with a netmask. */
+        HOST_WILDCARD,  /*< Compared with LIKE. */
+        HOST_INVALID    /*< A netmask that could not be parsed, never matches. */
+    };
+
+    struct Grant
+    {
+        std::string host;       /*< The host as it was given. */
+        std::string pattern;    /*< The host in lower case. */
+        HostType    type;
+        size_t      prefix;     /*< Length of the unescaped literal prefix of a wildcard pattern. */
+        uint32_t    address;    /*< Network address of a netmask, in host byte order. */
+        uint32_t    netmask;    /*< The netmask, in host byte order. */
+        bool        has_db;
+        std::string db;
+        bool        anydb;
+        std::string password;
+
+        bool host_matches(const char* host) const;
+        bool db_matches(const char* db, bool lower_case) const;
+    };
+
+    typedef std::unordered_map<std::string, std::vector<Grant>> Users;
+
+    Users                           m_users;
+    std::unordered_set<std::string> m_databases;
+    std::unordered_set<std::string> m_lower_databases;
+    size_t                          m_size;
+};
+
+typedef std::shared_ptr<const UserIndex> SUserIndex;
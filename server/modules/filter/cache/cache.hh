@@ -118,13 +118,20 @@ public:
     /**
      * See @Storage::put_value
      */
-    virtual cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue) = 0;
+    virtual cache_result_t put_value(const CACHE_KEY& key,
+                                     const std::vector<std::string>& tables,
+                                     const GWBUF* pValue) = 0;
 
     /**
      * See @Storage::del_value
      */
     virtual cache_result_t del_value(const CACHE_KEY& key) = 0;
 
+    /**
+     * See @Storage::invalidate
+     */
+    virtual cache_result_t invalidate(const std::vector<std::string>& tables) = 0;
+
 protected:
     Cache(const std::string& name,
           const CACHE_CONFIG* pConfig,
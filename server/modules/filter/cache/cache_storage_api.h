@@ -235,6 +235,10 @@ typedef struct cache_storage_api
      *
      * @param storage    Pointer to a CACHE_STORAGE.
      * @param key        A key generated with get_key.
+     * @param tables     Array of fully qualified names of the tables the value
+     *                   depends upon, in lower case. May be NULL if @c n_tables
+     *                   is 0.
+     * @param n_tables   The number of elements in @c tables.
      * @param value      Pointer to GWBUF containing the value to be stored.
      *                   Must be one contiguous buffer.
      *
@@ -244,6 +248,8 @@ typedef struct cache_storage_api
      */
     cache_result_t (* putValue)(CACHE_STORAGE* storage,
                                 const CACHE_KEY* key,
+                                const char* const* tables,
+                                size_t n_tables,
                                 const GWBUF* value);
 
     /**
@@ -258,6 +264,20 @@ typedef struct cache_storage_api
     cache_result_t (* delValue)(CACHE_STORAGE* storage,
                                 const CACHE_KEY* key);
 
+    /**
+     * Delete all values that depend upon any of the specified tables.
+     *
+     * @param storage    Pointer to a CACHE_STORAGE.
+     * @param tables     Array of fully qualified names of tables, in lower case.
+     * @param n_tables   The number of elements in @c tables.
+     *
+     * @return CACHE_RESULT_OK if the values were deleted. Note that
+     *         CACHE_RESULT_OK is returned also if there were no such values.
+     */
+    cache_result_t (* invalidate)(CACHE_STORAGE* storage,
+                                  const char* const* tables,
+                                  size_t n_tables);
+
     /**
      * Get the head item from the storage. This is only intended for testing and
      * debugging purposes and if the storage is being used by different threads
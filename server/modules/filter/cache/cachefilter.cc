@@ -149,6 +149,15 @@ static const MXS_ENUM_VALUE parameter_cache_in_trxs_values[] =
     {NULL}
 };
 
+// Enumeration values for `invalidate`
+static const MXS_ENUM_VALUE parameter_invalidate_values[] =
+{
+    {"never",   CACHE_INVALIDATE_NEVER  },
+    {"current", CACHE_INVALIDATE_CURRENT},
+    {"all",     CACHE_INVALIDATE_ALL    },
+    {NULL}
+};
+
 extern "C" MXS_MODULE* MXS_CREATE_MODULE()
 {
     static modulecmd_arg_type_t show_argv[] =
@@ -254,6 +263,13 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
                 MXS_MODULE_PARAM_BOOL,
                 CACHE_ZDEFAULT_ENABLED
             },
+            {
+                "invalidate",
+                MXS_MODULE_PARAM_ENUM,
+                CACHE_ZDEFAULT_INVALIDATE,
+                MXS_MODULE_OPT_NONE,
+                parameter_invalidate_values
+            },
             {MXS_END_MODULE_PARAMS}
         }
     };
@@ -363,6 +379,9 @@ bool CacheFilter::process_params(MXS_CONFIG_PARAMETER* ppParams, CACHE_CONFIG& c
                                                                         "cache_in_transactions",
                                                                         parameter_cache_in_trxs_values));
     config.enabled = config_get_bool(ppParams, "enabled");
+    config.invalidate = static_cast<cache_invalidate_t>(config_get_enum(ppParams,
+                                                                        "invalidate",
+                                                                        parameter_invalidate_values));
 
     if (!config.storage)
     {
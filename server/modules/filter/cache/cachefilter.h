@@ -70,6 +70,8 @@ const cache_selects_t CACHE_DEFAULT_SELECTS = CACHE_SELECTS_ASSUME_CACHEABLE;
 #define CACHE_ZDEFAULT_CACHE_IN_TRXS "all_transactions"
 // Enabled
 #define CACHE_ZDEFAULT_ENABLED "true"
+// Invalidation
+#define CACHE_ZDEFAULT_INVALIDATE "never"
 
 typedef enum cache_in_trxs
 {
@@ -79,6 +81,13 @@ typedef enum cache_in_trxs
     CACHE_IN_TRXS_ALL,
 } cache_in_trxs_t;
 
+typedef enum cache_invalidate
+{
+    CACHE_INVALIDATE_NEVER,     // Entries are removed only when their TTL has passed.
+    CACHE_INVALIDATE_CURRENT,   // Modifications invalidate the cache used by the session.
+    CACHE_INVALIDATE_ALL,       // Modifications invalidate the caches of all threads.
+} cache_invalidate_t;
+
 typedef struct cache_config
 {
     uint64_t max_resultset_rows;            /**< The maximum number of rows of a resultset for it to be
@@ -98,4 +107,5 @@ typedef struct cache_config
     cache_selects_t      selects;           /**< Assume/verify that selects are cacheable. */
     cache_in_trxs_t      cache_in_trxs;     /**< To cache or not to cache inside transactions. */
     bool                 enabled;           /**< Whether the cache is enabled or not. */
+    cache_invalidate_t   invalidate;        /**< How modifications invalidate cached data. */
 } CACHE_CONFIG;
@@ -13,6 +13,7 @@
 
 #define MXS_MODULE_NAME "cache"
 #include "cachefiltersession.hh"
+#include <algorithm>
 #include <new>
 #include <maxscale/alloc.h>
 #include <maxscale/modutil.h>
@@ -42,6 +43,9 @@ const char SV_MAXSCALE_CACHE_USE[] = "@maxscale.cache.use";
 const char SV_MAXSCALE_CACHE_SOFT_TTL[] = "@maxscale.cache.soft_ttl";
 const char SV_MAXSCALE_CACHE_HARD_TTL[] = "@maxscale.cache.hard_ttl";
 
+// The id of COM_STMT_EXECUTE that refers to the statement prepared last.
+const uint32_t PS_ID_LAST_PREPARED = 0xffffffff;
+
 const char* NON_CACHEABLE_FUNCTIONS[] =
 {
     "benchmark",
@@ -177,6 +181,70 @@ bool is_select_statement(GWBUF* pStmt)
 
     return is_select;
 }
+
+/**
+ * Returns the tables a statement refers to, fully qualified and in lower case.
+ *
+ * @param pStmt       A contiguous COM_QUERY packet.
+ * @param zDefaultDb  The current default database, may be NULL.
+ *
+ * @return The names of the tables, sorted and without duplicates.
+ */
+std::vector<std::string> get_table_names(GWBUF* pStmt, const char* zDefaultDb)
+{
+    std::vector<std::string> tables;
+
+    int n = 0;
+    char** pzNames = qc_get_table_names(pStmt, &n, true);
+
+    if (pzNames)
+    {
+        for (int i = 0; i < n; ++i)
+        {
+            std::string table;
+
+            if (!strchr(pzNames[i], '.') && zDefaultDb)
+            {
+                table += zDefaultDb;
+                table += '.';
+            }
+
+            table += pzNames[i];
+            std::transform(table.begin(), table.end(), table.begin(), ::tolower);
+
+            tables.push_back(table);
+
+            MXS_FREE(pzNames[i]);
+        }
+
+        MXS_FREE(pzNames);
+    }
+
+    std::sort(tables.begin(), tables.end());
+    tables.erase(std::unique(tables.begin(), tables.end()), tables.end());
+
+    return tables;
+}
+
+/**
+ * Returns the elements of a vector of strings as a comma separated list.
+ */
+std::string join(const std::vector<std::string>& strings)
+{
+    std::string s;
+
+    for (const auto& string : strings)
+    {
+        if (!s.empty())
+        {
+            s += ", ";
+        }
+
+        s += string;
+    }
+
+    return s;
+}
 }
 
 CacheFilterSession::CacheFilterSession(MXS_SESSION* pSession, Cache* pCache, char* zDefaultDb)
@@ -191,6 +259,7 @@ CacheFilterSession::CacheFilterSession(MXS_SESSION* pSession, Cache* pCache, cha
     , m_populate(pCache->config().enabled)
     , m_soft_ttl(pCache->config().soft_ttl)
     , m_hard_ttl(pCache->config().hard_ttl)
+    , m_last_ps_id(0)
 {
     m_key.data = 0;
 
@@ -323,6 +392,18 @@ int CacheFilterSession::routeQuery(GWBUF* pPacket)
         break;
 
     case MXS_COM_STMT_PREPARE:
+        if (m_pCache->config().invalidate != CACHE_INVALIDATE_NEVER)
+        {
+            // The tables are associated with the statement once its id is known.
+            m_prepared_tables = get_modified_tables(pPacket);
+            m_last_ps_id = 0;
+
+            if (!m_prepared_tables.empty())
+            {
+                m_state = CACHE_EXPECTING_PREPARE_RESPONSE;
+            }
+        }
+
         if (log_decisions())
         {
             MXS_NOTICE("COM_STMT_PREPARE, ignoring.");
@@ -330,12 +411,33 @@ int CacheFilterSession::routeQuery(GWBUF* pPacket)
         break;
 
     case MXS_COM_STMT_EXECUTE:
+        if (m_pCache->config().invalidate != CACHE_INVALIDATE_NEVER)
+        {
+            uint32_t id = mxs_mysql_extract_ps_id(pPacket);
+
+            if (id == PS_ID_LAST_PREPARED)
+            {
+                id = m_last_ps_id;
+            }
+
+            auto it = m_ps_tables.find(id);
+
+            if (it != m_ps_tables.end())
+            {
+                record_modified_tables(it->second);
+            }
+        }
+
         if (log_decisions())
         {
             MXS_NOTICE("COM_STMT_EXECUTE, ignoring.");
         }
         break;
 
+    case MXS_COM_STMT_CLOSE:
+        m_ps_tables.erase(mxs_mysql_extract_ps_id(pPacket));
+        break;
+
     case MXS_COM_QUERY:
         action = route_COM_QUERY(pPacket);
         break;
@@ -371,6 +473,14 @@ int CacheFilterSession::clientReply(GWBUF* pData)
         m_res.length = gwbuf_length(pData);
     }
 
+    if (!m_modified_tables.empty()
+        && (!session_trx_is_active(m_pSession) || session_trx_is_ending(m_pSession)))
+    {
+        // The response to a modification outside a transaction, or to the
+        // statement ending the transaction in which the modifications were made.
+        invalidate_modified_tables();
+    }
+
     if (m_state != CACHE_IGNORING_RESPONSE)
     {
         if (cache_max_resultset_size_exceeded(m_pCache->config(), m_res.length))
@@ -409,6 +519,10 @@ int CacheFilterSession::clientReply(GWBUF* pData)
         rv = handle_expecting_use_response();
         break;
 
+    case CACHE_EXPECTING_PREPARE_RESPONSE:
+        rv = handle_expecting_prepare_response();
+        break;
+
     case CACHE_IGNORING_RESPONSE:
         rv = handle_ignoring_response();
         break;
@@ -713,6 +827,40 @@ int CacheFilterSession::handle_expecting_use_response()
     return rv;
 }
 
+/**
+ * Called when the response to the preparation of a modifying statement is
+ * handled. The modified tables are associated with the id of the statement.
+ */
+int CacheFilterSession::handle_expecting_prepare_response()
+{
+    mxb_assert(m_state == CACHE_EXPECTING_PREPARE_RESPONSE);
+    mxb_assert(m_res.pData);
+
+    int rv = 1;
+
+    size_t buflen = m_res.length;
+    mxb_assert(m_res.length == gwbuf_length(m_res.pData));
+
+    if (buflen >= MYSQL_HEADER_LEN + 5)     // We need the command byte and the statement id.
+    {
+        uint8_t data[5];
+        copy_data(MYSQL_HEADER_LEN, sizeof(data), data);
+
+        if (data[0] == MYSQL_REPLY_OK)
+        {
+            m_last_ps_id = gw_mysql_get_byte4(data + 1);
+            m_ps_tables[m_last_ps_id] = std::move(m_prepared_tables);
+        }
+
+        m_prepared_tables.clear();
+
+        rv = send_upstream();
+        m_state = CACHE_IGNORING_RESPONSE;
+    }
+
+    return rv;
+}
+
 /**
  * Called when all data from the server is ignored.
  */
@@ -769,7 +917,7 @@ void CacheFilterSession::store_result()
     {
         m_res.pData = pData;
 
-        cache_result_t result = m_pCache->put_value(m_key, m_res.pData);
+        cache_result_t result = m_pCache->put_value(m_key, m_tables, m_res.pData);
 
         if (!CACHE_RESULT_IS_OK(result))
         {
@@ -791,6 +939,84 @@ void CacheFilterSession::store_result()
     }
 }
 
+/**
+ * Returns the tables of a SELECT whose result will be stored.
+ *
+ * @param pPacket  A contiguous COM_QUERY packet containing a SELECT.
+ *
+ * @return The tables, or an empty vector if invalidation is not enabled, in
+ *         which case the statement need not be parsed.
+ */
+std::vector<std::string> CacheFilterSession::get_tables_of_select(GWBUF* pPacket) const
+{
+    std::vector<std::string> tables;
+
+    if (m_pCache->config().invalidate != CACHE_INVALIDATE_NEVER)
+    {
+        tables = get_table_names(pPacket, m_zDefaultDb);
+    }
+
+    return tables;
+}
+
+/**
+ * Returns the tables modified by a statement.
+ *
+ * @param pPacket  A contiguous COM_QUERY or COM_STMT_PREPARE packet.
+ *
+ * @return The tables, or an empty vector if the statement is not a modification.
+ */
+std::vector<std::string> CacheFilterSession::get_modified_tables(GWBUF* pPacket) const
+{
+    std::vector<std::string> tables;
+    uint32_t type_mask = qc_get_type_mask(pPacket);
+
+    if (qc_query_is_type(type_mask, QUERY_TYPE_WRITE))
+    {
+        tables = get_table_names(pPacket, m_zDefaultDb);
+    }
+
+    return tables;
+}
+
+/**
+ * Record tables modified by a statement. They are invalidated once the
+ * modification is visible to other sessions.
+ *
+ * @param tables  The modified tables.
+ */
+void CacheFilterSession::record_modified_tables(const std::vector<std::string>& tables)
+{
+    for (const auto& table : tables)
+    {
+        if (std::find(m_modified_tables.begin(), m_modified_tables.end(), table)
+            == m_modified_tables.end())
+        {
+            m_modified_tables.push_back(table);
+        }
+    }
+}
+
+/**
+ * Invalidate the cached results that depend upon the modified tables.
+ */
+void CacheFilterSession::invalidate_modified_tables()
+{
+    if (log_decisions())
+    {
+        MXS_NOTICE("Invalidating cached results of tables: %s", join(m_modified_tables).c_str());
+    }
+
+    cache_result_t result = m_pCache->invalidate(m_modified_tables);
+
+    if (!CACHE_RESULT_IS_OK(result))
+    {
+        MXS_ERROR("Could not invalidate cached results of tables: %s", join(m_modified_tables).c_str());
+    }
+
+    m_modified_tables.clear();
+}
+
 /**
  * Whether the cache should be consulted.
  *
@@ -1012,6 +1238,12 @@ CacheFilterSession::routing_action_t CacheFilterSession::route_COM_QUERY(GWBUF*
     mxb_assert((int)MYSQL_GET_COMMAND(pData) == MXS_COM_QUERY);
 
     routing_action_t routing_action = ROUTING_CONTINUE;
+
+    if (m_pCache->config().invalidate != CACHE_INVALIDATE_NEVER && !is_select_statement(pPacket))
+    {
+        record_modified_tables(get_modified_tables(pPacket));
+    }
+
     cache_action_t cache_action = get_cache_action(pPacket);
 
     if (cache_action != CACHE_IGNORE)
@@ -1126,6 +1358,7 @@ CacheFilterSession::routing_action_t CacheFilterSession::route_SELECT(cache_acti
             if (m_populate || m_refreshing || CACHE_RESULT_IS_DISCARDED(result))
             {
                 m_state = CACHE_EXPECTING_RESPONSE;
+                m_tables = get_tables_of_select(pPacket);
             }
             else
             {
@@ -1160,6 +1393,7 @@ CacheFilterSession::routing_action_t CacheFilterSession::route_SELECT(cache_acti
                        "refreshing cache entry.");
         }
         m_state = CACHE_EXPECTING_RESPONSE;
+        m_tables = get_tables_of_select(pPacket);
     }
     else
     {
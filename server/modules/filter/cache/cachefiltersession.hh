@@ -13,6 +13,9 @@
 #pragma once
 
 #include <maxscale/ccdefs.hh>
+#include <string>
+#include <unordered_map>
+#include <vector>
 #include <maxscale/buffer.h>
 #include <maxscale/filter.hh>
 #include "cache.hh"
@@ -32,6 +35,7 @@ public:
         CACHE_EXPECTING_ROWS,           // A select has been sent, and we want more rows.
         CACHE_EXPECTING_NOTHING,        // We are not expecting anything from the server.
         CACHE_EXPECTING_USE_RESPONSE,   // A "USE DB" was issued.
+        CACHE_EXPECTING_PREPARE_RESPONSE,   // A modifying statement is being prepared.
         CACHE_IGNORING_RESPONSE,        // We are not interested in the data received from the server.
     };
 
@@ -101,6 +105,7 @@ private:
     int handle_expecting_response();
     int handle_expecting_rows();
     int handle_expecting_use_response();
+    int handle_expecting_prepare_response();
     int handle_ignoring_response();
 
     int send_upstream();
@@ -114,6 +119,11 @@ private:
 
     void store_result();
 
+    std::vector<std::string> get_tables_of_select(GWBUF* pPacket) const;
+    std::vector<std::string> get_modified_tables(GWBUF* pPacket) const;
+    void                     record_modified_tables(const std::vector<std::string>& tables);
+    void                     invalidate_modified_tables();
+
     enum cache_action_t
     {
         CACHE_IGNORE           = 0,
@@ -181,16 +191,23 @@ private:
     CacheFilterSession(MXS_SESSION* pSession, Cache* pCache, char* zDefaultDb);
 
 private:
-    cache_session_state_t m_state;          /**< What state is the session in, what data is expected. */
-    Cache*                m_pCache;         /**< The cache instance the session is associated with. */
-    CACHE_RESPONSE_STATE  m_res;            /**< The response state. */
-    CACHE_KEY             m_key;            /**< Key storage. */
-    char*                 m_zDefaultDb;     /**< The default database. */
-    char*                 m_zUseDb;         /**< Pending default database. Needs server response. */
-    bool                  m_refreshing;     /**< Whether the session is updating a stale cache entry. */
-    bool                  m_is_read_only;   /**< Whether the current trx has been read-only in pratice. */
-    bool                  m_use;            /**< Whether the cache should be used in this session. */
-    bool                  m_populate;       /**< Whether the cache should be populated in this session. */
-    uint32_t              m_soft_ttl;       /**< The soft TTL used in the session. */
-    uint32_t              m_hard_ttl;       /**< The hard TTL used in the session. */
+    cache_session_state_t    m_state;            /**< What state is the session in, what data is expected. */
+    Cache*                   m_pCache;           /**< The cache instance the session is associated with. */
+    CACHE_RESPONSE_STATE     m_res;              /**< The response state. */
+    CACHE_KEY                m_key;              /**< Key storage. */
+    char*                    m_zDefaultDb;       /**< The default database. */
+    char*                    m_zUseDb;           /**< Pending default database. Needs server response. */
+    bool                     m_refreshing;       /**< Whether the session is updating a stale cache entry. */
+    bool                     m_is_read_only;     /**< Whether the current trx has been read-only in pratice. */
+    bool                     m_use;              /**< Whether the cache should be used in this session. */
+    bool                     m_populate;         /**< Whether the cache should be populated in this session. */
+    uint32_t                 m_soft_ttl;         /**< The soft TTL used in the session. */
+    uint32_t                 m_hard_ttl;         /**< The hard TTL used in the session. */
+    std::vector<std::string> m_tables;           /**< The tables of the SELECT being fetched. */
+    std::vector<std::string> m_modified_tables;  /**< Tables modified in the current transaction. */
+    std::vector<std::string> m_prepared_tables;  /**< Tables modified by the statement being prepared. */
+    uint32_t                 m_last_ps_id;       /**< The id of the statement prepared last. */
+
+    /** The tables modified by the prepared statements, by statement id. */
+    std::unordered_map<uint32_t, std::vector<std::string>> m_ps_tables;
 };
@@ -14,8 +14,10 @@
 #define MXS_MODULE_NAME "cache"
 #include "cachept.hh"
 
+#include <atomic>
 #include <maxbase/atomic.h>
 #include <maxscale/config.h>
+#include <maxscale/routingworker.hh>
 
 #include "cachest.hh"
 #include "storagefactory.hh"
@@ -44,6 +46,42 @@ inline int thread_index()
 
     return u_thread_id;
 }
+
+/**
+ * Combines the results of invalidating the caches of all threads. As the
+ * threads invalidate their caches asynchronously, a failure is logged when
+ * the last of them is done and the object is deleted.
+ */
+class Invalidation
+{
+public:
+    Invalidation(const string& name)
+        : m_name(name)
+        , m_nFailed(0)
+    {
+    }
+
+    ~Invalidation()
+    {
+        if (m_nFailed != 0)
+        {
+            MXS_ERROR("Invalidating the cache '%s' failed in %d thread(s), "
+                      "stale results may be returned.", m_name.c_str(), m_nFailed.load());
+        }
+    }
+
+    void add(cache_result_t result)
+    {
+        if (!CACHE_RESULT_IS_OK(result))
+        {
+            ++m_nFailed;
+        }
+    }
+
+private:
+    string           m_name;
+    std::atomic<int> m_nFailed;
+};
 }
 
 CachePT::CachePT(const std::string& name,
@@ -136,9 +174,11 @@ cache_result_t CachePT::get_value(const CACHE_KEY& key,
     return thread_cache().get_value(key, flags, soft_ttl, hard_ttl, ppValue);
 }
 
-cache_result_t CachePT::put_value(const CACHE_KEY& key, const GWBUF* pValue)
+cache_result_t CachePT::put_value(const CACHE_KEY& key,
+                                  const std::vector<std::string>& tables,
+                                  const GWBUF* pValue)
 {
-    return thread_cache().put_value(key, pValue);
+    return thread_cache().put_value(key, tables, pValue);
 }
 
 cache_result_t CachePT::del_value(const CACHE_KEY& key)
@@ -146,6 +186,44 @@ cache_result_t CachePT::del_value(const CACHE_KEY& key)
     return thread_cache().del_value(key);
 }
 
+cache_result_t CachePT::invalidate(const std::vector<std::string>& tables)
+{
+    cache_result_t result = CACHE_RESULT_OK;
+
+    if (m_config.invalidate == CACHE_INVALIDATE_ALL)
+    {
+        // A thread specific cache may only be accessed by its own thread, so
+        // every worker must invalidate its own. The cache of the calling worker
+        // is invalidated immediately, those of the others asynchronously. The
+        // caches are captured by value, as this instance need not outlive the
+        // asynchronous calls.
+        int caller = thread_index();
+        Caches caches = m_caches;
+        shared_ptr<Invalidation> sInvalidation = std::make_shared<Invalidation>(m_name);
+
+        result = caches[caller]->invalidate(tables);
+        sInvalidation->add(result);
+
+        auto invalidate_thread_cache = [caches, tables, caller, sInvalidation]() {
+                int i = thread_index();
+
+                if (i != caller)
+                {
+                    mxb_assert(i < (int)caches.size());
+                    sInvalidation->add(caches[i]->invalidate(tables));
+                }
+            };
+
+        mxs::RoutingWorker::broadcast(invalidate_thread_cache, mxs::RoutingWorker::EXECUTE_AUTO);
+    }
+    else
+    {
+        result = thread_cache().invalidate(tables);
+    }
+
+    return result;
+}
+
 // static
 CachePT* CachePT::Create(const std::string& name,
                          const CACHE_CONFIG* pConfig,
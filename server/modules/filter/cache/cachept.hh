@@ -38,10 +38,14 @@ public:
                              uint32_t hard_ttl,
                              GWBUF**  ppValue) const;
 
-    cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue);
+    cache_result_t put_value(const CACHE_KEY& key,
+                             const std::vector<std::string>& tables,
+                             const GWBUF* pValue);
 
     cache_result_t del_value(const CACHE_KEY& key);
 
+    cache_result_t invalidate(const std::vector<std::string>& tables);
+
 private:
     typedef std::shared_ptr<Cache> SCache;
     typedef std::vector<SCache>    Caches;
@@ -62,9 +62,10 @@ cache_result_t CacheSimple::get_value(const CACHE_KEY& key,
 }
 
 cache_result_t CacheSimple::put_value(const CACHE_KEY& key,
+                                      const std::vector<std::string>& tables,
                                       const GWBUF* pValue)
 {
-    return m_pStorage->put_value(key, pValue);
+    return m_pStorage->put_value(key, tables, pValue);
 }
 
 cache_result_t CacheSimple::del_value(const CACHE_KEY& key)
@@ -72,6 +73,11 @@ cache_result_t CacheSimple::del_value(const CACHE_KEY& key)
     return m_pStorage->del_value(key);
 }
 
+cache_result_t CacheSimple::invalidate(const std::vector<std::string>& tables)
+{
+    return m_pStorage->invalidate(tables);
+}
+
 // protected:
 json_t* CacheSimple::do_get_info(uint32_t what) const
 {
@@ -81,7 +81,9 @@ cache_result_t LRUStorage::do_get_value(const CACHE_KEY& key,
     return access_value(APPROACH_GET, key, flags, soft_ttl, hard_ttl, ppValue);
 }
 
-cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key, const GWBUF* pvalue)
+cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key,
+                                        const std::vector<std::string>& tables,
+                                        const GWBUF* pvalue)
 {
     cache_result_t result = CACHE_RESULT_ERROR;
 
@@ -105,7 +107,7 @@ cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key, const GWBUF* pvalu
     {
         mxb_assert(pNode);
 
-        result = m_pStorage->put_value(key, pvalue);
+        result = m_pStorage->put_value(key, tables, pvalue);
 
         if (CACHE_RESULT_IS_OK(result))
         {
@@ -114,6 +116,8 @@ cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key, const GWBUF* pvalu
                 ++m_stats.updates;
                 mxb_assert(m_stats.size >= pNode->size());
                 m_stats.size -= pNode->size();
+
+                unlink_tables(key, pNode->tables());
             }
             else
             {
@@ -121,8 +125,11 @@ cache_result_t LRUStorage::do_put_value(const CACHE_KEY& key, const GWBUF* pvalu
             }
 
             pNode->reset(&i->first, value_size);
+            pNode->set_tables(tables);
             m_stats.size += pNode->size();
 
+            link_tables(key, tables);
+
             move_to_head(pNode);
         }
         else if (!existed)
@@ -164,6 +171,44 @@ cache_result_t LRUStorage::do_del_value(const CACHE_KEY& key)
     return result;
 }
 
+cache_result_t LRUStorage::do_invalidate(const std::vector<std::string>& tables)
+{
+    cache_result_t result = m_pStorage->invalidate(tables);
+
+    if (CACHE_RESULT_IS_OK(result))
+    {
+        for (const auto& table : tables)
+        {
+            KeysByTable::iterator i = m_keys_by_table.find(table);
+
+            if (i != m_keys_by_table.end())
+            {
+                // Freeing a node modifies the mapping, so the keys must be copied.
+                std::vector<CACHE_KEY> keys(i->second.begin(), i->second.end());
+
+                for (const auto& key : keys)
+                {
+                    NodesByKey::iterator j = m_nodes_by_key.find(key);
+                    mxb_assert(j != m_nodes_by_key.end());
+
+                    // The real storage has already deleted the value.
+                    ++m_stats.invalidations;
+
+                    mxb_assert(m_stats.size >= j->second->size());
+                    mxb_assert(m_stats.items > 0);
+
+                    m_stats.size -= j->second->size();
+                    --m_stats.items;
+
+                    free_node(j);
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
 cache_result_t LRUStorage::do_get_head(CACHE_KEY* pKey, GWBUF** ppValue) const
 {
     cache_result_t result = CACHE_RESULT_NOT_FOUND;
@@ -363,9 +408,12 @@ bool LRUStorage::free_node_data(Node* pNode)
 
         if (i != m_nodes_by_key.end())
         {
+            unlink_tables(i->first, pNode->tables());
             m_nodes_by_key.erase(i);
         }
 
+        pNode->set_tables(std::vector<std::string>());
+
         mxb_assert(m_stats.size >= pNode->size());
         mxb_assert(m_stats.items > 0);
 
@@ -405,6 +453,7 @@ void LRUStorage::free_node(Node* pNode) const
  */
 void LRUStorage::free_node(NodesByKey::iterator& i) const
 {
+    unlink_tables(i->first, i->second->tables());
     free_node(i->second);   // A Node
     m_nodes_by_key.erase(i);
 }
@@ -464,6 +513,44 @@ void LRUStorage::move_to_head(Node* pNode) const
     mxb_assert(m_pTail->next() == NULL);
 }
 
+/**
+ * Record that the value of a key depends upon tables.
+ *
+ * @param key     The key.
+ * @param tables  The tables.
+ */
+void LRUStorage::link_tables(const CACHE_KEY& key, const std::vector<std::string>& tables)
+{
+    for (const auto& table : tables)
+    {
+        m_keys_by_table[table].insert(key);
+    }
+}
+
+/**
+ * Remove the record of the value of a key depending upon tables.
+ *
+ * @param key     The key.
+ * @param tables  The tables.
+ */
+void LRUStorage::unlink_tables(const CACHE_KEY& key, const std::vector<std::string>& tables) const
+{
+    for (const auto& table : tables)
+    {
+        KeysByTable::iterator i = m_keys_by_table.find(table);
+
+        if (i != m_keys_by_table.end())
+        {
+            i->second.erase(key);
+
+            if (i->second.empty())
+            {
+                m_keys_by_table.erase(i);
+            }
+        }
+    }
+}
+
 cache_result_t LRUStorage::get_existing_node(NodesByKey::iterator& i, const GWBUF* pValue, Node** ppNode)
 {
     cache_result_t result = CACHE_RESULT_OK;
@@ -607,4 +694,5 @@ void LRUStorage::Stats::fill(json_t* pObject) const
     set_integer(pObject, "updates", updates);
     set_integer(pObject, "deletes", deletes);
     set_integer(pObject, "evictions", evictions);
+    set_integer(pObject, "invalidations", invalidations);
 }
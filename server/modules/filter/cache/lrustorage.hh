@@ -13,7 +13,10 @@
 #pragma once
 
 #include <maxscale/ccdefs.hh>
+#include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 #include "cachefilter.h"
 #include "cache_storage_api.hh"
 #include "storage.hh"
@@ -49,6 +52,7 @@ protected:
      * @see Storage::put_value
      */
     cache_result_t do_put_value(const CACHE_KEY& key,
+                                const std::vector<std::string>& tables,
                                 const GWBUF* pValue);
 
     /**
@@ -56,6 +60,11 @@ protected:
      */
     cache_result_t do_del_value(const CACHE_KEY& key);
 
+    /**
+     * @see Storage::invalidate
+     */
+    cache_result_t do_invalidate(const std::vector<std::string>& tables);
+
     /**
      * @see Storage::get_head
      */
@@ -136,6 +145,10 @@ private:
         {
             return m_pPrev;
         }
+        const std::vector<std::string>& tables() const
+        {
+            return m_tables;
+        }
 
         /**
          * Move the node before the node provided as argument.
@@ -202,14 +215,21 @@ private:
             m_size = size;
         }
 
+        void set_tables(const std::vector<std::string>& tables)
+        {
+            m_tables = tables;
+        }
+
     private:
-        const CACHE_KEY* m_pKey;    /*< Points at the key stored in nodes_by_key_ below. */
-        size_t           m_size;    /*< The size of the data referred to by m_pKey. */
-        Node*            m_pNext;   /*< The next node in the LRU list. */
-        Node*            m_pPrev;   /*< The previous node in the LRU list. */
+        const CACHE_KEY*         m_pKey;    /*< Points at the key stored in nodes_by_key_ below. */
+        size_t                   m_size;    /*< The size of the data referred to by m_pKey. */
+        Node*                    m_pNext;   /*< The next node in the LRU list. */
+        Node*                    m_pPrev;   /*< The previous node in the LRU list. */
+        std::vector<std::string> m_tables;  /*< The tables the data depends upon. */
     };
 
-    typedef std::unordered_map<CACHE_KEY, Node*> NodesByKey;
+    typedef std::unordered_map<CACHE_KEY, Node*>                           NodesByKey;
+    typedef std::unordered_map<std::string, std::unordered_set<CACHE_KEY>> KeysByTable;
 
     Node* vacate_lru();
     Node* vacate_lru(size_t space);
@@ -218,6 +238,8 @@ private:
     void  free_node(NodesByKey::iterator& i) const;
     void  remove_node(Node* pNode) const;
     void  move_to_head(Node* pNode) const;
+    void  link_tables(const CACHE_KEY& key, const std::vector<std::string>& tables);
+    void  unlink_tables(const CACHE_KEY& key, const std::vector<std::string>& tables) const;
 
     cache_result_t get_existing_node(NodesByKey::iterator& i, const GWBUF* pvalue, Node** ppNode);
     cache_result_t get_new_node(const CACHE_KEY& key,
@@ -236,18 +258,20 @@ private:
             , updates(0)
             , deletes(0)
             , evictions(0)
+            , invalidations(0)
         {
         }
 
         void fill(json_t* pObject) const;
 
-        uint64_t size;      /*< The total size of the stored values. */
-        uint64_t items;     /*< The number of stored items. */
-        uint64_t hits;      /*< How many times a key was found in the cache. */
-        uint64_t misses;    /*< How many times a key was not found in the cache. */
-        uint64_t updates;   /*< How many times an existing key in the cache was updated. */
-        uint64_t deletes;   /*< How many times an existing key in the cache was deleted. */
-        uint64_t evictions; /*< How many times an item has been evicted from the cache. */
+        uint64_t size;          /*< The total size of the stored values. */
+        uint64_t items;         /*< The number of stored items. */
+        uint64_t hits;          /*< How many times a key was found in the cache. */
+        uint64_t misses;        /*< How many times a key was not found in the cache. */
+        uint64_t updates;       /*< How many times an existing key in the cache was updated. */
+        uint64_t deletes;       /*< How many times an existing key in the cache was deleted. */
+        uint64_t evictions;     /*< How many times an item has been evicted from the cache. */
+        uint64_t invalidations; /*< How many items have been deleted due to an invalidation. */
     };
 
     const CACHE_STORAGE_CONFIG m_config;        /*< The configuration. */
@@ -258,4 +282,5 @@ private:
     mutable NodesByKey         m_nodes_by_key;  /*< Mapping from cache keys to corresponding Node. */
     mutable Node*              m_pHead;         /*< The node at the LRU list. */
     mutable Node*              m_pTail;         /*< The node at bottom of the LRU list.*/
+    mutable KeysByTable        m_keys_by_table; /*< Mapping from tables to keys depending upon them. */
 };
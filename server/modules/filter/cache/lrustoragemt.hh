@@ -21,6 +21,10 @@
 class LRUStorageMT : public LRUStorage
 {
 public:
+    // The convenience overloads of Storage would otherwise be hidden.
+    using Storage::get_value;
+    using Storage::put_value;
+
     ~LRUStorageMT();
 
     static LRUStorageMT* create(const CACHE_STORAGE_CONFIG& config, Storage* pstorage);
@@ -35,10 +39,13 @@ public:
                              GWBUF**  ppValue) const;
 
     cache_result_t put_value(const CACHE_KEY& key,
+                             const std::vector<std::string>& tables,
                              const GWBUF* pValue);
 
     cache_result_t del_value(const CACHE_KEY& key);
 
+    cache_result_t invalidate(const std::vector<std::string>& tables);
+
     cache_result_t get_head(CACHE_KEY* pKey,
                             GWBUF** ppValue) const;
 
@@ -48,9 +48,11 @@ cache_result_t LRUStorageST::get_value(const CACHE_KEY& key,
     return LRUStorage::do_get_value(key, flags, soft_ttl, hard_ttl, ppValue);
 }
 
-cache_result_t LRUStorageST::put_value(const CACHE_KEY& key, const GWBUF* pValue)
+cache_result_t LRUStorageST::put_value(const CACHE_KEY& key,
+                                       const std::vector<std::string>& tables,
+                                       const GWBUF* pValue)
 {
-    return LRUStorage::do_put_value(key, pValue);
+    return LRUStorage::do_put_value(key, tables, pValue);
 }
 
 cache_result_t LRUStorageST::del_value(const CACHE_KEY& key)
@@ -58,6 +60,11 @@ cache_result_t LRUStorageST::del_value(const CACHE_KEY& key)
     return LRUStorage::do_del_value(key);
 }
 
+cache_result_t LRUStorageST::invalidate(const std::vector<std::string>& tables)
+{
+    return LRUStorage::do_invalidate(tables);
+}
+
 cache_result_t LRUStorageST::get_head(CACHE_KEY* pKey, GWBUF** ppValue) const
 {
     return LRUStorage::do_get_head(pKey, ppValue);
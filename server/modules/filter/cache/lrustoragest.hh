@@ -18,6 +18,10 @@
 class LRUStorageST : public LRUStorage
 {
 public:
+    // The convenience overloads of Storage would otherwise be hidden.
+    using Storage::get_value;
+    using Storage::put_value;
+
     ~LRUStorageST();
 
     static LRUStorageST* create(const CACHE_STORAGE_CONFIG& config, Storage* pstorage);
@@ -32,10 +36,13 @@ public:
                              GWBUF**  ppValue) const;
 
     cache_result_t put_value(const CACHE_KEY& key,
+                             const std::vector<std::string>& tables,
                              const GWBUF* pValue);
 
     cache_result_t del_value(const CACHE_KEY& key);
 
+    cache_result_t invalidate(const std::vector<std::string>& tables);
+
     cache_result_t get_head(CACHE_KEY* pKey,
                             GWBUF** ppValue) const;
 
@@ -13,6 +13,8 @@
 #pragma once
 
 #include <maxscale/ccdefs.hh>
+#include <string>
+#include <vector>
 #include "cache_storage_api.h"
 
 class Storage
@@ -81,13 +83,23 @@ public:
      * Put a value to the cache.
      *
      * @param key     A key generated with get_key.
+     * @param tables  The fully qualified names of the tables the value depends
+     *                upon, in lower case. When any of them is invalidated, the
+     *                value is deleted.
      * @param pValue  Pointer to GWBUF containing the value to be stored.
      *                Must be one contiguous buffer.
      * @return CACHE_RESULT_OK if item was successfully put,
      *         CACHE_RESULT_OUT_OF_RESOURCES if item could not be put, due to
      *         some resource having become exhausted, or some other error code.
      */
-    virtual cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue) = 0;
+    virtual cache_result_t put_value(const CACHE_KEY& key,
+                                     const std::vector<std::string>& tables,
+                                     const GWBUF* pValue) = 0;
+
+    cache_result_t put_value(const CACHE_KEY& key, const GWBUF* pValue)
+    {
+        return put_value(key, std::vector<std::string>(), pValue);
+    }
 
     /**
      * Delete a value from the cache.
@@ -100,6 +112,16 @@ public:
      */
     virtual cache_result_t del_value(const CACHE_KEY& key) = 0;
 
+    /**
+     * Delete all values that depend upon any of the specified tables.
+     *
+     * @param tables  Fully qualified names of tables, in lower case.
+     *
+     * @return CACHE_RESULT_OK if the values were deleted. Note that
+     *         CACHE_RESULT_OK is returned also if there were no such values.
+     */
+    virtual cache_result_t invalidate(const std::vector<std::string>& tables) = 0;
+
     /**
      * Get the head item from the storage. This is only intended for testing and
      * debugging purposes and if the storage is being used by different threads
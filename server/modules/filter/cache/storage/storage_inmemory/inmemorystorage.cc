@@ -170,7 +170,7 @@ cache_result_t InMemoryStorage::do_get_value(const CACHE_KEY& key,
 
         if (is_hard_stale)
         {
-            m_entries.erase(i);
+            erase(i);
             result |= CACHE_RESULT_DISCARDED;
         }
         else if (!is_soft_stale || include_stale)
@@ -209,7 +209,9 @@ cache_result_t InMemoryStorage::do_get_value(const CACHE_KEY& key,
     return result;
 }
 
-cache_result_t InMemoryStorage::do_put_value(const CACHE_KEY& key, const GWBUF& value)
+cache_result_t InMemoryStorage::do_put_value(const CACHE_KEY& key,
+                                             const std::vector<std::string>& tables,
+                                             const GWBUF& value)
 {
     mxb_assert(GWBUF_IS_CONTIGUOUS(&value));
 
@@ -231,6 +233,8 @@ cache_result_t InMemoryStorage::do_put_value(const CACHE_KEY& key, const GWBUF&
 
         pEntry = &i->second;
 
+        unlink_tables(key, pEntry->tables);
+
         m_stats.size -= pEntry->value.size();
 
         if (size < pEntry->value.capacity())
@@ -252,27 +256,93 @@ cache_result_t InMemoryStorage::do_put_value(const CACHE_KEY& key, const GWBUF&
 
     copy(pData, pData + size, pEntry->value.begin());
     pEntry->time = time(NULL);
+    pEntry->tables = tables;
+
+    link_tables(key, tables);
 
     return CACHE_RESULT_OK;
 }
 
 cache_result_t InMemoryStorage::do_del_value(const CACHE_KEY& key)
 {
+    cache_result_t result = CACHE_RESULT_NOT_FOUND;
+
     Entries::iterator i = m_entries.find(key);
 
     if (i != m_entries.end())
     {
-        mxb_assert(m_stats.size >= i->second.value.size());
-        mxb_assert(m_stats.items > 0);
-
-        m_stats.size -= i->second.value.size();
-        m_stats.items -= 1;
         m_stats.deletes += 1;
 
-        m_entries.erase(i);
+        erase(i);
+        result = CACHE_RESULT_OK;
+    }
+
+    return result;
+}
+
+cache_result_t InMemoryStorage::do_invalidate(const std::vector<std::string>& tables)
+{
+    for (const auto& table : tables)
+    {
+        KeysByTable::iterator i = m_keys_by_table.find(table);
+
+        if (i != m_keys_by_table.end())
+        {
+            // Erasing an entry modifies the mapping, so the keys must be copied.
+            std::vector<CACHE_KEY> keys(i->second.begin(), i->second.end());
+
+            for (const auto& key : keys)
+            {
+                Entries::iterator j = m_entries.find(key);
+                mxb_assert(j != m_entries.end());
+
+                m_stats.invalidations += 1;
+
+                erase(j);
+            }
+        }
     }
 
-    return i != m_entries.end() ? CACHE_RESULT_OK : CACHE_RESULT_NOT_FOUND;
+    return CACHE_RESULT_OK;
+}
+
+void InMemoryStorage::erase(Entries::iterator i)
+{
+    mxb_assert(m_stats.size >= i->second.value.size());
+    mxb_assert(m_stats.items > 0);
+
+    m_stats.size -= i->second.value.size();
+    m_stats.items -= 1;
+
+    unlink_tables(i->first, i->second.tables);
+
+    m_entries.erase(i);
+}
+
+void InMemoryStorage::link_tables(const CACHE_KEY& key, const std::vector<std::string>& tables)
+{
+    for (const auto& table : tables)
+    {
+        m_keys_by_table[table].insert(key);
+    }
+}
+
+void InMemoryStorage::unlink_tables(const CACHE_KEY& key, const std::vector<std::string>& tables)
+{
+    for (const auto& table : tables)
+    {
+        KeysByTable::iterator i = m_keys_by_table.find(table);
+
+        if (i != m_keys_by_table.end())
+        {
+            i->second.erase(key);
+
+            if (i->second.empty())
+            {
+                m_keys_by_table.erase(i);
+            }
+        }
+    }
 }
 
 static void set_integer(json_t* pObject, const char* zName, size_t value)
@@ -294,4 +364,5 @@ void InMemoryStorage::Stats::fill(json_t* pObject) const
     set_integer(pObject, "misses", misses);
     set_integer(pObject, "updates", updates);
     set_integer(pObject, "deletes", deletes);
+    set_integer(pObject, "invalidations", invalidations);
 }
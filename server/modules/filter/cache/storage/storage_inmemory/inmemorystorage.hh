@@ -17,6 +17,7 @@
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include "../../cache_storage_api.hh"
 
 class InMemoryStorage
@@ -38,8 +39,11 @@ public:
                                      uint32_t soft_ttl,
                                      uint32_t hard_ttl,
                                      GWBUF**  ppResult) = 0;
-    virtual cache_result_t put_value(const CACHE_KEY& key, const GWBUF& value) = 0;
+    virtual cache_result_t put_value(const CACHE_KEY& key,
+                                     const std::vector<std::string>& tables,
+                                     const GWBUF& value) = 0;
     virtual cache_result_t del_value(const CACHE_KEY& key) = 0;
+    virtual cache_result_t invalidate(const std::vector<std::string>& tables) = 0;
 
     cache_result_t get_head(CACHE_KEY* pKey, GWBUF** ppHead) const;
     cache_result_t get_tail(CACHE_KEY* pKey, GWBUF** ppHead) const;
@@ -56,8 +60,11 @@ protected:
                                 uint32_t soft_ttl,
                                 uint32_t hard_ttl,
                                 GWBUF**  ppResult);
-    cache_result_t do_put_value(const CACHE_KEY& key, const GWBUF& value);
+    cache_result_t do_put_value(const CACHE_KEY& key,
+                                const std::vector<std::string>& tables,
+                                const GWBUF& value);
     cache_result_t do_del_value(const CACHE_KEY& key);
+    cache_result_t do_invalidate(const std::vector<std::string>& tables);
 
 private:
     InMemoryStorage(const InMemoryStorage&);
@@ -73,8 +80,9 @@ private:
         {
         }
 
-        uint32_t time;
-        Value    value;
+        uint32_t                 time;
+        Value                    value;
+        std::vector<std::string> tables;    // The tables the value depends upon.
     };
 
     struct Stats
@@ -86,23 +94,31 @@ private:
             , misses(0)
             , updates(0)
             , deletes(0)
+            , invalidations(0)
         {
         }
 
         void fill(json_t* pObject) const;
 
-        uint64_t size;      /*< The total size of the stored values. */
-        uint64_t items;     /*< The number of stored items. */
-        uint64_t hits;      /*< How many times a key was found in the cache. */
-        uint64_t misses;    /*< How many times a key was not found in the cache. */
-        uint64_t updates;   /*< How many times an existing key in the cache was updated. */
-        uint64_t deletes;   /*< How many times an existing key in the cache was deleted. */
+        uint64_t size;          /*< The total size of the stored values. */
+        uint64_t items;         /*< The number of stored items. */
+        uint64_t hits;          /*< How many times a key was found in the cache. */
+        uint64_t misses;        /*< How many times a key was not found in the cache. */
+        uint64_t updates;       /*< How many times an existing key in the cache was updated. */
+        uint64_t deletes;       /*< How many times an existing key in the cache was deleted. */
+        uint64_t invalidations; /*< How many items have been deleted due to an invalidation. */
     };
 
-    typedef std::unordered_map<CACHE_KEY, Entry> Entries;
+    typedef std::unordered_map<CACHE_KEY, Entry>                           Entries;
+    typedef std::unordered_map<std::string, std::unordered_set<CACHE_KEY>> KeysByTable;
+
+    void erase(Entries::iterator i);
+    void link_tables(const CACHE_KEY& key, const std::vector<std::string>& tables);
+    void unlink_tables(const CACHE_KEY& key, const std::vector<std::string>& tables);
 
     std::string                m_name;
     const CACHE_STORAGE_CONFIG m_config;
     Entries                    m_entries;
+    KeysByTable                m_keys_by_table;
     Stats                      m_stats;
 };
@@ -52,11 +52,13 @@ cache_result_t InMemoryStorageMT::get_value(const CACHE_KEY& key,
     return do_get_value(key, flags, soft_ttl, hard_ttl, ppResult);
 }
 
-cache_result_t InMemoryStorageMT::put_value(const CACHE_KEY& key, const GWBUF& value)
+cache_result_t InMemoryStorageMT::put_value(const CACHE_KEY& key,
+                                            const std::vector<std::string>& tables,
+                                            const GWBUF& value)
 {
     std::lock_guard<std::mutex> guard(m_lock);
 
-    return do_put_value(key, value);
+    return do_put_value(key, tables, value);
 }
 
 cache_result_t InMemoryStorageMT::del_value(const CACHE_KEY& key)
@@ -65,3 +67,10 @@ cache_result_t InMemoryStorageMT::del_value(const CACHE_KEY& key)
 
     return do_del_value(key);
 }
+
+cache_result_t InMemoryStorageMT::invalidate(const std::vector<std::string>& tables)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+
+    return do_invalidate(tables);
+}
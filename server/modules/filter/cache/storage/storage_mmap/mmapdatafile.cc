@@ -0,0 +1,412 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#define MXS_MODULE_NAME "storage_mmap"
+#include "mmapdatafile.hh"
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/file.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <zlib.h>
+#include <algorithm>
+#include <maxscale/log.h>
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace
+{
+
+struct DataHeader
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t generation;
+    uint64_t end;           /*< The offset following the last record. */
+};
+
+const uint64_t DATA_MAGIC = 0x415441444d4d584d;     // "MXMMDATA"
+const uint32_t DATA_VERSION = 1;
+const uint64_t DATA_BEGIN = 64;
+
+static_assert(sizeof(DataHeader) <= DATA_BEGIN, "The data header does not fit.");
+static_assert(sizeof(MMapRecord) % 8 == 0, "Records must be 8-byte aligned.");
+
+inline uint64_t align8(uint64_t n)
+{
+    return (n + 7) & ~(uint64_t)7;
+}
+
+inline uint64_t round_to_pages(uint64_t n)
+{
+    uint64_t page_size = sysconf(_SC_PAGESIZE);
+
+    return ((n + page_size - 1) / page_size) * page_size;
+}
+
+uint32_t checksum(const uint8_t* pData, size_t length)
+{
+    return crc32(crc32(0, Z_NULL, 0), pData, length);
+}
+
+bool lock_file(int fd, const string& path)
+{
+    bool rv = (flock(fd, LOCK_EX | LOCK_NB) == 0);
+
+    if (!rv)
+    {
+        if (errno == EWOULDBLOCK)
+        {
+            MXS_ERROR("The cache file '%s' is in use by another process.", path.c_str());
+        }
+        else
+        {
+            MXS_ERROR("Could not lock the cache file '%s': %s", path.c_str(), mxs_strerror(errno));
+        }
+    }
+
+    return rv;
+}
+}
+
+vector<string> MMapRecord::tables() const
+{
+    vector<string> rv;
+
+    const char* pTable = reinterpret_cast<const char*>(value() + value_length);
+    const char* pEnd = pTable + tables_length;
+
+    while (pTable < pEnd)
+    {
+        size_t length = strlen(pTable);
+        rv.push_back(string(pTable, length));
+        pTable += length + 1;
+    }
+
+    return rv;
+}
+
+bool MMapRecord::is_valid(uint64_t max_size) const
+{
+    uint64_t needed = sizeof(MMapRecord) + (uint64_t)value_length + tables_length;
+
+    return magic == MAGIC
+           && size % 8 == 0
+           && size <= max_size
+           && needed <= size
+           && (tables_length == 0 || value()[value_length + tables_length - 1] == 0)
+           && crc == checksum(value(), value_length);
+}
+
+MMapExtent::MMapExtent(uint64_t offset, uint8_t* pBase, size_t size)
+    : m_offset(offset)
+    , m_pBase(pBase)
+    , m_size(size)
+{
+}
+
+MMapExtent::~MMapExtent()
+{
+    munmap(m_pBase, m_size);
+}
+
+const SMMapExtent& mmap_find_extent(const MMapExtents& extents, uint64_t offset)
+{
+    auto i = std::upper_bound(extents.begin(), extents.end(), offset,
+                              [](uint64_t offset, const SMMapExtent& sExtent) {
+                                  return offset < sExtent->begin();
+                              });
+
+    mxb_assert(i != extents.begin());
+    --i;
+    mxb_assert(offset < (*i)->end());
+
+    return *i;
+}
+
+MMapDataFile::MMapDataFile(const string& path, int fd, size_t extent_size)
+    : m_path(path)
+    , m_fd(fd)
+    , m_extent_size(extent_size)
+{
+}
+
+MMapDataFile::~MMapDataFile()
+{
+    // The extents may still be referred to, but they do not need the descriptor.
+    close(m_fd);
+}
+
+// static
+unique_ptr<MMapDataFile> MMapDataFile::Open(const string& path, size_t extent_size)
+{
+    unique_ptr<MMapDataFile> sFile;
+
+    int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+
+    if (fd != -1)
+    {
+        if (lock_file(fd, path))
+        {
+            sFile.reset(new MMapDataFile(path, fd, extent_size));
+
+            struct stat st;
+
+            if (fstat(fd, &st) == 0
+                && (uint64_t)st.st_size >= DATA_BEGIN
+                && (uint64_t)st.st_size == round_to_pages(st.st_size)
+                && sFile->map(0, st.st_size))
+            {
+                const DataHeader* pHeader = reinterpret_cast<const DataHeader*>(sFile->extent(0)->at(0));
+
+                if (pHeader->magic != DATA_MAGIC
+                    || pHeader->version != DATA_VERSION
+                    || pHeader->end < DATA_BEGIN
+                    || pHeader->end > (uint64_t)st.st_size)
+                {
+                    MXS_WARNING("'%s' is not a valid cache data file.", path.c_str());
+                    sFile.reset();
+                }
+            }
+            else
+            {
+                MXS_WARNING("Could not map the cache data file '%s'.", path.c_str());
+                sFile.reset();
+            }
+        }
+        else
+        {
+            close(fd);
+        }
+    }
+    else if (errno != ENOENT)
+    {
+        MXS_ERROR("Could not open the cache data file '%s': %s", path.c_str(), mxs_strerror(errno));
+    }
+
+    return sFile;
+}
+
+// static
+unique_ptr<MMapDataFile> MMapDataFile::Create(const string& path,
+                                              size_t extent_size,
+                                              uint64_t generation,
+                                              uint64_t capacity)
+{
+    unique_ptr<MMapDataFile> sFile;
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+
+    if (fd != -1)
+    {
+        if (lock_file(fd, path))
+        {
+            sFile.reset(new MMapDataFile(path, fd, extent_size));
+
+            uint64_t size = round_to_pages(DATA_BEGIN + capacity);
+
+            if (ftruncate(fd, 0) == 0 && ftruncate(fd, size) == 0 && sFile->map(0, size))
+            {
+                DataHeader* pHeader = reinterpret_cast<DataHeader*>(sFile->extent(0)->at(0));
+
+                pHeader->magic = DATA_MAGIC;
+                pHeader->version = DATA_VERSION;
+                pHeader->generation = generation;
+                pHeader->end = DATA_BEGIN;
+            }
+            else
+            {
+                MXS_ERROR("Could not create the cache data file '%s': %s",
+                          path.c_str(), mxs_strerror(errno));
+                sFile.reset();
+            }
+        }
+        else
+        {
+            close(fd);
+        }
+    }
+    else
+    {
+        MXS_ERROR("Could not create the cache data file '%s': %s", path.c_str(), mxs_strerror(errno));
+    }
+
+    return sFile;
+}
+
+uint64_t MMapDataFile::generation() const
+{
+    return reinterpret_cast<const DataHeader*>(m_extents.front()->at(0))->generation;
+}
+
+uint64_t MMapDataFile::begin() const
+{
+    return DATA_BEGIN;
+}
+
+uint64_t MMapDataFile::end() const
+{
+    return reinterpret_cast<const DataHeader*>(m_extents.front()->at(0))->end;
+}
+
+uint64_t MMapDataFile::append(const CACHE_KEY& key,
+                              uint32_t time,
+                              const vector<string>& tables,
+                              const uint8_t* pValue,
+                              size_t value_length)
+{
+    uint64_t offset = 0;
+
+    size_t tables_length = 0;
+
+    for (const auto& table : tables)
+    {
+        tables_length += table.length() + 1;
+    }
+
+    uint64_t size = align8(sizeof(MMapRecord) + value_length + tables_length);
+
+    uint8_t* pData = (size <= UINT32_MAX) ? reserve(size) : nullptr;
+
+    if (pData)
+    {
+        MMapRecord* pRecord = reinterpret_cast<MMapRecord*>(pData);
+        uint8_t* pTo = pData + sizeof(MMapRecord);
+
+        memcpy(pTo, pValue, value_length);
+        pTo += value_length;
+
+        for (const auto& table : tables)
+        {
+            memcpy(pTo, table.c_str(), table.length() + 1);
+            pTo += table.length() + 1;
+        }
+
+        pRecord->magic = MMapRecord::MAGIC;
+        pRecord->size = size;
+        pRecord->key = key.data;
+        pRecord->time = time;
+        pRecord->crc = checksum(pValue, value_length);
+        pRecord->value_length = value_length;
+        pRecord->tables_length = tables_length;
+
+        offset = end();
+        commit(size);
+    }
+
+    return offset;
+}
+
+uint64_t MMapDataFile::append(const MMapRecord& record)
+{
+    uint64_t offset = 0;
+
+    uint8_t* pData = reserve(record.size);
+
+    if (pData)
+    {
+        memcpy(pData, &record, record.size);
+
+        offset = end();
+        commit(record.size);
+    }
+
+    return offset;
+}
+
+bool MMapDataFile::rename(const string& path)
+{
+    bool rv = (::rename(m_path.c_str(), path.c_str()) == 0);
+
+    if (rv)
+    {
+        m_path = path;
+    }
+    else
+    {
+        MXS_ERROR("Could not rename '%s' to '%s': %s", m_path.c_str(), path.c_str(), mxs_strerror(errno));
+    }
+
+    return rv;
+}
+
+bool MMapDataFile::map(uint64_t offset, size_t size)
+{
+    void* pBase = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, offset);
+
+    if (pBase != MAP_FAILED)
+    {
+        m_extents.push_back(std::make_shared<MMapExtent>(offset, static_cast<uint8_t*>(pBase), size));
+    }
+    else
+    {
+        MXS_ERROR("Could not map %lu bytes of '%s': %s",
+                  (unsigned long)size, m_path.c_str(), mxs_strerror(errno));
+    }
+
+    return pBase != MAP_FAILED;
+}
+
+/**
+ * Get room for a record at the end of the file, growing the file if needed.
+ *
+ * @param size  The size of the record.
+ *
+ * @return Pointer to where the record should be written, or NULL if the file
+ *         could not be grown.
+ */
+uint8_t* MMapDataFile::reserve(size_t size)
+{
+    DataHeader* pHeader = reinterpret_cast<DataHeader*>(m_extents.front()->at(0));
+    uint64_t last_end = m_extents.back()->end();
+    bool fits = true;
+
+    if (pHeader->end + size > last_end)
+    {
+        // A record never spans extents, so the rest of the last one is padded.
+        uint64_t extent_size = round_to_pages(std::max(size, m_extent_size));
+
+        if (ftruncate(m_fd, last_end + extent_size) == 0 && map(last_end, extent_size))
+        {
+            uint64_t remaining = last_end - pHeader->end;
+
+            if (remaining != 0)
+            {
+                mxb_assert(remaining <= UINT32_MAX);
+                MMapRecord* pPadding = reinterpret_cast<MMapRecord*>(extent(pHeader->end)->at(pHeader->end));
+                pPadding->magic = MMapRecord::PADDING;
+                pPadding->size = remaining;
+            }
+
+            pHeader->end = last_end;
+        }
+        else
+        {
+            MXS_ERROR("Could not grow the cache data file '%s': %s", m_path.c_str(), mxs_strerror(errno));
+            fits = false;
+        }
+    }
+
+    return fits ? extent(pHeader->end)->at(pHeader->end) : nullptr;
+}
+
+void MMapDataFile::commit(size_t size)
+{
+    DataHeader* pHeader = reinterpret_cast<DataHeader*>(m_extents.front()->at(0));
+
+    pHeader->end += size;
+}
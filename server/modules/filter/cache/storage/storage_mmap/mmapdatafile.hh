@@ -0,0 +1,227 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../../cache_storage_api.h"
+
+/**
+ * A record in the data file. The header is followed by the value and then
+ * by the names of the tables the value depends upon, each terminated by a
+ * NUL. A record is always 8-byte aligned and never spans two extents.
+ */
+struct MMapRecord
+{
+    enum
+    {
+        MAGIC   = 0x4d584352,   // "MXCR"
+        PADDING = 0x4d584350    // "MXCP", fills the unused end of an extent.
+    };
+
+    uint32_t magic;
+    uint32_t size;          /*< Size of the whole record, including this header. */
+    uint64_t key;           /*< The key of the value. */
+    uint32_t time;          /*< When the value was stored. */
+    uint32_t crc;           /*< CRC32 of the value. */
+    uint32_t value_length;  /*< Length of the value. */
+    uint32_t tables_length; /*< Length of the table names, including the NULs. */
+
+    bool is_padding() const
+    {
+        return magic == PADDING;
+    }
+
+    const uint8_t* value() const
+    {
+        return reinterpret_cast<const uint8_t*>(this + 1);
+    }
+
+    std::vector<std::string> tables() const;
+
+    /**
+     * Check whether the record is intact.
+     *
+     * @param max_size  How many bytes there are available for the record.
+     *
+     * @return True, if the header is consistent and the checksum of the value matches.
+     */
+    bool is_valid(uint64_t max_size) const;
+};
+
+/**
+ * A memory mapped region of the data file. An extent remains mapped as long
+ * as someone refers to it, even if the data file it belongs to has been
+ * replaced, which allows values to be handed out without copying them.
+ */
+class MMapExtent
+{
+public:
+    MMapExtent(uint64_t offset, uint8_t* pBase, size_t size);
+    ~MMapExtent();
+
+    uint64_t begin() const
+    {
+        return m_offset;
+    }
+
+    uint64_t end() const
+    {
+        return m_offset + m_size;
+    }
+
+    uint8_t* at(uint64_t offset) const
+    {
+        mxb_assert(offset >= begin() && offset < end());
+        return m_pBase + (offset - m_offset);
+    }
+
+private:
+    MMapExtent(const MMapExtent&);
+    MMapExtent& operator=(const MMapExtent&);
+
+    uint64_t m_offset;
+    uint8_t* m_pBase;
+    size_t   m_size;
+};
+
+typedef std::shared_ptr<MMapExtent> SMMapExtent;
+typedef std::vector<SMMapExtent>    MMapExtents;
+
+/**
+ * Find the extent containing a particular offset.
+ *
+ * @param extents  Extents ordered by offset.
+ * @param offset   An offset in the file.
+ *
+ * @return The extent containing the offset.
+ */
+const SMMapExtent& mmap_find_extent(const MMapExtents& extents, uint64_t offset);
+
+/**
+ * An append-only file of records. The file grows an extent at a time and
+ * each extent is mapped separately, so that growing the file never moves
+ * data that already has been mapped.
+ */
+class MMapDataFile
+{
+public:
+    ~MMapDataFile();
+
+    /**
+     * Open an existing data file. The whole file will be mapped as one extent.
+     *
+     * @param path         The path of the file.
+     * @param extent_size  The size with which the file is grown.
+     *
+     * @return The file, or NULL if it does not exist, is not a valid data file
+     *         or cannot be locked.
+     */
+    static std::unique_ptr<MMapDataFile> Open(const std::string& path, size_t extent_size);
+
+    /**
+     * Create a new data file, replacing an existing file.
+     *
+     * @param path         The path of the file.
+     * @param extent_size  The size with which the file is grown.
+     * @param generation   The generation of the file.
+     * @param capacity     The initial number of bytes for records.
+     *
+     * @return The file, or NULL if it could not be created.
+     */
+    static std::unique_ptr<MMapDataFile> Create(const std::string& path,
+                                                size_t extent_size,
+                                                uint64_t generation,
+                                                uint64_t capacity);
+
+    const std::string& path() const
+    {
+        return m_path;
+    }
+
+    uint64_t generation() const;
+
+    /**
+     * @return The offset of the first record.
+     */
+    uint64_t begin() const;
+
+    /**
+     * @return The offset following the last record.
+     */
+    uint64_t end() const;
+
+    uint64_t file_size() const
+    {
+        return m_extents.back()->end();
+    }
+
+    const MMapExtents& extents() const
+    {
+        return m_extents;
+    }
+
+    const MMapRecord* record(uint64_t offset) const
+    {
+        return reinterpret_cast<const MMapRecord*>(extent(offset)->at(offset));
+    }
+
+    const SMMapExtent& extent(uint64_t offset) const
+    {
+        return mmap_find_extent(m_extents, offset);
+    }
+
+    /**
+     * Append a record.
+     *
+     * @return The offset of the record, or 0 if it could not be appended.
+     */
+    uint64_t append(const CACHE_KEY& key,
+                    uint32_t time,
+                    const std::vector<std::string>& tables,
+                    const uint8_t* pValue,
+                    size_t value_length);
+
+    /**
+     * Append a copy of a record of another file.
+     *
+     * @return The offset of the record, or 0 if it could not be appended.
+     */
+    uint64_t append(const MMapRecord& record);
+
+    /**
+     * Rename the file.
+     *
+     * @param path  The new path.
+     *
+     * @return True, if the file could be renamed.
+     */
+    bool rename(const std::string& path);
+
+private:
+    MMapDataFile(const std::string& path, int fd, size_t extent_size);
+
+    MMapDataFile(const MMapDataFile&);
+    MMapDataFile& operator=(const MMapDataFile&);
+
+    bool     map(uint64_t offset, size_t size);
+    uint8_t* reserve(size_t size);
+    void     commit(size_t size);
+
+    std::string m_path;
+    int         m_fd;
+    size_t      m_extent_size;
+    MMapExtents m_extents;
+};
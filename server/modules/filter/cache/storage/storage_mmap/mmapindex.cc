@@ -0,0 +1,351 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#define MXS_MODULE_NAME "storage_mmap"
+#include "mmapindex.hh"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <maxscale/log.h>
+
+using std::string;
+using std::unique_ptr;
+
+namespace
+{
+
+struct IndexHeader
+{
+    uint64_t magic;
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t generation;    /*< The generation of the data file the index refers to. */
+    uint64_t n_slots;
+    uint64_t n_used;
+    uint64_t n_deleted;
+};
+
+const uint64_t INDEX_MAGIC = 0x5844494d4d4d584d;    // "MXMMMIDX"
+const uint32_t INDEX_VERSION = 1;
+const size_t INDEX_BEGIN = 64;
+const size_t INDEX_MIN_SLOTS = 64;
+
+static_assert(sizeof(IndexHeader) <= INDEX_BEGIN, "The index header does not fit.");
+
+inline IndexHeader* header_of(void* pBase)
+{
+    return static_cast<IndexHeader*>(pBase);
+}
+
+/**
+ * The keys are CRCs, so the bits are mixed before the slot is selected
+ * to avoid clustering.
+ */
+inline uint64_t mix(uint64_t key)
+{
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccd;
+    key ^= key >> 33;
+    key *= 0xc4ceb9fe1a85ec53;
+    key ^= key >> 33;
+
+    return key;
+}
+}
+
+MMapIndex::MMapIndex(const string& path, int fd, void* pBase, size_t size)
+    : m_path(path)
+    , m_fd(fd)
+    , m_pBase(pBase)
+    , m_size(size)
+    , m_pSlots(reinterpret_cast<Slot*>(static_cast<uint8_t*>(pBase) + INDEX_BEGIN))
+    , m_n_slots((size - INDEX_BEGIN) / sizeof(Slot))
+{
+}
+
+MMapIndex::~MMapIndex()
+{
+    munmap(m_pBase, m_size);
+    close(m_fd);
+}
+
+// static
+unique_ptr<MMapIndex> MMapIndex::Open(const string& path, uint64_t generation)
+{
+    unique_ptr<MMapIndex> sIndex;
+
+    int fd = open(path.c_str(), O_RDWR | O_CLOEXEC);
+
+    if (fd != -1)
+    {
+        struct stat st;
+
+        if (fstat(fd, &st) == 0 && (uint64_t)st.st_size > INDEX_BEGIN)
+        {
+            sIndex = map(path, fd, st.st_size);
+
+            if (sIndex)
+            {
+                const IndexHeader* pHeader = header_of(sIndex->m_pBase);
+                size_t n_slots = sIndex->m_n_slots;
+
+                if (pHeader->magic != INDEX_MAGIC
+                    || pHeader->version != INDEX_VERSION
+                    || pHeader->generation != generation
+                    || pHeader->n_slots != n_slots
+                    || (n_slots & (n_slots - 1)) != 0
+                    || pHeader->n_used + pHeader->n_deleted >= n_slots)
+                {
+                    MXS_WARNING("The cache index '%s' is not valid or does not match the data file.",
+                                path.c_str());
+                    sIndex.reset();
+                }
+            }
+        }
+        else
+        {
+            close(fd);
+        }
+    }
+    else if (errno != ENOENT)
+    {
+        MXS_ERROR("Could not open the cache index '%s': %s", path.c_str(), mxs_strerror(errno));
+    }
+
+    return sIndex;
+}
+
+// static
+unique_ptr<MMapIndex> MMapIndex::Create(const string& path, uint64_t generation, size_t n_keys)
+{
+    unique_ptr<MMapIndex> sIndex;
+
+    // The index is kept at most half full after having been created.
+    size_t n_slots = INDEX_MIN_SLOTS;
+
+    while (n_keys * 2 > n_slots)
+    {
+        n_slots *= 2;
+    }
+
+    size_t size = INDEX_BEGIN + n_slots * sizeof(Slot);
+
+    int fd = open(path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0660);
+
+    // Truncating to 0 first ensures that all slots are empty.
+    if (fd != -1 && ftruncate(fd, 0) == 0 && ftruncate(fd, size) == 0)
+    {
+        sIndex = map(path, fd, size);
+
+        if (sIndex)
+        {
+            IndexHeader* pHeader = header_of(sIndex->m_pBase);
+
+            pHeader->magic = INDEX_MAGIC;
+            pHeader->version = INDEX_VERSION;
+            pHeader->generation = generation;
+            pHeader->n_slots = n_slots;
+        }
+    }
+    else
+    {
+        MXS_ERROR("Could not create the cache index '%s': %s", path.c_str(), mxs_strerror(errno));
+
+        if (fd != -1)
+        {
+            close(fd);
+        }
+    }
+
+    return sIndex;
+}
+
+size_t MMapIndex::size() const
+{
+    return header_of(m_pBase)->n_used;
+}
+
+uint64_t MMapIndex::find(const CACHE_KEY& key) const
+{
+    const Slot* pSlot = lookup(key.data);
+
+    return pSlot->is_used() ? pSlot->offset : 0;
+}
+
+bool MMapIndex::insert(const CACHE_KEY& key, uint64_t offset)
+{
+    mxb_assert(offset > Slot::DELETED);
+
+    bool rv = true;
+    IndexHeader* pHeader = header_of(m_pBase);
+
+    if ((pHeader->n_used + pHeader->n_deleted + 1) * 4 > m_n_slots * 3)
+    {
+        // If most of the slots are deleted ones, the size remains the same.
+        size_t n_slots = m_n_slots;
+
+        while ((pHeader->n_used + 1) * 2 > n_slots)
+        {
+            n_slots *= 2;
+        }
+
+        rv = rebuild(n_slots);
+        pHeader = header_of(m_pBase);
+    }
+
+    if (rv)
+    {
+        Slot* pSlot = lookup(key.data);
+
+        if (!pSlot->is_used())
+        {
+            if (pSlot->offset == Slot::DELETED)
+            {
+                --pHeader->n_deleted;
+            }
+
+            ++pHeader->n_used;
+            pSlot->key = key.data;
+        }
+
+        pSlot->offset = offset;
+    }
+
+    return rv;
+}
+
+bool MMapIndex::erase(const CACHE_KEY& key)
+{
+    Slot* pSlot = lookup(key.data);
+    bool rv = pSlot->is_used();
+
+    if (rv)
+    {
+        IndexHeader* pHeader = header_of(m_pBase);
+
+        pSlot->offset = Slot::DELETED;
+        --pHeader->n_used;
+        ++pHeader->n_deleted;
+    }
+
+    return rv;
+}
+
+bool MMapIndex::rename(const string& path)
+{
+    bool rv = (::rename(m_path.c_str(), path.c_str()) == 0);
+
+    if (rv)
+    {
+        m_path = path;
+    }
+    else
+    {
+        MXS_ERROR("Could not rename '%s' to '%s': %s", m_path.c_str(), path.c_str(), mxs_strerror(errno));
+    }
+
+    return rv;
+}
+
+// static
+unique_ptr<MMapIndex> MMapIndex::map(const string& path, int fd, size_t size)
+{
+    unique_ptr<MMapIndex> sIndex;
+
+    void* pBase = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+    if (pBase != MAP_FAILED)
+    {
+        sIndex.reset(new MMapIndex(path, fd, pBase, size));
+    }
+    else
+    {
+        MXS_ERROR("Could not map the cache index '%s': %s", path.c_str(), mxs_strerror(errno));
+        close(fd);
+    }
+
+    return sIndex;
+}
+
+/**
+ * Find the slot of a key.
+ *
+ * @param key  The key to look for.
+ *
+ * @return The slot of the key if it is present, otherwise the slot where
+ *         the key should be inserted.
+ */
+MMapIndex::Slot* MMapIndex::lookup(uint64_t key) const
+{
+    size_t mask = m_n_slots - 1;
+    size_t i = mix(key) & mask;
+
+    Slot* pFree = nullptr;
+    Slot* pSlot = &m_pSlots[i];
+
+    // There is always at least one empty slot, so the loop terminates.
+    while (pSlot->offset != Slot::EMPTY && !(pSlot->is_used() && pSlot->key == key))
+    {
+        if (pSlot->offset == Slot::DELETED && !pFree)
+        {
+            pFree = pSlot;
+        }
+
+        i = (i + 1) & mask;
+        pSlot = &m_pSlots[i];
+    }
+
+    return (pSlot->offset == Slot::EMPTY && pFree) ? pFree : pSlot;
+}
+
+/**
+ * Rebuild the index into a new file, which then replaces the current one.
+ *
+ * @param n_slots  The number of slots of the new index.
+ *
+ * @return True, if the index could be rebuilt.
+ */
+bool MMapIndex::rebuild(size_t n_slots)
+{
+    bool rv = false;
+
+    unique_ptr<MMapIndex> sIndex = Create(m_path + ".tmp", header_of(m_pBase)->generation, n_slots / 2);
+
+    if (sIndex)
+    {
+        for_each([&sIndex](const CACHE_KEY& key, uint64_t offset) {
+                     MXB_AT_DEBUG(bool inserted = ) sIndex->insert(key, offset);
+                     mxb_assert(inserted);
+                 });
+
+        if (sIndex->rename(m_path))
+        {
+            swap(*sIndex);
+            rv = true;
+        }
+    }
+
+    return rv;
+}
+
+void MMapIndex::swap(MMapIndex& rhs)
+{
+    std::swap(m_path, rhs.m_path);
+    std::swap(m_fd, rhs.m_fd);
+    std::swap(m_pBase, rhs.m_pBase);
+    std::swap(m_size, rhs.m_size);
+    std::swap(m_pSlots, rhs.m_pSlots);
+    std::swap(m_n_slots, rhs.m_n_slots);
+}
@@ -0,0 +1,141 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <memory>
+#include <string>
+#include "../../cache_storage_api.h"
+
+/**
+ * A memory mapped open addressing hash table from keys to offsets in the
+ * data file. The table is rebuilt into a new file when it becomes too full.
+ */
+class MMapIndex
+{
+public:
+    struct Slot
+    {
+        enum
+        {
+            EMPTY   = 0,
+            DELETED = 1
+        };
+
+        uint64_t key;
+        uint64_t offset;    /*< Offset of the record, or EMPTY or DELETED. */
+
+        bool is_used() const
+        {
+            return offset != EMPTY && offset != DELETED;
+        }
+    };
+
+    ~MMapIndex();
+
+    /**
+     * Open an existing index.
+     *
+     * @param path        The path of the file.
+     * @param generation  The generation of the data file the index must refer to.
+     *
+     * @return The index, or NULL if it does not exist, is not valid or does not
+     *         belong to the data file.
+     */
+    static std::unique_ptr<MMapIndex> Open(const std::string& path, uint64_t generation);
+
+    /**
+     * Create a new index, replacing an existing file.
+     *
+     * @param path        The path of the file.
+     * @param generation  The generation of the data file the index refers to.
+     * @param n_keys      The number of keys the index should initially have room for.
+     *
+     * @return The index, or NULL if it could not be created.
+     */
+    static std::unique_ptr<MMapIndex> Create(const std::string& path,
+                                             uint64_t generation,
+                                             size_t n_keys);
+
+    /**
+     * @return The number of keys in the index.
+     */
+    size_t size() const;
+
+    /**
+     * Find the offset of a key.
+     *
+     * @return The offset of the record of the key, or 0 if the key is not present.
+     */
+    uint64_t find(const CACHE_KEY& key) const;
+
+    /**
+     * Insert or replace a key. The index is grown if needed.
+     *
+     * @return True, if the key could be inserted.
+     */
+    bool insert(const CACHE_KEY& key, uint64_t offset);
+
+    /**
+     * Remove a key.
+     *
+     * @return True, if the key was present.
+     */
+    bool erase(const CACHE_KEY& key);
+
+    /**
+     * Call a function for each key in the index.
+     *
+     * @param f  Function to be called with the key and the offset.
+     */
+    template<class Function>
+    void for_each(Function f) const
+    {
+        for (const Slot* pSlot = m_pSlots; pSlot != m_pSlots + m_n_slots; ++pSlot)
+        {
+            if (pSlot->is_used())
+            {
+                CACHE_KEY key = {pSlot->key};
+                f(key, pSlot->offset);
+            }
+        }
+    }
+
+    /**
+     * Rename the file.
+     *
+     * @param path  The new path.
+     *
+     * @return True, if the file could be renamed.
+     */
+    bool rename(const std::string& path);
+
+private:
+    MMapIndex(const std::string& path, int fd, void* pBase, size_t size);
+
+    MMapIndex(const MMapIndex&);
+    MMapIndex& operator=(const MMapIndex&);
+
+    static std::unique_ptr<MMapIndex> map(const std::string& path, int fd, size_t size);
+
+    Slot* lookup(uint64_t key) const;
+    bool  rebuild(size_t n_slots);
+    void  swap(MMapIndex& rhs);
+
+    std::string m_path;
+    int         m_fd;
+    void*       m_pBase;
+    size_t      m_size;
+    Slot*       m_pSlots;
+    size_t      m_n_slots;
+};
@@ -0,0 +1,853 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#define MXS_MODULE_NAME "storage_mmap"
+#include "mmapstorage.hh"
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <maxscale/config.h>
+#include <maxscale/paths.h>
+#include <maxscale/utils.h>
+
+using std::string;
+using std::unique_ptr;
+using std::vector;
+
+namespace
+{
+
+const size_t MMAP_MIN_EXTENT_SIZE = 1024 * 1024;
+const size_t MMAP_MAX_EXTENT_SIZE = 1024 * 1024 * 1024;
+const size_t MMAP_DEFAULT_EXTENT_SIZE = 64 * 1024 * 1024;
+
+// Compacting less than this is not worth the while.
+const uint64_t MMAP_MIN_COMPACTION_SIZE = 1024 * 1024;
+
+// How long to wait before retrying a failed compaction.
+const std::chrono::seconds MMAP_COMPACTION_RETRY_INTERVAL(60);
+
+void release_extent(void* pContext)
+{
+    delete static_cast<SMMapExtent*>(pContext);
+}
+
+bool get_number(const string& key, const string& value, uint64_t min, uint64_t max, uint64_t* pNumber)
+{
+    char* zEnd;
+    uint64_t number = strtoull(value.c_str(), &zEnd, 10);
+
+    bool rv = !value.empty() && *zEnd == 0 && number >= min && number <= max;
+
+    if (rv)
+    {
+        *pNumber = number;
+    }
+    else
+    {
+        MXS_ERROR("The value of the storage option '%s' must be a number between %lu and %lu, "
+                  "'%s' is not.",
+                  key.c_str(), (unsigned long)min, (unsigned long)max, value.c_str());
+    }
+
+    return rv;
+}
+
+bool parse_options(int argc, char* argv[], MMapStorage::Options* pOptions)
+{
+    bool rv = true;
+
+    for (int i = 0; i < argc; ++i)
+    {
+        string arg(argv[i]);
+        string::size_type pos = arg.find('=');
+
+        if (pos != string::npos)
+        {
+            string key = arg.substr(0, pos);
+            string value = arg.substr(pos + 1);
+            uint64_t number;
+
+            if (key == "cache_directory")
+            {
+                pOptions->directory = value;
+            }
+            else if (key == "extent_size")
+            {
+                if (get_number(key, value, MMAP_MIN_EXTENT_SIZE, MMAP_MAX_EXTENT_SIZE, &number))
+                {
+                    pOptions->extent_size = number;
+                }
+                else
+                {
+                    rv = false;
+                }
+            }
+            else if (key == "compaction_threshold")
+            {
+                if (get_number(key, value, 1, 100, &number))
+                {
+                    pOptions->compaction_threshold = number;
+                }
+                else
+                {
+                    rv = false;
+                }
+            }
+            else if (key == "zero_copy")
+            {
+                int truth = config_truth_value(value.c_str());
+
+                if (truth != -1)
+                {
+                    pOptions->zero_copy = truth;
+                }
+                else
+                {
+                    MXS_ERROR("The value of the storage option 'zero_copy' must be a boolean, "
+                              "'%s' is not.", value.c_str());
+                    rv = false;
+                }
+            }
+            else
+            {
+                MXS_WARNING("Unknown storage option '%s' ignored.", key.c_str());
+            }
+        }
+        else
+        {
+            MXS_WARNING("Storage option '%s' does not have a value, ignored.", arg.c_str());
+        }
+    }
+
+    return rv;
+}
+
+void set_integer(json_t* pObject, const char* zName, size_t value)
+{
+    json_t* pValue = json_integer(value);
+
+    if (pValue)
+    {
+        json_object_set(pObject, zName, pValue);
+        json_decref(pValue);
+    }
+}
+}
+
+MMapStorage::Options::Options()
+    : directory(get_cachedir())
+    , extent_size(MMAP_DEFAULT_EXTENT_SIZE)
+    , compaction_threshold(50)
+    , zero_copy(false)
+{
+}
+
+MMapStorage::MMapStorage(const string& name,
+                         const CACHE_STORAGE_CONFIG& config,
+                         const Options& options,
+                         unique_ptr<MMapDataFile> sData,
+                         unique_ptr<MMapIndex> sIndex)
+    : m_name(name)
+    , m_config(config)
+    , m_options(options)
+    , m_data_path(sData->path())
+    , m_index_path(m_data_path.substr(0, m_data_path.rfind('.')) + ".index")
+    , m_sData(std::move(sData))
+    , m_sIndex(std::move(sIndex))
+    , m_live(0)
+    , m_evict_offset(m_sData->begin())
+    , m_compact(false)
+    , m_stop(false)
+{
+    load();
+
+    m_compactor = std::thread(&MMapStorage::run_compactor, this);
+}
+
+MMapStorage::~MMapStorage()
+{
+    Guard guard(m_lock);
+    m_stop = true;
+    guard.unlock();
+
+    m_cond.notify_one();
+    m_compactor.join();
+}
+
+bool MMapStorage::Initialize(uint32_t* pCapabilities)
+{
+    // The storage enforces the limits itself, as the content of a storage
+    // wrapped by the LRU storage would not be known after a restart.
+    *pCapabilities = (CACHE_STORAGE_CAP_ST
+                      | CACHE_STORAGE_CAP_MT
+                      | CACHE_STORAGE_CAP_MAX_COUNT
+                      | CACHE_STORAGE_CAP_MAX_SIZE);
+
+    return true;
+}
+
+MMapStorage* MMapStorage::Create_instance(const char* zName,
+                                          const CACHE_STORAGE_CONFIG& config,
+                                          int argc,
+                                          char* argv[])
+{
+    mxb_assert(zName);
+
+    MMapStorage* pStorage = NULL;
+    Options options;
+
+    if (parse_options(argc, argv, &options))
+    {
+        string directory = options.directory + "/storage_mmap";
+
+        if (mxs_mkdir_all(directory.c_str(), 0770))
+        {
+            string name(zName);
+            std::replace(name.begin(), name.end(), '/', '_');
+
+            string data_path = directory + "/" + name + ".data";
+            string index_path = directory + "/" + name + ".index";
+
+            unique_ptr<MMapDataFile> sData = MMapDataFile::Open(data_path, options.extent_size);
+            unique_ptr<MMapIndex> sIndex;
+
+            if (sData)
+            {
+                sIndex = MMapIndex::Open(index_path, sData->generation());
+
+                if (!sIndex)
+                {
+                    MXS_WARNING("The cache content of '%s' cannot be used, starting with an empty cache.",
+                                data_path.c_str());
+                    sData.reset();
+                }
+            }
+
+            if (!sData)
+            {
+                sData = MMapDataFile::Create(data_path, options.extent_size, 1, options.extent_size);
+
+                if (sData)
+                {
+                    sIndex = MMapIndex::Create(index_path, sData->generation(), 0);
+                }
+            }
+
+            if (sData && sIndex)
+            {
+                pStorage = new MMapStorage(zName, config, options, std::move(sData), std::move(sIndex));
+
+                MXS_NOTICE("Storage module created, %lu items loaded from '%s'.",
+                           (unsigned long)pStorage->m_stats.items, data_path.c_str());
+            }
+        }
+        else
+        {
+            MXS_ERROR("Could not create the cache directory '%s'.", directory.c_str());
+        }
+    }
+
+    return pStorage;
+}
+
+void MMapStorage::get_config(CACHE_STORAGE_CONFIG* pConfig)
+{
+    *pConfig = m_config;
+}
+
+cache_result_t MMapStorage::get_info(uint32_t what, json_t** ppInfo) const
+{
+    Guard guard(m_lock);
+
+    *ppInfo = json_object();
+
+    if (*ppInfo)
+    {
+        m_stats.fill(*ppInfo);
+
+        uint64_t used = m_sData->end() - m_sData->begin();
+
+        set_integer(*ppInfo, "file_size", m_sData->file_size());
+        set_integer(*ppInfo, "unused_size", used - m_live);
+    }
+
+    return *ppInfo ? CACHE_RESULT_OK : CACHE_RESULT_OUT_OF_RESOURCES;
+}
+
+cache_result_t MMapStorage::get_value(const CACHE_KEY& key,
+                                      uint32_t flags,
+                                      uint32_t soft_ttl,
+                                      uint32_t hard_ttl,
+                                      GWBUF**  ppResult)
+{
+    cache_result_t result = CACHE_RESULT_NOT_FOUND;
+
+    Guard guard(m_lock);
+
+    uint64_t offset = m_sIndex->find(key);
+
+    if (offset != 0)
+    {
+        m_stats.hits += 1;
+
+        if (soft_ttl == CACHE_USE_CONFIG_TTL)
+        {
+            soft_ttl = m_config.soft_ttl;
+        }
+
+        if (hard_ttl == CACHE_USE_CONFIG_TTL)
+        {
+            hard_ttl = m_config.hard_ttl;
+        }
+
+        if (soft_ttl > hard_ttl)
+        {
+            soft_ttl = hard_ttl;
+        }
+
+        const MMapRecord* pRecord = m_sData->record(offset);
+
+        uint32_t now = time(NULL);
+
+        bool is_hard_stale = hard_ttl == 0 ? false : (now - pRecord->time > hard_ttl);
+        bool is_soft_stale = soft_ttl == 0 ? false : (now - pRecord->time > soft_ttl);
+        bool include_stale = ((flags & CACHE_FLAGS_INCLUDE_STALE) != 0);
+
+        if (is_hard_stale)
+        {
+            erase(key, offset);
+            check_compaction();
+            result |= CACHE_RESULT_DISCARDED;
+        }
+        else if (!is_soft_stale || include_stale)
+        {
+            uint8_t* pValue = const_cast<uint8_t*>(pRecord->value());
+
+            if (m_options.zero_copy)
+            {
+                // The buffer keeps the extent mapped, even if the file is compacted. As the
+                // mapping is shared and writable, modifying the buffer modifies the file.
+                SMMapExtent* pExtent = new SMMapExtent(m_sData->extent(offset));
+
+                *ppResult = gwbuf_alloc_external(pValue, pRecord->value_length, release_extent, pExtent);
+
+                if (!*ppResult)
+                {
+                    delete pExtent;
+                }
+            }
+            else
+            {
+                *ppResult = gwbuf_alloc_and_load(pRecord->value_length, pValue);
+            }
+
+            if (*ppResult)
+            {
+                result = CACHE_RESULT_OK;
+
+                if (is_soft_stale)
+                {
+                    result |= CACHE_RESULT_STALE;
+                }
+            }
+            else
+            {
+                result = CACHE_RESULT_OUT_OF_RESOURCES;
+            }
+        }
+        else
+        {
+            mxb_assert(is_soft_stale);
+            result |= CACHE_RESULT_STALE;
+        }
+    }
+    else
+    {
+        m_stats.misses += 1;
+    }
+
+    return result;
+}
+
+cache_result_t MMapStorage::put_value(const CACHE_KEY& key,
+                                      const vector<string>& tables,
+                                      const GWBUF& value)
+{
+    mxb_assert(GWBUF_IS_CONTIGUOUS(&value));
+
+    cache_result_t result = CACHE_RESULT_OUT_OF_RESOURCES;
+
+    size_t size = GWBUF_LENGTH(&value);
+
+    Guard guard(m_lock);
+
+    uint64_t offset = m_sData->append(key, time(NULL), tables, GWBUF_DATA(&value), size);
+
+    if (offset != 0)
+    {
+        uint64_t existing = m_sIndex->find(key);
+
+        if (existing != 0)
+        {
+            m_stats.updates += 1;
+            erase(key, existing);
+        }
+
+        if (m_sIndex->insert(key, offset))
+        {
+            m_stats.size += size;
+            m_stats.items += 1;
+            m_live += m_sData->record(offset)->size;
+
+            for (const auto& table : tables)
+            {
+                m_keys_by_table[table].insert(key);
+            }
+
+            evict();
+
+            result = CACHE_RESULT_OK;
+        }
+
+        check_compaction();
+    }
+
+    return result;
+}
+
+cache_result_t MMapStorage::del_value(const CACHE_KEY& key)
+{
+    cache_result_t result = CACHE_RESULT_NOT_FOUND;
+
+    Guard guard(m_lock);
+
+    uint64_t offset = m_sIndex->find(key);
+
+    if (offset != 0)
+    {
+        m_stats.deletes += 1;
+
+        erase(key, offset);
+        check_compaction();
+        result = CACHE_RESULT_OK;
+    }
+
+    return result;
+}
+
+cache_result_t MMapStorage::invalidate(const vector<string>& tables)
+{
+    Guard guard(m_lock);
+
+    for (const auto& table : tables)
+    {
+        KeysByTable::iterator i = m_keys_by_table.find(table);
+
+        if (i != m_keys_by_table.end())
+        {
+            // Erasing an entry modifies the mapping, so the keys must be copied.
+            vector<CACHE_KEY> keys(i->second.begin(), i->second.end());
+
+            for (const auto& key : keys)
+            {
+                uint64_t offset = m_sIndex->find(key);
+                mxb_assert(offset != 0);
+
+                m_stats.invalidations += 1;
+
+                erase(key, offset);
+            }
+        }
+    }
+
+    check_compaction();
+
+    return CACHE_RESULT_OK;
+}
+
+/**
+ * As values are not reordered when they are used, the head is the value that
+ * was stored last and the tail the one that will be evicted next.
+ */
+cache_result_t MMapStorage::get_head(CACHE_KEY* pKey, GWBUF** ppHead) const
+{
+    Guard guard(m_lock);
+
+    return get_record(find_live_record(true), pKey, ppHead);
+}
+
+cache_result_t MMapStorage::get_tail(CACHE_KEY* pKey, GWBUF** ppHead) const
+{
+    Guard guard(m_lock);
+
+    return get_record(find_live_record(false), pKey, ppHead);
+}
+
+cache_result_t MMapStorage::get_size(uint64_t* pSize) const
+{
+    Guard guard(m_lock);
+
+    *pSize = m_stats.size;
+
+    return CACHE_RESULT_OK;
+}
+
+cache_result_t MMapStorage::get_items(uint64_t* pItems) const
+{
+    Guard guard(m_lock);
+
+    *pItems = m_stats.items;
+
+    return CACHE_RESULT_OK;
+}
+
+/**
+ * Verify the records referred to by the index and build the in-memory
+ * state from them. Keys whose records are not intact are dropped.
+ */
+void MMapStorage::load()
+{
+    vector<CACHE_KEY> invalid;
+
+    uint64_t begin = m_sData->begin();
+    uint64_t end = m_sData->end();
+
+    m_sIndex->for_each([&](const CACHE_KEY& key, uint64_t offset) {
+                           const MMapRecord* pRecord = nullptr;
+
+                           if (offset >= begin && offset < end && offset % 8 == 0)
+                           {
+                               pRecord = m_sData->record(offset);
+
+                               if (!pRecord->is_valid(end - offset) || pRecord->key != key.data)
+                               {
+                                   pRecord = nullptr;
+                               }
+                           }
+
+                           if (pRecord)
+                           {
+                               m_stats.size += pRecord->value_length;
+                               m_stats.items += 1;
+                               m_live += pRecord->size;
+
+                               for (const auto& table : pRecord->tables())
+                               {
+                                   m_keys_by_table[table].insert(key);
+                               }
+                           }
+                           else
+                           {
+                               invalid.push_back(key);
+                           }
+                       });
+
+    if (!invalid.empty())
+    {
+        MXS_WARNING("Dropped %lu invalid entries from the cache '%s'.",
+                    (unsigned long)invalid.size(), m_name.c_str());
+
+        for (const auto& key : invalid)
+        {
+            m_sIndex->erase(key);
+        }
+    }
+
+    evict();
+    check_compaction();
+}
+
+/**
+ * Remove a key. The record of the key becomes unused space that will be
+ * reclaimed when the data file is compacted.
+ *
+ * @param key     The key to remove.
+ * @param offset  The offset of the record of the key.
+ */
+void MMapStorage::erase(const CACHE_KEY& key, uint64_t offset)
+{
+    const MMapRecord* pRecord = m_sData->record(offset);
+
+    mxb_assert(m_stats.size >= pRecord->value_length);
+    mxb_assert(m_stats.items > 0);
+    mxb_assert(m_live >= pRecord->size);
+
+    m_stats.size -= pRecord->value_length;
+    m_stats.items -= 1;
+    m_live -= pRecord->size;
+
+    for (const auto& table : pRecord->tables())
+    {
+        KeysByTable::iterator i = m_keys_by_table.find(table);
+
+        if (i != m_keys_by_table.end())
+        {
+            i->second.erase(key);
+
+            if (i->second.empty())
+            {
+                m_keys_by_table.erase(i);
+            }
+        }
+    }
+
+    MXB_AT_DEBUG(bool erased = ) m_sIndex->erase(key);
+    mxb_assert(erased);
+}
+
+/**
+ * Remove the oldest values until the limits are no longer exceeded. As the
+ * data file is append-only, the oldest values are found at its beginning.
+ */
+void MMapStorage::evict()
+{
+    while (((m_config.max_count != 0 && m_stats.items > m_config.max_count)
+            || (m_config.max_size != 0 && m_stats.size > m_config.max_size))
+           && m_evict_offset < m_sData->end())
+    {
+        uint64_t offset = m_evict_offset;
+        const MMapRecord* pRecord = m_sData->record(offset);
+
+        m_evict_offset += pRecord->size;
+
+        if (!pRecord->is_padding())
+        {
+            CACHE_KEY key = {pRecord->key};
+
+            // The record may have been superseded or deleted.
+            if (m_sIndex->find(key) == offset)
+            {
+                erase(key, offset);
+                m_stats.evictions += 1;
+            }
+        }
+    }
+}
+
+/**
+ * Find the oldest or the newest value that has not been superseded or deleted.
+ * As the data file is append-only, finding the newest one requires reading
+ * through the file.
+ *
+ * @param newest  Whether the newest or the oldest value should be found.
+ *
+ * @return The offset of the record, or 0 if there are no values.
+ */
+uint64_t MMapStorage::find_live_record(bool newest) const
+{
+    uint64_t found = 0;
+    uint64_t offset = m_evict_offset;
+
+    while (offset < m_sData->end() && (newest || found == 0))
+    {
+        const MMapRecord* pRecord = m_sData->record(offset);
+
+        if (!pRecord->is_padding())
+        {
+            CACHE_KEY key = {pRecord->key};
+
+            if (m_sIndex->find(key) == offset)
+            {
+                found = offset;
+            }
+        }
+
+        offset += pRecord->size;
+    }
+
+    return found;
+}
+
+cache_result_t MMapStorage::get_record(uint64_t offset, CACHE_KEY* pKey, GWBUF** ppValue) const
+{
+    cache_result_t result = CACHE_RESULT_NOT_FOUND;
+
+    if (offset != 0)
+    {
+        const MMapRecord* pRecord = m_sData->record(offset);
+
+        *ppValue = gwbuf_alloc_and_load(pRecord->value_length, pRecord->value());
+
+        if (*ppValue)
+        {
+            pKey->data = pRecord->key;
+            result = CACHE_RESULT_OK;
+        }
+        else
+        {
+            result = CACHE_RESULT_OUT_OF_RESOURCES;
+        }
+    }
+
+    return result;
+}
+
+void MMapStorage::check_compaction()
+{
+    uint64_t used = m_sData->end() - m_sData->begin();
+    uint64_t unused = used - m_live;
+
+    if (!m_compact
+        && unused >= MMAP_MIN_COMPACTION_SIZE
+        && unused * 100 >= used * m_options.compaction_threshold)
+    {
+        m_compact = true;
+        m_cond.notify_one();
+    }
+}
+
+void MMapStorage::run_compactor()
+{
+    Guard guard(m_lock);
+
+    while (!m_stop)
+    {
+        m_cond.wait(guard, [this]() {
+                        return m_compact || m_stop;
+                    });
+
+        if (!m_stop)
+        {
+            if (!compact(guard))
+            {
+                MXS_ERROR("Could not compact the cache data file '%s', retrying in %d seconds.",
+                          m_data_path.c_str(), (int)MMAP_COMPACTION_RETRY_INTERVAL.count());
+
+                m_cond.wait_for(guard, MMAP_COMPACTION_RETRY_INTERVAL, [this]() {
+                                    return m_stop;
+                                });
+            }
+
+            m_compact = false;
+            check_compaction();
+        }
+    }
+}
+
+/**
+ * Copy the live records to a new data file, which then replaces the current
+ * one. The bulk of the copying is done without holding the lock; only the
+ * records that were added while the copying was made are copied with the
+ * lock held.
+ *
+ * @param guard  The guard of the lock, locked on entry and on return.
+ *
+ * @return True, if the data file could be compacted.
+ */
+bool MMapStorage::compact(Guard& guard)
+{
+    typedef std::vector<std::pair<uint64_t, CACHE_KEY>> Records;
+
+    auto collect = [this](Records* pRecords) {
+            pRecords->clear();
+            pRecords->reserve(m_sIndex->size());
+
+            m_sIndex->for_each([pRecords](const CACHE_KEY& key, uint64_t offset) {
+                                   pRecords->emplace_back(offset, key);
+                               });
+
+            // The order of the records is retained, so that the oldest are still evicted first.
+            std::sort(pRecords->begin(), pRecords->end(),
+                      [](const Records::value_type& lhs, const Records::value_type& rhs) {
+                          return lhs.first < rhs.first;
+                      });
+        };
+
+    Records records;
+    collect(&records);
+
+    // The extents are kept mapped even if the file grows meanwhile.
+    MMapExtents extents = m_sData->extents();
+    uint64_t generation = m_sData->generation() + 1;
+    uint64_t live = m_live;
+
+    guard.unlock();
+
+    string data_path = m_data_path + ".tmp";
+    string index_path = m_index_path + ".tmp";
+
+    unique_ptr<MMapDataFile> sData = MMapDataFile::Create(data_path,
+                                                          m_options.extent_size,
+                                                          generation,
+                                                          live + m_options.extent_size);
+    std::unordered_map<uint64_t, uint64_t> moved;
+    bool ok = (sData != nullptr);
+
+    for (auto i = records.begin(); ok && i != records.end(); ++i)
+    {
+        const MMapRecord* pRecord =
+            reinterpret_cast<const MMapRecord*>(mmap_find_extent(extents, i->first)->at(i->first));
+
+        uint64_t offset = sData->append(*pRecord);
+
+        moved[i->first] = offset;
+        ok = (offset != 0);
+    }
+
+    guard.lock();
+
+    unique_ptr<MMapIndex> sIndex;
+
+    if (ok)
+    {
+        // Values may have been added, updated or deleted while the lock was released.
+        collect(&records);
+
+        sIndex = MMapIndex::Create(index_path, generation, records.size());
+        ok = (sIndex != nullptr);
+
+        for (auto i = records.begin(); ok && i != records.end(); ++i)
+        {
+            auto j = moved.find(i->first);
+            uint64_t offset = (j != moved.end()) ? j->second : sData->append(*m_sData->record(i->first));
+
+            ok = (offset != 0) && sIndex->insert(i->second, offset);
+        }
+    }
+
+    if (ok && sData->rename(m_data_path))
+    {
+        // If the index cannot be renamed, the generations of the files will
+        // not match at the next startup and the content will be discarded.
+        sIndex->rename(m_index_path);
+
+        m_sData = std::move(sData);
+        m_sIndex = std::move(sIndex);
+        m_evict_offset = m_sData->begin();
+        m_stats.compactions += 1;
+    }
+    else
+    {
+        unlink(data_path.c_str());
+        unlink(index_path.c_str());
+        ok = false;
+    }
+
+    return ok;
+}
+
+void MMapStorage::Stats::fill(json_t* pObject) const
+{
+    set_integer(pObject, "size", size);
+    set_integer(pObject, "items", items);
+    set_integer(pObject, "hits", hits);
+    set_integer(pObject, "misses", misses);
+    set_integer(pObject, "updates", updates);
+    set_integer(pObject, "deletes", deletes);
+    set_integer(pObject, "invalidations", invalidations);
+    set_integer(pObject, "evictions", evictions);
+    set_integer(pObject, "compactions", compactions);
+}
@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../../cache_storage_api.hh"
+#include "mmapdatafile.hh"
+#include "mmapindex.hh"
+
+/**
+ * A storage that keeps the values in a memory mapped append-only data file
+ * and their locations in a memory mapped hash index, so that the content
+ * survives restarts. Space of deleted values is reclaimed by a background
+ * thread that compacts the data file.
+ *
+ * As the compaction runs concurrently with the users of the storage, the
+ * storage is always thread safe, irrespective of the thread model.
+ */
+class MMapStorage
+{
+public:
+    struct Options
+    {
+        Options();
+
+        std::string directory;              /*< Where the files are placed. */
+        size_t      extent_size;            /*< The size with which the data file grows. */
+        uint32_t    compaction_threshold;   /*< Percentage of unused data triggering compaction. */
+        bool        zero_copy;              /*< Whether values are returned without copying. */
+    };
+
+    ~MMapStorage();
+
+    static bool Initialize(uint32_t* pCapabilities);
+
+    static MMapStorage* Create_instance(const char* zName,
+                                        const CACHE_STORAGE_CONFIG& config,
+                                        int argc,
+                                        char* argv[]);
+
+    void           get_config(CACHE_STORAGE_CONFIG* pConfig);
+    cache_result_t get_info(uint32_t what, json_t** ppInfo) const;
+    cache_result_t get_value(const CACHE_KEY& key,
+                             uint32_t flags,
+                             uint32_t soft_ttl,
+                             uint32_t hard_ttl,
+                             GWBUF**  ppResult);
+    cache_result_t put_value(const CACHE_KEY& key,
+                             const std::vector<std::string>& tables,
+                             const GWBUF& value);
+    cache_result_t del_value(const CACHE_KEY& key);
+    cache_result_t invalidate(const std::vector<std::string>& tables);
+
+    cache_result_t get_head(CACHE_KEY* pKey, GWBUF** ppHead) const;
+    cache_result_t get_tail(CACHE_KEY* pKey, GWBUF** ppHead) const;
+    cache_result_t get_size(uint64_t* pSize) const;
+    cache_result_t get_items(uint64_t* pItems) const;
+
+private:
+    MMapStorage(const std::string& name,
+                const CACHE_STORAGE_CONFIG& config,
+                const Options& options,
+                std::unique_ptr<MMapDataFile> sData,
+                std::unique_ptr<MMapIndex> sIndex);
+
+    MMapStorage(const MMapStorage&);
+    MMapStorage& operator=(const MMapStorage&);
+
+    struct Stats
+    {
+        Stats()
+            : size(0)
+            , items(0)
+            , hits(0)
+            , misses(0)
+            , updates(0)
+            , deletes(0)
+            , invalidations(0)
+            , evictions(0)
+            , compactions(0)
+        {
+        }
+
+        void fill(json_t* pObject) const;
+
+        uint64_t size;          /*< The total size of the stored values. */
+        uint64_t items;         /*< The number of stored items. */
+        uint64_t hits;          /*< How many times a key was found in the cache. */
+        uint64_t misses;        /*< How many times a key was not found in the cache. */
+        uint64_t updates;       /*< How many times an existing key in the cache was updated. */
+        uint64_t deletes;       /*< How many times an existing key in the cache was deleted. */
+        uint64_t invalidations; /*< How many items have been deleted due to an invalidation. */
+        uint64_t evictions;     /*< How many items have been evicted due to the limits. */
+        uint64_t compactions;   /*< How many times the data file has been compacted. */
+    };
+
+    typedef std::unordered_map<std::string, std::unordered_set<CACHE_KEY>> KeysByTable;
+    typedef std::unique_lock<std::mutex>                                   Guard;
+
+    void load();
+    void erase(const CACHE_KEY& key, uint64_t offset);
+    void evict();
+    uint64_t find_live_record(bool newest) const;
+    cache_result_t get_record(uint64_t offset, CACHE_KEY* pKey, GWBUF** ppValue) const;
+    void check_compaction();
+    void run_compactor();
+    bool compact(Guard& guard);
+
+    std::string                   m_name;
+    const CACHE_STORAGE_CONFIG    m_config;
+    const Options                 m_options;
+    std::string                   m_data_path;
+    std::string                   m_index_path;
+    mutable std::mutex            m_lock;
+    std::unique_ptr<MMapDataFile> m_sData;
+    std::unique_ptr<MMapIndex>    m_sIndex;
+    uint64_t                      m_live;           /*< Bytes used by live records. */
+    uint64_t                      m_evict_offset;   /*< Where the oldest record may be. */
+    KeysByTable                   m_keys_by_table;
+    mutable Stats                 m_stats;
+    std::condition_variable       m_cond;
+    bool                          m_compact;
+    bool                          m_stop;
+    std::thread                   m_compactor;
+};
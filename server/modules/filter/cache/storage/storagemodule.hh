@@ -13,6 +13,8 @@
 #pragma once
 
 #include <maxscale/ccdefs.hh>
+#include <string>
+#include <vector>
 
 template<class StorageType>
 class StorageModule
@@ -91,17 +93,23 @@ public:
 
     static cache_result_t putValue(CACHE_STORAGE* pCache_storage,
                                    const CACHE_KEY* pKey,
+                                   const char* const* pzTables,
+                                   size_t nTables,
                                    const GWBUF* pValue)
     {
         mxb_assert(pCache_storage);
         mxb_assert(pKey);
+        mxb_assert(pzTables || (nTables == 0));
         mxb_assert(pValue);
 
         cache_result_t result = CACHE_RESULT_ERROR;
 
         StorageType* pStorage = reinterpret_cast<StorageType*>(pCache_storage);
 
-        MXS_EXCEPTION_GUARD(result = pStorage->put_value(*pKey, *pValue));
+        MXS_EXCEPTION_GUARD(result = pStorage->put_value(*pKey,
+                                                         std::vector<std::string>(pzTables,
+                                                                                  pzTables + nTables),
+                                                         *pValue));
 
         return result;
     }
@@ -120,6 +128,23 @@ public:
         return result;
     }
 
+    static cache_result_t invalidate(CACHE_STORAGE* pCache_storage,
+                                     const char* const* pzTables,
+                                     size_t nTables)
+    {
+        mxb_assert(pCache_storage);
+        mxb_assert(pzTables || (nTables == 0));
+
+        cache_result_t result = CACHE_RESULT_ERROR;
+
+        StorageType* pStorage = reinterpret_cast<StorageType*>(pCache_storage);
+
+        MXS_EXCEPTION_GUARD(result = pStorage->invalidate(std::vector<std::string>(pzTables,
+                                                                                   pzTables + nTables)));
+
+        return result;
+    }
+
     static cache_result_t getHead(CACHE_STORAGE* pCache_storage,
                                   CACHE_KEY* pKey,
                                   GWBUF** ppHead)
@@ -190,6 +215,7 @@ CACHE_STORAGE_API StorageModule<StorageType>::s_api =
     &StorageModule<StorageType>::getValue,
     &StorageModule<StorageType>::putValue,
     &StorageModule<StorageType>::delValue,
+    &StorageModule<StorageType>::invalidate,
     &StorageModule<StorageType>::getHead,
     &StorageModule<StorageType>::getTail,
     &StorageModule<StorageType>::getSize,
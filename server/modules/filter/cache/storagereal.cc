@@ -14,6 +14,22 @@
 #define MXS_MODULE_NAME "cache"
 #include "storagereal.hh"
 
+namespace
+{
+
+std::vector<const char*> to_c_strings(const std::vector<std::string>& strings)
+{
+    std::vector<const char*> zStrings;
+    zStrings.reserve(strings.size());
+
+    for (const auto& s : strings)
+    {
+        zStrings.push_back(s.c_str());
+    }
+
+    return zStrings;
+}
+}
 
 StorageReal::StorageReal(CACHE_STORAGE_API* pApi, CACHE_STORAGE* pStorage)
     : m_pApi(pApi)
@@ -47,9 +63,13 @@ cache_result_t StorageReal::get_value(const CACHE_KEY& key,
     return m_pApi->getValue(m_pStorage, &key, flags, soft_ttl, hard_ttl, ppValue);
 }
 
-cache_result_t StorageReal::put_value(const CACHE_KEY& key, const GWBUF* pValue)
+cache_result_t StorageReal::put_value(const CACHE_KEY& key,
+                                      const std::vector<std::string>& tables,
+                                      const GWBUF* pValue)
 {
-    return m_pApi->putValue(m_pStorage, &key, pValue);
+    std::vector<const char*> zTables = to_c_strings(tables);
+
+    return m_pApi->putValue(m_pStorage, &key, zTables.data(), zTables.size(), pValue);
 }
 
 cache_result_t StorageReal::del_value(const CACHE_KEY& key)
@@ -57,6 +77,13 @@ cache_result_t StorageReal::del_value(const CACHE_KEY& key)
     return m_pApi->delValue(m_pStorage, &key);
 }
 
+cache_result_t StorageReal::invalidate(const std::vector<std::string>& tables)
+{
+    std::vector<const char*> zTables = to_c_strings(tables);
+
+    return m_pApi->invalidate(m_pStorage, zTables.data(), zTables.size());
+}
+
 cache_result_t StorageReal::get_head(CACHE_KEY* pKey, GWBUF** ppHead) const
 {
     return m_pApi->getHead(m_pStorage, pKey, ppHead);
@@ -41,8 +41,10 @@ int TesterLRUStorage::execute(size_t n_threads, size_t n_seconds, const CacheIte
     int rv4 = test_max_size(n_threads, n_seconds, cache_items, size);
     out() << endl;
     int rv5 = test_max_count_and_size(n_threads, n_seconds, cache_items, size);
+    out() << endl;
+    int rv6 = combine_rvs(test_invalidate(cache_items), test_invalidate_evicted(cache_items));
 
-    return combine_rvs(rv1, rv2, rv3, rv4, rv5);
+    return combine_rvs(rv1, rv2, rv3, rv4, combine_rvs(rv5, rv6));
 }
 
 Storage* TesterLRUStorage::get_storage(const CACHE_STORAGE_CONFIG& config) const
@@ -275,3 +277,77 @@ int TesterLRUStorage::test_max_count_and_size(size_t n_threads,
 
     return rv;
 }
+
+int TesterLRUStorage::test_invalidate_evicted(const CacheItems& cache_items)
+{
+    int rv = EXIT_FAILURE;
+    out() << "Invalidate evicted\n" << endl;
+
+    mxb_assert(cache_items.size() >= 3);
+
+    CacheStorageConfig config(CACHE_THREAD_MODEL_MT);
+    config.max_count = 2;
+
+    Storage* pStorage = get_storage(config);
+
+    if (pStorage)
+    {
+        rv = EXIT_SUCCESS;
+
+        std::vector<std::string> tables {"db.t1"};
+
+        // The first item is evicted when the third is put, which must also remove
+        // it from the mapping from tables to keys.
+        for (size_t i = 0; i < 3; ++i)
+        {
+            const CacheItems::value_type& cache_item = cache_items[i];
+
+            if (!CACHE_RESULT_IS_OK(pStorage->put_value(cache_item.first, tables, cache_item.second)))
+            {
+                out() << "Could not put item." << endl;
+                rv = EXIT_FAILURE;
+            }
+        }
+
+        uint64_t items = 0;
+        pStorage->get_items(&items);
+
+        if (items != 2)
+        {
+            out() << "Expected 2 items after eviction, found " << items << "." << endl;
+            rv = EXIT_FAILURE;
+        }
+
+        if (!CACHE_RESULT_IS_OK(pStorage->invalidate(tables)))
+        {
+            out() << "Could not invalidate." << endl;
+            rv = EXIT_FAILURE;
+        }
+
+        items = 0;
+        pStorage->get_items(&items);
+
+        if (items != 0)
+        {
+            out() << "Expected no items after invalidation, found " << items << "." << endl;
+            rv = EXIT_FAILURE;
+        }
+
+        for (size_t i = 0; i < 3; ++i)
+        {
+            GWBUF* pValue = NULL;
+            cache_result_t result = pStorage->get_value(cache_items[i].first, 0, &pValue);
+            gwbuf_free(pValue);
+
+            if (!CACHE_RESULT_IS_NOT_FOUND(result))
+            {
+                out() << "An invalidated item was found." << endl;
+                rv = EXIT_FAILURE;
+            }
+        }
+
+        delete pStorage;
+    }
+
+    return rv;
+}
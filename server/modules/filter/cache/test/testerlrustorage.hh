@@ -52,6 +52,7 @@ private:
                                 size_t n_seconds,
                                 const CacheItems& cache_items,
                                 uint64_t size);
+    int test_invalidate_evicted(const CacheItems& cache_items);
 
 private:
     TesterLRUStorage(const TesterLRUStorage&);
@@ -24,6 +24,7 @@ TesterRawStorage::TesterRawStorage(std::ostream* pOut, StorageFactory* pFactory)
 int TesterRawStorage::execute(size_t n_threads, size_t n_seconds, const CacheItems& cache_items)
 {
     int rv1 = test_smoke(cache_items);
+    int rv3 = test_invalidate(cache_items);
 
     int rv2 = EXIT_FAILURE;
     CacheStorageConfig config(CACHE_THREAD_MODEL_MT);
@@ -36,7 +37,7 @@ int TesterRawStorage::execute(size_t n_threads, size_t n_seconds, const CacheIte
         delete pStorage;
     }
 
-    return combine_rvs(rv1, rv2);
+    return combine_rvs(rv1, rv2, rv3);
 }
 
 Storage* TesterRawStorage::get_storage(const CACHE_STORAGE_CONFIG& config) const
@@ -419,3 +419,135 @@ int TesterStorage::test_ttl(const CacheItems& cache_items, Storage& storage)
 
     return rv;
 }
+
+int TesterStorage::test_invalidate(const CacheItems& cache_items)
+{
+    CacheStorageConfig config;
+
+    out() << "ST" << endl;
+
+    config.thread_model = CACHE_THREAD_MODEL_ST;
+
+    Storage* pStorage;
+
+    int rv1 = EXIT_FAILURE;
+    pStorage = get_storage(config);
+
+    if (pStorage)
+    {
+        rv1 = test_invalidate(cache_items, *pStorage);
+        delete pStorage;
+    }
+
+    out() << "MT" << endl;
+
+    config.thread_model = CACHE_THREAD_MODEL_MT;
+
+    int rv2 = EXIT_FAILURE;
+    pStorage = get_storage(config);
+
+    if (pStorage)
+    {
+        rv2 = test_invalidate(cache_items, *pStorage);
+        delete pStorage;
+    }
+
+    return combine_rvs(rv1, rv2);
+}
+
+namespace
+{
+
+bool is_found(Storage& storage, const CACHE_KEY& key)
+{
+    GWBUF* pValue = NULL;
+    cache_result_t result = storage.get_value(key, 0, &pValue);
+    gwbuf_free(pValue);
+
+    return CACHE_RESULT_IS_OK(result);
+}
+}
+
+int TesterStorage::test_invalidate(const CacheItems& cache_items, Storage& storage)
+{
+    int rv = EXIT_SUCCESS;
+
+    out() << "Testing invalidation." << endl;
+
+    mxb_assert(cache_items.size() >= 3);
+
+    const CacheItems::value_type& a = cache_items[0];
+    const CacheItems::value_type& b = cache_items[1];
+    const CacheItems::value_type& c = cache_items[2];
+
+    vector<string> t1 {"db.t1"};
+    vector<string> t2 {"db.t2"};
+    vector<string> t3 {"db.t3"};
+    vector<string> t1_t2 {"db.t1", "db.t2"};
+
+    if (!CACHE_RESULT_IS_OK(storage.put_value(a.first, t1, a.second))
+        || !CACHE_RESULT_IS_OK(storage.put_value(b.first, t1_t2, b.second))
+        || !CACHE_RESULT_IS_OK(storage.put_value(c.first, t3, c.second)))
+    {
+        out() << "Could not put items." << endl;
+        return EXIT_FAILURE;
+    }
+
+    // Invalidating a table removes every value depending upon it, but nothing else.
+    if (!CACHE_RESULT_IS_OK(storage.invalidate(t1)))
+    {
+        out() << "Could not invalidate." << endl;
+        rv = EXIT_FAILURE;
+    }
+    else if (is_found(storage, a.first) || is_found(storage, b.first))
+    {
+        out() << "Values depending upon an invalidated table were found." << endl;
+        rv = EXIT_FAILURE;
+    }
+    else if (!is_found(storage, c.first))
+    {
+        out() << "A value not depending upon an invalidated table was not found." << endl;
+        rv = EXIT_FAILURE;
+    }
+
+    // When a value is replaced, it no longer depends upon the tables of the old value.
+    storage.put_value(a.first, t1, a.second);
+    storage.put_value(a.first, t2, a.second);
+
+    storage.invalidate(t1);
+
+    if (!is_found(storage, a.first))
+    {
+        out() << "A replaced value was invalidated using the tables of the old value." << endl;
+        rv = EXIT_FAILURE;
+    }
+
+    storage.invalidate(t2);
+
+    if (is_found(storage, a.first))
+    {
+        out() << "A replaced value was not invalidated using the tables of the new value." << endl;
+        rv = EXIT_FAILURE;
+    }
+
+    // A deleted value must not linger in the table index.
+    storage.del_value(c.first);
+    storage.put_value(b.first, t1, b.second);
+    storage.invalidate(t3);
+
+    if (!is_found(storage, b.first))
+    {
+        out() << "Invalidating the table of a deleted value removed an unrelated value." << endl;
+        rv = EXIT_FAILURE;
+    }
+
+    storage.invalidate(t1);
+
+    if (is_found(storage, b.first))
+    {
+        out() << "A value was not invalidated." << endl;
+        rv = EXIT_FAILURE;
+    }
+
+    return rv;
+}
@@ -169,6 +169,9 @@ public:
     int test_ttl(const CacheItems& cache_items);
     int test_ttl(const CacheItems& cache_items, Storage& storage);
 
+    int test_invalidate(const CacheItems& cache_items);
+    int test_invalidate(const CacheItems& cache_items, Storage& storage);
+
 protected:
     /**
      * Constructor
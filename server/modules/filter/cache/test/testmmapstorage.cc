@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include <maxscale/ccdefs.hh>
+#include <stdlib.h>
+#include <unistd.h>
+#include <iostream>
+#include <memory>
+#include <maxscale/alloc.h>
+#include <maxscale/buffer.h>
+#include <maxscale/log.h>
+#include <maxscale/paths.h>
+#include "storage.hh"
+#include "storagefactory.hh"
+#include "cache_storage_api.hh"
+
+using namespace std;
+
+namespace
+{
+
+const size_t N_ITEMS = 100;
+
+CACHE_KEY get_key(size_t i)
+{
+    CacheKey key;
+    key.data = i + 1;
+    return key;
+}
+
+GWBUF* get_value(size_t i)
+{
+    size_t size = (i + 1) * 10;
+    GWBUF* pValue = gwbuf_alloc(size);
+    mxb_assert(pValue);
+
+    uint8_t* pData = GWBUF_DATA(pValue);
+
+    for (size_t j = 0; j < size; ++j)
+    {
+        pData[j] = i + j;
+    }
+
+    return pValue;
+}
+
+vector<string> get_tables(size_t i)
+{
+    return {i % 2 == 0 ? "db.even" : "db.odd"};
+}
+
+/**
+ * Check whether a value is found in the storage and is intact.
+ *
+ * @return 1 if the value is found and intact, 0 if it is not found and -1 if it differs.
+ */
+int check_value(Storage& storage, size_t i)
+{
+    GWBUF* pValue = NULL;
+    cache_result_t result = storage.get_value(get_key(i), 0, &pValue);
+
+    int rv = 0;
+
+    if (CACHE_RESULT_IS_OK(result))
+    {
+        GWBUF* pExpected = get_value(i);
+        rv = (gwbuf_compare(pValue, pExpected) == 0) ? 1 : -1;
+        gwbuf_free(pExpected);
+    }
+
+    gwbuf_free(pValue);
+
+    return rv;
+}
+
+class TestMMapStorage
+{
+public:
+    TestMMapStorage(StorageFactory& factory, const string& directory)
+        : m_factory(factory)
+        , m_option("cache_directory=" + directory)
+    {
+    }
+
+    int run()
+    {
+        int rv1 = test_put_get_invalidate();
+        int rv2 = test_reopen();
+
+        return (rv1 == EXIT_SUCCESS && rv2 == EXIT_SUCCESS) ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+
+private:
+    unique_ptr<Storage> open()
+    {
+        CacheStorageConfig config(CACHE_THREAD_MODEL_MT);
+        char* argv[] = {&m_option[0]};
+
+        return unique_ptr<Storage>(m_factory.createRawStorage("test", config, 1, argv));
+    }
+
+    int test_put_get_invalidate()
+    {
+        int rv = EXIT_FAILURE;
+        cout << "Put, get and invalidate." << endl;
+
+        unique_ptr<Storage> sStorage = open();
+
+        if (sStorage)
+        {
+            rv = EXIT_SUCCESS;
+
+            for (size_t i = 0; i < N_ITEMS; ++i)
+            {
+                GWBUF* pValue = get_value(i);
+
+                if (!CACHE_RESULT_IS_OK(sStorage->put_value(get_key(i), get_tables(i), pValue)))
+                {
+                    cout << "Could not put item " << i << "." << endl;
+                    rv = EXIT_FAILURE;
+                }
+
+                gwbuf_free(pValue);
+            }
+
+            for (size_t i = 0; i < N_ITEMS; ++i)
+            {
+                if (check_value(*sStorage, i) != 1)
+                {
+                    cout << "Item " << i << " was not found or differs." << endl;
+                    rv = EXIT_FAILURE;
+                }
+            }
+
+            // Downstream filters may modify a returned value in place, which must not
+            // affect what is in the storage.
+            GWBUF* pValue = NULL;
+            sStorage->get_value(get_key(0), 0, &pValue);
+
+            if (pValue)
+            {
+                GWBUF_DATA(pValue)[0] ^= 0xff;
+                gwbuf_free(pValue);
+            }
+
+            if (check_value(*sStorage, 0) != 1)
+            {
+                cout << "Modifying a returned value modified the stored value." << endl;
+                rv = EXIT_FAILURE;
+            }
+
+            sStorage->invalidate({"db.odd"});
+
+            for (size_t i = 0; i < N_ITEMS; ++i)
+            {
+                if (check_value(*sStorage, i) != (i % 2 == 0 ? 1 : 0))
+                {
+                    cout << "Item " << i << " was not correctly invalidated." << endl;
+                    rv = EXIT_FAILURE;
+                }
+            }
+
+            // The head is the item stored last and the tail the one stored first.
+            CACHE_KEY key;
+
+            pValue = NULL;
+
+            if (!CACHE_RESULT_IS_OK(sStorage->get_head(&key, &pValue))
+                || key.data != get_key(N_ITEMS - 2).data)
+            {
+                cout << "The head was not the last item that remains." << endl;
+                rv = EXIT_FAILURE;
+            }
+
+            gwbuf_free(pValue);
+
+            pValue = NULL;
+
+            if (!CACHE_RESULT_IS_OK(sStorage->get_tail(&key, &pValue))
+                || key.data != get_key(0).data)
+            {
+                cout << "The tail was not the first item that remains." << endl;
+                rv = EXIT_FAILURE;
+            }
+
+            gwbuf_free(pValue);
+        }
+
+        return rv;
+    }
+
+    int test_reopen()
+    {
+        int rv = EXIT_FAILURE;
+        cout << "Reopen." << endl;
+
+        unique_ptr<Storage> sStorage = open();
+
+        if (sStorage)
+        {
+            rv = EXIT_SUCCESS;
+
+            uint64_t items = 0;
+            sStorage->get_items(&items);
+
+            if (items != N_ITEMS / 2)
+            {
+                cout << "Expected " << N_ITEMS / 2 << " items after reopening, found " << items << "." << endl;
+                rv = EXIT_FAILURE;
+            }
+
+            for (size_t i = 0; i < N_ITEMS; ++i)
+            {
+                if (check_value(*sStorage, i) != (i % 2 == 0 ? 1 : 0))
+                {
+                    cout << "Item " << i << " was not correctly restored." << endl;
+                    rv = EXIT_FAILURE;
+                }
+            }
+
+            // The dependencies upon the tables must have been restored as well.
+            sStorage->invalidate({"db.even"});
+
+            items = 0;
+            sStorage->get_items(&items);
+
+            if (items != 0)
+            {
+                cout << "Expected no items after invalidating a restored table, found " << items << "."
+                     << endl;
+                rv = EXIT_FAILURE;
+            }
+
+            sStorage.reset();
+            sStorage = open();
+
+            items = 0;
+
+            if (!sStorage || !CACHE_RESULT_IS_OK(sStorage->get_items(&items)) || items != 0)
+            {
+                cout << "Invalidated items reappeared after reopening." << endl;
+                rv = EXIT_FAILURE;
+            }
+        }
+
+        return rv;
+    }
+
+    StorageFactory& m_factory;
+    string          m_option;
+};
+
+void remove_files(const string& directory)
+{
+    string subdirectory = directory + "/storage_mmap";
+
+    unlink((subdirectory + "/test.data").c_str());
+    unlink((subdirectory + "/test.index").c_str());
+    rmdir(subdirectory.c_str());
+    rmdir(directory.c_str());
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = EXIT_FAILURE;
+
+    if (mxs_log_init(NULL, ".", MXS_LOG_TARGET_DEFAULT))
+    {
+        char* libdir = MXS_STRDUP_A("../storage/storage_mmap/");
+        set_libdir(libdir);
+
+        StorageFactory* pFactory = StorageFactory::Open("storage_mmap");
+
+        if (pFactory)
+        {
+            char directory[] = "/tmp/testmmapstorage-XXXXXX";
+
+            if (mkdtemp(directory))
+            {
+                TestMMapStorage test(*pFactory, directory);
+                rv = test.run();
+
+                remove_files(directory);
+            }
+            else
+            {
+                cerr << "error: Could not create a temporary directory." << endl;
+            }
+
+            delete pFactory;
+        }
+        else
+        {
+            cerr << "error: Could not initialize factory storage_mmap." << endl;
+        }
+
+        mxs_log_finish();
+    }
+    else
+    {
+        cerr << "error: Could not initialize log." << endl;
+    }
+
+    return rv;
+}
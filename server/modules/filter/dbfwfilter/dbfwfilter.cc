@@ -70,6 +70,7 @@
 #include <map>
 
 #include <maxbase/atomic.h>
+#include <maxbase/stopwatch.hh>
 #include <maxscale/modulecmd.h>
 #include <maxscale/modutil.h>
 #include <maxscale/log.h>
@@ -98,6 +99,16 @@ namespace
 class DbfwThread
 {
 public:
+    DbfwThread()
+        : m_query_id(0)
+    {
+    }
+
+    uint64_t next_query_id()
+    {
+        return ++m_query_id;
+    }
+
     int& rule_version(const Dbfw* d)
     {
         return m_instance_data[d].rule_version;
@@ -126,6 +137,7 @@ private:
     };
 
     std::map<const Dbfw*, Data> m_instance_data;
+    uint64_t                    m_query_id; /*< Identifier of the latest query */
 };
 
 thread_local DbfwThread* this_thread = NULL;
@@ -1049,9 +1061,11 @@ bool define_regex_rule(void* scanner, char* pattern)
                             &offset,
                             NULL)))
     {
+        // Failing to JIT compile is not fatal, the pattern is then interpreted
+        pcre2_jit_compile(re, PCRE2_JIT_COMPLETE);
         struct parser_stack* rstack = (struct parser_stack*)dbfw_yyget_extra((yyscan_t) scanner);
         mxb_assert(rstack);
-        rstack->add(new RegexRule(rstack->name, re));
+        rstack->add(new RegexRule(rstack->name, re, (const char*)start));
     }
     else
     {
@@ -1122,6 +1136,42 @@ static bool process_user_templates(UserMap& users,
     return rval;
 }
 
+/**
+ * Combine the patterns of the regex rules so that a query that matches none of
+ * them is rejected with one pass of the combined pattern.
+ *
+ * @param rules The rules of a rule file
+ */
+static void combine_regex_rules(const RuleList& rules)
+{
+    std::vector<RegexRule*> combined;
+    std::vector<std::string> patterns;
+
+    for (const auto& rule : rules)
+    {
+        RegexRule* regex = dynamic_cast<RegexRule*>(rule.get());
+
+        if (regex && regex->can_combine())
+        {
+            combined.push_back(regex);
+            patterns.push_back(regex->pattern());
+        }
+    }
+
+    if (combined.size() > 1)
+    {
+        SRegexSet set = RegexSet::create(patterns);
+
+        if (set)
+        {
+            for (auto regex : combined)
+            {
+                regex->set_regex_set(set);
+            }
+        }
+    }
+}
+
 /**
  * Read a rule file from disk and process it into rule and user definitions
  * @param filename Name of the file
@@ -1153,6 +1203,7 @@ static bool do_process_rule_file(const char* filename, RuleList* rules, UserMap*
 
         if (rc == 0 && process_user_templates(new_users, pstack.templates, pstack.rule))
         {
+            combine_regex_rules(pstack.rule);
             rules->swap(pstack.rule);
             users->swap(new_users);
         }
@@ -1256,6 +1307,8 @@ Dbfw::Dbfw(MXS_CONFIG_PARAMETER* params)
     , m_treat_string_arg_as_field(config_get_bool(params, "treat_string_arg_as_field"))
     , m_filename(config_get_string(params, "rules"))
     , m_version(atomic_add(&global_version, 1))
+    , m_n_checked(0)
+    , m_check_ns(0)
 {
     if (config_get_bool(params, "log_match"))
     {
@@ -1452,6 +1505,7 @@ DbfwSession::DbfwSession(Dbfw* instance, MXS_SESSION* session)
     : mxs::FilterSession::FilterSession(session)
     , m_instance(instance)
     , m_session(session)
+    , m_query_id(0)
 {
 }
 
@@ -1589,7 +1643,10 @@ int DbfwSession::routeQuery(GWBUF* buffer)
             else if (suser)
             {
                 char* rname = NULL;
+                m_query_id = this_thread->next_query_id();
+                mxb::StopWatch timer;
                 bool match = suser->match(m_instance, this, analyzed_queue, &rname);
+                m_instance->record_match_time(timer.split().count());
 
                 switch (m_instance->get_action())
                 {
@@ -1836,6 +1893,13 @@ bool rule_matches(Dbfw* my_instance,
     return matches;
 }
 
+/** Add the time it took to check a query against the rules to the statistics */
+void Dbfw::record_match_time(int64_t nanoseconds)
+{
+    atomic_add_uint64(&m_n_checked, 1);
+    atomic_add_uint64(&m_check_ns, nanoseconds);
+}
+
 /**
  * Diagnostics routine
  *
@@ -1848,7 +1912,13 @@ bool rule_matches(Dbfw* my_instance,
  */
 void Dbfw::diagnostics(DCB* dcb) const
 {
+    uint64_t n_checked = atomic_load_uint64(&m_n_checked);
+    uint64_t check_ns = atomic_load_uint64(&m_check_ns);
+
     dcb_printf(dcb, "Firewall Filter\n");
+    dcb_printf(dcb, "Queries checked: %lu\n", n_checked);
+    dcb_printf(dcb, "Average time per query: %.2f us\n",
+               n_checked ? check_ns / 1000.0 / n_checked : 0.0);
     dcb_printf(dcb, "Rule, Type, Times Matched\n");
 
     RuleList& rules = this_thread->rules(this);
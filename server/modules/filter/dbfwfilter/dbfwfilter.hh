@@ -181,11 +181,22 @@ public:
     QuerySpeed* query_speed();      // TODO: Remove this, it exposes internals to a Rule
     fw_actions  get_action() const;
 
+    /**
+     * Get the identifier of the query being processed
+     *
+     * @return An identifier that is unique within the current thread
+     */
+    uint64_t query_id() const
+    {
+        return m_query_id;
+    }
+
 private:
     Dbfw*        m_instance;    /*< Router instance */
     MXS_SESSION* m_session;     /*< Client session structure */
     std::string  m_error;       /*< Rule specific error message */
     QuerySpeed   m_qs;          /*< How fast the user has executed queries */
+    uint64_t     m_query_id;    /*< Identifier of the current query */
 };
 
 /**
@@ -275,6 +286,13 @@ public:
      */
     bool reload_rules(std::string filename);
 
+    /**
+     * Record the time spent in matching the rules against a query
+     *
+     * @param nanoseconds The time spent
+     */
+    void record_match_time(int64_t nanoseconds);
+
     /** Diagnostic routines */
     void    diagnostics(DCB* dcb) const;
     json_t* diagnostics_json() const;
@@ -292,6 +310,8 @@ private:
     mutable std::mutex m_lock;      /*< Instance spinlock */
     std::string        m_filename;  /*< Path to the rule file */
     int                m_version;   /*< Latest rule file version, incremented on reload */
+    uint64_t           m_n_checked; /*< Number of queries matched against the rules */
+    uint64_t           m_check_ns;  /*< Total time spent in matching the rules */
 
     Dbfw(MXS_CONFIG_PARAMETER* param);
     bool do_reload_rules(std::string filename);
@@ -124,21 +124,104 @@ bool NoWhereClauseRule::matches_query(DbfwSession* session, GWBUF* buffer, char*
     return rval;
 }
 
-bool RegexRule::matches_query(DbfwSession* session, GWBUF* buffer, char** msg) const
+// static
+SRegexSet RegexSet::create(const std::vector<std::string>& patterns)
 {
-    bool rval = false;
+    std::string combined;
 
-    if (query_is_sql(buffer))
+    for (const auto& pattern : patterns)
+    {
+        if (!combined.empty())
+        {
+            combined += '|';
+        }
+
+        combined += "(?:" + pattern + ")";
+    }
+
+    SRegexSet rval;
+    int err;
+    size_t offset;
+    pcre2_code* re = pcre2_compile((PCRE2_SPTR)combined.c_str(), PCRE2_ZERO_TERMINATED,
+                                   0, &err, &offset, NULL);
+
+    if (re)
     {
-        pcre2_code* re = m_re.get();
+        pcre2_jit_compile(re, PCRE2_JIT_COMPLETE);
         pcre2_match_data* mdata = pcre2_match_data_create_from_pattern(re, NULL);
         MXS_ABORT_IF_NULL(mdata);
+        rval.reset(new RegexSet(re, mdata));
+    }
+    else
+    {
+        // Not an error, the rules are then matched one by one
+        MXS_INFO("Could not combine %lu regex rules into one pattern.", patterns.size());
+    }
+
+    return rval;
+}
+
+RegexSet::RegexSet(pcre2_code* re, pcre2_match_data* mdata)
+    : m_re(re)
+    , m_mdata(mdata)
+    , m_query_id(0)
+    , m_result(false)
+{
+}
+
+bool RegexSet::matches(uint64_t query_id, const char* sql, size_t len) const
+{
+    if (query_id != m_query_id)
+    {
+        m_result = pcre2_match(m_re.get(), (PCRE2_SPTR)sql, len, 0, 0, m_mdata.get(), NULL) > 0;
+        m_query_id = query_id;
+    }
+
+    return m_result;
+}
+
+RegexRule::RegexRule(std::string name, pcre2_code* re, std::string pattern)
+    : Rule(name, "REGEX")
+    , m_re(re)
+    , m_mdata(pcre2_match_data_create_from_pattern(re, NULL))
+    , m_pattern(pattern)
+{
+    MXS_ABORT_IF_NULL(m_mdata.get());
+}
 
+bool RegexRule::can_combine() const
+{
+    uint32_t captures = 0;
+    pcre2_pattern_info(m_re.get(), PCRE2_INFO_CAPTURECOUNT, &captures);
+
+    // Without capture groups, the only constructs whose meaning depends on the
+    // rest of the pattern are the recursions into the whole pattern. Comments and
+    // quoted sequences could swallow the parenthesis that closes the group.
+    const char* unsafe[] = {"(?R", "(?0", "\\g", "(*", "\\Q", "#"};
+
+    for (const char* str : unsafe)
+    {
+        if (m_pattern.find(str) != std::string::npos)
+        {
+            return false;
+        }
+    }
+
+    return captures == 0;
+}
+
+bool RegexRule::matches_query(DbfwSession* session, GWBUF* buffer, char** msg) const
+{
+    bool rval = false;
+
+    if (query_is_sql(buffer))
+    {
         char* sql;
         int len;
         modutil_extract_SQL(buffer, &sql, &len);
 
-        if (pcre2_match(re, (PCRE2_SPTR)sql, (size_t)len, 0, 0, mdata, NULL) > 0)
+        if ((!m_set || m_set->matches(session->query_id(), sql, len))
+            && pcre2_match(m_re.get(), (PCRE2_SPTR)sql, (size_t)len, 0, 0, m_mdata.get(), NULL) > 0)
         {
             MXS_NOTICE("rule '%s': regex matched on query", name().c_str());
             if (session->get_action() == FW_ACTION_BLOCK)
@@ -147,8 +230,6 @@ bool RegexRule::matches_query(DbfwSession* session, GWBUF* buffer, char** msg) c
             }
             rval = true;
         }
-
-        pcre2_match_data_free(mdata);
     }
 
     return rval;
@@ -264,8 +264,56 @@ private:
     int m_holdoff;
 };
 
+/**
+ * The patterns of several regex rules combined into one alternation
+ *
+ * A single pass of the combined pattern tells whether any of the rules can
+ * match a query. If it does not match, the rules need not be matched one by one.
+ * The result is remembered for the query being processed, so that only the first
+ * rule of the set pays for it.
+ */
+class RegexSet
+{
+    RegexSet(const RegexSet&);
+    RegexSet& operator=(const RegexSet&);
+
+public:
+    /**
+     * Create a combined pattern
+     *
+     * @param patterns The patterns to combine
+     *
+     * @return The set or NULL if the patterns could not be combined
+     */
+    static std::shared_ptr<RegexSet> create(const std::vector<std::string>& patterns);
+
+    /**
+     * Check whether any of the patterns matches
+     *
+     * @param query_id The identifier of the query, see DbfwSession::query_id()
+     * @param sql      The SQL of the query
+     * @param len      Length of the SQL
+     *
+     * @return True, if at least one of the patterns matches
+     */
+    bool matches(uint64_t query_id, const char* sql, size_t len) const;
+
+private:
+    RegexSet(pcre2_code* re, pcre2_match_data* mdata);
+
+    mxs::Closer<pcre2_code*>       m_re;
+    mxs::Closer<pcre2_match_data*> m_mdata;
+    mutable uint64_t               m_query_id;  /*< The query the result is for */
+    mutable bool                   m_result;
+};
+
+typedef std::shared_ptr<RegexSet> SRegexSet;
+
 /**
  * Matches if a queries matches a pattern
+ *
+ * The rules are created separately for each thread, so the match data is
+ * allocated only once and reused for all queries.
  */
 class RegexRule : public Rule
 {
@@ -273,11 +321,7 @@ class RegexRule : public Rule
     RegexRule& operator=(const RegexRule&);
 
 public:
-    RegexRule(std::string name, pcre2_code* re)
-        : Rule(name, "REGEX")
-        , m_re(re)
-    {
-    }
+    RegexRule(std::string name, pcre2_code* re, std::string pattern);
 
     ~RegexRule()
     {
@@ -290,8 +334,30 @@ public:
 
     bool matches_query(DbfwSession* session, GWBUF* buffer, char** msg) const;
 
+    /**
+     * Check whether the pattern can be a part of a RegexSet. Patterns that
+     * refer to capture groups or to the whole pattern, or that could affect
+     * the parsing of the patterns that follow them, are matched only on their own.
+     *
+     * @return True, if the pattern can be combined with others
+     */
+    bool can_combine() const;
+
+    const std::string& pattern() const
+    {
+        return m_pattern;
+    }
+
+    void set_regex_set(SRegexSet set)
+    {
+        m_set = set;
+    }
+
 private:
-    mxs::Closer<pcre2_code*> m_re;
+    mxs::Closer<pcre2_code*>       m_re;
+    mxs::Closer<pcre2_match_data*> m_mdata;
+    std::string                    m_pattern;
+    SRegexSet                      m_set;   /*< Set this rule belongs to, may be NULL */
 };
 
 typedef std::shared_ptr<Rule> SRule;
@@ -457,6 +457,56 @@ FW_TEST FIREWALL_TESTS[] =
             }
         }
     },
+    {
+        "rule regex1 match regex '(?i)drop'\n"
+        "rule regex2 match regex '^delete'\n"
+        "rule regex3 match regex '(a)\\1'\n"
+        "rule regex4 match regex 'x{2,}'\n"
+        "users bob@% match any rules regex1 regex2 regex3 regex4\n",
+        FW_ACTION_BLOCK,
+        {
+            {
+                "SELECT a FROM t",
+                FW_ACTION_ALLOW
+            },
+            {
+                "DROP TABLE t",
+                FW_ACTION_BLOCK
+            },
+            {
+                "delete FROM t",
+                FW_ACTION_BLOCK
+            },
+            {
+                "DELETE FROM t",
+                FW_ACTION_ALLOW
+            },
+            {
+                "SELECT aa FROM t",
+                FW_ACTION_BLOCK
+            },
+            {
+                "SELECT a FROM xx",
+                FW_ACTION_BLOCK
+            }
+        }
+    },
+    {
+        "rule regex1 match regex 'select'\n"
+        "rule regex2 match regex 'from t'\n"
+        "users bob@% match all rules regex1 regex2\n",
+        FW_ACTION_BLOCK,
+        {
+            {
+                "select a from t",
+                FW_ACTION_BLOCK
+            },
+            {
+                "select a from u",
+                FW_ACTION_ALLOW
+            }
+        }
+    },
     //
     // no_where_clause
     //
@@ -407,7 +407,7 @@ void MaskingFilterSession::handle_field(GWBUF* pPacket)
             zHost = "";
         }
 
-        const MaskingRules::Rule* pRule = m_res.rules()->get_rule_for(column_def, zUser, zHost);
+        const MaskingRules::Rule* pRule = user_rules(m_res.rules(), zUser, zHost).get_rule_for(column_def);
 
         if (m_res.append_type_and_rule(column_def.type(), pRule))
         {
@@ -573,19 +573,36 @@ void MaskingFilterSession::mask_values(ComPacket& response)
     }
 }
 
+const MaskingRules::UserRules& MaskingFilterSession::user_rules(const SMaskingRules& sRules,
+                                                              const char* zUser,
+                                                              const char* zHost)
+{
+    // The user can change with COM_CHANGE_USER and the rules can be reloaded,
+    // so both are checked. Otherwise the rules are resolved once per session.
+    if (sRules != m_sUser_rules_source || m_user != zUser || m_host != zHost)
+    {
+        m_user_rules = sRules->get_rules_for(zUser, zHost);
+        m_sUser_rules_source = sRules;
+        m_user = zUser;
+        m_host = zHost;
+    }
+
+    return m_user_rules;
+}
+
 bool MaskingFilterSession::is_function_used(GWBUF* pPacket, const char* zUser, const char* zHost)
 {
     bool is_used = false;
 
-    SMaskingRules sRules = m_filter.rules();
+    const MaskingRules::UserRules& rules = user_rules(m_filter.rules(), zUser, zHost);
 
-    auto pred1 = [&sRules, zUser, zHost](const QC_FIELD_INFO& field_info) {
-        const MaskingRules::Rule* pRule = sRules->get_rule_for(field_info, zUser, zHost);
+    auto pred1 = [&rules](const QC_FIELD_INFO& field_info) {
+        const MaskingRules::Rule* pRule = rules.get_rule_for(field_info);
 
         return pRule ? true : false;
     };
 
-    auto pred2 = [&sRules, zUser, zHost, &pred1](const QC_FUNCTION_INFO& function_info) {
+    auto pred2 = [&pred1](const QC_FUNCTION_INFO& function_info) {
         const QC_FIELD_INFO* begin = function_info.fields;
         const QC_FIELD_INFO* end = begin + function_info.n_fields;
 
@@ -624,19 +641,19 @@ bool MaskingFilterSession::is_variable_defined(GWBUF* pPacket, const char* zUser
 
     bool is_defined = false;
 
-    SMaskingRules sRules = m_filter.rules();
+    const MaskingRules::UserRules& rules = user_rules(m_filter.rules(), zUser, zHost);
 
-    auto pred = [&sRules, zUser, zHost](const QC_FIELD_INFO& field_info) {
+    auto pred = [&rules](const QC_FIELD_INFO& field_info) {
         bool rv = false;
 
         if (strcmp(field_info.column, "*") == 0)
         {
             // If "*" is used, then we must block if there is any rule for the current user.
-            rv = sRules->has_rule_for(zUser, zHost);
+            rv = !rules.empty();
         }
         else
         {
-            rv = sRules->get_rule_for(field_info, zUser, zHost) ? true : false;
+            rv = rules.get_rule_for(field_info) ? true : false;
         }
 
         return rv;
@@ -686,7 +703,7 @@ bool MaskingFilterSession::is_union_or_subquery_used(GWBUF* pPacket, const char*
 
     bool is_used = false;
 
-    SMaskingRules sRules = m_filter.rules();
+    const MaskingRules::UserRules& rules = user_rules(m_filter.rules(), zUser, zHost);
 
     uint32_t mask = 0;
 
@@ -700,7 +717,7 @@ bool MaskingFilterSession::is_union_or_subquery_used(GWBUF* pPacket, const char*
         mask |= QC_FIELD_SUBQUERY;
     }
 
-    auto pred = [&sRules, mask, zUser, zHost](const QC_FIELD_INFO& field_info) {
+    auto pred = [&rules, mask](const QC_FIELD_INFO& field_info) {
         bool rv = false;
 
         if (field_info.context & mask)
@@ -708,11 +725,11 @@ bool MaskingFilterSession::is_union_or_subquery_used(GWBUF* pPacket, const char*
             if (strcmp(field_info.column, "*") == 0)
             {
                 // If "*" is used, then we must block if there is any rule for the current user.
-                rv = sRules->has_rule_for(zUser, zHost);
+                rv = !rules.empty();
             }
             else
             {
-                rv = sRules->get_rule_for(field_info, zUser, zHost) ? true : false;
+                rv = rules.get_rule_for(field_info) ? true : false;
             }
         }
 
@@ -173,7 +173,15 @@ private:
         bool                                   m_some_rule_matches; /*<! At least one rule matches. */
     };
 
-    const MaskingFilter& m_filter;
-    state_t              m_state;
-    ResponseState        m_res;
+    const MaskingRules::UserRules& user_rules(const SMaskingRules& sRules,
+                                              const char* zUser,
+                                              const char* zHost);
+
+    const MaskingFilter&    m_filter;
+    state_t                 m_state;
+    ResponseState           m_res;
+    SMaskingRules           m_sUser_rules_source;   /*<! The rules m_user_rules was created from. */
+    std::string             m_user;                 /*<! The user m_user_rules was created for. */
+    std::string             m_host;                 /*<! The host m_user_rules was created for. */
+    MaskingRules::UserRules m_user_rules;           /*<! The rules that apply to the user. */
 };
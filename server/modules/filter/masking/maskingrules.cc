@@ -1050,9 +1050,7 @@ string MaskingRules::Rule::match() const
     return s;
 }
 
-bool MaskingRules::Rule::matches(const ComQueryResponse::ColumnDef& column_def,
-                                 const char* zUser,
-                                 const char* zHost) const
+bool MaskingRules::Rule::matches(const ComQueryResponse::ColumnDef& column_def) const
 {
     const LEncString& table = column_def.org_table();
     const LEncString& database = column_def.schema();
@@ -1062,25 +1060,12 @@ bool MaskingRules::Rule::matches(const ComQueryResponse::ColumnDef& column_def,
     // we consider it a match if a table or database have been provided.
     // Otherwise it would be easy to bypass a table/database rule.
 
-    bool match =
-        (m_column == column_def.org_name())
-        && (m_table.empty() || table.empty() || (m_table == table))
-        && (m_database.empty() || database.empty() || (m_database == database));
-
-    if (match)
-    {
-        // If the column matched, then we need to check whether the rule applies
-        // to the user and host.
-
-        match = matches_account(zUser, zHost);
-    }
-
-    return match;
+    return (m_column == column_def.org_name())
+           && (m_table.empty() || table.empty() || (m_table == table))
+           && (m_database.empty() || database.empty() || (m_database == database));
 }
 
-bool MaskingRules::Rule::matches(const QC_FIELD_INFO& field,
-                                 const char* zUser,
-                                 const char* zHost) const
+bool MaskingRules::Rule::matches(const QC_FIELD_INFO& field) const
 {
     const char* zColumn = field.column;
     const char* zTable = field.table;
@@ -1093,20 +1078,27 @@ bool MaskingRules::Rule::matches(const QC_FIELD_INFO& field,
     // we consider it a match if a table or database have been provided.
     // Otherwise it would be easy to bypass a table/database rule.
 
-    bool match =
-        (m_column == zColumn)
-        && (m_table.empty() || !zTable || (m_table == zTable))
-        && (m_database.empty() || !zDatabase || (m_database == zDatabase));
-
-    if (match)
-    {
-        // If the column matched, then we need to check whether the rule applies
-        // to the user and host.
+    return (m_column == zColumn)
+           && (m_table.empty() || !zTable || (m_table == zTable))
+           && (m_database.empty() || !zDatabase || (m_database == zDatabase));
+}
 
-        match = matches_account(zUser, zHost);
-    }
+bool MaskingRules::Rule::matches(const ComQueryResponse::ColumnDef& column_def,
+                                 const char* zUser,
+                                 const char* zHost) const
+{
+    // If the column matched, then we need to check whether the rule applies
+    // to the user and host.
+    return matches(column_def) && matches_account(zUser, zHost);
+}
 
-    return match;
+bool MaskingRules::Rule::matches(const QC_FIELD_INFO& field,
+                                 const char* zUser,
+                                 const char* zHost) const
+{
+    // If the column matched, then we need to check whether the rule applies
+    // to the user and host.
+    return matches(field) && matches_account(zUser, zHost);
 }
 
 namespace
@@ -1316,6 +1308,14 @@ MaskingRules::MaskingRules(json_t* pRoot, const std::vector<SRule>& rules)
     , m_rules(rules)
 {
     json_incref(m_pRoot);
+
+    // The column is the only part of a rule that must always match, so it is
+    // used as the key. The table and the database are checked when a column is
+    // looked up, as a resultset need not contain them.
+    for (const auto& sRule : m_rules)
+    {
+        m_rules_by_column[sRule->column()].push_back(sRule.get());
+    }
 }
 
 MaskingRules::~MaskingRules()
@@ -1405,74 +1405,95 @@ std::auto_ptr<MaskingRules> MaskingRules::create_from(json_t* pRoot)
 namespace
 {
 
+const string& column_of(const ComQueryResponse::ColumnDef& column_def, string* pBuffer)
+{
+    *pBuffer = column_def.org_name().to_string();
+    return *pBuffer;
+}
+
+const char* column_of(const QC_FIELD_INFO& field_info, string* pBuffer)
+{
+    return field_info.column;
+}
+
+/**
+ * Find the first rule of a column that matches a field and, optionally, a user/host.
+ */
 template<class T>
-class RuleMatcher : std::unary_function<MaskingRules::SRule, bool>
+const MaskingRules::Rule* find_rule(const std::unordered_map<string, vector<const MaskingRules::Rule*>>& rules,
+                                    const T& field,
+                                    const char* zUser,
+                                    const char* zHost)
 {
-public:
-    RuleMatcher(const T& field,
-                const char* zUser,
-                const char* zHost)
-        : m_field(field)
-        , m_zUser(zUser)
-        , m_zHost(zHost)
-    {
-    }
+    string buffer;
+    auto it = rules.find(column_of(field, &buffer));
 
-    bool operator()(const MaskingRules::SRule& sRule)
+    if (it != rules.end())
     {
-        return sRule->matches(m_field, m_zUser, m_zHost);
+        for (const MaskingRules::Rule* pRule : it->second)
+        {
+            if (zUser ? pRule->matches(field, zUser, zHost) : pRule->matches(field))
+            {
+                return pRule;
+            }
+        }
     }
 
-private:
-    const T&    m_field;
-    const char* m_zUser;
-    const char* m_zHost;
-};
+    return NULL;
+}
 }
 
 const MaskingRules::Rule* MaskingRules::get_rule_for(const ComQueryResponse::ColumnDef& column_def,
                                                      const char* zUser,
                                                      const char* zHost) const
 {
-    const Rule* pRule = NULL;
-
-    RuleMatcher<ComQueryResponse::ColumnDef> matcher(column_def, zUser, zHost);
-    vector<SRule>::const_iterator i = std::find_if(m_rules.begin(), m_rules.end(), matcher);
-
-    if (i != m_rules.end())
-    {
-        const SRule& sRule = *i;
-
-        pRule = sRule.get();
-    }
-
-    return pRule;
+    mxb_assert(zUser && zHost);
+    return find_rule(m_rules_by_column, column_def, zUser, zHost);
 }
 
 const MaskingRules::Rule* MaskingRules::get_rule_for(const QC_FIELD_INFO& field_info,
                                                      const char* zUser,
                                                      const char* zHost) const
 {
-    const Rule* pRule = NULL;
+    mxb_assert(zUser && zHost);
+    return find_rule(m_rules_by_column, field_info, zUser, zHost);
+}
 
-    RuleMatcher<QC_FIELD_INFO> matcher(field_info, zUser, zHost);
-    vector<SRule>::const_iterator i = std::find_if(m_rules.begin(), m_rules.end(), matcher);
+bool MaskingRules::has_rule_for(const char* zUser, const char* zHost) const
+{
+    auto i = std::find_if(m_rules.begin(), m_rules.end(), [zUser, zHost](const SRule& sRule) {
+            return sRule->matches_account(zUser, zHost);
+        });
 
-    if (i != m_rules.end())
-    {
-        const SRule& sRule = *i;
+    return i != m_rules.end();
+}
 
-        pRule = sRule.get();
+MaskingRules::UserRules MaskingRules::get_rules_for(const char* zUser, const char* zHost) const
+{
+    UserRules rules;
+
+    for (const auto& sRule : m_rules)
+    {
+        if (sRule->matches_account(zUser, zHost))
+        {
+            rules.m_rules[sRule->column()].push_back(sRule.get());
+        }
     }
 
-    return pRule;
+    return rules;
 }
 
-bool MaskingRules::has_rule_for(const char* zUser, const char* zHost) const
+//
+// MaskingRules::UserRules
+//
+
+const MaskingRules::Rule* MaskingRules::UserRules::get_rule_for(
+    const ComQueryResponse::ColumnDef& column_def) const
 {
-    auto i = std::find_if(m_rules.begin(), m_rules.end(), [zUser, zHost](SRule sRule) {
-            return sRule->matches_account(zUser, zHost);
-        });
+    return find_rule(m_rules, column_def, NULL, NULL);
+}
 
-    return i != m_rules.end();
+const MaskingRules::Rule* MaskingRules::UserRules::get_rule_for(const QC_FIELD_INFO& field_info) const
+{
+    return find_rule(m_rules, field_info, NULL, NULL);
 }
@@ -16,6 +16,7 @@
 
 #include <string>
 #include <memory>
+#include <unordered_map>
 #include <vector>
 
 #include <maxbase/jansson.h>
@@ -110,6 +111,25 @@ public:
             return m_exempted;
         }
 
+        /**
+         * Establish whether a rule matches a column definition, irrespective
+         * of the user/host.
+         *
+         * @param column_def  A column definition.
+         *
+         * @return True, if the rule matches.
+         */
+        bool matches(const ComQueryResponse::ColumnDef& column_def) const;
+
+        /**
+         * Establish whether a rule matches a field, irrespective of the user/host.
+         *
+         * @param field  What field.
+         *
+         * @return True, if the rule matches.
+         */
+        bool matches(const QC_FIELD_INFO& field) const;
+
         /**
          * Establish whether a rule matches a column definition and user/host.
          *
@@ -338,6 +358,56 @@ public:
         MatchRule& operator=(const MatchRule&);
     };
 
+private:
+    typedef std::unordered_map<std::string, std::vector<const Rule*>> RulesByColumn;
+
+public:
+    /**
+     * @class UserRules
+     *
+     * The rules that apply to a particular user/host, indexed by column. The
+     * accounts of the rules are matched only once, when the object is created,
+     * so finding the rule of a column does not depend upon the total number
+     * of rules.
+     *
+     * @attention The object remains valid only as long as the @c MaskingRules
+     *            object it was created from remains valid.
+     */
+    class UserRules
+    {
+    public:
+        /**
+         * Return the rule object that matches a column definition.
+         *
+         * @param column_def  A column definition.
+         *
+         * @return The first rule that matches the column definition or NULL.
+         */
+        const Rule* get_rule_for(const ComQueryResponse::ColumnDef& column_def) const;
+
+        /**
+         * Return the rule object that matches a field.
+         *
+         * @param field_info  A field.
+         *
+         * @return The first rule that matches the field or NULL.
+         */
+        const Rule* get_rule_for(const QC_FIELD_INFO& field_info) const;
+
+        /**
+         * @return True, if no rule applies to the user/host.
+         */
+        bool empty() const
+        {
+            return m_rules.empty();
+        }
+
+    private:
+        friend class MaskingRules;
+
+        RulesByColumn m_rules;
+    };
+
     ~MaskingRules();
 
     /**
@@ -414,6 +484,16 @@ public:
      */
     bool has_rule_for(const char* zUser, const char* zHost) const;
 
+    /**
+     * Resolve the rules that apply to a user/host.
+     *
+     * @param zUser  The current user.
+     * @param zHost  The current host.
+     *
+     * @return The rules that apply to the user/host.
+     */
+    UserRules get_rules_for(const char* zUser, const char* zHost) const;
+
 private:
     MaskingRules(json_t* pRoot, const std::vector<SRule>& rules);
 
@@ -424,4 +504,5 @@ private:
 private:
     json_t*            m_pRoot;
     std::vector<SRule> m_rules;
+    RulesByColumn      m_rules_by_column;   /*<! The rules by column, in the original order. */
 };
@@ -226,6 +226,54 @@ struct expected_account
 
 const size_t nExpected_accounts = (sizeof(expected_accounts) / sizeof(expected_accounts[0]));
 
+// Several rules for the same column, the first matching one should be used.
+const char valid_lookup[] =
+    "{"
+    "  \"rules\": ["
+    "    {"
+    "      \"replace\": { \"column\": \"a\", \"table\": \"t1\" },"
+    "      \"with\": { \"value\": \"1\" },"
+    "      \"applies_to\": [ \"'alice'\" ]"
+    "    },"
+    "    {"
+    "      \"replace\": { \"column\": \"a\", \"database\": \"db\" },"
+    "      \"with\": { \"value\": \"2\" }"
+    "    },"
+    "    {"
+    "      \"replace\": { \"column\": \"a\" },"
+    "      \"with\": { \"value\": \"3\" },"
+    "      \"exempted\": [ \"'admin'\" ]"
+    "    },"
+    "    {"
+    "      \"replace\": { \"column\": \"b\" },"
+    "      \"with\": { \"value\": \"4\" },"
+    "      \"applies_to\": [ \"'alice'\" ]"
+    "    }"
+    "  ]"
+    "}";
+
+struct lookup_test
+{
+    const char* zUser;
+    const char* zDatabase;
+    const char* zTable;
+    const char* zColumn;
+    int         rule;       // Index of the expected rule, -1 if none.
+} lookup_tests[] =
+{
+    {"alice", NULL,   NULL, "a", 0 },
+    {"alice", "db",   "t2", "a", 1 },
+    {"alice", "db2",  "t2", "a", 2 },
+    {"bob",   NULL,   "t1", "a", 1 },
+    {"bob",   "db2",  "t1", "a", 2 },
+    {"admin", "db2",  "t1", "a", -1},
+    {"alice", NULL,   NULL, "b", 3 },
+    {"bob",   NULL,   NULL, "b", -1},
+    {"alice", NULL,   NULL, "c", -1},
+};
+
+const size_t nLookup_tests = (sizeof(lookup_tests) / sizeof(lookup_tests[0]));
+
 class MaskingRulesTester
 {
 public:
@@ -292,6 +340,38 @@ public:
 
         return rc;
     }
+
+    static int test_rule_lookup()
+    {
+        int rc = EXIT_SUCCESS;
+
+        auto_ptr<MaskingRules> sRules = MaskingRules::parse(valid_lookup);
+        mxb_assert(sRules.get());
+
+        for (size_t i = 0; i < nLookup_tests; ++i)
+        {
+            const lookup_test& test = lookup_tests[i];
+
+            QC_FIELD_INFO field = {};
+            field.database = const_cast<char*>(test.zDatabase);
+            field.table = const_cast<char*>(test.zTable);
+            field.column = const_cast<char*>(test.zColumn);
+
+            const MaskingRules::Rule* pExpected = test.rule == -1 ? NULL : sRules->m_rules[test.rule].get();
+            const MaskingRules::Rule* pRule = sRules->get_rule_for(field, test.zUser, "host");
+            const MaskingRules::Rule* pUser_rule =
+                sRules->get_rules_for(test.zUser, "host").get_rule_for(field);
+
+            if (pRule != pExpected || pUser_rule != pExpected)
+            {
+                cout << i << ": Expected rule " << test.rule << " for " << test.zUser
+                     << ", got a different one." << endl;
+                rc = EXIT_FAILURE;
+            }
+        }
+
+        return rc;
+    }
 };
 
 int main()
@@ -305,6 +385,10 @@ int main()
         {
             rc = (MaskingRulesTester::test_account_handling() == EXIT_FAILURE) ? EXIT_FAILURE : EXIT_SUCCESS;
         }
+        if (!rc)
+        {
+            rc = (MaskingRulesTester::test_rule_lookup() == EXIT_FAILURE) ? EXIT_FAILURE : EXIT_SUCCESS;
+        }
         mxs_log_finish();
     }
 
@@ -0,0 +1,108 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+/**
+ * @file qladecode.cc - Prints binary query logs of qlafilter as CSV
+ */
+
+#include "qlarecord.hh"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <fstream>
+#include <iostream>
+
+namespace
+{
+
+bool decode(std::istream& in, const char* name, std::string* pOut)
+{
+    qla::Reader reader(in);
+
+    if (!reader.read_header())
+    {
+        fprintf(stderr, "%s: Not a binary query log file.\n", name);
+        return false;
+    }
+
+    qla::RecordView rec;
+    size_t n = 0;
+
+    while (reader.next(&rec))
+    {
+        qla::append_csv(rec, qla::LOG_DATA_ALL, pOut);
+        ++n;
+
+        if (pOut->length() >= 64 * 1024)
+        {
+            std::cout << *pOut;
+            pOut->clear();
+        }
+    }
+
+    std::cout << *pOut;
+    pOut->clear();
+
+    if (reader.error())
+    {
+        // Most likely the file is still being written to or was copied while being written.
+        fprintf(stderr, "%s: Truncated or invalid record after %lu records.\n", name, n);
+        return false;
+    }
+
+    return true;
+}
+}
+
+int main(int argc, char** argv)
+{
+    int rval = 0;
+
+    if (argc > 1 && (strcmp(argv[1], "-h") == 0 || strcmp(argv[1], "--help") == 0))
+    {
+        printf("Usage: qladecode [FILE...]\n\n"
+               "Prints the binary query logs written by qlafilter with 'log_format=binary'\n"
+               "as CSV. If no files are given, the log is read from the standard input.\n");
+        return 0;
+    }
+
+    std::ios::sync_with_stdio(false);
+    std::string out;
+    qla::append_csv_header(qla::LOG_DATA_ALL, &out);
+
+    if (argc < 2)
+    {
+        if (!decode(std::cin, "stdin", &out))
+        {
+            rval = 1;
+        }
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        std::ifstream file(argv[i], std::ios::binary);
+
+        if (!file)
+        {
+            fprintf(stderr, "Failed to open file '%s': %d, %s\n", argv[i], errno, strerror(errno));
+            rval = 1;
+        }
+        else if (!decode(file, argv[i], &out))
+        {
+            rval = 1;
+        }
+    }
+
+    return rval;
+}
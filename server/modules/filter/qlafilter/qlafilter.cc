@@ -15,7 +15,8 @@
  * @file qlafilter.cc - Quary Log All Filter
  *
  * QLA Filter - Query Log All. A simple query logging filter. All queries passing
- * through the filter are written to a text file.
+ * through the filter are written to a text file. The unified log can also be
+ * written in the background in CSV or in a binary format, see qlawriter.hh.
  *
  * The filter makes no attempt to deal with query packets that do not fit
  * in a single GWBUF.
@@ -49,7 +50,11 @@
 #include <maxscale/modulecmd.h>
 #include <maxscale/json_api.h>
 
+#include "qlarecord.hh"
+#include "qlawriter.hh"
+
 using std::string;
+using namespace qla;
 
 class QlaFilterSession;
 class QlaInstance;
@@ -64,6 +69,11 @@ class QlaInstance;
 /* Default values for logged data */
 #define LOG_DATA_DEFAULT "date,user,query"
 
+/* Formats of the unified log file */
+#define LOG_FORMAT_TEXT   0     // Default value, written synchronously by the worker threads
+#define LOG_FORMAT_CSV    1     // Written in the background
+#define LOG_FORMAT_BINARY 2     // Written in the background, read with qladecode
+
 static const char PARAM_MATCH[] = "match";
 static const char PARAM_EXCLUDE[] = "exclude";
 static const char PARAM_USER[] = "user";
@@ -76,17 +86,8 @@ static const char PARAM_FLUSH[] = "flush";
 static const char PARAM_APPEND[] = "append";
 static const char PARAM_NEWLINE[] = "newline_replacement";
 static const char PARAM_SEPARATOR[] = "separator";
-
-/* Flags for controlling extra log entry contents */
-enum log_options
-{
-    LOG_DATA_SERVICE    = (1 << 0),
-    LOG_DATA_SESSION    = (1 << 1),
-    LOG_DATA_DATE       = (1 << 2),
-    LOG_DATA_USER       = (1 << 3),
-    LOG_DATA_QUERY      = (1 << 4),
-    LOG_DATA_REPLY_TIME = (1 << 5),
-};
+static const char PARAM_LOG_FORMAT[] = "log_format";
+static const char PARAM_ROTATE_SIZE[] = "rotate_size";
 
 /* The filter entry points */
 static MXS_FILTER*         createInstance(const char* name, MXS_CONFIG_PARAMETER*);
@@ -104,11 +105,13 @@ static int      clientReply(MXS_FILTER* instance, MXS_FILTER_SESSION* session, G
 static void     diagnostic(MXS_FILTER* instance, MXS_FILTER_SESSION* fsession, DCB* dcb);
 static json_t*  diagnostic_json(const MXS_FILTER* instance, const MXS_FILTER_SESSION* fsession);
 static uint64_t getCapabilities(MXS_FILTER* instance);
+static void     destroyInstance(MXS_FILTER* instance);
 
 
 static FILE* open_log_file(QlaInstance*, uint32_t, const char*);
 static int write_log_entry(FILE*, QlaInstance*, QlaFilterSession*, uint32_t,
                            const char*, const char*, size_t, int);
+static void write_log_record(QlaInstance*, QlaFilterSession*, uint64_t, const char*, size_t, int);
 static bool cb_log(const MODULECMD_ARG* argv, json_t** output);
 
 static const MXS_ENUM_VALUE option_values[] =
@@ -137,6 +140,14 @@ static const MXS_ENUM_VALUE log_data_values[] =
     {NULL}
 };
 
+static const MXS_ENUM_VALUE log_format_values[] =
+{
+    {"text",   LOG_FORMAT_TEXT  },
+    {"csv",    LOG_FORMAT_CSV   },
+    {"binary", LOG_FORMAT_BINARY},
+    {NULL}
+};
+
 /**
  * Helper struct for holding data before it's written to file.
  */
@@ -154,6 +165,7 @@ public:
     {
         0, 0
     })
+        , timestamp_us(0)
     {
     }
 
@@ -174,12 +186,14 @@ public:
         query_clone = NULL;
         query_date[0] = '\0';
         begin_time = {0, 0};
+        timestamp_us = 0;
     }
 
     bool     has_message;                       // Does message data exist?
     GWBUF*   query_clone;                       // Clone of the query buffer.
     char     query_date[QLA_DATE_BUFFER_SIZE];  // Text representation of date.
     timespec begin_time;                        // Timer value at the moment of receiving query.
+    uint64_t timestamp_us;                      // Date of the query for the log writer.
 };
 
 /**
@@ -204,11 +218,14 @@ public:
 
     uint32_t log_mode_flags;        /* Log file mode settings */
     uint32_t log_file_data_flags;   /* What data is saved to the files */
+    uint32_t log_format;            /* Format of the unified log file */
+    uint64_t rotate_size;           /* Size at which the unified log is rotated, 0 for never */
 
     string filebase;            /* The filename base */
     string unified_filename;    /* Filename of the unified log file */
     FILE*  unified_fp;          /* Unified log file. The pointer needs to be shared here
                                  * to avoid garbled printing. */
+    std::unique_ptr<QlaLogWriter> writer;   /* Writes the unified log if it is not text */
     bool   flush_writes;        /* Flush log file after every write? */
     bool   append;              /* Open files in append-mode? */
     string query_newline;       /* Character(s) used to replace a newline within a query */
@@ -229,6 +246,8 @@ QlaInstance::QlaInstance(const char* name, MXS_CONFIG_PARAMETER* params)
     : name(name)
     , log_mode_flags(config_get_enum(params, PARAM_LOG_TYPE, log_type_values))
     , log_file_data_flags(config_get_enum(params, PARAM_LOG_DATA, log_data_values))
+    , log_format(config_get_enum(params, PARAM_LOG_FORMAT, log_format_values))
+    , rotate_size(config_get_size(params, PARAM_ROTATE_SIZE))
     , filebase(config_get_string(params, PARAM_FILEBASE))
     , unified_fp(NULL)
     , flush_writes(config_get_bool(params, PARAM_FLUSH))
@@ -360,7 +379,7 @@ MXS_MODULE* MXS_CREATE_MODULE()
         diagnostic,
         diagnostic_json,
         getCapabilities,
-        NULL,   // No destroyInstance
+        destroyInstance,
     };
 
     static MXS_MODULE info =
@@ -442,6 +461,18 @@ MXS_MODULE* MXS_CREATE_MODULE()
                 MXS_MODULE_PARAM_BOOL,
                 "false"
             },
+            {
+                PARAM_LOG_FORMAT,
+                MXS_MODULE_PARAM_ENUM,
+                "text",
+                MXS_MODULE_OPT_ENUM_UNIQUE,
+                log_format_values
+            },
+            {
+                PARAM_ROTATE_SIZE,
+                MXS_MODULE_PARAM_SIZE,
+                "0"
+            },
             {MXS_END_MODULE_PARAMS}
         }
     };
@@ -486,8 +517,34 @@ static MXS_FILTER* createInstance(const char* name, MXS_CONFIG_PARAMETER* params
             my_instance->re_match = re_match;
             my_instance->re_exclude = re_exclude;
             my_instance->ovec_size = ovec_size;
+
+            if (my_instance->log_format != LOG_FORMAT_TEXT)
+            {
+                if (my_instance->log_mode_flags & CONFIG_FILE_UNIFIED)
+                {
+                    // Written in the background, the worker threads only buffer the records.
+                    bool csv = my_instance->log_format == LOG_FORMAT_CSV;
+                    string filename = my_instance->filebase + (csv ? ".unified.csv" : ".unified.bin");
+                    my_instance->writer = QlaLogWriter::create(filename,
+                                                               csv ? QlaLogWriter::CSV : QlaLogWriter::BINARY,
+                                                               my_instance->log_file_data_flags,
+                                                               my_instance->rotate_size,
+                                                               my_instance->append);
+                }
+                else
+                {
+                    MXS_ERROR("Parameter '%s' requires that '%s' contains 'unified'.",
+                              PARAM_LOG_FORMAT, PARAM_LOG_TYPE);
+                }
+
+                if (!my_instance->writer)
+                {
+                    delete my_instance;
+                    my_instance = NULL;
+                }
+            }
             // Try to open the unified log file
-            if (my_instance->log_mode_flags & CONFIG_FILE_UNIFIED)
+            else if (my_instance->log_mode_flags & CONFIG_FILE_UNIFIED)
             {
                 string unified_filename = my_instance->filebase + ".unified";
                 // Open the file. It is only closed at program exit.
@@ -528,6 +585,18 @@ static MXS_FILTER* createInstance(const char* name, MXS_CONFIG_PARAMETER* params
     return (MXS_FILTER*) my_instance;
 }
 
+/**
+ * Destroy a filter instance. The records that the log writer still buffers
+ * are written before the unified log is closed.
+ *
+ * @param instance  The filter instance
+ */
+static void destroyInstance(MXS_FILTER* instance)
+{
+    QlaInstance* my_instance = (QlaInstance*) instance;
+    my_instance->writer.reset();
+}
+
 /**
  * Associate a new session with this instance of the filter.
  *
@@ -683,6 +752,7 @@ static void setUpstream(MXS_FILTER* instance, MXS_FILTER_SESSION* session, MXS_U
  * @param my_instance Filter instance
  * @param my_session Filter session
  * @param date_string Date string
+ * @param timestamp_us Date in microseconds since the epoch, used by the log writer
  * @param query Query string, not 0-terminated
  * @param querylen Query string length
  * @param elapsed_ms Query execution time, in milliseconds
@@ -690,6 +760,7 @@ static void setUpstream(MXS_FILTER* instance, MXS_FILTER_SESSION* session, MXS_U
 void write_log_entries(QlaInstance* my_instance,
                        QlaFilterSession* my_session,
                        const char* date_string,
+                       uint64_t timestamp_us,
                        const char* query,
                        int querylen,
                        int elapsed_ms)
@@ -712,7 +783,11 @@ void write_log_entries(QlaInstance* my_instance,
             write_error = true;
         }
     }
-    if (my_instance->log_mode_flags & CONFIG_FILE_UNIFIED)
+    if (my_instance->writer)
+    {
+        write_log_record(my_instance, my_session, timestamp_us, query, querylen, elapsed_ms);
+    }
+    else if (my_instance->log_mode_flags & CONFIG_FILE_UNIFIED)
     {
         uint32_t data_flags = my_instance->log_file_data_flags;
         if (write_log_entry(my_instance->unified_fp,
@@ -764,7 +839,16 @@ static int routeQuery(MXS_FILTER* instance, MXS_FILTER_SESSION* session, GWBUF*
     {
         const uint32_t data_flags = my_instance->log_file_data_flags;
         LogEventData& event = my_session->m_event_data;
-        if (data_flags & LOG_DATA_DATE)
+        if (my_instance->writer && (data_flags & LOG_DATA_DATE))
+        {
+            timespec now;
+            clock_gettime(CLOCK_REALTIME, &now);
+            event.timestamp_us = now.tv_sec * 1000000ull + now.tv_nsec / 1000;
+        }
+
+        // The date is printed only if a text log is written.
+        if ((data_flags & LOG_DATA_DATE)
+            && (my_instance->unified_fp || (my_instance->log_mode_flags & CONFIG_FILE_SESSION)))
         {
             // Print current date to a buffer. Use the buffer in the event data struct even if execution time
             // is not needed.
@@ -793,7 +877,8 @@ static int routeQuery(MXS_FILTER* instance, MXS_FILTER_SESSION* session, GWBUF*
         else
         {
             // If execution times are not logged, write the log entry now.
-            write_log_entries(my_instance, my_session, event.query_date, query, query_len, -1);
+            write_log_entries(my_instance, my_session, event.query_date, event.timestamp_us,
+                              query, query_len, -1);
         }
     }
     /* Pass the query downstream */
@@ -832,6 +917,7 @@ static int clientReply(MXS_FILTER* instance, MXS_FILTER_SESSION* session, GWBUF*
         write_log_entries(my_instance,
                           my_session,
                           event.query_date,
+                          event.timestamp_us,
                           query,
                           query_len,
                           std::floor(elapsed_ms + 0.5));
@@ -892,6 +978,21 @@ static void diagnostic(MXS_FILTER* instance, MXS_FILTER_SESSION* fsession, DCB*
     dcb_printf(dcb,
                "\t\tNewline replacement     %s\n",
                my_instance->query_newline.c_str());
+    if (my_instance->writer)
+    {
+        dcb_printf(dcb,
+                   "\t\tUnified log format     %s\n",
+                   my_instance->log_format == LOG_FORMAT_CSV ? "csv" : "binary");
+        dcb_printf(dcb,
+                   "\t\tRecords written        %lu\n",
+                   my_instance->writer->written());
+        dcb_printf(dcb,
+                   "\t\tRecords dropped        %lu\n",
+                   my_instance->writer->dropped());
+        dcb_printf(dcb,
+                   "\t\tLog rotations          %lu\n",
+                   my_instance->writer->rotations());
+    }
 }
 
 /**
@@ -938,6 +1039,17 @@ static json_t* diagnostic_json(const MXS_FILTER* instance, const MXS_FILTER_SESS
     json_object_set_new(rval, PARAM_SEPARATOR, json_string(my_instance->separator.c_str()));
     json_object_set_new(rval, PARAM_NEWLINE, json_string(my_instance->query_newline.c_str()));
 
+    if (my_instance->writer)
+    {
+        json_object_set_new(rval, PARAM_LOG_FORMAT,
+                            json_string(my_instance->log_format == LOG_FORMAT_CSV ? "csv" : "binary"));
+        json_object_set_new(rval, "unified_filename",
+                            json_string(my_instance->writer->filename().c_str()));
+        json_object_set_new(rval, "records_written", json_integer(my_instance->writer->written()));
+        json_object_set_new(rval, "records_dropped", json_integer(my_instance->writer->dropped()));
+        json_object_set_new(rval, "rotations", json_integer(my_instance->writer->rotations()));
+    }
+
     return rval;
 }
 
@@ -1192,6 +1304,97 @@ static int write_log_entry(FILE* logfile,
     }
 }
 
+/**
+ * Pass an entry to the log writer. The fields that are not logged are left empty.
+ *
+ * @param   instance      Filter instance
+ * @param   session       Filter session
+ * @param   timestamp_us  Date in microseconds since the epoch
+ * @param   sql_string    SQL-query, *not* NULL terminated
+ * @param   sql_str_len   Length of SQL-string
+ * @param   elapsed_ms    Query execution time, in milliseconds
+ */
+static void write_log_record(QlaInstance* instance,
+                             QlaFilterSession* session,
+                             uint64_t timestamp_us,
+                             const char* sql_string,
+                             size_t sql_str_len,
+                             int elapsed_ms)
+{
+    const uint32_t data_flags = instance->log_file_data_flags;
+    RecordView rec = {};
+
+    if (data_flags & LOG_DATA_SERVICE)
+    {
+        rec.service = {session->m_service, strlen(session->m_service)};
+    }
+    if (data_flags & LOG_DATA_SESSION)
+    {
+        rec.session = session->m_ses_id;
+    }
+    if (data_flags & LOG_DATA_DATE)
+    {
+        rec.timestamp_us = timestamp_us;
+    }
+    if (data_flags & LOG_DATA_USER)
+    {
+        rec.user = {session->m_user, strlen(session->m_user)};
+        rec.host = {session->m_remote, strlen(session->m_remote)};
+    }
+    rec.reply_time_ms = (data_flags & LOG_DATA_REPLY_TIME) ? elapsed_ms : -1;
+    if (data_flags & LOG_DATA_QUERY)
+    {
+        rec.query = {sql_string, sql_str_len};
+    }
+
+    instance->writer->write(rec);
+}
+
+/**
+ * Read the records of a binary log file as CSV lines.
+ *
+ * @param   file    The file
+ * @param   fields  The fields to include
+ * @param   start   The first line to read, the header being the first line
+ * @param   end     The line to stop at, 0 for the end of the file
+ * @param   arr     The array the lines are appended to
+ *
+ * @return  True, if the file is a valid binary log file
+ */
+static bool read_binary_log(std::ifstream& file, uint32_t fields, int start, int end, json_t* arr)
+{
+    Reader reader(file);
+
+    if (!reader.read_header())
+    {
+        return false;
+    }
+
+    // The header is the first line, as in the text format.
+    string line;
+    append_csv_header(fields, &line);
+    RecordView rec;
+    bool more = true;
+
+    for (int current = 0; more && (current < end || end == 0); current++)
+    {
+        if (current >= start)
+        {
+            line.pop_back();    // The newline
+            json_array_append_new(arr, json_string(line.c_str()));
+        }
+
+        line.clear();
+
+        if ((more = reader.next(&rec)))
+        {
+            append_csv(rec, fields, &line);
+        }
+    }
+
+    return true;
+}
+
 static bool cb_log(const MODULECMD_ARG* argv, json_t** output)
 {
     mxb_assert(argv->argc > 0);
@@ -1201,10 +1404,31 @@ static bool cb_log(const MODULECMD_ARG* argv, json_t** output)
     QlaInstance* instance = reinterpret_cast<QlaInstance*>(filter_def_get_instance(filter));
     bool rval = false;
 
-    if (instance->log_mode_flags & CONFIG_FILE_UNIFIED)
+    if (instance->writer && instance->writer->format() == QlaLogWriter::BINARY)
+    {
+        const string& filename = instance->writer->filename();
+        std::ifstream file(filename, std::ios::binary);
+        json_t* arr = json_array();
+        int start = argv->argc > 1 ? atoi(argv->argv[1].value.string) : 0;
+        int end = argv->argc > 2 ? atoi(argv->argv[2].value.string) : 0;
+
+        if (file && read_binary_log(file, instance->log_file_data_flags, start, end, arr))
+        {
+            *output = arr;
+            rval = true;
+        }
+        else
+        {
+            json_decref(arr);
+            *output = mxs_json_error("Failed to read binary log file '%s'", filename.c_str());
+        }
+    }
+    else if (instance->log_mode_flags & CONFIG_FILE_UNIFIED)
     {
-        mxb_assert(instance->unified_fp && !instance->unified_filename.empty());
-        std::ifstream file(instance->unified_filename);
+        // A CSV log is read like a text log.
+        const string& filename = instance->writer ? instance->writer->filename() : instance->unified_filename;
+        mxb_assert(instance->writer || (instance->unified_fp && !filename.empty()));
+        std::ifstream file(filename);
 
         if (file)
         {
@@ -1230,8 +1454,7 @@ static bool cb_log(const MODULECMD_ARG* argv, json_t** output)
         }
         else
         {
-            *output = mxs_json_error("Failed to open file '%s'",
-                                     instance->unified_filename.c_str());
+            *output = mxs_json_error("Failed to open file '%s'", filename.c_str());
         }
     }
     else
@@ -0,0 +1,316 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "qlarecord.hh"
+
+#include <stddef.h>
+#include <string.h>
+#include <time.h>
+#include <algorithm>
+#include <utility>
+
+namespace
+{
+
+const size_t FIXED_LEN = sizeof(uint64_t) + sizeof(uint64_t) + sizeof(int32_t);
+const size_t MAX_RECORD_LEN = 128 * 1024 * 1024;
+
+template<class T>
+void append_int(T value, std::string* pOut)
+{
+    uint64_t v = static_cast<uint64_t>(value);
+
+    for (size_t i = 0; i < sizeof(T); ++i)
+    {
+        pOut->push_back(static_cast<char>(v & 0xff));
+        v >>= 8;
+    }
+}
+
+template<class T>
+T read_int(const char* data)
+{
+    uint64_t v = 0;
+
+    for (size_t i = sizeof(T); i > 0; --i)
+    {
+        v = (v << 8) | static_cast<uint8_t>(data[i - 1]);
+    }
+
+    return static_cast<T>(v);
+}
+
+template<class T>
+void append_field(const qla::RecordView::Field& field, std::string* pOut)
+{
+    size_t len = std::min<size_t>(field.len, static_cast<T>(-1));
+    append_int<T>(len, pOut);
+
+    if (len > 0)
+    {
+        pOut->append(field.data, len);
+    }
+}
+
+template<class T>
+bool read_field(const char** pData, const char* end, qla::RecordView::Field* pField)
+{
+    bool rval = false;
+
+    if (end - *pData >= (ptrdiff_t)sizeof(T))
+    {
+        size_t len = read_int<T>(*pData);
+        *pData += sizeof(T);
+
+        if ((size_t)(end - *pData) >= len)
+        {
+            pField->data = *pData;
+            pField->len = len;
+            *pData += len;
+            rval = true;
+        }
+    }
+
+    return rval;
+}
+
+void append_csv_field(const char* data, size_t len, std::string* pOut)
+{
+    if (std::find_if(data, data + len, [](char c) {
+                         return c == ',' || c == '"' || c == '\n' || c == '\r';
+                     }) == data + len)
+    {
+        pOut->append(data, len);
+    }
+    else
+    {
+        pOut->push_back('"');
+
+        for (const char* p = data; p < data + len; ++p)
+        {
+            if (*p == '"')
+            {
+                pOut->push_back('"');
+            }
+
+            pOut->push_back(*p);
+        }
+
+        pOut->push_back('"');
+    }
+}
+
+void append_csv_field(const std::string& str, std::string* pOut)
+{
+    append_csv_field(str.data(), str.length(), pOut);
+}
+}
+
+namespace qla
+{
+
+void append_header(std::string* pOut)
+{
+    pOut->append(MAGIC, MAGIC_LEN);
+    append_int<uint16_t>(VERSION, pOut);
+}
+
+void append_record(const RecordView& rec, std::string* pOut)
+{
+    size_t start = pOut->length();
+    append_int<uint32_t>(0, pOut);     // Filled in below
+
+    append_int<uint64_t>(rec.timestamp_us, pOut);
+    append_int<uint64_t>(rec.session, pOut);
+    append_int<int32_t>(rec.reply_time_ms, pOut);
+    append_field<uint16_t>(rec.service, pOut);
+    append_field<uint16_t>(rec.user, pOut);
+    append_field<uint16_t>(rec.host, pOut);
+    append_field<uint32_t>(rec.query, pOut);
+
+    uint32_t len = pOut->length() - start - sizeof(uint32_t);
+
+    for (size_t i = 0; i < sizeof(uint32_t); ++i)
+    {
+        (*pOut)[start + i] = static_cast<char>((len >> (8 * i)) & 0xff);
+    }
+}
+
+bool decode_record(const char* data, size_t len, RecordView* pRec, size_t* pConsumed)
+{
+    bool rval = false;
+
+    if (len >= sizeof(uint32_t))
+    {
+        size_t body_len = read_int<uint32_t>(data);
+        const char* ptr = data + sizeof(uint32_t);
+        const char* end = ptr + body_len;
+
+        if (body_len >= FIXED_LEN && len - sizeof(uint32_t) >= body_len)
+        {
+            pRec->timestamp_us = read_int<uint64_t>(ptr);
+            ptr += sizeof(uint64_t);
+            pRec->session = read_int<uint64_t>(ptr);
+            ptr += sizeof(uint64_t);
+            pRec->reply_time_ms = read_int<int32_t>(ptr);
+            ptr += sizeof(int32_t);
+
+            rval = read_field<uint16_t>(&ptr, end, &pRec->service)
+                && read_field<uint16_t>(&ptr, end, &pRec->user)
+                && read_field<uint16_t>(&ptr, end, &pRec->host)
+                && read_field<uint32_t>(&ptr, end, &pRec->query)
+                && ptr == end;
+
+            if (rval)
+            {
+                *pConsumed = end - data;
+            }
+        }
+    }
+
+    return rval;
+}
+
+void append_csv_header(uint32_t fields, std::string* pOut)
+{
+    const char* sep = "";
+
+    // Same order as in the text format.
+    const std::pair<uint32_t, const char*> names[] =
+    {
+        {LOG_DATA_SERVICE,    "Service"   },
+        {LOG_DATA_SESSION,    "Session"   },
+        {LOG_DATA_DATE,       "Date"      },
+        {LOG_DATA_USER,       "User@Host" },
+        {LOG_DATA_REPLY_TIME, "Reply_time"},
+        {LOG_DATA_QUERY,      "Query"     }
+    };
+
+    for (const auto& name : names)
+    {
+        if (fields & name.first)
+        {
+            pOut->append(sep);
+            pOut->append(name.second);
+            sep = ",";
+        }
+    }
+
+    pOut->push_back('\n');
+}
+
+void append_csv(const RecordView& rec, uint32_t fields, std::string* pOut)
+{
+    const char* sep = "";
+
+    if (fields & LOG_DATA_SERVICE)
+    {
+        append_csv_field(rec.service.data, rec.service.len, pOut);
+        sep = ",";
+    }
+
+    if (fields & LOG_DATA_SESSION)
+    {
+        pOut->append(sep);
+        pOut->append(std::to_string(rec.session));
+        sep = ",";
+    }
+
+    if (fields & LOG_DATA_DATE)
+    {
+        time_t seconds = rec.timestamp_us / 1000000;
+        tm local_time;
+        localtime_r(&seconds, &local_time);
+        char date[32];
+        strftime(date, sizeof(date), "%F %T", &local_time);
+
+        pOut->append(sep);
+        pOut->append(date);
+        sep = ",";
+    }
+
+    if (fields & LOG_DATA_USER)
+    {
+        std::string user(rec.user.data, rec.user.len);
+        user += '@';
+        user.append(rec.host.data, rec.host.len);
+
+        pOut->append(sep);
+        append_csv_field(user, pOut);
+        sep = ",";
+    }
+
+    if (fields & LOG_DATA_REPLY_TIME)
+    {
+        pOut->append(sep);
+        pOut->append(std::to_string(rec.reply_time_ms));
+        sep = ",";
+    }
+
+    if (fields & LOG_DATA_QUERY)
+    {
+        pOut->append(sep);
+        append_csv_field(rec.query.data, rec.query.len, pOut);
+    }
+
+    pOut->push_back('\n');
+}
+
+Reader::Reader(std::istream& in)
+    : m_in(in)
+    , m_error(false)
+{
+}
+
+bool Reader::read_header()
+{
+    char header[HEADER_LEN];
+
+    bool rval = m_in.read(header, sizeof(header))
+        && memcmp(header, MAGIC, MAGIC_LEN) == 0
+        && read_int<uint16_t>(header + MAGIC_LEN) == VERSION;
+
+    m_error = !rval;
+    return rval;
+}
+
+bool Reader::next(RecordView* pRec)
+{
+    bool rval = false;
+    char len_buf[sizeof(uint32_t)];
+
+    if (!m_error && m_in.read(len_buf, sizeof(len_buf)))
+    {
+        size_t len = read_int<uint32_t>(len_buf);
+
+        if (len <= MAX_RECORD_LEN)
+        {
+            m_record.assign(len_buf, sizeof(len_buf));
+            m_record.resize(sizeof(len_buf) + len);
+
+            size_t consumed;
+            rval = m_in.read(&m_record[sizeof(len_buf)], len)
+                && decode_record(m_record.data(), m_record.length(), pRec, &consumed);
+        }
+
+        m_error = !rval;
+    }
+    else if (m_in.gcount() != 0)
+    {
+        // The file ends in the middle of the length of a record.
+        m_error = true;
+    }
+
+    return rval;
+}
+}
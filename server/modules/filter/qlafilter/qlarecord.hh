@@ -0,0 +1,158 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <stdint.h>
+#include <istream>
+#include <string>
+
+/**
+ * The records of the binary query log.
+ *
+ * A binary log file consists of a header followed by records:
+ *
+ *   file    := header record*
+ *   header  := "MXSQLA" version:u16
+ *   record  := length:u32 body             The length of the body
+ *   body    := timestamp:u64 session:u64 reply_time:i32
+ *              service:str16 user:str16 host:str16 query:str32
+ *   strN    := length:uN bytes
+ *
+ * The timestamp is the wall clock time of the query in microseconds since
+ * the epoch and the reply time is in milliseconds, or -1 if it was not
+ * measured. All integers are little-endian.
+ */
+namespace qla
+{
+
+/* The fields of a log entry */
+enum log_options
+{
+    LOG_DATA_SERVICE    = (1 << 0),
+    LOG_DATA_SESSION    = (1 << 1),
+    LOG_DATA_DATE       = (1 << 2),
+    LOG_DATA_USER       = (1 << 3),
+    LOG_DATA_QUERY      = (1 << 4),
+    LOG_DATA_REPLY_TIME = (1 << 5),
+    LOG_DATA_ALL        = (1 << 6) - 1
+};
+
+static const char     MAGIC[] = "MXSQLA";
+static const size_t   MAGIC_LEN = sizeof(MAGIC) - 1;
+static const uint16_t VERSION = 1;
+static const size_t   HEADER_LEN = MAGIC_LEN + sizeof(uint16_t);
+
+/**
+ * A record whose strings are owned by someone else.
+ */
+struct RecordView
+{
+    struct Field
+    {
+        const char* data;
+        size_t      len;
+    };
+
+    uint64_t timestamp_us;
+    uint64_t session;
+    int32_t  reply_time_ms;
+    Field    service;
+    Field    user;
+    Field    host;
+    Field    query;
+};
+
+/**
+ * Append the header of a binary log file to a buffer.
+ */
+void append_header(std::string* pOut);
+
+/**
+ * Append a record to a buffer.
+ *
+ * @param rec   The record.
+ * @param pOut  The buffer. Strings too long for their length field are truncated.
+ */
+void append_record(const RecordView& rec, std::string* pOut);
+
+/**
+ * Decode a record.
+ *
+ * @param data        Data that starts with a record.
+ * @param len         Length of the data.
+ * @param pRec        On success, the record. The strings point to @c data.
+ * @param pConsumed   On success, the length of the record.
+ *
+ * @return True, if the data contained a complete and valid record.
+ */
+bool decode_record(const char* data, size_t len, RecordView* pRec, size_t* pConsumed);
+
+/**
+ * Append the CSV header line to a buffer.
+ *
+ * @param fields  The fields to include, a combination of @c log_options.
+ * @param pOut    The buffer.
+ */
+void append_csv_header(uint32_t fields, std::string* pOut);
+
+/**
+ * Append a record as a CSV line to a buffer. The fields are quoted as in RFC 4180.
+ *
+ * @param rec     The record.
+ * @param fields  The fields to include, a combination of @c log_options.
+ * @param pOut    The buffer.
+ */
+void append_csv(const RecordView& rec, uint32_t fields, std::string* pOut);
+
+/**
+ * Reads the records of a binary log file.
+ */
+class Reader
+{
+public:
+    Reader(const Reader&) = delete;
+    Reader& operator=(const Reader&) = delete;
+
+    Reader(std::istream& in);
+
+    /**
+     * Read the file header. Must be called before the records are read.
+     *
+     * @return True, if the file has a valid header.
+     */
+    bool read_header();
+
+    /**
+     * Read the next record.
+     *
+     * @param pRec  The record. It is valid until the next call.
+     *
+     * @return True, if a record was read. False at the end of the file or on error.
+     */
+    bool next(RecordView* pRec);
+
+    /**
+     * @return True, if the file ended in the middle of a record or a record was invalid.
+     */
+    bool error() const
+    {
+        return m_error;
+    }
+
+private:
+    std::istream& m_in;
+    std::string   m_record;
+    bool          m_error;
+};
+}
@@ -0,0 +1,407 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#define MXS_MODULE_NAME "qlafilter"
+
+#include "qlawriter.hh"
+
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+
+#include <maxscale/log.h>
+
+namespace
+{
+
+// The writer is woken up when a buffer grows larger than this.
+const size_t FLUSH_SIZE = 64 * 1024;
+
+// Records are dropped instead of being buffered when a buffer grows larger than this.
+const size_t MAX_BUFFER_SIZE = 1024 * 1024;
+
+// How often the buffers are written even if none of them is large.
+const std::chrono::milliseconds FLUSH_INTERVAL(100);
+
+std::atomic<uint64_t> next_writer_id {1};
+}
+
+std::unique_ptr<QlaLogWriter> QlaLogWriter::create(const std::string& filename,
+                                                   Format format,
+                                                   uint32_t fields,
+                                                   uint64_t rotate_size,
+                                                   bool append)
+{
+    std::unique_ptr<QlaLogWriter> writer(new QlaLogWriter(filename, format, fields, rotate_size));
+
+    if (writer->open(append))
+    {
+        writer->m_thread = std::thread(&QlaLogWriter::run, writer.get());
+    }
+    else
+    {
+        writer.reset();
+    }
+
+    return writer;
+}
+
+QlaLogWriter::QlaLogWriter(const std::string& filename, Format format, uint32_t fields, uint64_t rotate_size)
+    : m_filename(filename)
+    , m_format(format)
+    , m_fields(fields)
+    , m_rotate_size(rotate_size)
+    , m_id(next_writer_id.fetch_add(1, std::memory_order_relaxed))
+    , m_fd(-1)
+    , m_file_size(0)
+    , m_header_size(0)
+    , m_write_error(false)
+    , m_written(0)
+    , m_dropped(0)
+    , m_rotations(0)
+    , m_stop(false)
+{
+}
+
+QlaLogWriter::~QlaLogWriter()
+{
+    if (m_thread.joinable())
+    {
+        {
+            std::lock_guard<std::mutex> guard(m_lock);
+            m_stop = true;
+        }
+
+        m_cond.notify_one();
+        m_thread.join();
+    }
+
+    for (const auto& buffer : m_buffers)
+    {
+        buffer->closed.store(true, std::memory_order_release);
+    }
+
+    if (m_fd != -1)
+    {
+        close(m_fd);
+    }
+}
+
+void QlaLogWriter::write(const qla::RecordView& rec)
+{
+    Buffer* buffer = local_buffer();
+    bool notify = false;
+
+    {
+        std::lock_guard<std::mutex> guard(buffer->lock);
+
+        if (buffer->data.length() < MAX_BUFFER_SIZE)
+        {
+            size_t old_len = buffer->data.length();
+            qla::append_record(rec, &buffer->data);
+            ++buffer->n_records;
+            notify = old_len < FLUSH_SIZE && buffer->data.length() >= FLUSH_SIZE;
+        }
+        else
+        {
+            m_dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    if (notify)
+    {
+        m_cond.notify_one();
+    }
+}
+
+QlaLogWriter::Buffer* QlaLogWriter::local_buffer()
+{
+    // The buffers of the writers the thread has logged to. Usually there is only one.
+    static thread_local std::vector<std::pair<uint64_t, std::shared_ptr<Buffer>>> buffers;
+
+    for (const auto& entry : buffers)
+    {
+        if (entry.first == m_id)
+        {
+            return entry.second.get();
+        }
+    }
+
+    // First record of this thread, forget the buffers of writers that are gone.
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [](const std::pair<uint64_t, std::shared_ptr<Buffer>>& entry) {
+                                     return entry.second->closed.load(std::memory_order_acquire);
+                                 }),
+                  buffers.end());
+
+    auto buffer = std::make_shared<Buffer>();
+    buffers.emplace_back(m_id, buffer);
+
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_buffers.push_back(buffer);
+
+    return buffer.get();
+}
+
+bool QlaLogWriter::open(bool append)
+{
+    int flags = O_WRONLY | O_CREAT | (append ? O_APPEND : O_TRUNC);
+    m_fd = ::open(m_filename.c_str(), flags, 0644);
+
+    if (m_fd == -1)
+    {
+        MXS_ERROR("Failed to open file '%s'. Error %d: '%s'.",
+                  m_filename.c_str(), errno, mxs_strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    m_file_size = fstat(m_fd, &st) == 0 ? st.st_size : 0;
+    m_header_size = 0;
+
+    if (m_file_size == 0)
+    {
+        std::string header;
+
+        if (m_format == BINARY)
+        {
+            qla::append_header(&header);
+        }
+        else
+        {
+            qla::append_csv_header(m_fields, &header);
+        }
+
+        write_data(header);
+        m_header_size = m_file_size;
+    }
+
+    return true;
+}
+
+bool QlaLogWriter::rotate()
+{
+    std::string rotated;
+    int i = 1;
+
+    do
+    {
+        rotated = m_filename + "." + std::to_string(i++);
+    }
+    while (access(rotated.c_str(), F_OK) == 0);
+
+    if (rename(m_filename.c_str(), rotated.c_str()) != 0)
+    {
+        MXS_ERROR("Failed to rename '%s' to '%s' when rotating the query log. Error %d: '%s'.",
+                  m_filename.c_str(), rotated.c_str(), errno, mxs_strerror(errno));
+        // Keep writing to the current file, truncating it would lose the log.
+        return false;
+    }
+
+    close(m_fd);
+    m_fd = -1;
+    m_rotations.fetch_add(1, std::memory_order_relaxed);
+
+    return open(false);
+}
+
+void QlaLogWriter::write_data(const std::string& data)
+{
+    const char* ptr = data.data();
+    size_t left = data.length();
+
+    while (left > 0 && m_fd != -1)
+    {
+        ssize_t rc = ::write(m_fd, ptr, left);
+
+        if (rc >= 0)
+        {
+            ptr += rc;
+            left -= rc;
+            m_file_size += rc;
+            m_write_error = false;
+        }
+        else if (errno != EINTR)
+        {
+            if (!m_write_error)
+            {
+                // Only logged once, the next failure is most likely the same.
+                MXS_ERROR("Failed to write to '%s'. Error %d: '%s'.",
+                          m_filename.c_str(), errno, mxs_strerror(errno));
+                m_write_error = true;
+            }
+            break;
+        }
+    }
+}
+
+void QlaLogWriter::flush_buffers()
+{
+    Buffers buffers;
+
+    {
+        std::lock_guard<std::mutex> guard(m_lock);
+
+        // Forget the buffers of the threads that have exited, once they have been written.
+        m_buffers.erase(std::remove_if(m_buffers.begin(), m_buffers.end(),
+                                       [](const std::shared_ptr<Buffer>& buffer) {
+                                           std::lock_guard<std::mutex> buffer_guard(buffer->lock);
+                                           return buffer.use_count() == 1 && buffer->data.empty();
+                                       }),
+                        m_buffers.end());
+        buffers = m_buffers;
+    }
+
+    // The data of each buffer and the number of records in it.
+    std::vector<std::pair<std::string, uint64_t>> chunks;
+
+    for (const auto& buffer : buffers)
+    {
+        std::string data;
+        uint64_t n_records;
+
+        {
+            std::lock_guard<std::mutex> guard(buffer->lock);
+            data.swap(buffer->data);
+            n_records = buffer->n_records;
+            buffer->n_records = 0;
+        }
+
+        if (!data.empty())
+        {
+            if (m_format == CSV)
+            {
+                std::string csv;
+                qla::RecordView rec;
+                size_t consumed;
+
+                for (size_t pos = 0; qla::decode_record(data.data() + pos, data.length() - pos,
+                                                        &rec, &consumed); pos += consumed)
+                {
+                    qla::append_csv(rec, m_fields, &csv);
+                }
+
+                data.swap(csv);
+            }
+
+            chunks.emplace_back(std::move(data), n_records);
+        }
+    }
+
+    // The chunks are written with as few system calls as possible. A rotation happens
+    // only between chunks, so a file can grow somewhat larger than the rotation size.
+    std::vector<iovec> iov;
+    std::vector<uint64_t> iov_records;
+    size_t batch_size = 0;
+
+    auto write_batch = [&]() {
+            size_t done = 0;
+
+            while (done < iov.size() && m_fd != -1)
+            {
+                int n = std::min<size_t>(iov.size() - done, IOV_MAX);
+                ssize_t rc = writev(m_fd, &iov[done], n);
+
+                if (rc < 0)
+                {
+                    if (errno == EINTR)
+                    {
+                        continue;
+                    }
+
+                    if (!m_write_error)
+                    {
+                        MXS_ERROR("Failed to write to '%s'. Error %d: '%s'.",
+                                  m_filename.c_str(), errno, mxs_strerror(errno));
+                        m_write_error = true;
+                    }
+                    break;
+                }
+
+                m_file_size += rc;
+                m_write_error = false;
+
+                // Skip what was written, a partial write may end in the middle of a chunk.
+                while (done < iov.size() && (size_t)rc >= iov[done].iov_len)
+                {
+                    rc -= iov[done].iov_len;
+                    ++done;
+                }
+
+                if (done < iov.size())
+                {
+                    iov[done].iov_base = (char*)iov[done].iov_base + rc;
+                    iov[done].iov_len -= rc;
+                }
+            }
+
+            // The records of the chunks that were not completely written, because writing
+            // failed or the file could not be reopened after a rotation, are lost.
+            uint64_t n_written = 0;
+            uint64_t n_dropped = 0;
+
+            for (size_t i = 0; i < iov_records.size(); ++i)
+            {
+                (i < done ? n_written : n_dropped) += iov_records[i];
+            }
+
+            m_written.fetch_add(n_written, std::memory_order_relaxed);
+            m_dropped.fetch_add(n_dropped, std::memory_order_relaxed);
+
+            iov.clear();
+            iov_records.clear();
+            batch_size = 0;
+        };
+
+    for (const auto& chunk : chunks)
+    {
+        const std::string& data = chunk.first;
+
+        if (m_rotate_size > 0 && m_file_size + batch_size + data.length() > m_rotate_size
+            && m_file_size + batch_size > m_header_size)
+        {
+            write_batch();
+            rotate();
+        }
+
+        iov.push_back({(void*)data.data(), data.length()});
+        iov_records.push_back(chunk.second);
+        batch_size += data.length();
+    }
+
+    write_batch();
+}
+
+void QlaLogWriter::run()
+{
+    std::unique_lock<std::mutex> guard(m_lock);
+
+    while (!m_stop)
+    {
+        m_cond.wait_for(guard, FLUSH_INTERVAL);
+        guard.unlock();
+        flush_buffers();
+        guard.lock();
+    }
+
+    guard.unlock();
+
+    // Whatever was logged before the writer was stopped.
+    flush_buffers();
+}
@@ -0,0 +1,145 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+#include <atomic>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "qlarecord.hh"
+
+/**
+ * Writes query log records to a file in the background.
+ *
+ * Each thread appends the records it logs to a buffer of its own, which
+ * only the writer thread competes for. The writer thread periodically
+ * collects the buffers of all threads and writes them to the file, either
+ * as such in the binary format or converted to CSV. When the file grows
+ * larger than the rotation size, it is renamed and a new file is started.
+ */
+class QlaLogWriter
+{
+public:
+    QlaLogWriter(const QlaLogWriter&) = delete;
+    QlaLogWriter& operator=(const QlaLogWriter&) = delete;
+
+    enum Format
+    {
+        BINARY,
+        CSV
+    };
+
+    /**
+     * Create a writer.
+     *
+     * @param filename     The file to write to.
+     * @param format       The format of the file.
+     * @param fields       The fields written to a CSV file, a combination of @c qla::log_options.
+     * @param rotate_size  The size at which the file is rotated, 0 for never.
+     * @param append       Whether to append to an existing file.
+     *
+     * @return A new writer, or NULL if the file could not be opened.
+     */
+    static std::unique_ptr<QlaLogWriter> create(const std::string& filename,
+                                                Format format,
+                                                uint32_t fields,
+                                                uint64_t rotate_size,
+                                                bool append);
+
+    /**
+     * Writes the remaining records and closes the file.
+     */
+    ~QlaLogWriter();
+
+    /**
+     * Log a record. The record is copied to the buffer of the calling thread.
+     * If the buffer is full because the writer cannot keep up, the record is
+     * dropped.
+     *
+     * @param rec  The record.
+     */
+    void write(const qla::RecordView& rec);
+
+    const std::string& filename() const
+    {
+        return m_filename;
+    }
+
+    Format format() const
+    {
+        return m_format;
+    }
+
+    uint64_t written() const
+    {
+        return m_written.load(std::memory_order_relaxed);
+    }
+
+    /**
+     * @return The number of records dropped because the writer could not keep
+     *         up or because writing them to the file failed.
+     */
+    uint64_t dropped() const
+    {
+        return m_dropped.load(std::memory_order_relaxed);
+    }
+
+    uint64_t rotations() const
+    {
+        return m_rotations.load(std::memory_order_relaxed);
+    }
+
+private:
+    struct Buffer
+    {
+        std::mutex        lock;
+        std::string       data;
+        uint64_t          n_records = 0;
+        std::atomic<bool> closed {false};   /**< Set when the writer is gone. */
+    };
+
+    typedef std::vector<std::shared_ptr<Buffer>> Buffers;
+
+    const std::string     m_filename;
+    const Format          m_format;
+    const uint32_t        m_fields;
+    const uint64_t        m_rotate_size;
+    const uint64_t        m_id;         /**< Identifies the writer for the thread local buffers. */
+    int                   m_fd;
+    uint64_t              m_file_size;
+    uint64_t              m_header_size;    /**< Size of the header written to the current file */
+    bool                  m_write_error;
+    std::atomic<uint64_t> m_written;
+    std::atomic<uint64_t> m_dropped;
+    std::atomic<uint64_t> m_rotations;
+
+    std::mutex              m_lock;     /**< Protects m_buffers and m_stop. */
+    std::condition_variable m_cond;
+    Buffers                 m_buffers;
+    bool                    m_stop;
+    std::thread             m_thread;
+
+    QlaLogWriter(const std::string& filename, Format format, uint32_t fields, uint64_t rotate_size);
+
+    bool    open(bool append);
+    bool    rotate();
+    Buffer* local_buffer();
+    void    flush_buffers();
+    void    write_data(const std::string& data);
+    void    run();
+};
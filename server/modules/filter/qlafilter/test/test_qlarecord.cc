@@ -0,0 +1,277 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../qlarecord.hh"
+
+#include <iostream>
+#include <sstream>
+
+using namespace std;
+
+namespace
+{
+
+qla::RecordView::Field field(const string& str)
+{
+    return {str.data(), str.length()};
+}
+
+string to_string(const qla::RecordView::Field& field)
+{
+    return string(field.data, field.len);
+}
+
+// The record refers to the strings, which must outlive it.
+qla::RecordView make_record(const string& service, const string& user, const string& host,
+                            const string& query)
+{
+    qla::RecordView rec;
+    rec.timestamp_us = 1540000000123456;
+    rec.session = 42;
+    rec.reply_time_ms = -1;
+    rec.service = field(service);
+    rec.user = field(user);
+    rec.host = field(host);
+    rec.query = field(query);
+    return rec;
+}
+
+bool equal(const qla::RecordView& lhs, const qla::RecordView& rhs)
+{
+    return lhs.timestamp_us == rhs.timestamp_us
+           && lhs.session == rhs.session
+           && lhs.reply_time_ms == rhs.reply_time_ms
+           && to_string(lhs.service) == to_string(rhs.service)
+           && to_string(lhs.user) == to_string(rhs.user)
+           && to_string(lhs.host) == to_string(rhs.host)
+           && to_string(lhs.query) == to_string(rhs.query);
+}
+
+int expect(bool cond, const string& what)
+{
+    if (!cond)
+    {
+        cout << "error: " << what << endl;
+    }
+
+    return cond ? 0 : 1;
+}
+
+int test_encode_decode()
+{
+    int rv = 0;
+    string service("RW-Split");
+    string user("bob");
+    string host("127.0.0.1");
+    string query("SELECT '\0\xff'", 11);
+    string none;
+    qla::RecordView rec = make_record(service, user, host, query);
+    qla::RecordView empty = make_record(none, none, none, none);
+    empty.reply_time_ms = 12;
+
+    string data;
+    qla::append_record(rec, &data);
+    size_t first_len = data.length();
+    qla::append_record(empty, &data);
+
+    qla::RecordView decoded;
+    size_t consumed = 0;
+
+    rv += expect(qla::decode_record(data.data(), data.length(), &decoded, &consumed),
+                 "An encoded record should be decoded");
+    rv += expect(consumed == first_len, "The length of the first record should be consumed");
+    rv += expect(equal(decoded, rec), "A decoded record should equal the encoded one");
+
+    rv += expect(qla::decode_record(data.data() + consumed, data.length() - consumed, &decoded, &consumed),
+                 "A record with empty strings should be decoded");
+    rv += expect(consumed == data.length() - first_len, "The length of the second record should be consumed");
+    rv += expect(equal(decoded, empty), "A decoded record with empty strings should equal the encoded one");
+
+    // A string longer than its length field is truncated.
+    string long_service(70000, 's');
+    string select("SELECT 1");
+    qla::RecordView longer = make_record(long_service, user, host, select);
+    data.clear();
+    qla::append_record(longer, &data);
+
+    rv += expect(qla::decode_record(data.data(), data.length(), &decoded, &consumed),
+                 "A record with a long string should be decoded");
+    rv += expect(decoded.service.len == 65535, "A string longer than its length field should be truncated");
+    rv += expect(to_string(decoded.query) == "SELECT 1", "The fields after a truncated one should be intact");
+
+    return rv;
+}
+
+int test_invalid()
+{
+    int rv = 0;
+    string data;
+    qla::append_record(make_record("RW-Split", "bob", "127.0.0.1", "SELECT 1"), &data);
+
+    qla::RecordView decoded;
+    size_t consumed;
+    size_t n_decoded = 0;
+
+    for (size_t len = 0; len < data.length(); ++len)
+    {
+        n_decoded += qla::decode_record(data.data(), len, &decoded, &consumed);
+    }
+
+    rv += expect(n_decoded == 0, "A truncated record should not be decoded");
+
+    // A body longer than its fields.
+    string padded = data + 'x';
+    padded[0] += 1;
+    rv += expect(!qla::decode_record(padded.data(), padded.length(), &decoded, &consumed),
+                 "A record with trailing data in the body should not be decoded");
+
+    // A string longer than the body.
+    string overflow = data;
+    overflow[4 + 8 + 8 + 4] = 0x7f;
+    rv += expect(!qla::decode_record(overflow.data(), overflow.length(), &decoded, &consumed),
+                 "A record with a string longer than the body should not be decoded");
+
+    // A body shorter than the fixed fields.
+    string tiny("\x04\0\0\0\0\0\0\0", 8);
+    rv += expect(!qla::decode_record(tiny.data(), tiny.length(), &decoded, &consumed),
+                 "A record shorter than the fixed fields should not be decoded");
+
+    return rv;
+}
+
+int test_reader()
+{
+    int rv = 0;
+    string file;
+    qla::append_header(&file);
+    qla::append_record(make_record("RW-Split", "bob", "127.0.0.1", "SELECT 1"), &file);
+    qla::append_record(make_record("RW-Split", "alice", "::1", "SELECT 2"), &file);
+
+    {
+        istringstream in(file);
+        qla::Reader reader(in);
+        qla::RecordView rec;
+        size_t n = 0;
+
+        rv += expect(reader.read_header(), "The header should be valid");
+
+        while (reader.next(&rec))
+        {
+            ++n;
+        }
+
+        rv += expect(n == 2, "All records should be read");
+        rv += expect(!reader.error(), "A complete file should be read without errors");
+        rv += expect(to_string(rec.query) == "SELECT 2", "The last record should be the last one read");
+    }
+
+    // Truncated in the middle of the length of a record and in the middle of a record.
+    for (size_t len : {qla::HEADER_LEN + 2, qla::HEADER_LEN + 5, file.length() - 1})
+    {
+        istringstream in(file.substr(0, len));
+        qla::Reader reader(in);
+        qla::RecordView rec;
+
+        reader.read_header();
+
+        while (reader.next(&rec))
+        {
+        }
+
+        rv += expect(reader.error(), "A truncated file should be an error");
+    }
+
+    {
+        istringstream in(file.substr(0, qla::HEADER_LEN));
+        qla::Reader reader(in);
+        qla::RecordView rec;
+
+        rv += expect(reader.read_header() && !reader.next(&rec) && !reader.error(),
+                     "A file without records should be read without errors");
+    }
+
+    {
+        string invalid = file;
+        invalid[0] = 'X';
+        istringstream in(invalid);
+        qla::Reader reader(in);
+
+        rv += expect(!reader.read_header(), "A file with an invalid header should not be read");
+    }
+
+    return rv;
+}
+
+int test_csv()
+{
+    struct
+    {
+        const char* zQuery;
+        const char* zCsv;
+    } tests[] =
+    {
+        {"SELECT 1",                 "SELECT 1"                    },
+        {"",                         ""                            },
+        {"SELECT 1, 2",              "\"SELECT 1, 2\""             },
+        {"SELECT \"a\"",             "\"SELECT \"\"a\"\"\""        },
+        {"SELECT\n1",                "\"SELECT\n1\""               },
+        {"SELECT\r\n1",              "\"SELECT\r\n1\""             },
+        {"SELECT 'a'",               "SELECT 'a'"                  },
+    };
+
+    int rv = 0;
+    const uint32_t fields = qla::LOG_DATA_ALL & ~qla::LOG_DATA_DATE;
+
+    for (const auto& t : tests)
+    {
+        string csv;
+        qla::append_csv(make_record("RW-Split", "bob", "127.0.0.1", t.zQuery), fields, &csv);
+
+        string expected = string("RW-Split,42,bob@127.0.0.1,-1,") + t.zCsv + "\n";
+        rv += expect(csv == expected, "Query '" + string(t.zQuery) + "' should be written as '" + t.zCsv
+                     + "', got '" + csv + "'");
+    }
+
+    string csv;
+    qla::append_csv(make_record("a,b", "bob", "10.0.0.1", "SELECT 1"),
+                    qla::LOG_DATA_SERVICE | qla::LOG_DATA_USER | qla::LOG_DATA_QUERY, &csv);
+    rv += expect(csv == "\"a,b\",bob@10.0.0.1,SELECT 1\n", "Service with a comma should be quoted");
+
+    csv.clear();
+    qla::append_csv(make_record("RW-Split", "bob", "127.0.0.1", "SELECT 1"), qla::LOG_DATA_QUERY, &csv);
+    rv += expect(csv == "SELECT 1\n", "Only the selected fields should be written");
+
+    csv.clear();
+    qla::append_csv_header(qla::LOG_DATA_ALL, &csv);
+    rv += expect(csv == "Service,Session,Date,User@Host,Reply_time,Query\n",
+                 "The header should contain all fields");
+
+    csv.clear();
+    qla::append_csv_header(qla::LOG_DATA_SESSION | qla::LOG_DATA_QUERY, &csv);
+    rv += expect(csv == "Session,Query\n", "The header should contain only the selected fields");
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = 0;
+
+    rv += test_encode_decode();
+    rv += test_invalid();
+    rv += test_reader();
+    rv += test_csv();
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -35,7 +35,7 @@
 #define DONOR_LIST_SET_VAR      "SET GLOBAL wsrep_sst_donor = \""
 
 /** Log a warning when a bad 'wsrep_local_index' is found */
-static bool warn_erange_on_local_index = true;
+static std::atomic<bool> warn_erange_on_local_index{true};
 
 static MXS_MONITORED_SERVER* set_cluster_master(MXS_MONITORED_SERVER*, MXS_MONITORED_SERVER*, int);
 static void                  disableMasterFailback(void*, int);
@@ -260,6 +260,7 @@ void GaleraMonitor::update_server_status(MXS_MONITORED_SERVER* monitored_server)
 
         monitored_server->server->node_id = info.joined ? info.local_index : -1;
 
+        std::lock_guard<std::mutex> guard(m_info_lock);
         m_info[monitored_server] = info;
 
         mysql_free_result(result);
@@ -18,6 +18,7 @@
 
 #include <maxscale/ccdefs.hh>
 
+#include <mutex>
 #include <unordered_map>
 
 #include <maxscale/monitor.hh>
@@ -67,6 +68,7 @@ private:
     std::string m_cluster_uuid;                 /**< The Cluster UUID */
     bool        m_log_no_members;               /**< Should we log if no member are found. */
     NodeMap     m_info;                         /**< Contains Galera Cluster variables of all nodes */
+    std::mutex  m_info_lock;                    /**< Protects m_info while the nodes are probed */
     int         m_cluster_size;                 /**< How many nodes in the cluster */
 
     GaleraMonitor(MXS_MONITOR* monitor);
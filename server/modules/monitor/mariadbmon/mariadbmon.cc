@@ -443,10 +443,17 @@ void MariaDBMonitor::tick()
         cluster_operation_disable_timer--;
     }
 
-    // Query all servers for their status.
+    // Query all servers for their status. The servers are independent of each other, so they can be
+    // queried concurrently.
+    run_concurrently(m_servers.size(), [this](size_t i) {
+                         MariaDBServer* server = m_servers[i];
+                         mxb::StopWatch timer;
+                         update_server(server);
+                         record_probe_time(server->m_server_base, timer.split());
+                     });
+
     for (MariaDBServer* server : m_servers)
     {
-        update_server(server);
         if (server->m_topology_changed)
         {
             m_cluster_topology_changed = true;
@@ -473,6 +473,31 @@ static inline void prepare_for_write(DCB* dcb, GWBUF* buffer)
  *******************************************************************************
  ******************************************************************************/
 
+/**
+ * Read the reply to a ping that was sent to a DCB in the persistent pool
+ *
+ * @param dcb  The pooled DCB
+ *
+ * @return False if the reply was not an OK packet
+ */
+static bool read_pool_ping_reply(DCB* dcb)
+{
+    GWBUF* readbuf = NULL;
+    bool rval = read_complete_packet(dcb, &readbuf);
+
+    if (readbuf)
+    {
+        readbuf = gwbuf_make_contiguous(readbuf);
+        MXS_ABORT_IF_NULL(readbuf);
+
+        rval = mxs_mysql_is_ok_packet(readbuf);
+        dcb->flags &= ~DCBF_PINGING;
+        gwbuf_free(readbuf);
+    }
+
+    return rval;
+}
+
 /**
  * Backend Read Event for EPOLLIN on the MySQL backend protocol module
  * @param dcb   The backend Descriptor Control Block
@@ -483,8 +508,11 @@ static int gw_read_backend_event(DCB* dcb)
     if (dcb->persistentstart)
     {
         /** If a DCB gets a read event when it's in the persistent pool, it is
-         * treated as if it were an error. */
-        dcb->dcb_errhandle_called = true;
+         * treated as if it were an error unless it is the reply to a ping. */
+        if (!(dcb->flags & DCBF_PINGING) || !read_pool_ping_reply(dcb))
+        {
+            dcb->dcb_errhandle_called = true;
+        }
         return 0;
     }
 
@@ -556,6 +584,8 @@ static int gw_read_backend_event(DCB* dcb)
             if (proto->protocol_auth_state == MXS_AUTH_STATE_COMPLETE)
             {
                 /** Authentication completed successfully */
+                dcb_backend_connected(dcb);
+
                 GWBUF* localq = dcb->delayq;
                 dcb->delayq = NULL;
 
@@ -817,10 +847,19 @@ static int gw_read_and_write(DCB* dcb)
     bool result_collected = false;
     MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
 
+    /** The replies are followed on behalf of the client protocol, if the session may be moved */
+    MXS_REPLY_TRACKER* tracker = &((MySQLProtocol*)session->client_dcb->protocol)->reply_tracker;
+
+    if (!tracker->enabled || tracker->lost)
+    {
+        tracker = NULL;
+    }
+
     if (rcap_type_required(capabilities, RCAP_TYPE_PACKET_OUTPUT)
         || rcap_type_required(capabilities, RCAP_TYPE_CONTIGUOUS_OUTPUT)
         || proto->collect_result
-        || proto->ignore_replies != 0)
+        || proto->ignore_replies != 0
+        || tracker)
     {
         GWBUF* tmp = modutil_get_complete_packets(&read_buffer);
         /* Put any residue into the read queue */
@@ -846,6 +885,11 @@ static int gw_read_and_write(DCB* dcb)
 
         read_buffer = tmp;
 
+        if (tracker)
+        {
+            mxs_mysql_track_reply(tracker, read_buffer);
+        }
+
         if (rcap_type_required(capabilities, RCAP_TYPE_CONTIGUOUS_OUTPUT)
             || proto->collect_result
             || proto->ignore_replies != 0)
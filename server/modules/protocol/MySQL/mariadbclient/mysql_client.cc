@@ -26,6 +26,7 @@
 
 #include <maxscale/alloc.h>
 #include <maxscale/authenticator.h>
+#include <maxscale/config.h>
 #include <maxscale/log.h>
 #include <maxscale/modinfo.h>
 #include <maxscale/modutil.h>
@@ -68,6 +69,7 @@ static int   gw_client_close(DCB* dcb);
 static int   gw_client_hangup_event(DCB* dcb);
 static char* gw_default_auth();
 static int   gw_connection_limit(DCB* dcb, int limit);
+static bool  gw_client_is_idle(DCB* dcb);
 static int   MySQLSendHandshake(DCB* dcb);
 static int route_by_statement(MXS_SESSION*, uint64_t, GWBUF**);
 static void           mysql_client_auth_error_handling(DCB* dcb, int auth_val, int packet_number);
@@ -112,7 +114,8 @@ extern "C"
             gw_default_auth,                        /* Default authenticator         */
             gw_connection_limit,                    /* Send error connection limit   */
             NULL,
-            NULL
+            NULL,
+            gw_client_is_idle                       /* Idle check for moving sessions */
         };
 
         static MXS_MODULE info =
@@ -836,6 +839,10 @@ static int gw_read_do_authentication(DCB* dcb, GWBUF* read_buffer, int nbytes_re
             // For the time being only the sql_mode is stored in MXS_SESSION::client_protocol_data.
             session->client_protocol_data = QC_SQL_MODE_DEFAULT;
             protocol->protocol_auth_state = MXS_AUTH_STATE_COMPLETE;
+            // The replies are followed only if they are needed for moving idle sessions
+            protocol->reply_tracker.enabled =
+                rcap_type_required(service_get_capabilities(dcb->service), RCAP_TYPE_SESSION_MIGRATION)
+                && config_get_global_options()->rebalance_period > 0;
             MXB_AT_DEBUG(bool check = ) mxs_rworker_register_session(session);
             mxb_assert(check);
             mxs_mysql_send_ok(dcb, next_sequence, 0, NULL);
@@ -900,6 +907,22 @@ static bool protocol_is_idle(DCB* dcb)
     return dcb->protocol_bytes_processed == dcb->protocol_packet_length;
 }
 
+/**
+ * @brief Check if the session of the DCB can be moved to another worker
+ *
+ * @param dcb DCB to check
+ * @return True if no command is being read, the reply to the latest command
+ * has been received and no transaction is open
+ */
+static bool gw_client_is_idle(DCB* dcb)
+{
+    MySQLProtocol* proto = (MySQLProtocol*)dcb->protocol;
+
+    return protocol_is_idle(dcb)
+           && !proto->changing_user
+           && mxs_mysql_reply_tracker_is_idle(&proto->reply_tracker);
+}
+
 /**
  * @brief Process the commands the client is executing
  *
@@ -976,6 +999,11 @@ static bool process_client_commands(DCB* dcb, int bytes_available, GWBUF** buffe
                 proto->current_command = (mxs_mysql_cmd_t)cmd;
             }
 
+            if (proto->reply_tracker.enabled)
+            {
+                mxs_mysql_track_request(&proto->reply_tracker, pktlen, cmd);
+            }
+
             dcb->protocol_packet_length = pktlen + MYSQL_HEADER_LEN;
             dcb->protocol_bytes_processed = 0;
         }
@@ -17,6 +17,7 @@
 
 #include <netinet/tcp.h>
 
+#include <algorithm>
 #include <set>
 #include <sstream>
 #include <map>
@@ -64,6 +65,7 @@ MySQLProtocol* mysql_protocol_init(DCB* dcb, int fd)
     p->num_eof_packets = 0;
     p->large_query = false;
     p->track_state = false;
+    memset(&p->reply_tracker, 0, sizeof(p->reply_tracker));
     /*< Assign fd with protocol */
     p->fd = fd;
     p->owner_dcb = dcb;
@@ -1338,6 +1340,247 @@ bool mxs_mysql_command_will_respond(uint8_t cmd)
            && cmd != MXS_COM_STMT_CLOSE;
 }
 
+/**
+ * Get the server status of an OK or an EOF packet.
+ *
+ * @param payload  The payload of the packet
+ * @param len      How much of the payload is available
+ * @param pStatus  The status is stored here
+ *
+ * @return True, if the status was in the available part of the payload.
+ */
+static bool get_server_status(const uint8_t* payload, size_t len, uint16_t* pStatus)
+{
+    size_t offset = 1;
+
+    if (payload[0] == MYSQL_REPLY_EOF)
+    {
+        // Skip the warning count
+        offset += 2;
+    }
+    else
+    {
+        // Skip the affected rows and the last insert id
+        for (int i = 0; i < 2 && offset < len; i++)
+        {
+            offset += mxs_leint_bytes(payload + offset);
+        }
+    }
+
+    bool rval = offset + 2 <= len;
+
+    if (rval)
+    {
+        *pStatus = payload[offset] | (payload[offset + 1] << 8);
+    }
+
+    return rval;
+}
+
+static void end_result(MXS_REPLY_TRACKER* tracker, uint16_t status)
+{
+    // MySQL 5.6 and 5.7 do not set SERVER_MORE_RESULTS_EXIST at the end of the
+    // result set of OUT parameters, although an OK packet follows it.
+    bool more = (status & SERVER_MORE_RESULTS_EXIST) || tracker->out_params;
+
+    tracker->out_params = false;
+    tracker->in_trx = status & SERVER_STATUS_IN_TRANS;
+    tracker->state = more ? MXS_REPLY_TRACK_START : MXS_REPLY_TRACK_DONE;
+}
+
+void mxs_mysql_track_request(MXS_REPLY_TRACKER* tracker, uint32_t len, uint8_t cmd)
+{
+    bool skip = tracker->skip_request;
+    tracker->skip_request = len == GW_MYSQL_MAX_PACKET_LEN;
+
+    if (skip)
+    {
+        // The rest of a large packet
+    }
+    else if (tracker->state == MXS_REPLY_TRACK_LOAD_DATA)
+    {
+        if (len == 0)
+        {
+            // The end of the file, the server responds with an OK or an ERR packet
+            tracker->state = MXS_REPLY_TRACK_START;
+        }
+    }
+    else if (tracker->state != MXS_REPLY_TRACK_DONE
+             || cmd == MXS_COM_CHANGE_USER
+             || cmd == MXS_COM_BINLOG_DUMP)
+    {
+        tracker->lost = true;
+    }
+    else if (mxs_mysql_command_will_respond(cmd))
+    {
+        tracker->command = cmd;
+        tracker->state = MXS_REPLY_TRACK_START;
+    }
+}
+
+static void track_reply_packet(MXS_REPLY_TRACKER* tracker, const uint8_t* payload, size_t avail, uint32_t len)
+{
+    uint8_t cmd = payload[0];
+    uint8_t command = tracker->command;
+    // A row can start with 0xfe only if it is longer than an EOF packet
+    bool is_eof = cmd == MYSQL_REPLY_EOF && len == MYSQL_EOF_PACKET_LEN - MYSQL_HEADER_LEN;
+    uint16_t status = 0;
+
+    switch (tracker->state)
+    {
+    case MXS_REPLY_TRACK_START:
+        if (command == MXS_COM_STATISTICS || cmd == MYSQL_REPLY_ERR)
+        {
+            // The statistics are a single string and nothing follows an error
+            tracker->state = MXS_REPLY_TRACK_DONE;
+        }
+        else if (cmd == MYSQL_REPLY_OK && command == MXS_COM_STMT_PREPARE)
+        {
+            // The statement id, the number of columns and the number of parameters
+            if (avail >= 9)
+            {
+                uint16_t n_columns = payload[5] | (payload[6] << 8);
+                uint16_t n_params = payload[7] | (payload[8] << 8);
+
+                // Both lists of definitions end with an EOF packet
+                tracker->n_packets = (n_columns ? n_columns + 1 : 0) + (n_params ? n_params + 1 : 0);
+                tracker->state = tracker->n_packets ? MXS_REPLY_TRACK_PREPARE : MXS_REPLY_TRACK_DONE;
+            }
+            else
+            {
+                tracker->lost = true;
+            }
+        }
+        else if (is_eof || (cmd == MYSQL_REPLY_OK && command != MXS_COM_STMT_FETCH))
+        {
+            if (get_server_status(payload, avail, &status))
+            {
+                end_result(tracker, status);
+            }
+            else
+            {
+                tracker->lost = true;
+            }
+        }
+        else if (cmd == MYSQL_REPLY_LOCAL_INFILE)
+        {
+            tracker->state = MXS_REPLY_TRACK_LOAD_DATA;
+        }
+        else if (command == MXS_COM_FIELD_LIST || command == MXS_COM_STMT_FETCH)
+        {
+            // Column definitions or rows, terminated by an EOF packet
+            tracker->state = MXS_REPLY_TRACK_ROWS;
+        }
+        else
+        {
+            // The number of columns of a result set
+            tracker->n_packets = mxs_leint_value(payload);
+
+            if (tracker->n_packets > 0)
+            {
+                tracker->state = MXS_REPLY_TRACK_COLDEF;
+            }
+            else
+            {
+                tracker->lost = true;
+            }
+        }
+        break;
+
+    case MXS_REPLY_TRACK_COLDEF:
+        if (--tracker->n_packets == 0)
+        {
+            tracker->state = MXS_REPLY_TRACK_COLDEF_EOF;
+        }
+        break;
+
+    case MXS_REPLY_TRACK_COLDEF_EOF:
+        if (is_eof && get_server_status(payload, avail, &status))
+        {
+            if (status & SERVER_STATUS_CURSOR_EXISTS)
+            {
+                // A cursor was opened, the rows are fetched with COM_STMT_FETCH
+                end_result(tracker, status);
+            }
+            else
+            {
+                tracker->out_params = status & SERVER_PS_OUT_PARAMS;
+                tracker->state = MXS_REPLY_TRACK_ROWS;
+            }
+        }
+        else
+        {
+            tracker->lost = true;
+        }
+        break;
+
+    case MXS_REPLY_TRACK_ROWS:
+        if (is_eof)
+        {
+            if (get_server_status(payload, avail, &status))
+            {
+                end_result(tracker, status);
+            }
+            else
+            {
+                tracker->lost = true;
+            }
+        }
+        else if (cmd == MYSQL_REPLY_ERR)
+        {
+            tracker->state = MXS_REPLY_TRACK_DONE;
+        }
+        break;
+
+    case MXS_REPLY_TRACK_PREPARE:
+        if (--tracker->n_packets == 0)
+        {
+            tracker->state = MXS_REPLY_TRACK_DONE;
+        }
+        break;
+
+    case MXS_REPLY_TRACK_DONE:
+    case MXS_REPLY_TRACK_LOAD_DATA:
+        // Nothing was expected from the server
+        tracker->lost = true;
+        break;
+    }
+}
+
+void mxs_mysql_track_reply(MXS_REPLY_TRACKER* tracker, GWBUF* reply)
+{
+    size_t len = gwbuf_length(reply);
+    size_t offset = 0;
+
+    while (offset < len && !tracker->lost)
+    {
+        // Large enough for the parts of the packets that are inspected
+        uint8_t data[MYSQL_HEADER_LEN + 32] = {};
+        size_t n = gwbuf_copy_data(reply, offset, sizeof(data), data);
+        mxb_assert(n > MYSQL_HEADER_LEN);
+        uint32_t payload_len = MYSQL_GET_PAYLOAD_LEN(data);
+        offset += MYSQL_HEADER_LEN + payload_len;
+
+        bool skip = tracker->skip_reply;
+        tracker->skip_reply = payload_len == GW_MYSQL_MAX_PACKET_LEN;
+
+        if (!skip)
+        {
+            size_t avail = std::min<size_t>(n - MYSQL_HEADER_LEN, payload_len);
+            track_reply_packet(tracker, data + MYSQL_HEADER_LEN, avail, payload_len);
+        }
+    }
+}
+
+bool mxs_mysql_reply_tracker_is_idle(const MXS_REPLY_TRACKER* tracker)
+{
+    return tracker->enabled
+           && !tracker->lost
+           && tracker->state == MXS_REPLY_TRACK_DONE
+           && !tracker->skip_request
+           && !tracker->in_trx;
+}
+
 namespace
 {
 
@@ -40,6 +40,7 @@ RWBackend::~RWBackend()
 bool RWBackend::execute_session_command()
 {
     m_command = next_session_command()->get_command();
+    m_current = {m_command, maxbase::TimePoint(), 0};
     bool expect_response = mxs_mysql_command_will_respond(m_command);
     bool rval = mxs::Backend::execute_session_command();
 
@@ -74,17 +75,53 @@ uint32_t RWBackend::get_ps_handle(uint32_t id) const
     return 0;
 }
 
+bool RWBackend::can_pipeline(GWBUF* buffer) const
+{
+    auto plain_result = [](uint8_t cmd, GWBUF* buf) {
+            bool rval = cmd == MXS_COM_QUERY;
+
+            if (cmd == MXS_COM_STMT_EXECUTE)
+            {
+                // Any non-zero flag value means that a cursor is opened
+                uint8_t flags = 0;
+                gwbuf_copy_data(buf, MYSQL_PS_ID_OFFSET + MYSQL_PS_ID_SIZE, 1, &flags);
+                rval = flags == 0;
+            }
+
+            return rval;
+        };
+
+    return in_use()
+           && is_waiting_result()
+           && !has_session_commands()
+           && !m_local_infile_requested
+           && !is_opening_cursor()
+           && (m_command == MXS_COM_QUERY || m_command == MXS_COM_STMT_EXECUTE)
+           && plain_result(mxs_mysql_get_command(buffer), buffer);
+}
+
 bool RWBackend::write(GWBUF* buffer, response_type type)
 {
-    if (type == mxs::Backend::EXPECT_RESPONSE)
+    uint8_t cmd = mxs_mysql_get_command(buffer);
+
+    if (type == mxs::Backend::EXPECT_RESPONSE && is_waiting_result())
     {
-        /** The server will reply to this command */
-        set_reply_state(REPLY_STATE_START);
+        /** The reply to the current command is still being read, the reply
+         * to this command is processed after it */
+        mxb_assert(can_pipeline(buffer));
+        m_pipelined.push_back({cmd, maxbase::TimePoint(), 0});
     }
+    else
+    {
+        if (type == mxs::Backend::EXPECT_RESPONSE)
+        {
+            /** The server will reply to this command */
+            set_reply_state(REPLY_STATE_START);
+        }
 
-    uint8_t cmd = mxs_mysql_get_command(buffer);
-
-    m_command = cmd;
+        m_command = cmd;
+        m_current = {cmd, maxbase::TimePoint(), 0};
+    }
 
     if (mxs_mysql_is_ps_command(cmd))
     {
@@ -131,9 +168,17 @@ bool RWBackend::write(GWBUF* buffer, response_type type)
     return mxs::Backend::write(buffer, type);
 }
 
+void RWBackend::measure_last_query(uint64_t shape)
+{
+    Query& query = m_pipelined.empty() ? m_current : m_pipelined.back();
+    query.start = maxbase::Clock::now();
+    query.shape = shape;
+}
+
 void RWBackend::close(close_type type)
 {
     m_reply_state = REPLY_STATE_DONE;
+    m_pipelined.clear();
     mxs::Backend::close(type);
 }
 
@@ -288,15 +333,24 @@ void RWBackend::process_reply_start(Iter it)
     }
 }
 
-void RWBackend::process_packets(GWBUF* result)
+/**
+ * Process the packets of a reply
+ *
+ * @param result  The packets
+ *
+ * @return The number of bytes processed. If queries are pipelined, the processing
+ *         stops at the end of the reply to the current query.
+ */
+size_t RWBackend::process_packets(GWBUF* result)
 {
     mxs::Buffer buffer(result);
     auto it = buffer.begin();
     MXB_AT_DEBUG(size_t total_len = buffer.length());
-    MXB_AT_DEBUG(size_t used_len = 0);
+    size_t used_len = 0;
     mxb_assert(dcb()->session->service->capabilities & (RCAP_TYPE_PACKET_OUTPUT | RCAP_TYPE_STMT_OUTPUT));
 
-    while (it != buffer.end())
+    while (it != buffer.end()
+           && !(m_reply_state == REPLY_STATE_DONE && !m_pipelined.empty()))
     {
         // Extract packet length and command byte
         uint32_t len = *it++;
@@ -304,8 +358,8 @@ void RWBackend::process_packets(GWBUF* result)
         len |= (*it++) << 16;
         ++it;   // Skip the sequence
         mxb_assert(it != buffer.end());
-        mxb_assert(used_len + len <= total_len);
-        MXB_AT_DEBUG(used_len += len);
+        used_len += MYSQL_HEADER_LEN + len;
+        mxb_assert(used_len <= total_len);
         auto end = it;
         end.advance(len);
         uint8_t cmd = *it;
@@ -379,6 +433,7 @@ void RWBackend::process_packets(GWBUF* result)
     }
 
     buffer.release();
+    return used_len;
 }
 
 /**
@@ -388,6 +443,15 @@ void RWBackend::process_packets(GWBUF* result)
  */
 void RWBackend::process_reply(GWBUF* buffer)
 {
+    MXB_AT_DEBUG(GWBUF* rest = ) process_next_reply(&buffer);
+    mxb_assert_message(!rest, "Only readwritesplit pipelines queries");
+}
+
+GWBUF* RWBackend::process_next_reply(GWBUF** ppBuffer)
+{
+    GWBUF* buffer = *ppBuffer;
+    GWBUF* rest = NULL;
+
     if (current_command() == MXS_COM_STMT_FETCH)
     {
         // If the server responded with an error, n_eof > 0
@@ -405,13 +469,38 @@ void RWBackend::process_reply(GWBUF* buffer)
     else
     {
         // Normal result, process it one packet at a time
-        process_packets(buffer);
+        size_t len = process_packets(buffer);
+
+        if (len < gwbuf_length(buffer))
+        {
+            // The rest of the buffer belongs to the replies to the pipelined queries
+            rest = buffer;
+            *ppBuffer = gwbuf_split(&rest, len);
+        }
     }
 
     if (get_reply_state() == REPLY_STATE_DONE)
     {
-        ack_write();
+        m_completed_time = m_current.start == maxbase::TimePoint() ?
+            maxbase::Duration(0) : maxbase::Clock::now() - m_current.start;
+        m_completed_shape = m_current.shape;
+        m_current.start = maxbase::TimePoint();
+
+        if (m_pipelined.empty())
+        {
+            ack_write();
+        }
+        else
+        {
+            // Start waiting for the reply to the next query
+            m_current = m_pipelined.front();
+            m_command = m_current.command;
+            m_pipelined.pop_front();
+            set_reply_state(REPLY_STATE_START);
+        }
     }
+
+    return rest;
 }
 
 ResponseStat& RWBackend::response_stat()
@@ -1283,7 +1283,8 @@ static void createListener(DCB* dcb,
                            char* ca,
                            char* version,
                            char* depth,
-                           char* verify)
+                           char* verify,
+                           char* reuseport)
 {
     if (runtime_create_listener((Service*)service,
                                 name,
@@ -1297,7 +1298,8 @@ static void createListener(DCB* dcb,
                                 ca,
                                 version,
                                 depth,
-                                verify))
+                                verify,
+                                reuseport))
     {
         dcb_printf(dcb, "Listener '%s' created\n", name);
     }
@@ -1346,11 +1348,11 @@ struct subcommand createoptions[] =
         }
     },
     {
-        "listener", 2, 13, (FN)createListener,
+        "listener", 2, 14, (FN)createListener,
         "Create a new listener for a service",
         "Usage: create listener SERVICE NAME [HOST] [PORT] [PROTOCOL] [AUTHENTICATOR] [OPTIONS]\n"
         "                       [SSL_KEY] [SSL_CERT] [SSL_CA] [SSL_VERSION] [SSL_VERIFY_DEPTH]\n"
-        "                       [SSL_VERIFY_PEER_CERTIFICATE]\n"
+        "                       [SSL_VERIFY_PEER_CERTIFICATE] [REUSEPORT]\n"
         "\n"
         "Parameters\n"
         "SERVICE       Service where this listener is added\n"
@@ -1366,6 +1368,7 @@ struct subcommand createoptions[] =
         "SSL_VERSION   SSL version (default MAX)\n"
         "SSL_VERIFY_DEPTH Certificate verification depth\n"
         "SSL_VERIFY_PEER_CERTIFICATE Verify peer certificate\n"
+        "REUSEPORT     Give each worker a socket of its own (default false)\n"
         "\n"
         "The first two parameters are required, the others are optional.\n"
         "Any of the optional parameters can also have the value 'default'\n"
@@ -1377,7 +1380,7 @@ struct subcommand createoptions[] =
             ARG_TYPE_OBJECT_NAME, ARG_TYPE_OBJECT_NAME, ARG_TYPE_OBJECT_NAME,
             ARG_TYPE_STRING,    // Rest of the arguments are paths which can contain spaces
             ARG_TYPE_STRING, ARG_TYPE_STRING, ARG_TYPE_STRING, ARG_TYPE_STRING,
-            ARG_TYPE_STRING,
+            ARG_TYPE_STRING, ARG_TYPE_OBJECT_NAME,
         }
     },
     {
@@ -1742,6 +1745,8 @@ struct subcommand alteroptions[] =
         "ssl_verify_peer_certificate Peer certificate verification\n"
         "persistpoolmax              Persisted connection pool size\n"
         "persistmaxtime              Persisted connection maximum idle time\n"
+        "persistpoolmin              Persisted connections kept regardless of age\n"
+        "persistpingtime             Persisted connection ping interval\n"
         "\n"
         "To configure SSL for a newly created server, the 'ssl', 'ssl_cert',\n"
         "'ssl_key' and 'ssl_ca_cert' parameters must be given at the same time.\n"
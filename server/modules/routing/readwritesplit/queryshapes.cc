@@ -0,0 +1,191 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "queryshapes.hh"
+
+#include <string.h>
+#include <algorithm>
+
+#include <maxscale/alloc.h>
+#include <maxscale/query_classifier.h>
+
+namespace
+{
+// The weight of a new execution time in the moving average, once there are enough of them.
+const double MIN_ALPHA = 0.1;
+}
+
+void QueryShapes::Profile::add(double secs)
+{
+    ++count;
+    total += secs;
+
+    // Until there are enough samples, this is the plain average.
+    double alpha = std::max(1.0 / count, MIN_ALPHA);
+    average += alpha * (secs - average);
+}
+
+QueryShapes::Profile& QueryShapes::Profile::operator+=(const Profile& rhs)
+{
+    if (count + rhs.count != 0)
+    {
+        average = (average * count + rhs.average * rhs.count) / (count + rhs.count);
+    }
+
+    count += rhs.count;
+    total += rhs.total;
+
+    return *this;
+}
+
+const QueryShapes::Profile* QueryShapes::Shape::find(SERVER* server) const
+{
+    auto it = std::find_if(servers.begin(), servers.end(),
+                           [server](const std::pair<SERVER*, Profile>& p) {
+                               return p.first == server;
+                           });
+
+    return it != servers.end() ? &it->second : nullptr;
+}
+
+const QueryShapes::Shape* QueryShapes::find(uint64_t hash) const
+{
+    auto it = m_shapes.find(hash);
+
+    return it != m_shapes.end() ? &it->second : nullptr;
+}
+
+void QueryShapes::add(uint64_t hash, GWBUF* pStmt)
+{
+    if (m_shapes.find(hash) == m_shapes.end())
+    {
+        if (m_shapes.size() >= MAX_SHAPES)
+        {
+            prune();
+        }
+
+        Shape& shape = m_shapes[hash];
+
+        // Only done once per statement, so the extra allocation does not matter.
+        char* zCanonical = qc_get_canonical(pStmt);
+
+        if (zCanonical)
+        {
+            shape.sql.assign(zCanonical, std::min(strlen(zCanonical), (size_t)MAX_SQL));
+            MXS_FREE(zCanonical);
+        }
+    }
+}
+
+void QueryShapes::add_latency(uint64_t hash, SERVER* server, maxbase::Duration latency)
+{
+    auto it = m_shapes.find(hash);
+
+    if (it != m_shapes.end())
+    {
+        Shape& shape = it->second;
+        double secs = latency.secs();
+
+        shape.profile.add(secs);
+
+        auto jt = std::find_if(shape.servers.begin(), shape.servers.end(),
+                               [server](const std::pair<SERVER*, Profile>& p) {
+                                   return p.first == server;
+                               });
+
+        if (jt == shape.servers.end())
+        {
+            shape.servers.emplace_back(server, Profile());
+            jt = shape.servers.end() - 1;
+        }
+
+        jt->second.add(secs);
+    }
+}
+
+std::vector<const QueryShapes::Shape*> QueryShapes::top(size_t n) const
+{
+    std::vector<const Shape*> rv;
+    rv.reserve(m_shapes.size());
+
+    for (const auto& kv : m_shapes)
+    {
+        rv.push_back(&kv.second);
+    }
+
+    auto by_total = [](const Shape* pLhs, const Shape* pRhs) {
+            return pLhs->profile.total > pRhs->profile.total;
+        };
+
+    n = std::min(n, rv.size());
+    std::partial_sort(rv.begin(), rv.begin() + n, rv.end(), by_total);
+    rv.resize(n);
+
+    return rv;
+}
+
+QueryShapes& QueryShapes::operator+=(const QueryShapes& rhs)
+{
+    for (const auto& kv : rhs.m_shapes)
+    {
+        Shape& shape = m_shapes[kv.first];
+
+        if (shape.sql.empty())
+        {
+            shape.sql = kv.second.sql;
+        }
+
+        shape.profile += kv.second.profile;
+
+        for (const auto& server : kv.second.servers)
+        {
+            auto it = std::find_if(shape.servers.begin(), shape.servers.end(),
+                                   [&server](const std::pair<SERVER*, Profile>& p) {
+                                       return p.first == server.first;
+                                   });
+
+            if (it != shape.servers.end())
+            {
+                it->second += server.second;
+            }
+            else
+            {
+                shape.servers.push_back(server);
+            }
+        }
+    }
+
+    return *this;
+}
+
+/**
+ * Drop the half of the statements with the smallest total execution time.
+ */
+void QueryShapes::prune()
+{
+    std::vector<std::pair<double, uint64_t>> totals;
+    totals.reserve(m_shapes.size());
+
+    for (const auto& kv : m_shapes)
+    {
+        totals.emplace_back(kv.second.profile.total, kv.first);
+    }
+
+    auto middle = totals.begin() + totals.size() / 2;
+    std::nth_element(totals.begin(), middle, totals.end());
+
+    for (auto it = totals.begin(); it != middle; ++it)
+    {
+        m_shapes.erase(it->second);
+    }
+}
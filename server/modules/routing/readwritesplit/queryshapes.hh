@@ -0,0 +1,114 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <maxbase/stopwatch.hh>
+#include <maxscale/buffer.h>
+#include <maxscale/server.h>
+
+/**
+ * Latency profiles of statements, grouped by the hash of their canonical form,
+ * i.e. statements that only differ in their literals share the profile. The
+ * profile is kept both for all servers and for each server separately.
+ *
+ * The number of statements is bounded. When the limit is reached, the half
+ * of the statements with the smallest total execution time is dropped.
+ */
+class QueryShapes
+{
+public:
+    enum
+    {
+        MAX_SHAPES = 1024,  /**< Maximum number of statements */
+        MAX_SQL    = 256    /**< Maximum length of the stored canonical statement */
+    };
+
+    struct Profile
+    {
+        int64_t count = 0;      /**< Number of executions */
+        double  total = 0;      /**< Total execution time in seconds */
+        double  average = 0;    /**< Moving average of the execution time in seconds */
+
+        void     add(double secs);
+        Profile& operator+=(const Profile& rhs);
+    };
+
+    struct Shape
+    {
+        std::string                              sql;       /**< The statement in canonical form */
+        Profile                                  profile;   /**< The profile on all servers */
+        std::vector<std::pair<SERVER*, Profile>> servers;   /**< The profiles on each server */
+
+        /**
+         * @return The profile of the statement on a server, or NULL if the
+         *         statement has not been executed on it.
+         */
+        const Profile* find(SERVER* server) const;
+    };
+
+    using Shapes = std::unordered_map<uint64_t, Shape>;
+
+    /**
+     * Find a statement.
+     *
+     * @param hash  The hash of the canonical statement.
+     *
+     * @return The statement, or NULL if it is not known.
+     */
+    const Shape* find(uint64_t hash) const;
+
+    /**
+     * Add a statement, if it is not already present.
+     *
+     * @param hash   The hash of the canonical statement.
+     * @param pStmt  The statement.
+     */
+    void add(uint64_t hash, GWBUF* pStmt);
+
+    /**
+     * Add the execution time of a statement. Nothing is done if the statement
+     * is not present, e.g. because it has been dropped after it was routed.
+     *
+     * @param hash     The hash of the canonical statement.
+     * @param server   The server the statement was executed on.
+     * @param latency  The execution time.
+     */
+    void add_latency(uint64_t hash, SERVER* server, maxbase::Duration latency);
+
+    /**
+     * Get the statements with the largest total execution time.
+     *
+     * @param n  How many statements to return at most.
+     *
+     * @return The statements, in descending order of total execution time.
+     */
+    std::vector<const Shape*> top(size_t n) const;
+
+    /**
+     * Add the statements of another instance. The size is not limited, so
+     * this should only be used for combining the statements of all workers.
+     */
+    QueryShapes& operator+=(const QueryShapes& rhs);
+
+private:
+    void prune();
+
+    Shapes m_shapes;
+};
@@ -50,6 +50,9 @@ using namespace maxscale;
 /** Maximum number of slaves */
 #define MAX_SLAVE_COUNT "255"
 
+/** How many statements are shown in the diagnostics */
+#define TOP_QUERY_SHAPES 10
+
 // TODO: Don't process parameters in readwritesplit
 static bool handle_max_slaves(Config& config, const char* str)
 {
@@ -76,6 +79,36 @@ static bool handle_max_slaves(Config& config, const char* str)
     return rval;
 }
 
+static json_t* latency_to_json(const maxbase::LatencyHistogram& latency)
+{
+    using std::chrono::duration_cast;
+    using std::chrono::microseconds;
+
+    json_t* obj = json_object();
+    json_object_set_new(obj, "samples", json_real(latency.count()));
+    json_object_set_new(obj, "p50", json_integer(duration_cast<microseconds>(latency.percentile(50)).count()));
+    json_object_set_new(obj, "p90", json_integer(duration_cast<microseconds>(latency.percentile(90)).count()));
+    json_object_set_new(obj, "p99", json_integer(duration_cast<microseconds>(latency.percentile(99)).count()));
+
+    json_t* buckets = json_array();
+
+    for (int i = 0; i < maxbase::LatencyHistogram::N_BUCKETS; ++i)
+    {
+        if (latency.bucket_count(i) > 0)
+        {
+            json_t* bucket = json_object();
+            json_object_set_new(bucket, "lower", json_integer(maxbase::LatencyHistogram::bucket_lower_us(i)));
+            json_object_set_new(bucket, "upper", json_integer(maxbase::LatencyHistogram::bucket_upper_us(i)));
+            json_object_set_new(bucket, "count", json_real(latency.bucket_count(i)));
+            json_array_append_new(buckets, bucket);
+        }
+    }
+
+    json_object_set_new(obj, "buckets", buckets);
+
+    return obj;
+}
+
 RWSplit::RWSplit(SERVICE* service, const Config& config)
     : mxs::Router<RWSplit, RWSplitSession>(service)
     , m_service(service)
@@ -130,6 +163,28 @@ maxscale::SrvStatMap RWSplit::all_server_stats() const
     return stats;
 }
 
+QueryShapes& RWSplit::local_query_shapes()
+{
+    return *m_query_shapes;
+}
+
+SessionCommandInterner& RWSplit::local_sescmd_interner()
+{
+    return *m_sescmd_interner;
+}
+
+QueryShapes RWSplit::all_query_shapes() const
+{
+    QueryShapes shapes;
+
+    for (const auto& a : m_query_shapes.values())
+    {
+        shapes += a;
+    }
+
+    return shapes;
+}
+
 int RWSplit::max_slave_count() const
 {
     int router_nservers = m_service->n_dbref;
@@ -228,6 +283,13 @@ RWSplit* RWSplit::create(SERVICE* service, MXS_CONFIG_PARAMETER* params)
         return NULL;
     }
 
+    if (config.multiplex_idle_time && config.disable_sescmd_history)
+    {
+        MXS_ERROR("Both 'multiplex_idle_time' and 'disable_sescmd_history' are enabled: "
+                  "Released connections cannot be restored without session command history.");
+        return NULL;
+    }
+
     if (config.master_reconnection && config.disable_sescmd_history)
     {
         MXS_ERROR("Both 'master_reconnection' and 'disable_sescmd_history' are enabled: "
@@ -235,6 +297,13 @@ RWSplit* RWSplit::create(SERVICE* service, MXS_CONFIG_PARAMETER* params)
         return NULL;
     }
 
+    if (config.multiplex_idle_time && config.prune_sescmd_history)
+    {
+        MXS_ERROR("Both 'multiplex_idle_time' and 'prune_sescmd_history' are enabled: "
+                  "Released connections cannot be restored from a pruned session command history.");
+        return NULL;
+    }
+
     return new(std::nothrow) RWSplit(service, config);
 }
 
@@ -258,6 +327,9 @@ void RWSplit::diagnostics(DCB* dcb)
     dcb_printf(dcb,
                "\tslave_selection_criteria:  %s\n",
                select_criteria_to_str(cnf.slave_selection_criteria));
+    dcb_printf(dcb,
+               "\ttransaction_replay_checksum: %s\n",
+               cnf.trx_checksum == Trx::CHECKSUM_SHA1 ? "sha1" : "murmur3");
     dcb_printf(dcb,
                "\tmaster_failure_mode:       %s\n",
                failure_mode_to_str(cnf.master_failure_mode));
@@ -279,6 +351,9 @@ void RWSplit::diagnostics(DCB* dcb)
     dcb_printf(dcb,
                "\tdisable_sescmd_history:    %s\n",
                cnf.disable_sescmd_history ? "true" : "false");
+    dcb_printf(dcb,
+               "\tcompact_sescmd_history:    %s\n",
+               cnf.compact_sescmd_history ? "true" : "false");
     dcb_printf(dcb,
                "\tmax_sescmd_history:        %lu\n",
                cnf.max_sescmd_history);
@@ -303,6 +378,18 @@ void RWSplit::diagnostics(DCB* dcb)
     dcb_printf(dcb,
                "\tdelayed_retry_timeout:       %lu\n",
                cnf.delayed_retry_timeout);
+    dcb_printf(dcb,
+               "\tquery_shape_routing:       %s\n",
+               cnf.query_shape_routing ? "true" : "false");
+    dcb_printf(dcb,
+               "\tquery_shape_threshold:       %lu\n",
+               cnf.query_shape_threshold);
+    dcb_printf(dcb,
+               "\tpipeline_queries:          %s\n",
+               cnf.pipeline_queries ? "true" : "false");
+    dcb_printf(dcb,
+               "\tmultiplex_idle_time:       %lu\n",
+               cnf.multiplex_idle_time);
 
     dcb_printf(dcb, "\n");
 
@@ -344,6 +431,30 @@ void RWSplit::diagnostics(DCB* dcb)
                "\tNumber of replayed transactions:        %" PRIu64 "\n",
                stats().n_trx_replay);
 
+    if (stats().n_trx_replay)
+    {
+        dcb_printf(dcb,
+                   "\tAverage size of replayed transactions:  %" PRIu64 " bytes\n",
+                   stats().trx_replay_size / stats().n_trx_replay);
+        dcb_printf(dcb,
+                   "\tAverage transaction replay time:        %.3f ms\n",
+                   stats().trx_replay_time / 1000.0 / stats().n_trx_replay);
+    }
+
+    if (stats().n_trx_logged)
+    {
+        dcb_printf(dcb,
+                   "\tAverage size of stored transactions:    %" PRIu64 " bytes\n",
+                   stats().trx_logged_size / stats().n_trx_logged);
+    }
+
+    if (cnf.multiplex_idle_time)
+    {
+        dcb_printf(dcb,
+                   "\tNumber of released idle connections:    %" PRIu64 "\n",
+                   stats().n_released);
+    }
+
     if (*weightby)
     {
         dcb_printf(dcb,
@@ -388,6 +499,24 @@ void RWSplit::diagnostics(DCB* dcb)
                        cs.ave_session_selects);
         }
     }
+
+    QueryShapes shapes = all_query_shapes();
+    auto top = shapes.top(TOP_QUERY_SHAPES);
+
+    if (!top.empty())
+    {
+        dcb_printf(dcb, "\n    %10s %12s %12s  %s\n", "Count", "Total", "Average", "Statement");
+
+        for (const QueryShapes::Shape* pShape : top)
+        {
+            dcb_printf(dcb,
+                       "    %10ld %11.3fs %11.3fs  %s\n",
+                       pShape->profile.count,
+                       pShape->profile.total,
+                       pShape->profile.average,
+                       pShape->sql.c_str());
+        }
+    }
 }
 
 json_t* RWSplit::diagnostics_json() const
@@ -403,6 +532,11 @@ json_t* RWSplit::diagnostics_json() const
     json_object_set_new(rval, "rw_transactions", json_integer(stats().n_rw_trx));
     json_object_set_new(rval, "ro_transactions", json_integer(stats().n_ro_trx));
     json_object_set_new(rval, "replayed_transactions", json_integer(stats().n_trx_replay));
+    json_object_set_new(rval, "replayed_transactions_size", json_integer(stats().trx_replay_size));
+    json_object_set_new(rval, "replayed_transactions_time_us", json_integer(stats().trx_replay_time));
+    json_object_set_new(rval, "stored_transactions", json_integer(stats().n_trx_logged));
+    json_object_set_new(rval, "stored_transactions_size", json_integer(stats().trx_logged_size));
+    json_object_set_new(rval, "released_connections", json_integer(stats().n_released));
 
     const char* weightby = serviceGetWeightingParameter(service());
 
@@ -425,11 +559,41 @@ json_t* RWSplit::diagnostics_json() const
         json_object_set_new(obj, "avg_sess_duration", json_string(to_string(stats.ave_session_dur).c_str()));
         json_object_set_new(obj, "avg_sess_active_pct", json_real(stats.ave_session_active_pct));
         json_object_set_new(obj, "avg_selects_per_session", json_integer(stats.ave_session_selects));
+        json_object_set_new(obj, "latency", latency_to_json(a.second.latency()));
         json_array_append_new(arr, obj);
     }
 
     json_object_set_new(rval, "server_query_statistics", arr);
 
+    QueryShapes shapes = all_query_shapes();
+    json_t* top = json_array();
+
+    for (const QueryShapes::Shape* pShape : shapes.top(TOP_QUERY_SHAPES))
+    {
+        json_t* obj = json_object();
+        json_object_set_new(obj, "statement", json_string(pShape->sql.c_str()));
+        json_object_set_new(obj, "count", json_integer(pShape->profile.count));
+        json_object_set_new(obj, "total_time", json_real(pShape->profile.total));
+        json_object_set_new(obj, "avg_time", json_real(pShape->profile.average));
+
+        json_t* servers = json_array();
+
+        for (const auto& server : pShape->servers)
+        {
+            json_t* srv = json_object();
+            json_object_set_new(srv, "id", json_string(server.first->name));
+            json_object_set_new(srv, "count", json_integer(server.second.count));
+            json_object_set_new(srv, "total_time", json_real(server.second.total));
+            json_object_set_new(srv, "avg_time", json_real(server.second.average));
+            json_array_append_new(servers, srv);
+        }
+
+        json_object_set_new(obj, "servers", servers);
+        json_array_append_new(top, obj);
+    }
+
+    json_object_set_new(rval, "top_query_shapes", top);
+
     return rval;
 }
 
@@ -495,6 +659,13 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
                 MXS_MODULE_OPT_NONE,
                 slave_selection_criteria_values
             },
+            {
+                "transaction_replay_checksum",
+                MXS_MODULE_PARAM_ENUM,
+                "murmur3",
+                MXS_MODULE_OPT_NONE,
+                trx_checksum_values
+            },
             {
                 "master_failure_mode",
                 MXS_MODULE_PARAM_ENUM,
@@ -506,6 +677,7 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
             {"max_slave_connections",      MXS_MODULE_PARAM_STRING,  MAX_SLAVE_COUNT},
             {"retry_failed_reads",         MXS_MODULE_PARAM_BOOL,    "true"         },
             {"prune_sescmd_history",       MXS_MODULE_PARAM_BOOL,    "false"        },
+            {"compact_sescmd_history",     MXS_MODULE_PARAM_BOOL,    "true"         },
             {"disable_sescmd_history",     MXS_MODULE_PARAM_BOOL,    "false"        },
             {"max_sescmd_history",         MXS_MODULE_PARAM_COUNT,   "50"           },
             {"strict_multi_stmt",          MXS_MODULE_PARAM_BOOL,    "false"        },
@@ -520,6 +692,10 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
             {"transaction_replay",         MXS_MODULE_PARAM_BOOL,    "false"        },
             {"transaction_replay_max_size",MXS_MODULE_PARAM_SIZE,    "1Mi"          },
             {"optimistic_trx",             MXS_MODULE_PARAM_BOOL,    "false"        },
+            {"query_shape_routing",        MXS_MODULE_PARAM_BOOL,    "false"        },
+            {"pipeline_queries",           MXS_MODULE_PARAM_BOOL,    "false"        },
+            {"query_shape_threshold",      MXS_MODULE_PARAM_COUNT,   "100"          },
+            {"multiplex_idle_time",        MXS_MODULE_PARAM_COUNT,   "0"            },
             {MXS_END_MODULE_PARAMS}
         }
     };
@@ -38,6 +38,10 @@
 #include <maxscale/protocol/rwbackend.hh>
 #include <maxscale/session_stats.hh>
 
+#include "queryshapes.hh"
+#include "sescmdinterner.hh"
+#include "trx.hh"
+
 enum backend_type_t
 {
     BE_UNDEFINED = -1,
@@ -66,7 +70,8 @@ enum select_criteria_t
     LEAST_ROUTER_CONNECTIONS,   /**< connections established by this router */
     LEAST_BEHIND_MASTER,
     LEAST_CURRENT_OPERATIONS,
-    ADAPTIVE_ROUTING
+    ADAPTIVE_ROUTING,
+    ADAPTIVE_LATENCY            /**< latency percentiles and current operations */
 };
 
 /**
@@ -96,6 +101,14 @@ static const MXS_ENUM_VALUE slave_selection_criteria_values[] =
     {"LEAST_BEHIND_MASTER",      LEAST_BEHIND_MASTER     },
     {"LEAST_CURRENT_OPERATIONS", LEAST_CURRENT_OPERATIONS},
     {"ADAPTIVE_ROUTING",         ADAPTIVE_ROUTING        },
+    {"ADAPTIVE_LATENCY",         ADAPTIVE_LATENCY        },
+    {NULL}
+};
+
+static const MXS_ENUM_VALUE trx_checksum_values[] =
+{
+    {"sha1",    Trx::CHECKSUM_SHA1   },
+    {"murmur3", Trx::CHECKSUM_MURMUR3},
     {NULL}
 };
 
@@ -134,7 +147,7 @@ static const char gtid_wait_stmt[] =
  */
 using SRWBackendVector = std::vector<mxs::SRWBackend*>;
 using BackendSelectFunction = std::function
-    <SRWBackendVector::iterator (SRWBackendVector& sBackends)>;
+    <SRWBackendVector::iterator (SRWBackendVector& sBackends, const maxscale::SrvStatMap& stats)>;
 BackendSelectFunction get_backend_select_function(select_criteria_t);
 
 struct Config
@@ -152,6 +165,7 @@ struct Config
                 params, "master_failure_mode", master_failure_mode_values))
         , max_sescmd_history(config_get_integer(params, "max_sescmd_history"))
         , prune_sescmd_history(config_get_bool(params, "prune_sescmd_history"))
+        , compact_sescmd_history(config_get_bool(params, "compact_sescmd_history"))
         , disable_sescmd_history(config_get_bool(params, "disable_sescmd_history"))
         , master_accept_reads(config_get_bool(params, "master_accept_reads"))
         , strict_multi_stmt(config_get_bool(params, "strict_multi_stmt"))
@@ -168,7 +182,14 @@ struct Config
         , delayed_retry_timeout(config_get_integer(params, "delayed_retry_timeout"))
         , transaction_replay(config_get_bool(params, "transaction_replay"))
         , trx_max_size(config_get_size(params, "transaction_replay_max_size"))
+        , trx_checksum(
+            (Trx::ChecksumType)config_get_enum(
+                params, "transaction_replay_checksum", trx_checksum_values))
         , optimistic_trx(config_get_bool(params, "optimistic_trx"))
+        , query_shape_routing(config_get_bool(params, "query_shape_routing"))
+        , query_shape_threshold(config_get_integer(params, "query_shape_threshold"))
+        , pipeline_queries(config_get_bool(params, "pipeline_queries"))
+        , multiplex_idle_time(config_get_integer(params, "multiplex_idle_time"))
     {
         if (causal_reads)
         {
@@ -197,6 +218,12 @@ struct Config
             master_reconnection = true;
             master_failure_mode = RW_FAIL_ON_WRITE;
         }
+
+        if (multiplex_idle_time)
+        {
+            // Released connections are taken back into use by reconnecting
+            master_reconnection = true;
+        }
     }
 
     select_criteria_t     slave_selection_criteria;     /**< The slave selection criteria */
@@ -207,6 +234,7 @@ struct Config
     failure_mode master_failure_mode;   /**< Master server failure handling mode */
     uint64_t     max_sescmd_history;    /**< Maximum amount of session commands to store */
     bool         prune_sescmd_history;  /**< Prune session command history */
+    bool         compact_sescmd_history;/**< Remove overridden commands from the history */
     bool         disable_sescmd_history;/**< Disable session command history */
     bool         master_accept_reads;   /**< Use master for reads */
     bool         strict_multi_stmt;     /**< Force non-multistatement queries to be routed to
@@ -226,7 +254,14 @@ struct Config
     uint64_t    delayed_retry_timeout;  /**< How long to delay until an error is returned */
     bool        transaction_replay;     /**< Replay failed transactions */
     size_t      trx_max_size;           /**< Max transaction size for replaying */
+    Trx::ChecksumType trx_checksum;     /**< Checksum used to verify replayed transactions */
     bool        optimistic_trx;         /**< Enable optimistic transactions */
+    bool        query_shape_routing;    /**< Route heavy statements to the fastest slaves */
+    uint64_t    query_shape_threshold;  /**< Average execution time, in milliseconds, above which
+                                         * a statement is heavy */
+    bool        pipeline_queries;       /**< Send queries to a busy server without waiting */
+    uint64_t    multiplex_idle_time;    /**< Seconds after which idle connections are returned to
+                                         * the connection pool, 0 if never */
 };
 
 /**
@@ -240,8 +275,13 @@ struct Stats
     uint64_t n_slave = 0;           /**< Number of stmts sent to slave */
     uint64_t n_all = 0;             /**< Number of stmts sent to all */
     uint64_t n_trx_replay = 0;      /**< Number of replayed transactions */
+    uint64_t trx_replay_size = 0;   /**< Total size of the replayed transactions, in bytes */
+    uint64_t trx_replay_time = 0;   /**< Total time spent replaying transactions, in microseconds */
+    uint64_t n_trx_logged = 0;      /**< Number of completed transactions stored for replay */
+    uint64_t trx_logged_size = 0;   /**< Total size of the stored transactions, in bytes */
     uint64_t n_ro_trx = 0;          /**< Read-only transaction count */
     uint64_t n_rw_trx = 0;          /**< Read-write transaction count */
+    uint64_t n_released = 0;        /**< Idle connections returned to the connection pool */
 };
 
 using maxscale::ServerStats;
@@ -268,6 +308,10 @@ public:
     const Stats&  stats() const;
     SrvStatMap&   local_server_stats();
     SrvStatMap    all_server_stats() const;
+    QueryShapes&  local_query_shapes();
+    QueryShapes   all_query_shapes() const;
+
+    SessionCommandInterner& local_sescmd_interner();
 
     int  max_slave_count() const;
     bool have_enough_servers() const;
@@ -343,10 +387,13 @@ private:
     // Called when worker local data needs to be updated
     static void update_config(void* data);
 
-    SERVICE*                       m_service;   /**< Service where the router belongs*/
-    mxs::rworker_local<Config>     m_config;
-    Stats                          m_stats;
-    mxs::rworker_local<SrvStatMap> m_server_stats;
+    SERVICE*                        m_service;  /**< Service where the router belongs*/
+    mxs::rworker_local<Config>      m_config;
+    Stats                           m_stats;
+    mxs::rworker_local<SrvStatMap>  m_server_stats;
+    mxs::rworker_local<QueryShapes> m_query_shapes;
+
+    mxs::rworker_local<SessionCommandInterner> m_sescmd_interner;
 };
 
 static inline const char* select_criteria_to_str(select_criteria_t type)
@@ -368,6 +415,9 @@ static inline const char* select_criteria_to_str(select_criteria_t type)
     case ADAPTIVE_ROUTING:
         return "ADAPTIVE_ROUTING";
 
+    case ADAPTIVE_LATENCY:
+        return "ADAPTIVE_LATENCY";
+
     default:
         return "UNDEFINED_CRITERIA";
     }
@@ -413,6 +463,7 @@ std::pair<int, int> get_slave_counts(mxs::SRWBackendList& backends, mxs::SRWBack
  *
  * @param backends: vector of SRWBackend
  * @param select:   selection function
+ * @param stats:    server statistics of the current worker
  * @param master_accept_reads: NOTE: even if this is false, in some cases a master can
  *                             still be selected for reads.
  *
@@ -420,8 +471,20 @@ std::pair<int, int> get_slave_counts(mxs::SRWBackendList& backends, mxs::SRWBack
  */
 SRWBackendVector::iterator find_best_backend(SRWBackendVector& backends,
                                              BackendSelectFunction select,
+                                             const SrvStatMap& stats,
                                              bool masters_accepts_reads);
 
+/**
+ * Find the backend that has executed a statement the fastest.
+ *
+ * @param backends: vector of SRWBackend
+ * @param shape:    the profile of the statement
+ *
+ * @return Valid iterator into argument backends, or end(backends) if empty
+ */
+SRWBackendVector::iterator backend_cmp_query_shape(SRWBackendVector& backends,
+                                                   const QueryShapes::Shape& shape);
+
 /*
  * The following are implemented in rwsplit_tmp_table_multi.c
  */
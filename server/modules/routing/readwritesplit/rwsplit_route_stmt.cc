@@ -201,6 +201,8 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
     route_target_t route_target = info.target();
 
     SRWBackend target;
+    bool measure = false;
+    m_query_shape = 0;
 
     if (TARGET_IS_ALL(route_target))
     {
@@ -276,6 +278,12 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
         }
         else if (TARGET_IS_SLAVE(route_target))
         {
+            if (m_config.query_shape_routing && command == MXS_COM_QUERY)
+            {
+                m_query_shape = qc_get_canonical_hash(querybuf);
+                m_query_shapes.add(m_query_shape, querybuf);
+            }
+
             if ((target = handle_slave_is_target(command, stmt_id)))
             {
                 succp = true;
@@ -284,8 +292,7 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
                 if (is_sql)
                 {
                     target->select_started();
-
-                    target->response_stat().query_started();
+                    measure = true;
 
                     if (m_config.retry_failed_reads)
                     {
@@ -344,6 +351,11 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
                 // Target server was found and is in the correct state
                 succp = handle_got_target(querybuf, target, store_stmt);
 
+                if (succp && measure && target->is_waiting_result())
+                {
+                    target->measure_last_query(m_query_shape);
+                }
+
                 if (succp && !is_locked_to_master()
                     && (command == MXS_COM_STMT_EXECUTE || command == MXS_COM_STMT_SEND_LONG_DATA))
                 {
@@ -381,23 +393,13 @@ bool RWSplitSession::route_single_stmt(GWBUF* querybuf)
  *
  * This function removes data duplication by sharing buffers between session
  * commands that have identical data. Only one copy of the actual data is stored
- * for each unique session command.
+ * for each unique session command of all the sessions of the worker.
  *
  * @param sescmd Executed session command
  */
 void RWSplitSession::compress_history(mxs::SSessionCommand& sescmd)
 {
-    auto eq = [&](mxs::SSessionCommand& scmd) {
-            return scmd->eq(*sescmd);
-        };
-
-    auto first = std::find_if(m_sescmd_list.begin(), m_sescmd_list.end(), eq);
-
-    if (first != m_sescmd_list.end())
-    {
-        // Duplicate command, use a reference of the old command instead of duplicating it
-        sescmd->mark_as_duplicate(**first);
-    }
+    m_router->local_sescmd_interner().intern(sescmd);
 }
 
 void RWSplitSession::continue_large_session_write(GWBUF* querybuf, uint32_t type)
@@ -469,7 +471,9 @@ bool RWSplitSession::route_session_write(GWBUF* querybuf, uint8_t command, uint3
         replace_binary_ps_id(querybuf, m_qc.current_route_info().stmt_id());
     }
 
-    /** The SessionCommand takes ownership of the buffer */
+    /** The SessionCommand takes ownership of the buffer. It can stay in the
+     * history for the lifetime of the session, so it must not pin a larger read. */
+    querybuf = gwbuf_make_compact(querybuf);
     uint64_t id = m_sescmd_count++;
     mxs::SSessionCommand sescmd(new mxs::SessionCommand(querybuf, id));
     bool expecting_response = mxs_mysql_command_will_respond(command);
@@ -706,8 +710,20 @@ SRWBackend RWSplitSession::get_slave_backend(int max_rlag)
         }
     }
 
+    BackendSelectFunction select = m_config.backend_select_fct;
+    const QueryShapes::Shape* shape = m_query_shape ? m_query_shapes.find(m_query_shape) : nullptr;
+
+    if (shape && shape->profile.average * 1000 >= m_config.query_shape_threshold)
+    {
+        // A heavy statement, send it to the server that executes it the fastest.
+        select = [shape](SRWBackendVector& backends, const SrvStatMap& stats) {
+                return backend_cmp_query_shape(backends, *shape);
+            };
+    }
+
     SRWBackendVector::const_iterator rval = find_best_backend(candidates,
-                                                              m_config.backend_select_fct,
+                                                              select,
+                                                              m_server_stats,
                                                               m_config.master_accept_reads);
 
     return (rval == candidates.end()) ? SRWBackend() : **rval;
@@ -1212,13 +1228,19 @@ bool RWSplitSession::handle_got_target(GWBUF* querybuf, SRWBackend& target, bool
     bool large_query = is_large_query(querybuf);
 
     /**
-     * We should not be routing a query to a server that is busy processing a result.
-     *
-     * TODO: This effectively disables pipelining of queries, very bad for batch insert performance. Replace
-     *       with proper, per server tracking of which responses need to be sent to the client. This would
-     *       also solve MXS-2009 by speeding up session commands.
+     * We should not be routing a query to a server that is busy processing a result unless
+     * the query is pipelined. The per-server tracking of the replies is done by the backend.
      */
-    mxb_assert(target->get_reply_state() == REPLY_STATE_DONE || m_qc.large_query());
+    bool pipelined = response == mxs::Backend::EXPECT_RESPONSE && target->is_waiting_result();
+    mxb_assert(target->get_reply_state() == REPLY_STATE_DONE || m_qc.large_query() || pipelined);
+
+    if (pipelined)
+    {
+        // Only the last query would be retried, which would leave the client without the
+        // replies to the earlier ones. Pipelined queries are never retried.
+        m_current_query.reset();
+        store = false;
+    }
 
     uint32_t orig_id = 0;
 
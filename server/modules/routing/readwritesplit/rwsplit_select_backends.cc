@@ -77,7 +77,7 @@ SRWBackendVector::iterator best_score(SRWBackendVector& sBackends,
 }
 
 /** Compare number of connections from this router in backend servers */
-SRWBackendVector::iterator backend_cmp_router_conn(SRWBackendVector& sBackends)
+SRWBackendVector::iterator backend_cmp_router_conn(SRWBackendVector& sBackends, const SrvStatMap& stats)
 {
     static auto server_score = [](SERVER_REF* server) {
             return server->server_weight ? (server->connections + 1) / server->server_weight :
@@ -88,7 +88,7 @@ SRWBackendVector::iterator backend_cmp_router_conn(SRWBackendVector& sBackends)
 }
 
 /** Compare number of global connections in backend servers */
-SRWBackendVector::iterator backend_cmp_global_conn(SRWBackendVector& sBackends)
+SRWBackendVector::iterator backend_cmp_global_conn(SRWBackendVector& sBackends, const SrvStatMap& stats)
 {
     static auto server_score = [](SERVER_REF* server) {
             return server->server_weight ? (server->server->stats.n_current + 1) / server->server_weight :
@@ -99,7 +99,7 @@ SRWBackendVector::iterator backend_cmp_global_conn(SRWBackendVector& sBackends)
 }
 
 /** Compare replication lag between backend servers */
-SRWBackendVector::iterator backend_cmp_behind_master(SRWBackendVector& sBackends)
+SRWBackendVector::iterator backend_cmp_behind_master(SRWBackendVector& sBackends, const SrvStatMap& stats)
 {
     static auto server_score = [](SERVER_REF* server) {
             return server->server_weight ? server->server->rlag / server->server_weight :
@@ -110,7 +110,7 @@ SRWBackendVector::iterator backend_cmp_behind_master(SRWBackendVector& sBackends
 }
 
 /** Compare number of current operations in backend servers */
-SRWBackendVector::iterator backend_cmp_current_load(SRWBackendVector& sBackends)
+SRWBackendVector::iterator backend_cmp_current_load(SRWBackendVector& sBackends, const SrvStatMap& stats)
 {
     static auto server_score = [](SERVER_REF* server) {
             return server->server_weight ? (server->server->stats.n_current_ops + 1) / server->server_weight :
@@ -120,7 +120,8 @@ SRWBackendVector::iterator backend_cmp_current_load(SRWBackendVector& sBackends)
     return best_score(sBackends, server_score);
 }
 
-SRWBackendVector::iterator backend_cmp_response_time(SRWBackendVector& sBackends)
+SRWBackendVector::iterator backend_cmp_response_time(SRWBackendVector& sBackends,
+                                                     const SrvStatMap& stats)
 {
     const int SZ = sBackends.size();
     double slot[SZ];
@@ -178,6 +179,122 @@ SRWBackendVector::iterator backend_cmp_response_time(SRWBackendVector& sBackends
     return sBackends.begin() + winner;
 }
 
+namespace
+{
+// Below this many (decayed) samples the latency of a server is not considered
+// to be known. Such a server gets the best score so that it is measured, which
+// also means that a server that has not been used for a while is tried again.
+const double MIN_LATENCY_SAMPLES = 10;
+
+thread_local std::mt19937 latency_engine {std::random_device {}()};
+
+double latency_score(SERVER_REF* server, const SrvStatMap& stats)
+{
+    double score = 0;
+
+    if (!server->server_weight)
+    {
+        score = std::numeric_limits<double>::max();
+    }
+    else
+    {
+        auto it = stats.find(server->server);
+
+        if (it != stats.end() && it->second.latency().count() >= MIN_LATENCY_SAMPLES)
+        {
+            const maxbase::LatencyHistogram& latency = it->second.latency();
+            // The median reflects the typical query, the tail how congested the server is.
+            double secs = (latency.percentile(50).secs() + latency.percentile(99).secs()) / 2;
+
+            score = secs * (server->server->stats.n_current_ops + 1) / server->server_weight;
+        }
+    }
+
+    return score;
+}
+}
+
+/**
+ * Compare the latencies of the backend servers, using the power of two choices:
+ * of two randomly chosen servers, the one with the lower score is selected. That
+ * spreads the load evenly, yet steers it away from the slow servers without
+ * herding all sessions of a worker to the one server that currently is the fastest.
+ */
+SRWBackendVector::iterator backend_cmp_latency(SRWBackendVector& sBackends, const SrvStatMap& stats)
+{
+    auto server_score = [&stats](SERVER_REF* server) {
+            return latency_score(server, stats);
+        };
+
+    auto best = sBackends.end();
+    const size_t SZ = sBackends.size();
+
+    if (SZ <= 2)
+    {
+        best = best_score(sBackends, server_score);
+    }
+    else
+    {
+        size_t first = std::uniform_int_distribution<size_t>(0, SZ - 1)(latency_engine);
+        size_t second = (first + 1 + std::uniform_int_distribution<size_t>(0, SZ - 2)(latency_engine)) % SZ;
+
+        double first_score = server_score((**sBackends[first]).backend());
+        double second_score = server_score((**sBackends[second]).backend());
+
+        if (first_score <= second_score)
+        {
+            best = sBackends.begin() + first;
+        }
+        else
+        {
+            best = sBackends.begin() + second;
+        }
+
+        if (std::min(first_score, second_score) == std::numeric_limits<double>::max())
+        {
+            // Both have a zero weight, try the others.
+            best = best_score(sBackends, server_score);
+        }
+    }
+
+    return best;
+}
+
+namespace
+{
+// Below this many executions on a server, the execution time of a statement
+// on it is not considered to be known and the server is preferred.
+const int64_t MIN_QUERY_SHAPE_SAMPLES = 3;
+
+// How often a heavy statement is routed by the load, so that a server that
+// has become faster since it last executed the statement is noticed.
+const double QUERY_SHAPE_EXPLORE_PROBABILITY = 0.05;
+}
+
+SRWBackendVector::iterator backend_cmp_query_shape(SRWBackendVector& sBackends,
+                                                   const QueryShapes::Shape& shape)
+{
+    auto server_score = [&shape](SERVER_REF* server) {
+            double score = 0;
+            const QueryShapes::Profile* profile = shape.find(server->server);
+
+            if (!server->server_weight)
+            {
+                score = std::numeric_limits<double>::max();
+            }
+            else if (profile && profile->count >= MIN_QUERY_SHAPE_SAMPLES)
+            {
+                score = profile->average * (server->server->stats.n_current_ops + 1) / server->server_weight;
+            }
+
+            return score;
+        };
+
+    return toss() < QUERY_SHAPE_EXPLORE_PROBABILITY ?
+           backend_cmp_current_load(sBackends, SrvStatMap()) :
+           best_score(sBackends, server_score);
+}
+
 BackendSelectFunction get_backend_select_function(select_criteria_t sc)
 {
     switch (sc)
@@ -196,6 +313,9 @@ BackendSelectFunction get_backend_select_function(select_criteria_t sc)
 
     case ADAPTIVE_ROUTING:
         return backend_cmp_response_time;
+
+    case ADAPTIVE_LATENCY:
+        return backend_cmp_latency;
     }
 
     assert(false && "incorrect use of select_criteria_t");
@@ -213,12 +333,14 @@ thread_local std::array<SRWBackendVector, 3> priority_map;
  *
  * @param backends All backends
  * @param select   Server selection function
+ * @param stats    The server statistics of the current worker
  * @param masters_accepts_reads
  *
  * @return iterator to the best slave or backends.end() if none found
  */
 SRWBackendVector::iterator find_best_backend(SRWBackendVector& backends,
                                              BackendSelectFunction select,
+                                             const SrvStatMap& stats,
                                              bool masters_accepts_reads)
 {
     // Group backends by priority. The set of highest priority backends will then compete.
@@ -251,7 +373,7 @@ SRWBackendVector::iterator find_best_backend(SRWBackendVector& backends,
         best_priority = std::min(best_priority, priority);
     }
 
-    auto best = select(priority_map[best_priority]);
+    auto best = select(priority_map[best_priority], stats);
     auto rval = backends.end();
 
     if (best != priority_map[best_priority].end())
@@ -271,9 +393,12 @@ SRWBackendVector::iterator find_best_backend(SRWBackendVector& backends,
  * @brief Log server connections
  *
  * @param criteria Slave selection criteria
- * @param rses     Router client session
+ * @param backends The backends of the session
+ * @param stats    The server statistics of the current worker
  */
-static void log_server_connections(select_criteria_t criteria, const SRWBackendList& backends)
+static void log_server_connections(select_criteria_t criteria,
+                                   const SRWBackendList& backends,
+                                   const SrvStatMap& stats)
 {
     MXS_INFO("Servers and %s connection counts:",
              criteria == LEAST_GLOBAL_CONNECTIONS ? "all MaxScale" : "router");
@@ -329,6 +454,29 @@ static void log_server_connections(select_criteria_t criteria, const SRWBackendL
             }
             break;
 
+        case ADAPTIVE_LATENCY:
+            {
+                auto it = stats.find(b->server);
+                std::ostringstream os;
+
+                if (it != stats.end())
+                {
+                    const maxbase::LatencyHistogram& latency = it->second.latency();
+                    os << latency.percentile(50) << " / " << latency.percentile(99);
+                }
+                else
+                {
+                    os << "- / -";
+                }
+
+                MXS_INFO("latency p50 / p99: %s from \t[%s]:%d %s",
+                         os.str().c_str(),
+                         b->server->address,
+                         b->server->port,
+                         STRSRVSTATUS(b->server));
+            }
+            break;
+
         default:
             mxb_assert(!true);
             break;
@@ -408,7 +556,7 @@ bool RWSplit::select_connect_backend_servers(MXS_SESSION* session,
 
     if (mxs_log_is_priority_enabled(LOG_INFO))
     {
-        log_server_connections(select_criteria, backends);
+        log_server_connections(select_criteria, backends, local_server_stats());
     }
 
     if (type == ALL)
@@ -449,7 +597,7 @@ bool RWSplit::select_connect_backend_servers(MXS_SESSION* session,
 
     while (slaves_connected < max_nslaves && candidates.size())
     {
-        auto ite = m_config->backend_select_fct(candidates);
+        auto ite = m_config->backend_select_fct(candidates, local_server_stats());
         if (ite == candidates.end())
         {
             break;
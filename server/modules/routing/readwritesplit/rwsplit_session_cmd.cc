@@ -13,12 +13,14 @@
 
 #include "readwritesplit.hh"
 #include "rwsplitsession.hh"
+#include "sescmdcompaction.hh"
 
 #include <stdio.h>
 #include <strings.h>
 #include <string.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <ctype.h>
 
 #include <maxscale/router.h>
 
@@ -82,6 +84,43 @@ static void discard_if_response_differs(SRWBackend backend,
     }
 }
 
+/**
+ * Remove the commands from the session command history whose effect a
+ * successfully executed command overrides.
+ *
+ * @param pos  The position of the command that was executed.
+ */
+void RWSplitSession::compact_history(uint64_t pos)
+{
+    size_t n_removed = sescmd_compact_history(&m_sescmd_list, pos);
+
+    if (n_removed)
+    {
+        MXS_INFO("Removed %lu overridden session commands from the history (length: %lu)",
+                 n_removed, m_sescmd_list.size());
+        prune_responses();
+    }
+}
+
+/**
+ * Remove the responses that are not needed anymore: those that no backend is
+ * waiting for and that are not in the session command history.
+ */
+void RWSplitSession::prune_responses()
+{
+    uint64_t lowest_pos = m_sescmd_count;
+
+    for (const auto& backend : m_backends)
+    {
+        if (backend->in_use() && backend->has_session_commands())
+        {
+            lowest_pos = std::min(lowest_pos, backend->next_session_command()->get_position());
+        }
+    }
+
+    sescmd_prune_responses(m_sescmd_list, lowest_pos, &m_sescmd_responses);
+}
+
 void RWSplitSession::process_sescmd_response(SRWBackend& backend, GWBUF** ppPacket)
 {
     if (backend->has_session_commands())
@@ -116,6 +155,11 @@ void RWSplitSession::process_sescmd_response(SRWBackend& backend, GWBUF** ppPack
                  * be compared to it */
                 m_sescmd_responses[id] = cmd;
 
+                if (cmd != MYSQL_REPLY_ERR && m_config.compact_sescmd_history)
+                {
+                    compact_history(id);
+                }
+
                 if (cmd == MYSQL_REPLY_ERR)
                 {
                     MXS_INFO("Session command no. %lu failed: %s",
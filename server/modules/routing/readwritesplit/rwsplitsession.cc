@@ -41,10 +41,18 @@ RWSplitSession::RWSplitSession(RWSplit* instance,
     , m_wait_gtid(NONE)
     , m_next_seq(0)
     , m_qc(this, session, m_config.use_sql_variables_in)
+    , m_classified_query(nullptr)
     , m_retry_duration(0)
+    , m_trx(m_config.trx_checksum)
     , m_is_replay_active(false)
     , m_can_replay_trx(true)
+    , m_replayed_trx(m_config.trx_checksum)
+    , m_orig_trx(m_config.trx_checksum)
     , m_server_stats(instance->local_server_stats())
+    , m_query_shapes(instance->local_query_shapes())
+    , m_query_shape(0)
+    , m_release_dcid(0)
+    , m_released(false)
 {
     if (m_config.rw_max_slave_conn_percent)
     {
@@ -53,6 +61,13 @@ RWSplitSession::RWSplitSession(RWSplit* instance,
         n_conn = MXS_MAX(floor((double)m_nbackends * pct), 1);
         m_config.max_slave_connections = n_conn;
     }
+
+    if (m_config.multiplex_idle_time)
+    {
+        m_release_dcid = mxb::Worker::get_current()->delayed_call(m_config.multiplex_idle_time * 1000,
+                                                                  &RWSplitSession::release_idle_connections,
+                                                                  this);
+    }
 }
 
 RWSplitSession* RWSplitSession::create(RWSplit* router, MXS_SESSION* session)
@@ -107,8 +122,15 @@ void close_all_connections(SRWBackendList& backends)
 
 void RWSplitSession::close()
 {
+    if (m_release_dcid)
+    {
+        mxb::Worker::get_current()->cancel_delayed_call(m_release_dcid);
+        m_release_dcid = 0;
+    }
+
     close_all_connections(m_backends);
     m_current_query.reset();
+    m_classified_query = nullptr;
 
     for (auto& backend : m_backends)
     {
@@ -140,10 +162,19 @@ int32_t RWSplitSession::routeQuery(GWBUF* querybuf)
         return 1;
     }
 
+    if (m_released)
+    {
+        // If the history has to be replayed, the query is queued below until it completes
+        reattach_connections();
+    }
+
+    bool pipelined = false;
+
     if ((m_query_queue.empty() || GWBUF_IS_REPLAYED(querybuf))
         && (m_expected_responses == 0
             || m_qc.load_data_state() == QueryClassifier::LOAD_DATA_ACTIVE
-            || m_qc.large_query()))
+            || m_qc.large_query()
+            || (pipelined = can_pipeline_query(querybuf))))
     {
         /** Gather the information required to make routing decisions */
 
@@ -162,14 +193,41 @@ int32_t RWSplitSession::routeQuery(GWBUF* querybuf)
             current_target = QueryClassifier::CURRENT_TARGET_SLAVE;
         }
 
-        if (!m_qc.large_query())
+        // The route info of the query whose replies are being received
+        QueryClassifier::RouteInfo current_route_info = m_qc.current_route_info();
+
+        if (querybuf == m_classified_query)
+        {
+            // The query was classified when it arrived, before it was queued. Any other query,
+            // e.g. one that is retried or replayed meanwhile, is classified as usual.
+            m_qc.set_route_info(m_classified_route_info);
+            m_classified_query = nullptr;
+        }
+        else if (!m_qc.large_query())
         {
             m_qc.update_route_info(current_target, querybuf);
         }
 
-        /** No active or pending queries */
-        if (route_single_stmt(querybuf))
+        if (pipelined && !is_pipeline_target())
+        {
+            // The query goes elsewhere, the replies to the earlier queries must be received
+            // before it can be routed. The query classification is done in the order the
+            // queries arrive so it is not repeated when the queued query is routed. Until
+            // then, the replies are processed with the route info of the earlier query.
+            MXS_INFO("Storing query (len: %d cmd: %0x), not routed to '%s' where %d replies are expected",
+                     gwbuf_length(querybuf), GWBUF_DATA(querybuf)[4],
+                     m_prev_target->name(), m_expected_responses);
+            mxb_assert(!m_classified_query);
+            m_classified_query = querybuf;
+            m_classified_route_info = m_qc.current_route_info();
+            m_qc.set_route_info(current_route_info);
+            m_query_queue.emplace_back(querybuf);
+            querybuf = NULL;
+            rval = 1;
+        }
+        else if (route_single_stmt(querybuf))
         {
+            /** No active or pending queries */
             rval = 1;
         }
     }
@@ -194,6 +252,158 @@ int32_t RWSplitSession::routeQuery(GWBUF* querybuf)
     return rval;
 }
 
+/**
+ * Check whether a query could be pipelined
+ *
+ * A query can be sent before the replies to the earlier queries are received
+ * only if all of the replies come from one server and the reply to the query
+ * would be read from the same connection after them. The target of the query
+ * is checked after it has been classified with is_pipeline_target().
+ *
+ * @param querybuf The query
+ *
+ * @return True if the query can be pipelined if it is routed to the previous target
+ */
+bool RWSplitSession::can_pipeline_query(GWBUF* querybuf)
+{
+    bool rval = false;
+
+    // Transaction replay and causal reads track the current query which requires serial execution
+    if (m_config.pipeline_queries && !m_config.transaction_replay && !m_config.causal_reads
+        && m_wait_gtid == NONE && m_prev_target && m_prev_target->can_pipeline(querybuf))
+    {
+        rval = std::none_of(m_backends.begin(), m_backends.end(), [this](const SRWBackend& backend) {
+                                return backend != m_prev_target && backend->in_use()
+                                       && backend->is_waiting_result();
+                            });
+    }
+
+    return rval;
+}
+
+/**
+ * Check whether the classified query would be routed to the server the
+ * earlier queries were pipelined to
+ *
+ * @return True if the current query can be routed to the previous target
+ */
+bool RWSplitSession::is_pipeline_target()
+{
+    uint32_t target = m_qc.current_route_info().target();
+    bool rval = false;
+
+    if (TARGET_IS_NAMED_SERVER(target) || TARGET_IS_RLAG_MAX(target) || TARGET_IS_ALL(target))
+    {
+        // Hinted queries and session commands are never pipelined
+    }
+    else if (TARGET_IS_MASTER(target))
+    {
+        rval = m_prev_target == m_current_master && m_prev_target->is_master();
+    }
+    else if (TARGET_IS_SLAVE(target))
+    {
+        // A slave is only known in advance inside a read-only transaction
+        rval = m_target_node == m_prev_target && session_trx_is_read_only(m_client->session);
+    }
+    else if (TARGET_IS_LAST_USED(target))
+    {
+        rval = true;
+    }
+
+    return rval;
+}
+
+bool RWSplitSession::can_release_connections() const
+{
+    // Temporary tables, open cursors of executed prepared statements and the state of
+    // an unfinished transaction only exist on the connection and would be lost
+    return m_expected_responses == 0
+           && m_query_queue.empty()
+           && !session_trx_is_active(m_client->session)
+           && !m_is_replay_active
+           && m_otrx_state == OTRX_INACTIVE
+           && !m_target_node
+           && m_wait_gtid == NONE
+           && !m_qc.large_query()
+           && m_qc.load_data_state() == QueryClassifier::LOAD_DATA_INACTIVE
+           && !m_qc.have_tmp_tables()
+           && m_exec_map.empty()
+           && can_recover_servers()
+           && !m_config.disable_sescmd_history;
+}
+
+bool RWSplitSession::release_idle_connections(mxb::Worker::Call::action_t action)
+{
+    if (action == mxb::Worker::Call::CANCEL)
+    {
+        return false;
+    }
+
+    if (can_release_connections())
+    {
+        /** Each heartbeat is 1/10th of a second */
+        int64_t idle_time = m_config.multiplex_idle_time * 10;
+        int64_t now = mxs_clock();
+
+        for (auto& backend : m_backends)
+        {
+            if (backend->in_use() && !backend->is_waiting_result() && !backend->has_session_commands()
+                && now - backend->dcb()->last_read >= idle_time)
+            {
+                MXS_INFO("Releasing '%s', idle for %ld seconds",
+                         backend->name(),
+                         MXS_CLOCK_TO_SEC(now - backend->dcb()->last_read));
+
+                if (backend == m_prev_target)
+                {
+                    m_prev_target.reset();
+                }
+
+                backend->close(mxs::Backend::CLOSE_IDLE);
+                m_released = true;
+                mxb::atomic::add(&m_router->stats().n_released, 1, mxb::atomic::RELAXED);
+            }
+        }
+    }
+
+    return true;
+}
+
+void RWSplitSession::reattach_connections()
+{
+    m_released = false;
+
+    if (std::none_of(m_backends.begin(), m_backends.end(), [](const SRWBackend& backend) {
+                         return backend->in_use();
+                     }))
+    {
+        // Session commands are only routed to connections that are in use, at least one
+        // is needed. Other connections are taken into use when queries are routed to them.
+        SRWBackend target;
+
+        if (m_current_master && m_current_master->can_connect())
+        {
+            target = m_current_master;
+        }
+        else
+        {
+            for (auto& backend : m_backends)
+            {
+                if (backend->is_slave() && backend->can_connect())
+                {
+                    target = backend;
+                    break;
+                }
+            }
+        }
+
+        if (target && !prepare_target(target, target->is_master() ? TARGET_MASTER : TARGET_SLAVE))
+        {
+            MXS_INFO("Failed to reconnect to '%s'", target->name());
+        }
+    }
+}
+
 /**
  * @brief Route a stored query
  *
@@ -443,11 +653,15 @@ void RWSplitSession::trx_replay_next_stmt()
 
         if (!m_replayed_trx.empty())
         {
-            // Check that the checksums match.
-            SHA1Checksum chksum = m_trx.checksum();
-            chksum.finalize();
+            mxb::atomic::add(&m_router->stats().trx_replay_size, m_replayed_trx.size(),
+                             mxb::atomic::RELAXED);
+            mxb::atomic::add(&m_router->stats().trx_replay_time,
+                             std::chrono::duration_cast<std::chrono::microseconds>(
+                                 m_replay_timer.split()).count(),
+                             mxb::atomic::RELAXED);
 
-            if (chksum == m_replayed_trx.checksum())
+            // Check that the checksums match.
+            if (m_trx.checksum_matches(m_replayed_trx))
             {
                 MXS_INFO("Checksums match, replay successful.");
 
@@ -578,6 +792,33 @@ void RWSplitSession::close_stale_connections()
 }
 
 void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
+{
+    SRWBackend& backend = get_backend_from_dcb(backend_dcb);
+
+    // If queries were pipelined, the buffer can contain the replies to many of them
+    while (writebuf)
+    {
+        GWBUF* rest = NULL;
+        handle_reply(writebuf, backend_dcb, &rest);
+        writebuf = rest;
+
+        if (writebuf && !backend->in_use())
+        {
+            gwbuf_free(writebuf);
+            writebuf = NULL;
+        }
+    }
+}
+
+/**
+ * Handle a reply from a backend
+ *
+ * @param writebuf    The reply
+ * @param backend_dcb The backend DCB
+ * @param ppRest      The replies to the pipelined queries that were in @c writebuf
+ *                    after the reply to the current query
+ */
+void RWSplitSession::handle_reply(GWBUF* writebuf, DCB* backend_dcb, GWBUF** ppRest)
 {
     DCB* client_dcb = backend_dcb->session->client_dcb;
     SRWBackend& backend = get_backend_from_dcb(backend_dcb);
@@ -616,9 +857,11 @@ void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
     // Track transaction contents and handle ROLLBACK with aggressive transaction load balancing
     manage_transactions(backend, writebuf);
 
-    backend->process_reply(writebuf);
+    size_t n_pipelined = backend->pipelined_queries();
+    *ppRest = backend->process_next_reply(&writebuf);
 
-    if (backend->reply_is_complete())
+    // When a reply to a query is complete, the next pipelined query becomes the current one
+    if (backend->reply_is_complete() || backend->pipelined_queries() < n_pipelined)
     {
         /** Got a complete reply, decrement expected response count */
         m_expected_responses--;
@@ -626,7 +869,7 @@ void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
         session_book_server_response(m_pSession, backend->backend()->server, m_expected_responses == 0);
 
         mxb_assert(m_expected_responses >= 0);
-        mxb_assert(backend->get_reply_state() == REPLY_STATE_DONE);
+        mxb_assert(backend->get_reply_state() == REPLY_STATE_DONE || n_pipelined > 0);
         MXS_INFO("Reply complete, last reply from %s", backend->name());
 
         if (m_wait_gtid == RETRYING_ON_MASTER)
@@ -646,8 +889,23 @@ void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
             return;
         }
 
+        // The timing is kept with each query, as the replies to pipelined queries
+        // complete after later queries have been routed.
         ResponseStat& stat = backend->response_stat();
-        stat.query_ended();
+        uint64_t shape = 0;
+        maxbase::Duration latency = backend->completed_query_time(&shape);
+
+        if (latency != maxbase::Duration(0))
+        {
+            stat.add_sample(latency);
+            m_server_stats[backend->server()].add_latency(latency);
+
+            if (shape)
+            {
+                m_query_shapes.add_latency(shape, backend->server(), latency);
+            }
+        }
+
         if (stat.is_valid() && (stat.sync_time_reached()
                                 || server_response_time_num_samples(backend->server()) == 0))
         {
@@ -731,6 +989,13 @@ void RWSplitSession::clientReply(GWBUF* writebuf, DCB* backend_dcb)
     else if (m_config.transaction_replay && session_trx_is_ending(m_client->session))
     {
         MXS_INFO("Transaction complete");
+
+        if (!m_trx.empty())
+        {
+            mxb::atomic::add(&m_router->stats().n_trx_logged, 1, mxb::atomic::RELAXED);
+            mxb::atomic::add(&m_router->stats().trx_logged_size, m_trx.size(), mxb::atomic::RELAXED);
+        }
+
         m_trx.close();
         m_can_replay_trx = true;
     }
@@ -806,6 +1071,7 @@ bool RWSplitSession::start_trx_replay()
         if (!m_is_replay_active)
         {
             // This is the first time we're retrying this transaction, store it and the interrupted query
+            m_replay_timer.restart();
             m_orig_trx = m_trx;
             m_orig_stmt.copy_from(m_current_query);
         }
@@ -817,7 +1083,9 @@ bool RWSplitSession::start_trx_replay()
             m_trx = m_orig_trx;
             m_current_query.copy_from(m_orig_stmt);
 
-            // Erase all replayed queries from the query queue to prevent checksum mismatches
+            // Erase all replayed queries from the query queue to prevent checksum mismatches. The
+            // classification of a queued query is not kept as its buffer may be among them.
+            m_classified_query = nullptr;
             m_query_queue.erase(std::remove_if(m_query_queue.begin(), m_query_queue.end(), [](mxs::Buffer b) {
                                                    return GWBUF_IS_REPLAYED(b.get());
                                                }), m_query_queue.end());
@@ -965,9 +1233,10 @@ void RWSplitSession::handleError(GWBUF* errmsgbuf,
     SRWBackend& backend = get_backend_from_dcb(problem_dcb);
     mxb_assert(backend->in_use());
 
-    if (backend->reply_has_started())
+    if (backend->reply_has_started() || backend->pipelined_queries() > 0)
     {
-        MXS_ERROR("Server '%s' was lost in the middle of a resultset, cannot continue the session: %s",
+        MXS_ERROR("Server '%s' was lost in the middle of a resultset or while pipelined "
+                  "queries were being executed, cannot continue the session: %s",
                   backend->name(), extract_error(errmsgbuf).c_str());
 
         // This effectively causes an instant termination of the client connection and prevents any errors
@@ -13,11 +13,14 @@
 #pragma once
 
 #include "readwritesplit.hh"
+#include "sescmdcompaction.hh"
 #include "trx.hh"
 
 #include <string>
 #include <deque>
 
+#include <maxbase/stopwatch.hh>
+#include <maxbase/worker.hh>
 #include <maxscale/buffer.hh>
 #include <maxscale/modutil.h>
 #include <maxscale/queryclassifier.hh>
@@ -33,7 +36,6 @@
 typedef std::map<uint32_t, uint32_t> ClientHandleMap;   /** External ID to internal ID */
 
 typedef std::unordered_set<std::string> TableSet;
-typedef std::map<uint64_t, uint8_t>     ResponseMap;
 
 /** List of slave responses that arrived before the master */
 typedef std::list<std::pair<mxs::SRWBackend, uint8_t>> SlaveResponseList;
@@ -156,6 +158,10 @@ public:
     wait_gtid_state      m_wait_gtid;           /**< State of MASTER_GTID_WAIT reply */
     uint32_t             m_next_seq;            /**< Next packet's sequence number */
     mxs::QueryClassifier m_qc;                  /**< The query classifier. */
+
+    GWBUF*                          m_classified_query;     /**< Queued query classified on arrival */
+    mxs::QueryClassifier::RouteInfo m_classified_route_info;/**< The route info of m_classified_query */
+
     uint64_t             m_retry_duration;      /**< Total time spent retrying queries */
     mxs::Buffer          m_current_query;       /**< Current query being executed */
     Trx                  m_trx;                 /**< Current transaction */
@@ -166,12 +172,17 @@ public:
     mxs::Buffer m_interrupted_query;            /**< Query that was interrupted mid-transaction. */
     Trx         m_orig_trx;                     /**< The backup of the transaction we're replaying */
     mxs::Buffer m_orig_stmt;                    /**< The backup of the statement that was interrupted */
+    mxb::StopWatch m_replay_timer;              /**< Measures the duration of a transaction replay */
 
     otrx_state m_otrx_state = OTRX_INACTIVE;    /**< Optimistic trx state*/
 
     SrvStatMap& m_server_stats;     /**< The server stats local to this thread, cached in the session object.
                                      * This avoids the lookup involved in getting the worker-local value from
                                      * the worker's container.*/
+    QueryShapes& m_query_shapes;    /**< The statement profiles local to this thread */
+    uint64_t     m_query_shape;     /**< Canonical hash of the statement being routed, 0 if not profiled */
+    uint32_t     m_release_dcid;    /**< Delayed call that releases idle connections, 0 if none */
+    bool         m_released;        /**< Whether idle connections have been released */
 
 private:
     RWSplitSession(RWSplit* instance,
@@ -181,6 +192,8 @@ private:
 
     void process_sescmd_response(mxs::SRWBackend& backend, GWBUF** ppPacket);
     void compress_history(mxs::SSessionCommand& sescmd);
+    void compact_history(uint64_t pos);
+    void prune_responses();
 
     void prune_to_position(uint64_t pos);
     bool route_session_write(GWBUF* querybuf, uint8_t command, uint32_t type);
@@ -188,6 +201,9 @@ private:
     bool route_single_stmt(GWBUF* querybuf);
     bool route_stored_query();
     void close_stale_connections();
+    bool can_pipeline_query(GWBUF* querybuf);
+    bool is_pipeline_target();
+    void handle_reply(GWBUF* writebuf, DCB* backend_dcb, GWBUF** ppRest);
 
     mxs::SRWBackend get_hinted_backend(const char* name);
     mxs::SRWBackend get_slave_backend(int max_rlag);
@@ -232,6 +248,25 @@ private:
 
     void trx_replay_next_stmt();
 
+    /**
+     * Return idle connections to the connection pool of the worker
+     *
+     * Called periodically when `multiplex_idle_time` is enabled. A connection
+     * is released only if the session has no state that the session command
+     * history cannot restore.
+     *
+     * @param action Whether the call is executed or cancelled
+     *
+     * @return True if the call should be repeated
+     */
+    bool release_idle_connections(mxb::Worker::Call::action_t action);
+
+    // Whether the connections of the session can be released
+    bool can_release_connections() const;
+
+    // Take a connection back into use if all of them have been released
+    void reattach_connections();
+
     // Do we have at least one open slave connection
     bool have_connected_slaves() const;
 
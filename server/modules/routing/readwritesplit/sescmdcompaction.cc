@@ -0,0 +1,404 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "sescmdcompaction.hh"
+
+#include <ctype.h>
+#include <string.h>
+#include <strings.h>
+
+#include <algorithm>
+
+#include <maxscale/protocol/mysql.h>
+
+namespace
+{
+
+/**
+ * A minimal scanner for the session commands whose effect can be overridden
+ * by a later command.
+ */
+class SescmdScanner
+{
+public:
+    SescmdScanner(const std::string& sql)
+        : m_pI(sql.c_str())
+        , m_pEnd(sql.c_str() + sql.length())
+    {
+    }
+
+    void skip_space()
+    {
+        while (m_pI < m_pEnd && isspace(*m_pI))
+        {
+            ++m_pI;
+        }
+    }
+
+    // Consume a keyword, case-insensitively. It must not be followed by an identifier character.
+    bool keyword(const char* zKeyword)
+    {
+        const char* pI = m_pI;
+
+        while (*zKeyword && pI < m_pEnd && toupper(*pI) == *zKeyword)
+        {
+            ++pI;
+            ++zKeyword;
+        }
+
+        bool rv = !*zKeyword && !(pI < m_pEnd && is_ident(*pI));
+
+        if (rv)
+        {
+            m_pI = pI;
+        }
+
+        return rv;
+    }
+
+    // Consume two keywords separated by whitespace, or neither of them.
+    bool keywords(const char* zFirst, const char* zSecond)
+    {
+        const char* pI = m_pI;
+        bool rv = keyword(zFirst);
+
+        if (rv)
+        {
+            skip_space();
+            rv = keyword(zSecond);
+        }
+
+        if (!rv)
+        {
+            m_pI = pI;
+        }
+
+        return rv;
+    }
+
+    bool prefix(const char* zPrefix)
+    {
+        size_t len = strlen(zPrefix);
+        bool rv = (size_t)(m_pEnd - m_pI) >= len && strncasecmp(m_pI, zPrefix, len) == 0;
+
+        if (rv)
+        {
+            m_pI += len;
+        }
+
+        return rv;
+    }
+
+    bool identifier(std::string* pName)
+    {
+        const char* pStart = m_pI;
+
+        if (m_pI < m_pEnd && *m_pI == '`')
+        {
+            const char* pClose = static_cast<const char*>(memchr(m_pI + 1, '`', m_pEnd - m_pI - 1));
+
+            if (pClose && pClose > m_pI + 1)
+            {
+                pName->assign(m_pI + 1, pClose);
+                m_pI = pClose + 1;
+            }
+        }
+        else
+        {
+            while (m_pI < m_pEnd && is_ident(*m_pI))
+            {
+                ++m_pI;
+            }
+
+            pName->assign(pStart, m_pI);
+        }
+
+        for (auto& c : *pName)
+        {
+            c = tolower(c);
+        }
+
+        return m_pI != pStart;
+    }
+
+    // A single-quoted string, a number or a word such as ON or DEFAULT. Double-quoted
+    // strings are not accepted, they are identifiers if ANSI_QUOTES is enabled.
+    bool literal()
+    {
+        const char* pStart = m_pI;
+
+        if (m_pI < m_pEnd && *m_pI == '\'')
+        {
+            char quote = *m_pI++;
+            bool closed = false;
+
+            while (m_pI < m_pEnd && !closed)
+            {
+                if (*m_pI == '\\' && m_pI + 1 < m_pEnd)
+                {
+                    m_pI += 2;
+                }
+                else if (*m_pI == quote)
+                {
+                    ++m_pI;
+
+                    if (m_pI < m_pEnd && *m_pI == quote)
+                    {
+                        ++m_pI;
+                    }
+                    else
+                    {
+                        closed = true;
+                    }
+                }
+                else
+                {
+                    ++m_pI;
+                }
+            }
+
+            if (!closed)
+            {
+                m_pI = pStart;
+            }
+        }
+        else
+        {
+            if (m_pI < m_pEnd && (*m_pI == '-' || *m_pI == '+'))
+            {
+                ++m_pI;
+            }
+
+            while (m_pI < m_pEnd && (is_ident(*m_pI) || *m_pI == '.'))
+            {
+                ++m_pI;
+            }
+        }
+
+        return m_pI != pStart;
+    }
+
+    bool at_end()
+    {
+        skip_space();
+
+        if (m_pI < m_pEnd && *m_pI == ';')
+        {
+            ++m_pI;
+            skip_space();
+        }
+
+        return m_pI == m_pEnd;
+    }
+
+private:
+    static bool is_ident(char c)
+    {
+        return isalnum(c) || c == '_' || c == '$';
+    }
+
+    const char* m_pI;
+    const char* m_pEnd;
+};
+}
+
+std::string sescmd_set_statement_key(const std::string& sql)
+{
+    std::string key;
+    SescmdScanner scanner(sql);
+
+    scanner.skip_space();
+
+    if (scanner.keyword("SET"))
+    {
+        scanner.skip_space();
+
+        std::string name;
+        bool ok = false;
+
+        if (scanner.keyword("NAMES"))
+        {
+            scanner.skip_space();
+            name = "names";
+            ok = scanner.literal();
+
+            scanner.skip_space();
+
+            if (ok && scanner.keyword("COLLATE"))
+            {
+                scanner.skip_space();
+                ok = scanner.literal();
+            }
+        }
+        else if (scanner.keyword("CHARSET") || scanner.keywords("CHARACTER", "SET"))
+        {
+            scanner.skip_space();
+            name = "charset";
+            ok = scanner.literal();
+        }
+        else
+        {
+            std::string prefix;
+
+            if (scanner.prefix("@@SESSION.") || scanner.prefix("@@LOCAL.") || scanner.prefix("@@"))
+            {
+                // Global variables are not included, their values are not specific to the session.
+                ok = !scanner.prefix("GLOBAL.");
+            }
+            else if (scanner.prefix("@"))
+            {
+                prefix = "@";
+                ok = true;
+            }
+            else if (scanner.keyword("SESSION") || scanner.keyword("LOCAL"))
+            {
+                scanner.skip_space();
+                ok = true;
+            }
+            else
+            {
+                ok = !scanner.keyword("GLOBAL");
+            }
+
+            ok = ok && scanner.identifier(&name);
+            name = prefix + name;
+
+            scanner.skip_space();
+
+            if (ok && (scanner.prefix(":=") || scanner.prefix("=")))
+            {
+                scanner.skip_space();
+                ok = scanner.literal();
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+
+        if (ok && scanner.at_end())
+        {
+            key = name;
+        }
+    }
+    else if (scanner.keyword("USE"))
+    {
+        scanner.skip_space();
+        std::string name;
+
+        if (scanner.identifier(&name) && scanner.at_end())
+        {
+            key = "use";
+        }
+    }
+
+    return key;
+}
+
+std::string sescmd_override_key(mxs::SessionCommand& sescmd)
+{
+    std::string key;
+
+    switch (sescmd.get_command())
+    {
+    case MXS_COM_INIT_DB:
+        key = "use";
+        break;
+
+    case MXS_COM_QUERY:
+        key = sescmd_set_statement_key(sescmd.to_string());
+        break;
+
+    default:
+        break;
+    }
+
+    return key;
+}
+
+bool sescmd_is_barrier_key(const std::string& key)
+{
+    return key == "names"
+           || key == "charset"
+           || key == "character_set_client"
+           || key == "character_set_connection"
+           || key == "character_set_results"
+           || key == "collation_connection"
+           || key == "sql_mode";
+}
+
+size_t sescmd_compact_history(mxs::SessionCommandList* pList, uint64_t pos)
+{
+    auto it = std::find_if(pList->rbegin(), pList->rend(),
+                           [pos](const mxs::SSessionCommand& sescmd) {
+                               return sescmd->get_position() == pos;
+                           });
+
+    std::string key = it != pList->rend() ? sescmd_override_key(**it) : "";
+    size_t n_removed = 0;
+
+    if (!key.empty())
+    {
+        // Only commands that do not depend on earlier ones may be skipped over. The
+        // character set and the sql_mode are not skipped over in either direction, as
+        // they affect how the literals of the commands in between are interpreted.
+        for (auto jt = std::next(it); jt != pList->rend();)
+        {
+            std::string other = sescmd_override_key(**jt);
+
+            if (other.empty())
+            {
+                break;
+            }
+            else if (other == key)
+            {
+                jt = decltype(jt)(pList->erase(std::next(jt).base()));
+                ++n_removed;
+            }
+            else if (sescmd_is_barrier_key(key) || sescmd_is_barrier_key(other))
+            {
+                break;
+            }
+            else
+            {
+                ++jt;
+            }
+        }
+    }
+
+    return n_removed;
+}
+
+void sescmd_prune_responses(const mxs::SessionCommandList& list, uint64_t lowest_pos,
+                            ResponseMap* pResponses)
+{
+    auto it = list.begin();
+    auto jt = pResponses->begin();
+
+    while (jt != pResponses->end() && jt->first < lowest_pos)
+    {
+        while (it != list.end() && (*it)->get_position() < jt->first)
+        {
+            ++it;
+        }
+
+        if (it != list.end() && (*it)->get_position() == jt->first)
+        {
+            ++jt;
+        }
+        else
+        {
+            jt = pResponses->erase(jt);
+        }
+    }
+}
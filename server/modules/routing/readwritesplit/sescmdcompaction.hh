@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+
+#include <map>
+#include <string>
+
+#include <maxscale/session_command.hh>
+
+/** Map of the master's response to each session command, by position */
+typedef std::map<uint64_t, uint8_t> ResponseMap;
+
+/**
+ * Get the key of a SET or USE statement whose effect a later statement with
+ * the same key overrides.
+ *
+ * @param sql  The statement.
+ *
+ * @return The variable the statement assigns, "names" for SET NAMES, "charset"
+ *         for SET CHARACTER SET, "use" for USE, or an empty string if the
+ *         statement is not of the form SET [SESSION] var = literal.
+ */
+std::string sescmd_set_statement_key(const std::string& sql);
+
+/**
+ * Get the key of a session command whose effect a later command with the same
+ * key overrides: the command either sets the default database or a single
+ * variable to a literal value. Commands that may depend on the session state,
+ * and thus on earlier commands, have no key.
+ *
+ * @param sescmd  The session command.
+ *
+ * @return The key of the command, or an empty string.
+ */
+std::string sescmd_override_key(mxs::SessionCommand& sescmd);
+
+/**
+ * Check whether a key belongs to a command that changes how the literals of
+ * later commands are interpreted, that is, the character set or the sql_mode
+ * (e.g. NO_BACKSLASH_ESCAPES or ANSI_QUOTES) of the connection. Such a command
+ * is a barrier compaction never crosses.
+ *
+ * @param key  A key returned by @c sescmd_override_key.
+ *
+ * @return True, if the command is a barrier.
+ */
+bool sescmd_is_barrier_key(const std::string& key);
+
+/**
+ * Remove the commands from a session command history whose effect a
+ * successfully executed command overrides.
+ *
+ * @param pList  The session command history.
+ * @param pos    The position of the command that was executed.
+ *
+ * @return The number of removed commands.
+ */
+size_t sescmd_compact_history(mxs::SessionCommandList* pList, uint64_t pos);
+
+/**
+ * Remove the responses that are not needed anymore: those before a position
+ * whose commands are not in the session command history.
+ *
+ * @param list        The session command history.
+ * @param lowest_pos  The position of the first command a backend may still be waiting for.
+ * @param pResponses  The responses to prune.
+ */
+void sescmd_prune_responses(const mxs::SessionCommandList& list, uint64_t lowest_pos,
+                            ResponseMap* pResponses);
@@ -0,0 +1,83 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "sescmdinterner.hh"
+
+namespace
+{
+
+size_t hash_of(const mxs::Buffer& buffer)
+{
+    // FNV-1a, session commands are short.
+    size_t hash = 14695981039346656037ULL;
+
+    for (auto it = buffer.begin(); it != buffer.end(); ++it)
+    {
+        hash ^= *it;
+        hash *= 1099511628211ULL;
+    }
+
+    return hash;
+}
+}
+
+void SessionCommandInterner::intern(const mxs::SSessionCommand& sescmd)
+{
+    size_t hash = hash_of(sescmd->get_buffer());
+    auto range = m_commands.equal_range(hash);
+    bool found = false;
+
+    for (auto it = range.first; it != range.second; ++it)
+    {
+        if (it->second->eq(*sescmd))
+        {
+            sescmd->mark_as_duplicate(*it->second);
+            found = true;
+            break;
+        }
+    }
+
+    if (!found)
+    {
+        if (m_commands.size() >= MAX_COMMANDS)
+        {
+            prune();
+        }
+
+        // If all commands are still in use, the command is simply not interned.
+        if (m_commands.size() < MAX_COMMANDS)
+        {
+            m_commands.emplace(hash, sescmd);
+        }
+    }
+}
+
+/**
+ * Remove the commands whose sessions have ended. The buffers may still be shared
+ * by commands of other sessions, but the next identical command will take the
+ * place of the removed one.
+ */
+void SessionCommandInterner::prune()
+{
+    for (auto it = m_commands.begin(); it != m_commands.end();)
+    {
+        if (it->second.use_count() == 1)
+        {
+            it = m_commands.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
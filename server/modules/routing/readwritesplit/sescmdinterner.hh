@@ -0,0 +1,59 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+#pragma once
+
+#include <maxscale/ccdefs.hh>
+
+#include <unordered_map>
+
+#include <maxscale/session_command.hh>
+
+/**
+ * Makes identical session commands of different sessions share their buffers.
+ * Connection pools typically execute the same session commands on each of
+ * their connections, so without sharing the memory used by the session command
+ * histories grows with the number of connections.
+ *
+ * As buffers may only be used by the worker that created them, each worker
+ * must have an instance of its own.
+ */
+class SessionCommandInterner
+{
+public:
+    enum
+    {
+        MAX_COMMANDS = 1024     /**< Maximum number of distinct commands */
+    };
+
+    /**
+     * Intern a session command. If an identical command has been interned,
+     * the command will share its buffer, otherwise it will be the command
+     * later commands share their buffer with.
+     *
+     * @param sescmd  The session command.
+     */
+    void intern(const mxs::SSessionCommand& sescmd);
+
+    /**
+     * @return The number of interned commands.
+     */
+    size_t size() const
+    {
+        return m_commands.size();
+    }
+
+private:
+    void prune();
+
+    std::unordered_multimap<size_t, mxs::SSessionCommand> m_commands;
+};
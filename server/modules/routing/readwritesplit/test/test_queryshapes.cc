@@ -0,0 +1,252 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../readwritesplit.hh"
+
+#include <chrono>
+#include <iostream>
+
+#include <maxscale/alloc.h>
+#include <maxscale/log.h>
+#include <maxscale/modutil.h>
+#include <maxscale/paths.h>
+#include <maxscale/query_classifier.h>
+
+using namespace std;
+using mxs::RWBackend;
+using mxs::SRWBackend;
+
+namespace
+{
+
+// Enough rounds for the occasional exploration of the other servers to show up.
+const int N_ROUNDS = 1000;
+
+int expect(bool cond, const string& what)
+{
+    if (!cond)
+    {
+        cout << "error: " << what << endl;
+    }
+
+    return cond ? 0 : 1;
+}
+
+maxbase::Duration millis(int64_t ms)
+{
+    return std::chrono::milliseconds(ms);
+}
+
+bool equal(double lhs, double rhs)
+{
+    return lhs - rhs < 1e-9 && rhs - lhs < 1e-9;
+}
+
+int test_add_find()
+{
+    int rv = 0;
+    QueryShapes shapes;
+    SERVER a = {};
+    SERVER b = {};
+    SERVER c = {};
+
+    GWBUF* pStmt = modutil_create_query("SELECT * FROM t1 WHERE id = 1");
+    shapes.add(1, pStmt);
+    gwbuf_free(pStmt);
+
+    const QueryShapes::Shape* pShape = shapes.find(1);
+
+    rv += expect(pShape, "An added statement should be found");
+    rv += expect(!shapes.find(2), "A statement that was not added should not be found");
+
+    if (pShape)
+    {
+        rv += expect(pShape->sql == "SELECT * FROM t1 WHERE id = ?",
+                     "The statement should be stored in canonical form, got '" + pShape->sql + "'");
+
+        shapes.add_latency(1, &a, millis(10));
+        shapes.add_latency(1, &a, millis(30));
+        shapes.add_latency(1, &b, millis(100));
+        shapes.add_latency(2, &a, millis(1000));
+
+        rv += expect(!shapes.find(2), "The latency of an unknown statement should be ignored");
+        rv += expect(pShape->profile.count == 3, "All executions should be counted");
+        rv += expect(equal(pShape->profile.total, 0.14), "The execution times should be summed");
+
+        const QueryShapes::Profile* pA = pShape->find(&a);
+        const QueryShapes::Profile* pB = pShape->find(&b);
+
+        rv += expect(pA && pA->count == 2 && equal(pA->average, 0.02),
+                     "The executions should be averaged per server");
+        rv += expect(pB && pB->count == 1 && equal(pB->average, 0.1),
+                     "Each server should have a profile of its own");
+        rv += expect(!pShape->find(&c),
+                     "A server that has not executed the statement should have no profile");
+
+        pStmt = modutil_create_query("SELECT * FROM t1 WHERE id = 2");
+        shapes.add(1, pStmt);
+        gwbuf_free(pStmt);
+
+        rv += expect(shapes.find(1) == pShape && pShape->profile.count == 3,
+                     "Adding a known statement should keep its profile");
+    }
+
+    return rv;
+}
+
+int test_prune()
+{
+    int rv = 0;
+    QueryShapes shapes;
+    SERVER server = {};
+    GWBUF* pStmt = modutil_create_query("SELECT 1");
+
+    // Statement i has a total execution time of i + 1 milliseconds.
+    for (uint64_t i = 0; i < QueryShapes::MAX_SHAPES; ++i)
+    {
+        shapes.add(i, pStmt);
+        shapes.add_latency(i, &server, millis(i + 1));
+    }
+
+    rv += expect(shapes.find(0) && shapes.find(QueryShapes::MAX_SHAPES - 1),
+                 "Up to MAX_SHAPES statements should be kept");
+
+    shapes.add(QueryShapes::MAX_SHAPES, pStmt);
+    gwbuf_free(pStmt);
+
+    rv += expect(!shapes.find(0) && !shapes.find(QueryShapes::MAX_SHAPES / 2 - 1),
+                 "The half of the statements with the smallest total should be dropped");
+    rv += expect(shapes.find(QueryShapes::MAX_SHAPES / 2) && shapes.find(QueryShapes::MAX_SHAPES - 1),
+                 "The half of the statements with the largest total should be kept");
+    rv += expect(shapes.find(QueryShapes::MAX_SHAPES), "The added statement should be kept");
+
+    auto top = shapes.top(2);
+
+    rv += expect(top.size() == 2
+                 && top[0] == shapes.find(QueryShapes::MAX_SHAPES - 1)
+                 && top[1] == shapes.find(QueryShapes::MAX_SHAPES - 2),
+                 "The statements with the largest total should be first");
+
+    return rv;
+}
+
+int test_select()
+{
+    int rv = 0;
+    SERVER fast = {};
+    SERVER slow = {};
+    SERVER unknown = {};
+    SERVER_REF refs[3] = {};
+    SERVER* servers[3] = {&fast, &slow, &unknown};
+    SRWBackend backends[3];
+
+    for (int i = 0; i < 3; ++i)
+    {
+        refs[i].server = servers[i];
+        refs[i].server_weight = 1;
+        refs[i].active = true;
+        backends[i] = SRWBackend(new RWBackend(&refs[i]));
+    }
+
+    QueryShapes shapes;
+    GWBUF* pStmt = modutil_create_query("SELECT * FROM t1 WHERE id = 1");
+    shapes.add(1, pStmt);
+    gwbuf_free(pStmt);
+
+    for (int i = 0; i < 3; ++i)
+    {
+        shapes.add_latency(1, &fast, millis(1));
+        shapes.add_latency(1, &slow, millis(100));
+    }
+
+    // By the current load alone, the slow server would be chosen.
+    fast.stats.n_current_ops = 5;
+
+    const QueryShapes::Shape& shape = *shapes.find(1);
+    SRWBackendVector candidates = {&backends[0], &backends[1]};
+    int n_fast = 0;
+    int n_slow = 0;
+
+    for (int i = 0; i < N_ROUNDS; ++i)
+    {
+        auto it = backend_cmp_query_shape(candidates, shape);
+        n_fast += it == candidates.begin();
+        n_slow += it == candidates.begin() + 1;
+    }
+
+    rv += expect(n_fast > N_ROUNDS * 9 / 10,
+                 "The server that executes the statement the fastest should be chosen");
+    rv += expect(n_slow > 0, "The other servers should be tried now and then");
+
+    // A single slow execution is not enough for the time to be considered known.
+    shapes.add_latency(1, &unknown, millis(1000));
+    candidates.push_back(&backends[2]);
+    int n_unknown = 0;
+
+    for (int i = 0; i < N_ROUNDS; ++i)
+    {
+        n_unknown += backend_cmp_query_shape(candidates, shape) == candidates.begin() + 2;
+    }
+
+    rv += expect(n_unknown > N_ROUNDS * 9 / 10,
+                 "A server that has not executed the statement enough times should be preferred");
+
+    refs[1].server_weight = 0;
+    candidates.pop_back();
+    n_slow = 0;
+
+    for (int i = 0; i < N_ROUNDS; ++i)
+    {
+        n_slow += backend_cmp_query_shape(candidates, shape) == candidates.begin() + 1;
+    }
+
+    rv += expect(n_slow == 0, "A server with a zero weight should not be chosen");
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = EXIT_FAILURE;
+
+    if (mxs_log_init(NULL, ".", MXS_LOG_TARGET_DEFAULT))
+    {
+        set_libdir(MXS_STRDUP_A("../../../../../query_classifier/qc_sqlite/"));
+
+        if (qc_init(NULL, QC_SQL_MODE_DEFAULT, "qc_sqlite", ""))
+        {
+            int errors = 0;
+
+            errors += test_add_find();
+            errors += test_prune();
+            errors += test_select();
+
+            rv = errors == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+
+            qc_end();
+        }
+        else
+        {
+            cerr << "error: Could not initialize the query classifier." << endl;
+        }
+
+        mxs_log_finish();
+    }
+    else
+    {
+        cerr << "error: Could not initialize log." << endl;
+    }
+
+    return rv;
+}
@@ -0,0 +1,346 @@
+/*
+ * Copyright (c) 2018 MariaDB Corporation Ab
+ *
+ * Use of this software is governed by the Business Source License included
+ * in the LICENSE.TXT file and at www.mariadb.com/bsl11.
+ *
+ * Change Date: 2022-01-01
+ *
+ * On the date above, in accordance with the Business Source License, use
+ * of this software will be governed by version 2 or later of the General
+ * Public License.
+ */
+
+#include "../sescmdcompaction.hh"
+
+#include <string.h>
+#include <iostream>
+#include <vector>
+
+#include <maxscale/buffer.h>
+#include <maxscale/modutil.h>
+#include <maxscale/protocol/mysql.h>
+
+using namespace std;
+
+namespace
+{
+
+int test_set_statement_key()
+{
+    struct
+    {
+        const char* zSql;
+        const char* zKey;
+    } tests[] =
+    {
+        {"SET autocommit=1",                          "autocommit"   },
+        {"set AutoCommit = 0;",                       "autocommit"   },
+        {"SET SESSION sql_mode = 'ANSI'",             "sql_mode"     },
+        {"SET LOCAL sql_mode='ANSI' ; ",              "sql_mode"     },
+        {"SET @@session.sql_mode='ANSI'",             "sql_mode"     },
+        {"SET @@local.sql_mode='ANSI'",               "sql_mode"     },
+        {"SET @@sql_mode='ANSI'",                     "sql_mode"     },
+        {"SET `sql_mode`='ANSI'",                     "sql_mode"     },
+        {"SET @a = 1",                                "@a"           },
+        {"SET @A := -1.5",                            "@a"           },
+        {"SET @a = 'it''s'",                          "@a"           },
+        {"SET @a = 'it\\'s'",                         "@a"           },
+        {"SET NAMES utf8",                            "names"        },
+        {"SET NAMES 'utf8mb4' COLLATE 'utf8mb4_bin'", "names"        },
+        {"SET CHARACTER SET latin1",                  "charset"      },
+        {"SET character  set latin1",                 "charset"      },
+        {"SET CHARSET DEFAULT",                       "charset"      },
+        {"SET character_set_client = latin1",         "character_set_client"},
+        {"USE test",                                  "use"          },
+        {"USE `test`;",                               "use"          },
+        // Statements that must not be compacted.
+        {"SET GLOBAL sql_mode='ANSI'",                ""             },
+        {"SET @@global.sql_mode='ANSI'",              ""             },
+        {"SET autocommit=1, sql_mode='ANSI'",         ""             },
+        {"SET @a = @b",                               ""             },
+        {"SET @a = (SELECT 1)",                       ""             },
+        {"SET @a = CONCAT('a', 'b')",                 ""             },
+        {"SET @a = 'unterminated",                    ""             },
+        {"SET @a = \"quoted\"",                       ""             },
+        {"SET CHARACTER latin1",                      ""             },
+        {"SET autocommit",                            ""             },
+        {"SELECT 1",                                  ""             },
+        {"USE test; SELECT 1",                        ""             },
+        {"SETautocommit=1",                           ""             },
+    };
+
+    int rv = 0;
+
+    for (const auto& test : tests)
+    {
+        string key = sescmd_set_statement_key(test.zSql);
+
+        if (key != test.zKey)
+        {
+            cout << "error: Expected key '" << test.zKey << "' for `" << test.zSql << "`, got '"
+                 << key << "'." << endl;
+            ++rv;
+        }
+    }
+
+    return rv;
+}
+
+class History
+{
+public:
+    History()
+        : m_pos(0)
+    {
+    }
+
+    // Add a COM_QUERY to the history.
+    void add(const char* zSql)
+    {
+        m_list.emplace_back(new mxs::SessionCommand(modutil_create_query(zSql), ++m_pos));
+        m_responses[m_pos] = MYSQL_REPLY_OK;
+    }
+
+    // Add a COM_INIT_DB to the history.
+    void add_init_db(const char* zDb)
+    {
+        size_t len = strlen(zDb);
+        GWBUF* pBuffer = gwbuf_alloc(MYSQL_HEADER_LEN + 1 + len);
+        uint8_t* pData = GWBUF_DATA(pBuffer);
+
+        gw_mysql_set_byte3(pData, 1 + len);
+        pData[3] = 0;
+        pData[4] = MXS_COM_INIT_DB;
+        memcpy(pData + MYSQL_HEADER_LEN + 1, zDb, len);
+
+        m_list.emplace_back(new mxs::SessionCommand(pBuffer, ++m_pos));
+        m_responses[m_pos] = MYSQL_REPLY_OK;
+    }
+
+    size_t compact()
+    {
+        return sescmd_compact_history(&m_list, m_pos);
+    }
+
+    vector<uint64_t> positions() const
+    {
+        vector<uint64_t> rv;
+
+        for (const auto& sescmd : m_list)
+        {
+            rv.push_back(sescmd->get_position());
+        }
+
+        return rv;
+    }
+
+    mxs::SessionCommandList& list()
+    {
+        return m_list;
+    }
+
+    ResponseMap& responses()
+    {
+        return m_responses;
+    }
+
+private:
+    uint64_t                m_pos;
+    mxs::SessionCommandList m_list;
+    ResponseMap             m_responses;
+};
+
+int check_positions(const char* zName, const History& history, const vector<uint64_t>& expected)
+{
+    int rv = 0;
+
+    if (history.positions() != expected)
+    {
+        cout << "error: " << zName << ": Unexpected history:";
+
+        for (auto pos : history.positions())
+        {
+            cout << " " << pos;
+        }
+
+        cout << endl;
+        rv = 1;
+    }
+
+    return rv;
+}
+
+int test_compact_history()
+{
+    int rv = 0;
+
+    {
+        // A later assignment removes an earlier one, over other assignments.
+        History h;
+        h.add("SET autocommit=0");
+        h.add("SET @a=1");
+        h.add("SET autocommit=1");
+
+        rv += h.compact() != 1;
+        rv += check_positions("override", h, {2, 3});
+    }
+
+    {
+        // USE and COM_INIT_DB override each other.
+        History h;
+        h.add("USE a");
+        h.add_init_db("b");
+        h.add("USE c");
+
+        rv += h.compact() != 2;
+        rv += check_positions("use", h, {3});
+    }
+
+    {
+        // A command that may depend on earlier state is never crossed.
+        History h;
+        h.add("SET @a=1");
+        h.add("SET @b=@a");
+        h.add("SET @a=2");
+
+        rv += h.compact() != 0;
+        rv += check_positions("dependency", h, {1, 2, 3});
+    }
+
+    {
+        // Only the command that was executed triggers compaction.
+        History h;
+        h.add("SET @a=1");
+        h.add("SET @a=2");
+        h.add("SELECT 1");
+
+        rv += h.compact() != 0;
+        rv += check_positions("no key", h, {1, 2, 3});
+    }
+
+    {
+        // An assignment does not cross a change of the character set, as the
+        // literal of the removed assignment was interpreted in another one.
+        History h;
+        h.add("SET @a='x'");
+        h.add("SET NAMES latin1");
+        h.add("SET @a='y'");
+
+        rv += h.compact() != 0;
+        rv += check_positions("charset barrier", h, {1, 2, 3});
+    }
+
+    {
+        // A change of the character set does not cross other commands.
+        History h;
+        h.add("SET NAMES latin1");
+        h.add("SET @a='x'");
+        h.add("SET NAMES utf8");
+
+        rv += h.compact() != 0;
+        rv += check_positions("charset over other", h, {1, 2, 3});
+    }
+
+    {
+        // Consecutive changes of the character set override each other.
+        History h;
+        h.add("SET @a='x'");
+        h.add("SET NAMES latin1");
+        h.add("SET NAMES utf8");
+
+        rv += h.compact() != 1;
+        rv += check_positions("charset", h, {1, 3});
+    }
+
+    {
+        // Different ways of changing the character set are not merged.
+        History h;
+        h.add("SET CHARACTER SET latin1");
+        h.add("SET character_set_client=utf8");
+        h.add("SET CHARACTER SET utf8");
+
+        rv += h.compact() != 0;
+        rv += check_positions("charset variants", h, {1, 2, 3});
+    }
+
+    {
+        // Whether the backslash is an escape character depends on the sql_mode,
+        // so the sql_mode does not cross an assignment in either direction.
+        History h;
+        h.add("SET sql_mode='NO_BACKSLASH_ESCAPES'");
+        h.add("SET @x='a\\b'");
+        h.add("SET sql_mode=''");
+
+        rv += h.compact() != 0;
+        rv += check_positions("sql_mode barrier", h, {1, 2, 3});
+
+        h.add("SET @x='c'");
+
+        rv += h.compact() != 0;
+        rv += check_positions("sql_mode barrier for assignment", h, {1, 2, 3, 4});
+    }
+
+    return rv;
+}
+
+int test_prune_responses()
+{
+    int rv = 0;
+
+    History h;
+    h.add("SET @a=1");
+    h.add("SET @b=1");
+    h.add("SET @a=2");
+    h.add("SET @b=2");
+
+    rv += h.compact() != 1;
+    rv += check_positions("prune", h, {1, 3, 4});
+
+    // A backend still waits for the response to command 2, so it is kept.
+    sescmd_prune_responses(h.list(), 2, &h.responses());
+
+    ResponseMap expected {{1, MYSQL_REPLY_OK}, {2, MYSQL_REPLY_OK}, {3, MYSQL_REPLY_OK},
+                          {4, MYSQL_REPLY_OK}};
+
+    if (h.responses() != expected)
+    {
+        cout << "error: A response that a backend waits for was pruned." << endl;
+        ++rv;
+    }
+
+    // Once no backend waits for it, the response of a removed command is pruned.
+    sescmd_prune_responses(h.list(), 5, &h.responses());
+    expected.erase(2);
+
+    if (h.responses() != expected)
+    {
+        cout << "error: The response of a removed command was not pruned." << endl;
+        ++rv;
+    }
+
+    // The responses of commands in the history are kept, even if no backend waits for them.
+    h.list().clear();
+    sescmd_prune_responses(h.list(), 4, &h.responses());
+    expected = {{4, MYSQL_REPLY_OK}};
+
+    if (h.responses() != expected)
+    {
+        cout << "error: Responses were not pruned up to the lowest position." << endl;
+        ++rv;
+    }
+
+    return rv;
+}
+}
+
+int main(int argc, char* argv[])
+{
+    int rv = 0;
+
+    rv += test_set_statement_key();
+    rv += test_compact_history();
+    rv += test_prune_responses();
+
+    return rv == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
@@ -14,7 +14,8 @@
 
 #include <maxscale/ccdefs.hh>
 
-#include <list>
+#include <memory>
+#include <vector>
 
 #include <maxscale/buffer.hh>
 #include <maxscale/utils.hh>
@@ -24,11 +25,24 @@
 class Trx
 {
 public:
-    // A log of executed queries, for transaction replay
-    typedef std::list<mxs::Buffer> TrxLog;
+    /**
+     * A log of executed queries, for transaction replay. The statements are
+     * references to the buffers the client sent and the log itself is shared
+     * between the copies of a transaction.
+     */
+    typedef std::vector<mxs::Buffer> TrxLog;
 
-    Trx()
-        : m_size(0)
+    // The checksum that is used to compare the results of the transaction
+    enum ChecksumType
+    {
+        CHECKSUM_SHA1,
+        CHECKSUM_MURMUR3
+    };
+
+    Trx(ChecksumType type = CHECKSUM_MURMUR3)
+        : m_checksum_type(type)
+        , m_replay_pos(0)
+        , m_size(0)
     {
     }
 
@@ -46,8 +60,20 @@ public:
             MXS_INFO("Adding to trx: %s", mxs::extract_sql(buf, 512).c_str());
         }
 
+        if (!m_sLog)
+        {
+            m_sLog = std::make_shared<TrxLog>();
+        }
+        else if (!m_sLog.unique())
+        {
+            // Some other copy of the transaction refers to the log, copy the references.
+            m_sLog = std::make_shared<TrxLog>(*m_sLog);
+        }
+
+        // The statement is kept until the transaction ends, don't let it pin a larger read.
+        buf = gwbuf_make_compact(buf);
         m_size += gwbuf_length(buf);
-        m_log.emplace_back(buf);
+        m_sLog->emplace_back(buf);
     }
 
     /**
@@ -59,23 +85,28 @@ public:
      */
     void add_result(GWBUF* buf)
     {
-        m_checksum.update(buf);
+        if (m_checksum_type == CHECKSUM_SHA1)
+        {
+            m_sha1.update(buf);
+        }
+        else
+        {
+            m_murmur3.update(buf);
+        }
     }
 
     /**
-     * Releases the oldest statement in this transaction
+     * Get the next statement to replay
      *
-     * This reduces the size of the transaction by one and should only be used
-     * to replay a transaction.
+     * The statements are returned in the order they were added. The statement
+     * remains in the log, the returned buffer is a reference to it.
      *
-     * @return The oldest statement in this transaction
+     * @return The next statement of this transaction
      */
     GWBUF* pop_stmt()
     {
-        mxb_assert(!m_log.empty());
-        GWBUF* rval = m_log.front().release();
-        m_log.pop_front();
-        return rval;
+        mxb_assert(have_stmts());
+        return gwbuf_clone((*m_sLog)[m_replay_pos++].get());
     }
 
     /**
@@ -87,7 +118,14 @@ public:
      */
     void finalize()
     {
-        m_checksum.finalize();
+        if (m_checksum_type == CHECKSUM_SHA1)
+        {
+            m_sha1.finalize();
+        }
+        else
+        {
+            m_murmur3.finalize();
+        }
     }
 
     /**
@@ -101,7 +139,7 @@ public:
      */
     bool have_stmts() const
     {
-        return !m_log.empty();
+        return m_sLog && m_replay_pos < m_sLog->size();
     }
 
     /**
@@ -131,25 +169,49 @@ public:
      */
     void close()
     {
-        m_checksum.reset();
-        m_log.clear();
+        m_sha1.reset();
+        m_murmur3.reset();
+        m_sLog.reset();
+        m_replay_pos = 0;
         m_size = 0;
     }
 
     /**
-     * Return the current checksum
+     * Check whether the results so far match those of a finalized transaction
+     *
+     * The checksum of this transaction is not finalized, so more results can
+     * still be added to it.
      *
-     * finalize() must be called before the return value of this function is used.
+     * @param finalized The transaction to compare to, finalize() must have been called
      *
-     * @return The checksum of the transaction
+     * @return True if the checksums match
      */
-    const mxs::SHA1Checksum& checksum() const
+    bool checksum_matches(const Trx& finalized) const
     {
-        return m_checksum;
+        mxb_assert(m_checksum_type == finalized.m_checksum_type);
+        bool rval;
+
+        if (m_checksum_type == CHECKSUM_SHA1)
+        {
+            mxs::SHA1Checksum sum = m_sha1;
+            sum.finalize();
+            rval = sum == finalized.m_sha1;
+        }
+        else
+        {
+            mxs::Murmur3Checksum sum = m_murmur3;
+            sum.finalize();
+            rval = sum == finalized.m_murmur3;
+        }
+
+        return rval;
     }
 
 private:
-    mxs::SHA1Checksum m_checksum;   /**< Checksum of the transaction */
-    TrxLog            m_log;        /**< The transaction contents */
-    size_t            m_size;       /**< Transaction size in bytes */
+    ChecksumType            m_checksum_type;    /**< The checksum in use */
+    mxs::SHA1Checksum       m_sha1;             /**< SHA1 checksum of the transaction */
+    mxs::Murmur3Checksum    m_murmur3;          /**< MurmurHash3 checksum of the transaction */
+    std::shared_ptr<TrxLog> m_sLog;             /**< The transaction contents */
+    size_t                  m_replay_pos;       /**< The next statement to replay */
+    size_t                  m_size;             /**< Transaction size in bytes */
 };
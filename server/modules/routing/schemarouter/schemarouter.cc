@@ -21,6 +21,7 @@ namespace schemarouter
 Config::Config(MXS_CONFIG_PARAMETER* conf)
     : refresh_min_interval(config_get_integer(conf, "refresh_interval"))
     , refresh_databases(config_get_bool(conf, "refresh_databases"))
+    , refresh_in_background(config_get_bool(conf, "refresh_in_background"))
     , debug(config_get_bool(conf, "debug"))
     , ignore_regex(config_get_compiled_regex(conf, "ignore_databases_regex", 0, NULL))
     , ignore_match_data(ignore_regex ? pcre2_match_data_create_from_pattern(ignore_regex, NULL) : NULL)
@@ -40,6 +41,40 @@ Config::Config(MXS_CONFIG_PARAMETER* conf)
     }
 }
 
+bool Config::ignore_database(const char* db) const
+{
+    bool rval = false;
+
+    if (ignored_dbs.count(db))
+    {
+        rval = true;
+    }
+    else if (ignore_regex)
+    {
+        pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(ignore_regex, NULL);
+
+        if (match_data == NULL)
+        {
+            throw std::bad_alloc();
+        }
+
+        if (pcre2_match(ignore_regex,
+                        (PCRE2_SPTR) db,
+                        PCRE2_ZERO_TERMINATED,
+                        0,
+                        0,
+                        match_data,
+                        NULL) >= 0)
+        {
+            rval = true;
+        }
+
+        pcre2_match_data_free(match_data);
+    }
+
+    return rval;
+}
+
 void SRBackend::set_mapped(bool value)
 {
     m_mapped = value;
@@ -43,6 +43,8 @@ struct Config
                                              * refreshes of databases */
     bool refresh_databases;                 /**< Are databases refreshed when
                                              * they are not found in the hashtable */
+    bool refresh_in_background;             /**< Are databases refreshed periodically
+                                             * with the service credentials */
     bool                  debug;            /**< Enable verbose debug messages to clients */
     pcre2_code*           ignore_regex;     /**< Regular expression used to ignore databases */
     pcre2_match_data*     ignore_match_data;/**< Match data for @c ignore_regex */
@@ -51,6 +53,15 @@ struct Config
 
     Config(MXS_CONFIG_PARAMETER* conf);
 
+    /**
+     * Check whether duplicates of a database are ignored
+     *
+     * @param db The database name
+     *
+     * @return True if the database is ignored
+     */
+    bool ignore_database(const char* db) const;
+
     ~Config()
     {
         pcre2_match_data_free(ignore_match_data);
@@ -73,6 +84,7 @@ struct Stats
     int    sessions;        /*< Number of sessions */
     int    shmap_cache_hit; /*< Shard map was found from the cache */
     int    shmap_cache_miss;/*< No shard map found from the cache */
+    int    shmap_refreshes; /*< Shard maps created by the background refresh */
     double ses_longest;     /*< Longest session */
     double ses_shortest;    /*< Shortest session */
     double ses_average;     /*< Average session length */
@@ -85,6 +97,7 @@ struct Stats
         , sessions(0)
         , shmap_cache_hit(0)
         , shmap_cache_miss(0)
+        , shmap_refreshes(0)
         , ses_longest(0.0)
         , ses_shortest(std::numeric_limits<double>::max())
         , ses_average(0.0)
@@ -20,11 +20,14 @@
 #include <string.h>
 #include <strings.h>
 
+#include <maxbase/atomic.hh>
 #include <maxscale/alloc.h>
 #include <maxscale/buffer.h>
+#include <maxscale/housekeeper.h>
 #include <maxscale/log.h>
 #include <maxscale/modinfo.h>
 #include <maxscale/modutil.h>
+#include <maxscale/mysql_utils.h>
 #include <maxscale/poll.h>
 #include <maxscale/query_classifier.h>
 #include <maxscale/router.h>
@@ -45,11 +48,18 @@ SchemaRouter::SchemaRouter(SERVICE* service, SConfig config)
     : mxs::Router<SchemaRouter, SchemaRouterSession>(service)
     , m_config(config)
     , m_service(service)
+    , m_refresh_task(std::string("schemarouter_refresh_") + service->name)
+    , m_refresh_interval(0)
 {
+    if (m_config->refresh_in_background)
+    {
+        start_refresh();
+    }
 }
 
 SchemaRouter::~SchemaRouter()
 {
+    stop_refresh();
 }
 
 SchemaRouter* SchemaRouter::create(SERVICE* pService, MXS_CONFIG_PARAMETER* params)
@@ -68,10 +78,147 @@ SchemaRouter* SchemaRouter::create(SERVICE* pService, MXS_CONFIG_PARAMETER* para
 bool SchemaRouter::configure(MXS_CONFIG_PARAMETER* params)
 {
     SConfig config(new Config(params));
-    m_config = config;
+    std::atomic_store(&m_config, config);
+
+    if (!config->refresh_in_background)
+    {
+        stop_refresh();
+    }
+    else if (m_refresh_interval != (int)config->refresh_min_interval)
+    {
+        stop_refresh();
+        start_refresh();
+    }
+
+    return true;
+}
+
+void SchemaRouter::start_refresh()
+{
+    m_refresh_interval = MXS_MAX((int)m_config->refresh_min_interval, 1);
+    hktask_add(m_refresh_task.c_str(), refresh_task, this, m_refresh_interval);
+}
+
+void SchemaRouter::stop_refresh()
+{
+    if (m_refresh_interval)
+    {
+        hktask_remove(m_refresh_task.c_str());
+        m_refresh_interval = 0;
+        m_shard_manager.update_default_shard(Shard());
+    }
+}
+
+// static
+bool SchemaRouter::refresh_task(void* data)
+{
+    static_cast<SchemaRouter*>(data)->refresh_databases();
     return true;
 }
 
+namespace
+{
+
+/**
+ * Add the databases of a server to a shard
+ *
+ * @param config   The router configuration
+ * @param server   The server to query
+ * @param user     The user to connect with
+ * @param password The decrypted password of the user
+ * @param shard    The shard where the databases are added
+ *
+ * @return True if the databases were added and no duplicate tables were found
+ */
+bool map_server(const Config& config, SERVER* server, const char* user, const char* password, Shard& shard)
+{
+    bool rval = false;
+    MYSQL* con = mysql_init(NULL);
+
+    if (con == NULL)
+    {
+        return false;
+    }
+
+    MXS_CONFIG* cnf = config_get_global_options();
+    mysql_optionsv(con, MYSQL_OPT_READ_TIMEOUT, &cnf->auth_read_timeout);
+    mysql_optionsv(con, MYSQL_OPT_CONNECT_TIMEOUT, &cnf->auth_conn_timeout);
+    mysql_optionsv(con, MYSQL_OPT_WRITE_TIMEOUT, &cnf->auth_write_timeout);
+
+    if (mxs_mysql_real_connect(con, server, user, password) == NULL)
+    {
+        MXS_ERROR("Failed to connect to '%s' when refreshing the databases: %s",
+                  server->name, mysql_error(con));
+    }
+    else if (mxs_mysql_query(con, SCHEMA_MAPPING_QUERY) != 0)
+    {
+        MXS_ERROR("Failed to query the databases of '%s': %s", server->name, mysql_error(con));
+    }
+    else if (MYSQL_RES* result = mysql_use_result(con))
+    {
+        rval = true;
+
+        while (MYSQL_ROW row = mysql_fetch_row(result))
+        {
+            const char* data = row[0];
+
+            if (data == NULL || shard.add_location(data, server))
+            {
+                continue;
+            }
+
+            if (!config.ignore_database(data) && strchr(data, '.') != NULL)
+            {
+                MXS_ERROR("Table '%s' found on servers '%s' and '%s'.",
+                          data, server->name, shard.get_location(data)->name);
+                rval = false;
+            }
+            else if (config.preferred_server == server)
+            {
+                shard.replace_location(data, server);
+            }
+        }
+
+        mysql_free_result(result);
+    }
+
+    mysql_close(con);
+    return rval;
+}
+}
+
+/**
+ * Map the databases of all servers with the service credentials. The shard map
+ * is only replaced if all usable servers could be mapped so that sessions never
+ * see a partial map.
+ */
+void SchemaRouter::refresh_databases()
+{
+    SConfig config = std::atomic_load(&m_config);
+    const char* user;
+    const char* password;
+    serviceGetUser(m_service, &user, &password);
+    char* dpwd = decrypt_password(password);
+    bool ok = dpwd != NULL;
+    Shard shard;
+
+    for (SERVER_REF* ref = m_service->dbref; ref && ok; ref = ref->next)
+    {
+        if (ref->active && server_is_usable(ref->server))
+        {
+            ok = map_server(*config, ref->server, user, dpwd, shard);
+        }
+    }
+
+    MXS_FREE(dpwd);
+
+    if (ok && !shard.empty())
+    {
+        m_shard_manager.update_default_shard(shard);
+        mxb::atomic::add(&m_stats.shmap_refreshes, 1, mxb::atomic::RELAXED);
+    }
+}
+
 /**
  * @node Search all RUNNING backend servers and connect
  *
@@ -236,6 +383,7 @@ void SchemaRouter::diagnostics(DCB* dcb)
     }
     dcb_printf(dcb, "Shard map cache hits: %d\n", m_stats.shmap_cache_hit);
     dcb_printf(dcb, "Shard map cache misses: %d\n", m_stats.shmap_cache_miss);
+    dcb_printf(dcb, "Shard map background refreshes: %d\n", m_stats.shmap_refreshes);
     dcb_printf(dcb, "\n");
 }
 
@@ -261,6 +409,7 @@ json_t* SchemaRouter::diagnostics_json() const
 
     json_object_set_new(rval, "shard_map_hits", json_integer(m_stats.shmap_cache_hit));
     json_object_set_new(rval, "shard_map_misses", json_integer(m_stats.shmap_cache_miss));
+    json_object_set_new(rval, "shard_map_refreshes", json_integer(m_stats.shmap_refreshes));
 
     return rval;
 }
@@ -304,6 +453,7 @@ extern "C" MXS_MODULE* MXS_CREATE_MODULE()
             {"disable_sescmd_history",                   MXS_MODULE_PARAM_BOOL, "false"},
             {"refresh_databases",                        MXS_MODULE_PARAM_BOOL, "true"},
             {"refresh_interval",                         MXS_MODULE_PARAM_COUNT, DEFAULT_REFRESH_INTERVAL},
+            {"refresh_in_background",                    MXS_MODULE_PARAM_BOOL, "false"},
             {"debug",                                    MXS_MODULE_PARAM_BOOL, "false"},
             {"preferred_server",                         MXS_MODULE_PARAM_SERVER  },
             {MXS_END_MODULE_PARAMS}
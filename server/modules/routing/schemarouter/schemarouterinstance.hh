@@ -48,11 +48,19 @@ private:
     /** Internal functions */
     SchemaRouter(SERVICE* service, SConfig config);
 
+    void        start_refresh();
+    void        stop_refresh();
+    void        refresh_databases();
+    static bool refresh_task(void* data);
+
     /** Member variables */
-    SConfig      m_config;          /*< expanded config info from SERVICE */
+    SConfig      m_config;          /*< expanded config info from SERVICE, replaced and read
+                                     *  with std::atomic_store and std::atomic_load */
     ShardManager m_shard_manager;   /*< Shard maps hashed by user name */
     SERVICE*     m_service;         /*< Pointer to service */
     std::mutex   m_lock;            /*< Lock for the instance data */
     Stats        m_stats;           /*< Statistics for this router */
+    std::string  m_refresh_task;    /*< Name of the background refresh task */
+    int          m_refresh_interval;/*< Interval of the background refresh */
 };
 }
@@ -43,7 +43,7 @@ SchemaRouterSession::SchemaRouterSession(MXS_SESSION* session,
     , m_client(session->client_dcb)
     , m_mysql_session((MYSQL_session*)session->client_dcb->data)
     , m_backends(backends)
-    , m_config(router->m_config)
+    , m_config(std::atomic_load(&router->m_config))
     , m_router(router)
     , m_shard(m_router->m_shard_manager.get_shard(m_client->user, m_config->refresh_min_interval))
     , m_state(0)
@@ -82,6 +82,11 @@ SchemaRouterSession::SchemaRouterSession(MXS_SESSION* session,
         m_connect_db = db;
     }
 
+    if (!m_shard.empty())
+    {
+        mxb::atomic::add(&m_router->m_stats.shmap_cache_hit, 1, mxb::atomic::RELAXED);
+    }
+
     mxb::atomic::add(&m_router->m_stats.sessions, 1);
 }
 
@@ -1192,42 +1197,6 @@ char* get_lenenc_str(void* data)
     return rval;
 }
 
-static const std::set<std::string> always_ignore = {"mysql", "information_schema", "performance_schema"};
-
-bool SchemaRouterSession::ignore_duplicate_database(const char* data)
-{
-    bool rval = false;
-
-    if (m_config->ignored_dbs.count(data) || always_ignore.count(data))
-    {
-        rval = true;
-    }
-    else if (m_config->ignore_regex)
-    {
-        pcre2_match_data* match_data = pcre2_match_data_create_from_pattern(m_config->ignore_regex, NULL);
-
-        if (match_data == NULL)
-        {
-            throw std::bad_alloc();
-        }
-
-        if (pcre2_match(m_config->ignore_regex,
-                        (PCRE2_SPTR) data,
-                        PCRE2_ZERO_TERMINATED,
-                        0,
-                        0,
-                        match_data,
-                        NULL) >= 0)
-        {
-            rval = true;
-        }
-
-        pcre2_match_data_free(match_data);
-    }
-
-    return rval;
-}
-
 /**
  * Parses a response set to a SHOW DATABASES query and inserts them into the
  * router client session's database hashtable. The name of the database is used
@@ -1304,7 +1273,7 @@ enum showdb_response SchemaRouterSession::parse_mapping_response(SSRBackend& bre
             }
             else
             {
-                if (!ignore_duplicate_database(data) && strchr(data, '.') != NULL)
+                if (!m_config->ignore_database(data) && strchr(data, '.') != NULL)
                 {
                     duplicate_found = true;
                     SERVER* duplicate = m_shard.get_location(data);
@@ -1377,11 +1346,7 @@ void SchemaRouterSession::query_databases()
     m_state |= INIT_MAPPING;
     m_state &= ~INIT_UNINT;
 
-    GWBUF* buffer = modutil_create_query("SELECT schema_name FROM information_schema.schemata AS s "
-                                         "LEFT JOIN information_schema.tables AS t ON s.schema_name = t.table_schema "
-                                         "WHERE t.table_name IS NULL "
-                                         "UNION "
-                                         "SELECT CONCAT (table_schema, '.', table_name) FROM information_schema.tables");
+    GWBUF* buffer = modutil_create_query(SCHEMA_MAPPING_QUERY);
     gwbuf_set_type(buffer, GWBUF_TYPE_COLLECT_RESULT);
 
     for (SSRBackendList::iterator it = m_backends.begin(); it != m_backends.end(); it++)
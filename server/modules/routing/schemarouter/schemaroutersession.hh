@@ -51,6 +51,14 @@ enum showdb_response
 #define SCHEMA_ERR_DBNOTFOUND     1049
 #define SCHEMA_ERRSTR_DBNOTFOUND  "42000"
 
+/** The query that lists the databases and tables of a server */
+#define SCHEMA_MAPPING_QUERY \
+    "SELECT schema_name FROM information_schema.schemata AS s " \
+    "LEFT JOIN information_schema.tables AS t ON s.schema_name = t.table_schema " \
+    "WHERE t.table_name IS NULL " \
+    "UNION " \
+    "SELECT CONCAT (table_schema, '.', table_name) FROM information_schema.tables"
+
 /**
  * Route target types
  */
@@ -129,7 +137,6 @@ private:
     bool       get_shard_dcb(DCB** dcb, char* name);
     bool       have_servers();
     bool       handle_default_db();
-    bool       ignore_duplicate_database(const char* data);
     SERVER*    get_query_target(GWBUF* buffer);
     SERVER*    get_ps_target(GWBUF* buffer, uint32_t qtype, qc_query_op_t op);
 
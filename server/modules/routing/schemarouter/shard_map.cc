@@ -18,7 +18,8 @@
 #include <maxscale/alloc.h>
 
 Shard::Shard()
-    : m_last_updated(time(NULL))
+    : m_map(std::make_shared<ServerMap>())
+    , m_last_updated(time(NULL))
 {
 }
 
@@ -26,9 +27,24 @@ Shard::~Shard()
 {
 }
 
+void Shard::make_unique()
+{
+    // Only this shard can access the map if the use count is one so the check is not racy
+    if (m_map.use_count() > 1)
+    {
+        m_map = std::make_shared<ServerMap>(*m_map);
+    }
+}
+
 bool Shard::add_location(std::string db, SERVER* target)
 {
-    return m_map.insert(std::make_pair(db, target)).second;
+    if (m_map->count(db))
+    {
+        return false;
+    }
+
+    make_unique();
+    return m_map->insert(std::make_pair(db, target)).second;
 }
 
 void Shard::add_statement(std::string stmt, SERVER* target)
@@ -65,7 +81,8 @@ uint32_t Shard::get_ps_handle(uint32_t id)
 
 void Shard::replace_location(std::string db, SERVER* target)
 {
-    m_map[db] = target;
+    make_unique();
+    (*m_map)[db] = target;
 }
 
 SERVER* Shard::get_location(std::string table)
@@ -73,7 +90,7 @@ SERVER* Shard::get_location(std::string table)
     SERVER* rval = NULL;
     if (table.find(".") == std::string::npos)
     {
-        for (ServerMap::iterator it = m_map.begin(); it != m_map.end(); it++)
+        for (ServerMap::const_iterator it = m_map->begin(); it != m_map->end(); it++)
         {
             std::transform(table.begin(), table.end(), table.begin(), ::tolower);
             std::string db = it->first.substr(0, it->first.find("."));
@@ -98,7 +115,7 @@ SERVER* Shard::get_location(std::string table)
     }
     else
     {
-        for (ServerMap::iterator it = m_map.begin(); it != m_map.end(); it++)
+        for (ServerMap::const_iterator it = m_map->begin(); it != m_map->end(); it++)
         {
             std::transform(table.begin(), table.end(), table.begin(), ::tolower);
             std::string db = it->first;
@@ -154,12 +171,12 @@ bool Shard::stale(double max_interval) const
 
 bool Shard::empty() const
 {
-    return m_map.size() == 0;
+    return m_map->size() == 0;
 }
 
 void Shard::get_content(ServerMap& dest)
 {
-    for (ServerMap::iterator it = m_map.begin(); it != m_map.end(); it++)
+    for (ServerMap::const_iterator it = m_map->begin(); it != m_map->end(); it++)
     {
         dest.insert(*it);
     }
@@ -170,6 +187,14 @@ bool Shard::newer_than(const Shard& shard) const
     return m_last_updated > shard.m_last_updated;
 }
 
+Shard Shard::locations() const
+{
+    Shard rval;
+    rval.m_map = m_map;
+    rval.m_last_updated = m_last_updated;
+    return rval;
+}
+
 ShardManager::ShardManager()
 {
 }
@@ -184,20 +209,34 @@ Shard ShardManager::get_shard(std::string user, double max_interval)
 
     ShardMap::iterator iter = m_maps.find(user);
 
-    if (iter == m_maps.end() || iter->second.stale(max_interval))
+    if (iter != m_maps.end() && !iter->second.stale(max_interval))
+    {
+        // Found valid shard
+        return iter->second;
+    }
+    else if (!m_default.empty())
+    {
+        // The background refresh keeps the default shard up to date
+        return m_default;
+    }
+    else if (iter != m_maps.end())
     {
-        // No previous shard or a stale shard, construct a new one
+        time_t now = time(NULL);
+        RefreshMap::iterator it = m_refreshing.find(user);
 
-        if (iter != m_maps.end())
+        if (it != m_refreshing.end() && difftime(now, it->second) <= max_interval)
         {
-            m_maps.erase(iter);
+            // Another session is refreshing the shard, use the stale one until it's done
+            return iter->second;
         }
 
-        return Shard();
+        // This session refreshes the shard. If it fails to do so, another session
+        // takes over once the refresh has taken longer than the lifetime of a shard.
+        m_refreshing[user] = now;
     }
 
-    // Found valid shard
-    return iter->second;
+    // No previous shard or a stale shard, construct a new one
+    return Shard();
 }
 
 void ShardManager::update_shard(Shard& shard, std::string user)
@@ -207,6 +246,14 @@ void ShardManager::update_shard(Shard& shard, std::string user)
 
     if (iter == m_maps.end() || shard.newer_than(iter->second))
     {
-        m_maps[user] = shard;
+        m_maps[user] = shard.locations();
     }
+
+    m_refreshing.erase(user);
+}
+
+void ShardManager::update_default_shard(const Shard& shard)
+{
+    std::lock_guard<std::mutex> guard(m_lock);
+    m_default = shard.locations();
 }
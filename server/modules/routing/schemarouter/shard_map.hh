@@ -15,6 +15,7 @@
 #include <maxscale/ccdefs.hh>
 
 #include <list>
+#include <memory>
 #include <mutex>
 #include <string>
 #include <unordered_map>
@@ -28,6 +29,12 @@ typedef std::unordered_map<std::string, SERVER*> ServerMap;
 typedef std::unordered_map<uint64_t, SERVER*>    BinaryPSMap;
 typedef std::unordered_map<uint32_t, uint32_t>   PSHandleMap;
 
+/**
+ * The database locations of a shard are shared between all the copies of the
+ * shard and copied only when they are modified. As the shard manager only
+ * hands out copies, the locations it stores are never modified and a new
+ * session gets its shard without the locations being copied.
+ */
 class Shard
 {
 public:
@@ -103,15 +110,25 @@ public:
      */
     bool newer_than(const Shard& shard) const;
 
+    /**
+     * @brief Get a copy of the shard that only contains the database locations
+     *
+     * @return The shared part of the shard
+     */
+    Shard locations() const;
+
 private:
-    ServerMap   m_map;
+    void make_unique();
+
+    std::shared_ptr<ServerMap> m_map;
     ServerMap   stmt_map;
     BinaryPSMap m_binary_map;
     PSHandleMap m_ps_handles;
     time_t      m_last_updated;
 };
 
-typedef std::unordered_map<std::string, Shard> ShardMap;
+typedef std::unordered_map<std::string, Shard>  ShardMap;
+typedef std::unordered_map<std::string, time_t> RefreshMap;
 
 class ShardManager
 {
@@ -122,11 +139,16 @@ public:
     /**
      * @brief Retrieve or create a shard
      *
+     * A stale shard is returned as-is if the shard is already being refreshed
+     * by another session or if there is a shard created by the background
+     * refresh. Otherwise an empty shard is returned and the caller is expected
+     * to map the databases and to call update_shard().
+     *
      * @param user         User whose shard to retrieve
      * @param max_lifetime The maximum lifetime of a shard
      *
      * @return The latest version of the shard or a newly created shard if no
-     * old version is available
+     * old version is available or if the caller should refresh it
      */
     Shard get_shard(std::string user, double max_lifetime);
 
@@ -141,7 +163,18 @@ public:
      */
     void update_shard(Shard& shard, std::string user);
 
+    /**
+     * @brief Update the shard created by the background refresh
+     *
+     * The shard is used for all users whose own shard is missing or stale.
+     *
+     * @param shard New version of the shard
+     */
+    void update_default_shard(const Shard& shard);
+
 private:
     mutable std::mutex m_lock;
     ShardMap           m_maps;
+    RefreshMap         m_refreshing;    /**< Users whose shard is being refreshed */
+    Shard              m_default;       /**< The shard created by the background refresh */
 };